@@ -0,0 +1,82 @@
+﻿/**
+ * @file Benchmark.h
+ * @brief Минимальный каркас для регистрации и запуска бенчмарков NetSphere.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+ /**
+  * @defgroup benchmark_module Модуль бенчмарков
+  * @brief Средства измерения производительности компонентов сети
+  * @{
+  */
+
+  /**
+   * @brief Описание зарегистрированного бенчмарка.
+   */
+struct BenchmarkCase {
+    std::string name;              ///< Имя бенчмарка (используется для фильтрации)
+    std::function<void()> body;    ///< Тело бенчмарка, само выводящее результаты
+};
+
+/**
+ * @brief Возвращает глобальный реестр бенчмарков.
+ * @return Ссылка на список зарегистрированных бенчмарков.
+ */
+inline std::vector<BenchmarkCase>& benchmarkRegistry() {
+    static std::vector<BenchmarkCase> registry;
+    return registry;
+}
+
+/**
+ * @brief Вспомогательная структура для статической регистрации бенчмарка.
+ */
+struct BenchmarkRegistrar {
+    BenchmarkRegistrar(const char* name, std::function<void()> body) {
+        benchmarkRegistry().push_back({ name, std::move(body) });
+    }
+};
+
+/**
+ * @brief Простой секундомер на основе steady_clock.
+ */
+class Stopwatch {
+private:
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+public:
+    /**
+     * @brief Возвращает время, прошедшее с создания секундомера.
+     * @return Время в секундах.
+     */
+    double elapsedSeconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+/**
+ * @brief Препятствует удалению компилятором вычислений, результат которых не используется.
+ * @param[in] value Значение, которое должно считаться используемым.
+ */
+template<typename T>
+inline void doNotOptimize(const T& value) {
+    static volatile const void* sink;
+    sink = &value;
+}
+
+/**
+ * @brief Регистрирует бенчмарк с заданным именем.
+ * @details Тело бенчмарка следует сразу за макросом в фигурных скобках.
+ */
+#define NETSPHERE_BENCHMARK(name)                                              \
+    static void netsphere_benchmark_##name();                                  \
+    static BenchmarkRegistrar netsphere_registrar_##name(#name, netsphere_benchmark_##name); \
+    static void netsphere_benchmark_##name()
+
+/** @} */ // Конец группы benchmark_module
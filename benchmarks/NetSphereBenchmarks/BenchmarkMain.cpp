@@ -0,0 +1,31 @@
+﻿/**
+ * @file BenchmarkMain.cpp
+ * @brief Точка входа для запуска бенчмарков NetSphere.
+ *
+ * Запуск без аргументов выполняет все бенчмарки; аргументы командной строки
+ * задают подстроки имён для фильтрации.
+ */
+
+#include "Benchmark.h"
+#include <iostream>
+
+int main(int argc, char* argv[]) {
+    size_t executed = 0;
+    for (const auto& benchmark : benchmarkRegistry()) {
+        bool selected = (argc < 2);
+        for (int i = 1; i < argc && !selected; ++i) {
+            selected = benchmark.name.find(argv[i]) != std::string::npos;
+        }
+        if (!selected) {
+            continue;
+        }
+
+        std::cout << "=== " << benchmark.name << " ===" << std::endl;
+        benchmark.body();
+        std::cout << std::endl;
+        ++executed;
+    }
+
+    std::cout << "Выполнено бенчмарков: " << executed << std::endl;
+    return 0;
+}
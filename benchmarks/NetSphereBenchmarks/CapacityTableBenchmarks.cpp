@@ -0,0 +1,66 @@
+﻿/**
+ * @file CapacityTableBenchmarks.cpp
+ * @brief Бенчмарки отчётов по ёмкости хранилищ всего парка.
+ */
+
+#include "Benchmark.h"
+#include "CorporateNetwork.h"
+#include "DataStorage.h"
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+NETSPHERE_BENCHMARK(FleetCapacityReports) {
+    constexpr size_t DOMAIN_COUNT = 100;
+    constexpr size_t STORAGES_PER_DOMAIN = 10000;
+    constexpr int REPEATS = 10;
+
+    CorporateNetwork network("bench_admin");
+    for (size_t d = 0; d < DOMAIN_COUNT; ++d) {
+        const std::string domainId = "capacity_domain_" + std::to_string(d);
+        network.addEntityToDomain("", std::make_shared<Domain>(domainId, "bench_admin"), "bench_admin");
+        std::vector<std::shared_ptr<NetworkEntity>> batch;
+        batch.reserve(STORAGES_PER_DOMAIN);
+        for (size_t i = 0; i < STORAGES_PER_DOMAIN; ++i) {
+            const size_t n = d * STORAGES_PER_DOMAIN + i;
+            auto storage = std::make_shared<DataStorage>("capacity_storage_" + std::to_string(n),
+                MacAddress::fromUInt64(n + 1), 1000.0 + static_cast<double>(n % 97));
+            *storage = static_cast<double>(n % 1000);
+            batch.push_back(std::move(storage));
+        }
+        network.addEntitiesToDomain(domainId, batch, "bench_admin");
+    }
+
+    auto report = [&](const char* name, auto&& body) {
+        Stopwatch timer;
+        for (int r = 0; r < REPEATS; ++r) {
+            doNotOptimize(body());
+        }
+        std::cout << std::setw(28) << name << std::setw(12) << std::fixed << std::setprecision(3)
+            << timer.elapsedSeconds() * 1000.0 / REPEATS << " мс" << std::endl;
+    };
+
+    std::cout << "Хранилищ: " << DOMAIN_COUNT * STORAGES_PER_DOMAIN << std::endl;
+
+    // Прежний способ: обход объектов по shared_ptr с виртуальной проверкой вида
+    report("object walk total", [&] {
+        return network.readLocked([&] {
+            double used = 0.0;
+            for (const auto& [id, entity] : network.getRootDomain()->getAllEntities()) {
+                for (const auto& [childId, child] : std::static_pointer_cast<Domain>(entity)->getAllEntities()) {
+                    if (auto storage = entityCast<DataStorage>(child)) {
+                        used += storage->getUsedSize();
+                    }
+                }
+            }
+            return used;
+        });
+    });
+
+    network.readCapacity([&](const CapacityTable& table) {
+        report("table sum", [&] { return table.sum(); });
+        report("table above 0.9", [&] { return table.countAboveFillRatio(0.9); });
+        report("table histogram(10)", [&] { return table.fillHistogram(10); });
+        report("table sum by domain", [&] { return table.sumByDomain(); });
+    });
+}
@@ -0,0 +1,46 @@
+﻿/**
+ * @file CommandBufferBenchmarks.cpp
+ * @brief Бенчмарки пакетного выполнения команд.
+ */
+
+#include "Benchmark.h"
+#include "CommandBuffer.h"
+#include "MacAddress.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+NETSPHERE_BENCHMARK(CommandBufferThroughput) {
+    constexpr size_t DEVICE_COUNT = 100000;
+
+    std::cout << std::setw(14) << "batch" << std::setw(16) << "commands/s" << std::endl;
+    for (size_t batchSize : { 1u, 64u, 4096u }) {
+        CorporateNetwork network("bench_admin");
+
+        // Буферы кодируются заранее: измеряется разбор и выполнение на стороне DLL
+        std::vector<CommandBufferWriter> batches;
+        for (size_t first = 0; first < DEVICE_COUNT; first += batchSize) {
+            CommandBufferWriter& writer = batches.emplace_back();
+            for (size_t i = first; i < std::min(first + batchSize, DEVICE_COUNT); ++i) {
+                const std::string id = "batched_storage_" + std::to_string(i);
+                writer.addStorage("", "bench_admin", id, MacAddress::fromUInt64(i).toString(), 1000)
+                    .storageDelta(id, 10);
+            }
+        }
+
+        std::vector<CommandStatus> statuses(batchSize * 2);
+        size_t failed = 0;
+        Stopwatch timer;
+        for (const auto& writer : batches) {
+            failed += CommandBufferExecutor::execute(network, writer.data(), statuses).failed;
+        }
+        const double seconds = timer.elapsedSeconds();
+
+        std::cout << std::setw(14) << batchSize
+            << std::setw(16) << std::fixed << std::setprecision(0) << DEVICE_COUNT * 2 / seconds << std::endl;
+        if (failed != 0) {
+            std::cout << "Ошибка: неуспешных команд " << failed << std::endl;
+        }
+    }
+}
@@ -0,0 +1,69 @@
+﻿/**
+ * @file CorporateNetworkBenchmarks.cpp
+ * @brief Бенчмарки операций класса CorporateNetwork.
+ */
+
+#include "Benchmark.h"
+#include "CorporateNetwork.h"
+#include "Printer.h"
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+    /**
+     * @brief Строит сеть заданного размера: цепочку вложенных доменов и принтеры в каждом из них.
+     * @param network Заполняемая сеть.
+     * @param entityCount Желаемое число сущностей.
+     * @param depth Глубина цепочки поддоменов.
+     * @return Идентификатор самого глубокого домена.
+     */
+    std::string buildNetwork(CorporateNetwork& network, size_t entityCount, size_t depth) {
+        std::string parentId;
+        for (size_t level = 0; level < depth; ++level) {
+            std::string domainId = "bench_domain_" + std::to_string(level);
+            std::string parentAdmin = parentId.empty() ? "bench_admin" : "admin_" + parentId;
+            network.addEntityToDomain(parentId, std::make_shared<Domain>(domainId, "admin_" + domainId), parentAdmin);
+            parentId = domainId;
+        }
+
+        for (size_t i = 0; i < entityCount; ++i) {
+            std::string domainId = "bench_domain_" + std::to_string(i % depth);
+            network.addEntityToDomain(domainId,
+                std::make_shared<Printer>("filler_" + std::to_string(i), MacAddress::fromUInt64(i).toString()),
+                "admin_" + domainId);
+        }
+        return parentId;
+    }
+
+}
+
+NETSPHERE_BENCHMARK(DeepDomainInsertCost) {
+    constexpr size_t DEPTH = 32;
+    constexpr size_t MEASURED_INSERTS = 20000;
+
+    std::cout << std::setw(12) << "entities" << std::setw(16) << "ns/insert" << std::endl;
+    for (size_t size : { 1000u, 10000u, 100000u, 500000u }) {
+        CorporateNetwork network("bench_admin");
+        const std::string deepest = buildNetwork(network, size, DEPTH);
+        const std::string admin = "admin_" + deepest;
+
+        // Идентификаторы интернируются заранее, чтобы измерять только вставку
+        std::vector<std::shared_ptr<NetworkEntity>> printers;
+        printers.reserve(MEASURED_INSERTS);
+        for (size_t i = 0; i < MEASURED_INSERTS; ++i) {
+            printers.push_back(std::make_shared<Printer>("measured_" + std::to_string(i),
+                MacAddress::fromUInt64(size + i).toString()));
+        }
+
+        Stopwatch timer;
+        for (const auto& printer : printers) {
+            network.addEntityToDomain(deepest, printer, admin);
+        }
+        const double seconds = timer.elapsedSeconds();
+
+        std::cout << std::setw(12) << size
+            << std::setw(16) << std::fixed << std::setprecision(1) << seconds * 1e9 / MEASURED_INSERTS
+            << std::endl;
+    }
+}
@@ -0,0 +1,59 @@
+﻿/**
+ * @file DataStorageBenchmarks.cpp
+ * @brief Бенчмарки одновременного учёта объёма в одном хранилище.
+ */
+
+#include "Benchmark.h"
+#include "DataStorage.h"
+#include "NetworkExceptions.h"
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+NETSPHERE_BENCHMARK(StorageAccountingContention) {
+    constexpr size_t OPERATIONS_PER_THREAD = 1000000;
+    constexpr uint64_t CHUNK_BYTES = 4096;
+
+    std::cout << "Операций на поток: " << OPERATIONS_PER_THREAD << " (резерв + освобождение)" << std::endl;
+    const unsigned hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threadCount : { 1u, 2u, 4u, 8u, 16u }) {
+        if (threadCount > 2 * hardwareThreads) {
+            break;
+        }
+        // Объём подобран так, чтобы часть резервов упиралась в границу и получала отказ
+        DataStorage storage("contention_storage", "00:1A:2B:3C:AD:01",
+            static_cast<double>(threadCount * CHUNK_BYTES * 3 / 2) / DataStorage::BYTES_PER_MB);
+        std::atomic<size_t> rejected{ 0 };
+
+        Stopwatch timer;
+        std::vector<std::thread> threads;
+        for (unsigned t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&] {
+                size_t ownRejected = 0;
+                for (size_t i = 0; i < OPERATIONS_PER_THREAD; ++i) {
+                    try {
+                        storage.reserveBytes(CHUNK_BYTES);
+                    }
+                    catch (const DeviceOperationException&) {
+                        ++ownRejected;
+                        continue;
+                    }
+                    storage.releaseBytes(CHUNK_BYTES);
+                }
+                rejected += ownRejected;
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        const double seconds = timer.elapsedSeconds();
+
+        const double operations = static_cast<double>(threadCount * OPERATIONS_PER_THREAD);
+        std::cout << std::setw(3) << threadCount << " потоков" << std::setw(14) << std::fixed << std::setprecision(0)
+            << operations / seconds << " операций/с, отказов " << rejected.load()
+            << ", занято в конце " << storage.getUsedBytes() << " байт" << std::endl;
+    }
+}
@@ -0,0 +1,120 @@
+﻿/**
+ * @file EntityIndexBenchmarks.cpp
+ * @brief Бенчмарки индекса сущностей: масштабирование поиска и вставок по числу потоков.
+ */
+
+#include "Benchmark.h"
+#include "CorporateNetwork.h"
+#include "EntityIndex.h"
+#include "MacAddress.h"
+#include "Printer.h"
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+NETSPHERE_BENCHMARK(ConcurrentReaderScaling) {
+    constexpr size_t ENTITY_COUNT = 100000;
+    constexpr size_t LOOKUPS_PER_THREAD = 1000000;
+
+    CorporateNetwork network("bench_admin");
+    std::vector<std::string> ids;
+    ids.reserve(ENTITY_COUNT);
+    for (size_t i = 0; i < ENTITY_COUNT; ++i) {
+        ids.push_back("reader_printer_" + std::to_string(i));
+        network.addEntityToDomain("", std::make_shared<Printer>(ids.back(), MacAddress::fromUInt64(i)), "bench_admin");
+    }
+
+    std::cout << std::setw(10) << "threads" << std::setw(18) << "lookups/s" << std::setw(14) << "writes" << std::endl;
+    for (unsigned threads : { 1u, 2u, 4u, 8u, 16u }) {
+        std::atomic<bool> done{ false };
+        std::atomic<size_t> writes{ 0 };
+
+        // Писатель непрерывно добавляет и удаляет сущность, пока читатели ищут
+        std::thread writer([&] {
+            auto churn = std::make_shared<Printer>("reader_churn", MacAddress::fromUInt64(ENTITY_COUNT));
+            while (!done.load(std::memory_order_relaxed)) {
+                network.addEntityToDomain("", churn, "bench_admin");
+                network.removeEntity("reader_churn", "bench_admin");
+                writes.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+
+        std::atomic<size_t> found{ 0 };
+        Stopwatch timer;
+        std::vector<std::thread> readers;
+        for (unsigned t = 0; t < threads; ++t) {
+            readers.emplace_back([&, t] {
+                size_t local = 0;
+                size_t position = t * 7919;
+                for (size_t i = 0; i < LOOKUPS_PER_THREAD; ++i) {
+                    position = (position + 104729) % ENTITY_COUNT;
+                    local += network.withEntity(ids[position], [](const NetworkEntity&) {});
+                }
+                found.fetch_add(local);
+            });
+        }
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        const double seconds = timer.elapsedSeconds();
+        done.store(true);
+        writer.join();
+
+        std::cout << std::setw(10) << threads
+            << std::setw(18) << std::fixed << std::setprecision(0) << threads * LOOKUPS_PER_THREAD / seconds
+            << std::setw(14) << writes.load() << std::endl;
+        if (found.load() != threads * LOOKUPS_PER_THREAD) {
+            std::cout << "Ошибка: найдены не все сущности" << std::endl;
+        }
+    }
+}
+
+NETSPHERE_BENCHMARK(ShardedIndexScaling) {
+    constexpr size_t OPERATIONS_PER_THREAD = 50000;
+    constexpr size_t FINDS_PER_INSERT = 4;
+
+    // Сущности создаются заранее, чтобы измерять только операции индекса
+    const size_t maxThreads = 64;
+    std::vector<std::shared_ptr<NetworkEntity>> entities;
+    entities.reserve(maxThreads * OPERATIONS_PER_THREAD);
+    for (size_t i = 0; i < maxThreads * OPERATIONS_PER_THREAD; ++i) {
+        entities.push_back(std::make_shared<Printer>("sharded_" + std::to_string(i), MacAddress::fromUInt64(i)));
+    }
+
+    std::cout << std::setw(10) << "threads" << std::setw(18) << "inserts/s" << std::setw(18) << "finds/s" << std::endl;
+    for (size_t threads : { 1u, 2u, 4u, 8u, 16u, 32u, 64u }) {
+        EntityIndex index;
+        std::atomic<size_t> found{ 0 };
+
+        Stopwatch timer;
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                size_t local = 0;
+                const size_t base = t * OPERATIONS_PER_THREAD;
+                for (size_t i = 0; i < OPERATIONS_PER_THREAD; ++i) {
+                    index.insert(entities[base + i], nullptr);
+                    EpochGuard guard;
+                    for (size_t f = 0; f < FINDS_PER_INSERT; ++f) {
+                        local += index.find(entities[base + (i * 7 + f) % (i + 1)]->getId()) != nullptr;
+                    }
+                }
+                found.fetch_add(local);
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        const double seconds = timer.elapsedSeconds();
+
+        const double inserts = static_cast<double>(threads * OPERATIONS_PER_THREAD);
+        std::cout << std::setw(10) << threads
+            << std::setw(18) << std::fixed << std::setprecision(0) << inserts / seconds
+            << std::setw(18) << inserts * FINDS_PER_INSERT / seconds << std::endl;
+        if (found.load() != threads * OPERATIONS_PER_THREAD * FINDS_PER_INSERT || index.size() != inserts) {
+            std::cout << "Ошибка: индекс потерял записи" << std::endl;
+        }
+    }
+    EpochManager::instance().collect();
+}
@@ -0,0 +1,71 @@
+﻿/**
+ * @file InventoryLoaderBenchmarks.cpp
+ * @brief Бенчмарки загрузчика инвентаря InventoryLoader.
+ */
+
+#include "Benchmark.h"
+#include "InventoryLoader.h"
+#include "MacAddress.h"
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+    /**
+     * @brief Формирует CSV-инвентарь: домены и равное число хранилищ, рабочих станций и принтеров.
+     * @param rowCount Число строк сущностей-устройств.
+     * @param domainCount Число доменов.
+     * @return Текст CSV с заголовком.
+     */
+    std::string makeInventory(size_t rowCount, size_t domainCount) {
+        std::ostringstream csv;
+        csv << "type,id,parent,admin,mac,total_mb,used_mb,trusted_users,user,power_on\n";
+        for (size_t d = 0; d < domainCount; ++d) {
+            csv << "Domain,inv_domain_" << d << ",,inv_admin_" << d << ",,,,,,\n";
+        }
+        for (size_t i = 0; i < rowCount; ++i) {
+            const std::string mac = MacAddress::fromUInt64(i).toString();
+            const size_t domain = i % domainCount;
+            switch (i % 3) {
+            case 0:
+                csv << "DataStorage,inv_storage_" << i << ",inv_domain_" << domain << ",," << mac
+                    << ",1000,100,\"user_" << i % 97 << ";guest_" << i % 89 << "\",,\n";
+                break;
+            case 1:
+                csv << "Workstation,inv_ws_" << i << ",inv_domain_" << domain << ",," << mac
+                    << ",,,,user_" << i % 97 << ",1700000000\n";
+                break;
+            default:
+                csv << "Printer,inv_printer_" << i << ",inv_domain_" << domain << ",," << mac << ",,,,,\n";
+                break;
+            }
+        }
+        return csv.str();
+    }
+
+}
+
+NETSPHERE_BENCHMARK(InventoryLoadThroughput) {
+    constexpr size_t ROWS = 200000;
+    constexpr size_t DOMAINS = 64;
+    const std::string inventory = makeInventory(ROWS, DOMAINS);
+
+    std::cout << std::setw(10) << "threads" << std::setw(16) << "rows/s" << std::setw(12) << "errors" << std::endl;
+    for (unsigned threads : { 1u, 2u, 4u, 8u }) {
+        CorporateNetwork network("bench_admin");
+        std::istringstream input(inventory);
+
+        InventoryLoadOptions options;
+        options.threadCount = threads;
+
+        Stopwatch timer;
+        InventoryLoadReport report = InventoryLoader(network, options).load(input);
+        const double seconds = timer.elapsedSeconds();
+        doNotOptimize(report);
+
+        std::cout << std::setw(10) << threads
+            << std::setw(16) << std::fixed << std::setprecision(0) << report.linesRead / seconds
+            << std::setw(12) << report.errorCount << std::endl;
+    }
+}
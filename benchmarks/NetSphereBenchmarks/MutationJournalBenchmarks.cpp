@@ -0,0 +1,65 @@
+﻿/**
+ * @file MutationJournalBenchmarks.cpp
+ * @brief Бенчмарки журнала изменений: пропускная способность по режимам долговечности.
+ */
+
+#include "Benchmark.h"
+#include "MutationJournal.h"
+#include "Workstation.h"
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+NETSPHERE_BENCHMARK(JournalGroupCommit) {
+    constexpr int UPDATES_PER_THREAD = 2000;
+    const std::string path = (std::filesystem::temp_directory_path() / "netsphere_bench.journal").string();
+
+    struct Mode {
+        const char* name;
+        JournalDurability durability;
+    };
+    const Mode modes[] = {
+        { "Buffered", JournalDurability::Buffered },
+        { "Periodic", JournalDurability::Periodic },
+        { "Sync", JournalDurability::Sync }
+    };
+
+    std::cout << std::setw(10) << "mode" << std::setw(10) << "threads" << std::setw(16) << "records/s" << std::endl;
+    for (const Mode& mode : modes) {
+        for (int threads : { 1, 4, 16 }) {
+            std::filesystem::remove(path);
+            CorporateNetwork network("bench_admin");
+            std::vector<std::shared_ptr<Workstation>> workstations;
+            for (int i = 0; i < threads; ++i) {
+                workstations.push_back(std::make_shared<Workstation>("journal_ws_" + std::to_string(i),
+                    MacAddress::fromUInt64(i), "user", 0));
+                network.addEntityToDomain("", workstations.back(), "bench_admin");
+            }
+
+            MutationJournal journal(path, { mode.durability });
+            network.addObserver(&journal);
+
+            Stopwatch timer;
+            std::vector<std::thread> writers;
+            for (int i = 0; i < threads; ++i) {
+                writers.emplace_back([&, i] {
+                    for (int update = 0; update < UPDATES_PER_THREAD; ++update) {
+                        workstations[i]->updatePowerOnTime(update);
+                    }
+                });
+            }
+            for (auto& writer : writers) {
+                writer.join();
+            }
+            journal.flush();
+            const double seconds = timer.elapsedSeconds();
+            network.removeObserver(&journal);
+
+            std::cout << std::setw(10) << mode.name << std::setw(10) << threads
+                << std::setw(16) << std::fixed << std::setprecision(0) << threads * UPDATES_PER_THREAD / seconds
+                << std::endl;
+        }
+    }
+    std::filesystem::remove(path);
+}
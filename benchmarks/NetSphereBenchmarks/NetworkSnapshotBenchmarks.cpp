@@ -0,0 +1,60 @@
+﻿/**
+ * @file NetworkSnapshotBenchmarks.cpp
+ * @brief Бенчмарки записи и загрузки двоичного снимка сети.
+ */
+
+#include "Benchmark.h"
+#include "NetworkSnapshot.h"
+#include "Printer.h"
+#include "Workstation.h"
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+
+NETSPHERE_BENCHMARK(SnapshotStartup) {
+    constexpr size_t ENTITIES = 1000000;
+    constexpr size_t DOMAINS = 1000;
+
+    CorporateNetwork network("bench_admin");
+    std::vector<std::shared_ptr<NetworkEntity>> batch;
+    for (size_t d = 0; d < DOMAINS; ++d) {
+        const std::string domainId = "snap_domain_" + std::to_string(d);
+        network.addEntityToDomain("", std::make_shared<Domain>(domainId, "snap_admin"), "bench_admin");
+
+        batch.clear();
+        for (size_t i = d; i < ENTITIES; i += DOMAINS) {
+            const MacAddress mac = MacAddress::fromUInt64(i);
+            if (i % 2 == 0) {
+                batch.push_back(std::make_shared<Printer>("snap_printer_" + std::to_string(i), mac));
+            }
+            else {
+                batch.push_back(std::make_shared<Workstation>("snap_ws_" + std::to_string(i), mac, "user", 0));
+            }
+        }
+        network.addEntitiesToDomain(domainId, batch, "snap_admin");
+    }
+    batch.clear();
+
+    const std::string path = (std::filesystem::temp_directory_path() / "netsphere_bench.snap").string();
+    auto report = [](const char* stage, double seconds) {
+        std::cout << std::setw(24) << std::left << stage << std::right
+            << std::setw(12) << std::fixed << std::setprecision(1) << seconds * 1e3 << " ms" << std::endl;
+    };
+
+    Stopwatch writeTimer;
+    NetworkSnapshot::write(network, path);
+    report("write", writeTimer.elapsedSeconds());
+
+    Stopwatch openTimer;
+    NetworkSnapshot snapshot(path);
+    auto found = snapshot.findIndex("snap_ws_777777");
+    report("open + first lookup", openTimer.elapsedSeconds());
+    doNotOptimize(found);
+
+    Stopwatch restoreTimer;
+    CorporateNetwork restored = snapshot.restore();
+    report("restore", restoreTimer.elapsedSeconds());
+    doNotOptimize(restored);
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,155 @@
+﻿/**
+ * @file PowerOnIngestorBenchmarks.cpp
+ * @brief Бенчмарки приёма телеметрии включения рабочих станций.
+ */
+
+#include "Benchmark.h"
+#include "CorporateNetwork.h"
+#include "PowerOnIngestor.h"
+#include "Workstation.h"
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+NETSPHERE_BENCHMARK(PowerOnTelemetryIngest) {
+    constexpr size_t WORKSTATION_COUNT = 100000;
+    constexpr size_t EVENT_COUNT = 2000000;
+    constexpr size_t BATCH_SIZE = 4096;
+    constexpr size_t THREAD_COUNT = 4;
+
+    CorporateNetwork network("bench_admin");
+    std::vector<std::shared_ptr<NetworkEntity>> workstations;
+    workstations.reserve(WORKSTATION_COUNT);
+    for (size_t i = 0; i < WORKSTATION_COUNT; ++i) {
+        workstations.push_back(std::make_shared<Workstation>("telemetry_ws_" + std::to_string(i),
+            MacAddress::fromUInt64(i + 1), "telemetry_user", 0));
+    }
+    network.addEntitiesToDomain("", workstations, "bench_admin");
+
+    // Агенты часто повторяют событие: половина событий приходится на 5% станций; 1% - неизвестные id
+    std::vector<std::string> ids;
+    ids.reserve(EVENT_COUNT);
+    std::mt19937_64 random(42);
+    for (size_t i = 0; i < EVENT_COUNT; ++i) {
+        const uint64_t roll = random();
+        if (roll % 100 == 0) {
+            ids.push_back("telemetry_unknown_" + std::to_string(roll % 1000));
+        }
+        else {
+            const size_t hot = (roll >> 8) % 2 == 0 ? WORKSTATION_COUNT / 20 : WORKSTATION_COUNT;
+            ids.push_back("telemetry_ws_" + std::to_string((roll >> 16) % hot));
+        }
+    }
+    time_t clock = 1000;
+    auto makeEvents = [&](size_t begin, size_t end) {
+        std::vector<PowerOnEvent> events;
+        events.reserve(end - begin);
+        for (size_t i = begin; i < end; ++i) {
+            events.push_back({ ids[i], clock + static_cast<time_t>(i) });
+        }
+        return events;
+    };
+
+    // Сводка по пакетам и окнам
+    struct Totals {
+        size_t unknown = 0;
+        size_t coalesced = 0;
+        size_t applied = 0;
+        size_t stale = 0;
+
+        void add(const PowerOnWindowStats& window) {
+            applied += window.applied;
+            stale += window.stale;
+        }
+        void add(const PowerOnSubmitResult& result) {
+            unknown += result.batch.unknown;
+            coalesced += result.batch.coalesced;
+            if (result.closedWindow) {
+                add(*result.closedWindow);
+            }
+        }
+        void add(const Totals& other) {
+            unknown += other.unknown;
+            coalesced += other.coalesced;
+            applied += other.applied;
+            stale += other.stale;
+        }
+    };
+
+    auto report = [](const char* name, double seconds, const Totals& totals) {
+        std::cout << std::setw(28) << name << std::setw(14) << std::fixed << std::setprecision(0)
+            << EVENT_COUNT / seconds << " событий/с"
+            << "  (применено " << totals.applied << ", слито " << totals.coalesced
+            << ", неизвестно " << totals.unknown << ")" << std::endl;
+    };
+
+    std::cout << "Станций: " << WORKSTATION_COUNT << ", событий: " << EVENT_COUNT
+        << ", пакет: " << BATCH_SIZE << std::endl;
+
+    // Прежний способ: поиск и обновление на каждое событие
+    {
+        const auto events = makeEvents(0, EVENT_COUNT);
+        Totals totals;
+        Stopwatch timer;
+        for (const PowerOnEvent& event : events) {
+            auto workstation = entityCast<Workstation>(network.findEntity(std::string(event.workstationId)));
+            if (!workstation) {
+                ++totals.unknown;
+                continue;
+            }
+            workstation->updatePowerOnTime(event.powerOnTime);
+            ++totals.applied;
+        }
+        report("findEntity per event", timer.elapsedSeconds(), totals);
+    }
+
+    for (const auto window : { std::chrono::milliseconds(0), PowerOnIngestor::DEFAULT_WINDOW }) {
+        clock += static_cast<time_t>(EVENT_COUNT);
+        const auto events = makeEvents(0, EVENT_COUNT);
+        PowerOnIngestor ingestor(network, window);
+        Totals totals;
+        Stopwatch timer;
+        for (size_t begin = 0; begin < events.size(); begin += BATCH_SIZE) {
+            const size_t count = std::min(BATCH_SIZE, events.size() - begin);
+            totals.add(ingestor.submit(std::span(events).subspan(begin, count)));
+        }
+        totals.add(ingestor.flush());
+        report(window.count() == 0 ? "ingestor, window 0" : "ingestor, window 100ms", timer.elapsedSeconds(), totals);
+    }
+
+    // Несколько потоков приёма, каждый со своим приёмником и своей частью станций
+    {
+        clock += static_cast<time_t>(EVENT_COUNT);
+        std::vector<std::vector<PowerOnEvent>> partitions(THREAD_COUNT);
+        const auto events = makeEvents(0, EVENT_COUNT);
+        for (const PowerOnEvent& event : events) {
+            partitions[std::hash<std::string_view>()(event.workstationId) % THREAD_COUNT].push_back(event);
+        }
+        std::vector<Totals> threadTotals(THREAD_COUNT);
+        Stopwatch timer;
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < THREAD_COUNT; ++t) {
+            threads.emplace_back([&, t] {
+                PowerOnIngestor ingestor(network);
+                const auto& partition = partitions[t];
+                for (size_t begin = 0; begin < partition.size(); begin += BATCH_SIZE) {
+                    const size_t count = std::min(BATCH_SIZE, partition.size() - begin);
+                    threadTotals[t].add(ingestor.submit(std::span(partition).subspan(begin, count)));
+                }
+                threadTotals[t].add(ingestor.flush());
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        const double seconds = timer.elapsedSeconds();
+        Totals totals;
+        for (const auto& stats : threadTotals) {
+            totals.add(stats);
+        }
+        report("ingestor, 4 threads", seconds, totals);
+    }
+}
@@ -15,11 +15,14 @@ ctypes-обертка для взаимодействия с DLL, реализу
 
 import ctypes
 import os
+import struct
 from ctypes import c_void_p, c_char_p, c_int, c_double, c_longlong, POINTER, Structure, byref, c_char, cast, addressof
 from enum import IntEnum
 from datetime import datetime
-from typing import Optional, List, Dict, Any
+from typing import Optional, List, Dict, Any, Tuple
 
+# Дескрипторы сети, устройств и курсоров: 64-битные значения на всех платформах (0 - ошибка)
+NetSphereHandle = ctypes.c_uint64
 
 class DeviceType(IntEnum):
     """Перечисление типов устройств, используемое в ctypes-API."""
@@ -40,6 +43,224 @@ class DeviceInfo(Structure):
     ]
 
 
+class StorageInfoData(Structure):
+    """Содержимое `DeviceInfo.data` для хранилища данных."""
+    _fields_ = [
+        ("total_mb", c_double),
+        ("used_mb", c_double),
+        ("trusted_user_count", ctypes.c_uint32)
+    ]
+
+
+class WorkstationInfoData(Structure):
+    """Содержимое `DeviceInfo.data` для рабочей станции."""
+    _fields_ = [
+        ("power_on_time", ctypes.c_int64),
+        ("user_id", ctypes.c_char * 248)
+    ]
+
+
+class DomainInfoData(Structure):
+    """Содержимое `DeviceInfo.data` для домена."""
+    _fields_ = [
+        ("child_count", ctypes.c_uint32),
+        ("admin_id", ctypes.c_char * 252)
+    ]
+
+
+class CursorRecord(Structure):
+    """Компактная запись страницы курсора перечисления (`cursor_next`)."""
+    _fields_ = [
+        ("id", ctypes.c_char * 64),
+        ("parent_id", ctypes.c_char * 64),
+        ("type", c_int),
+        ("depth", ctypes.c_uint32),
+        ("child_count", ctypes.c_uint32)
+    ]
+
+
+class CursorOrder(IntEnum):
+    """Порядок перечисления курсора."""
+    CHILDREN = 0
+    DEPTH_FIRST = 1
+    BREADTH_FIRST = 2
+
+
+CURSOR_MODIFIED = -2
+
+
+class ChangeRecord(Structure):
+    """Событие ленты изменений сети (`network_fetch_changes`)."""
+    _fields_ = [
+        ("sequence", ctypes.c_uint64),
+        ("type", c_int),
+        ("entity_type", c_int),
+        ("id", ctypes.c_char * 64),
+        ("related_id", ctypes.c_char * 64),
+        ("used_mb", c_double),
+        ("power_on_time", ctypes.c_int64)
+    ]
+
+
+class UserWorkstationRecord(Structure):
+    """Рабочая станция, найденная по пользователю (`network_find_user_workstations`)."""
+    _fields_ = [
+        ("user_index", ctypes.c_uint32),
+        ("workstation_id", ctypes.c_char * 64),
+        ("power_on_time", ctypes.c_int64)
+    ]
+
+
+class PowerOnRecord(Structure):
+    """Рабочая станция из диапазона времени включения (`network_find_workstations_by_power_on`)."""
+    _fields_ = [
+        ("workstation_id", ctypes.c_char * 64),
+        ("power_on_time", ctypes.c_int64)
+    ]
+
+
+class PowerOnIngestResult(Structure):
+    """Статистика пакета телеметрии включения (`network_ingest_power_on`)."""
+    _fields_ = [
+        ("received", ctypes.c_uint64),
+        ("unknown", ctypes.c_uint64),
+        ("coalesced", ctypes.c_uint64),
+        ("applied", ctypes.c_uint64),
+        ("stale", ctypes.c_uint64)
+    ]
+
+
+class ChangeType(IntEnum):
+    """Вид события ленты изменений."""
+    ENTITY_ADDED = 1
+    ENTITY_REMOVED = 2
+    ENTITY_UPDATED = 3
+    STORAGE_USAGE = 4
+    POWER_ON = 5
+
+
+CHANGES_RESYNC = -2
+
+
+def device_info_to_dict(info: DeviceInfo) -> Dict[str, Any]:
+    """Преобразует заполненную DLL структуру `DeviceInfo` в словарь.
+
+    Помимо `id`, `mac` и `type` добавляет поля, зависящие от типа:
+    `total_mb`, `used_mb`, `trusted_user_count` для хранилища, `user_id`
+    и `power_on_time` для рабочей станции, `admin_id` и `child_count` для домена.
+    """
+    result = {
+        'id': info.id.decode('utf-8'),
+        'mac': info.mac.decode('utf-8'),
+        'type': DeviceType(info.type)
+    }
+    raw = bytes(info.data)
+    if result['type'] == DeviceType.DATA_STORAGE:
+        data = StorageInfoData.from_buffer_copy(raw[:ctypes.sizeof(StorageInfoData)])
+        result.update(total_mb=data.total_mb, used_mb=data.used_mb,
+                      trusted_user_count=data.trusted_user_count)
+    elif result['type'] == DeviceType.WORKSTATION:
+        data = WorkstationInfoData.from_buffer_copy(raw[:ctypes.sizeof(WorkstationInfoData)])
+        result.update(user_id=data.user_id.decode('utf-8'), power_on_time=data.power_on_time)
+    elif result['type'] == DeviceType.DOMAIN:
+        data = DomainInfoData.from_buffer_copy(raw[:ctypes.sizeof(DomainInfoData)])
+        result.update(admin_id=data.admin_id.decode('utf-8'), child_count=data.child_count)
+    return result
+
+
+class CommandStatus(IntEnum):
+    """Компактный код результата команды пакета (см. CommandBuffer.h)."""
+    OK = 0
+    ACCESS_DENIED = 1
+    VALIDATION = 2
+    DEVICE_OPERATION = 3
+    DOMAIN_OPERATION = 4
+    NOT_FOUND = 5
+    MALFORMED = 6
+    FAILED = 7
+
+
+class CommandBuffer:
+    """Построитель пакета команд для `network_execute_commands`.
+
+    Команды кодируются в тот же двоичный формат, что и `CommandBufferWriter`
+    в нативной части: байт кода команды, строки как uint16-длина и UTF-8,
+    объёмы как double, время как int64 (всё little-endian). Пакет выполняется
+    за одно пересечение границы ctypes методом `CorporateNetwork.execute_commands`.
+    """
+    ADD_STORAGE = 1
+    ADD_WORKSTATION = 2
+    ADD_PRINTER = 3
+    ADD_DOMAIN = 4
+    REMOVE = 5
+    STORAGE_DELTA = 6
+    TRUSTED_USER_ADD = 7
+    TRUSTED_USER_REMOVE = 8
+    POWER_ON = 9
+
+    def __init__(self):
+        self._parts: List[bytes] = []
+        self.count = 0
+
+    def _command(self, opcode: int, *strings: str) -> 'CommandBuffer':
+        self._parts.append(struct.pack('<B', opcode))
+        for value in strings:
+            encoded = value.encode('utf-8')
+            self._parts.append(struct.pack('<H', len(encoded)))
+            self._parts.append(encoded)
+        self.count += 1
+        return self
+
+    def add_storage(self, domain_id: str, user: str, device_id: str, mac: str, total_size: float) -> 'CommandBuffer':
+        """Добавляет создание хранилища данных в домене `domain_id`."""
+        self._command(self.ADD_STORAGE, domain_id, user, device_id, mac)
+        self._parts.append(struct.pack('<d', total_size))
+        return self
+
+    def add_workstation(self, domain_id: str, user: str, device_id: str, mac: str,
+                        user_id: str, power_on_time: int) -> 'CommandBuffer':
+        """Добавляет создание рабочей станции в домене `domain_id`."""
+        self._command(self.ADD_WORKSTATION, domain_id, user, device_id, mac, user_id)
+        self._parts.append(struct.pack('<q', power_on_time))
+        return self
+
+    def add_printer(self, domain_id: str, user: str, device_id: str, mac: str) -> 'CommandBuffer':
+        """Добавляет создание принтера в домене `domain_id`."""
+        return self._command(self.ADD_PRINTER, domain_id, user, device_id, mac)
+
+    def add_domain(self, parent_id: str, user: str, domain_id: str, admin_id: str) -> 'CommandBuffer':
+        """Добавляет создание поддомена в домене `parent_id`."""
+        return self._command(self.ADD_DOMAIN, parent_id, user, domain_id, admin_id)
+
+    def remove(self, entity_id: str, user: str) -> 'CommandBuffer':
+        """Добавляет удаление сущности по идентификатору."""
+        return self._command(self.REMOVE, entity_id, user)
+
+    def storage_delta(self, storage_id: str, delta: float) -> 'CommandBuffer':
+        """Добавляет изменение занятого объёма: положительное - запись, отрицательное - освобождение."""
+        self._command(self.STORAGE_DELTA, storage_id)
+        self._parts.append(struct.pack('<d', delta))
+        return self
+
+    def add_trusted_user(self, storage_id: str, user: str) -> 'CommandBuffer':
+        """Добавляет доверенного пользователя хранилища."""
+        return self._command(self.TRUSTED_USER_ADD, storage_id, user)
+
+    def remove_trusted_user(self, storage_id: str, user: str) -> 'CommandBuffer':
+        """Удаляет доверенного пользователя хранилища."""
+        return self._command(self.TRUSTED_USER_REMOVE, storage_id, user)
+
+    def power_on(self, workstation_id: str, power_on_time: int) -> 'CommandBuffer':
+        """Добавляет обновление времени включения рабочей станции."""
+        self._command(self.POWER_ON, workstation_id)
+        self._parts.append(struct.pack('<q', power_on_time))
+        return self
+
+    def to_bytes(self) -> bytes:
+        """Возвращает закодированный пакет."""
+        return b''.join(self._parts)
+
+
 def load_dll(dll_path: str = None):
     """Загружает нативную DLL и настраивает `argtypes/restype` для C API.
 
@@ -82,44 +303,91 @@ def load_dll(dll_path: str = None):
         raise CorporateNetworkError(f"Не удалось загрузить DLL {dll_path}: {str(e)}")
 
     dll.network_create.argtypes = [c_char_p]
-    dll.network_create.restype = c_void_p
+    dll.network_create.restype = NetSphereHandle
 
-    dll.network_destroy.argtypes = [c_void_p]
+    dll.network_destroy.argtypes = [NetSphereHandle]
     dll.network_destroy.restype = None
 
     dll.device_create_domain.argtypes = [c_char_p, c_char_p]
-    dll.device_create_domain.restype = c_void_p
+    dll.device_create_domain.restype = NetSphereHandle
 
     dll.device_create_storage.argtypes = [c_char_p, c_char_p, c_double]
-    dll.device_create_storage.restype = c_void_p
+    dll.device_create_storage.restype = NetSphereHandle
 
     dll.device_create_workstation.argtypes = [c_char_p, c_char_p, c_char_p, c_longlong]
-    dll.device_create_workstation.restype = c_void_p
+    dll.device_create_workstation.restype = NetSphereHandle
 
     dll.device_create_printer.argtypes = [c_char_p, c_char_p]
-    dll.device_create_printer.restype = c_void_p
+    dll.device_create_printer.restype = NetSphereHandle
 
-    dll.device_destroy.argtypes = [c_void_p]
+    dll.device_destroy.argtypes = [NetSphereHandle]
     dll.device_destroy.restype = None
 
-    dll.network_add_device.argtypes = [c_void_p, c_char_p, c_void_p, c_char_p]
+    dll.network_add_device.argtypes = [NetSphereHandle, c_char_p, NetSphereHandle, c_char_p]
     dll.network_add_device.restype = c_int
 
-    dll.storage_add_trusted_user.argtypes = [c_void_p, c_char_p]
+    dll.storage_add_trusted_user.argtypes = [NetSphereHandle, c_char_p]
     dll.storage_add_trusted_user.restype = c_int
 
-    dll.storage_add_data.argtypes = [c_void_p, c_double]
+    dll.storage_add_data.argtypes = [NetSphereHandle, c_double]
     dll.storage_add_data.restype = c_int
 
-    dll.storage_free_data.argtypes = [c_void_p, c_double]
+    dll.storage_free_data.argtypes = [NetSphereHandle, c_double]
     dll.storage_free_data.restype = c_int
 
-    dll.network_remove_device.argtypes = [c_void_p, c_char_p, c_char_p]
+    dll.network_remove_device.argtypes = [NetSphereHandle, c_char_p, c_char_p]
     dll.network_remove_device.restype = c_int
 
-    dll.device_get_info.argtypes = [c_void_p, POINTER(DeviceInfo)]
+    dll.device_get_info.argtypes = [NetSphereHandle, POINTER(DeviceInfo)]
     dll.device_get_info.restype = c_int
 
+    dll.network_get_device_info.argtypes = [NetSphereHandle, c_char_p, POINTER(DeviceInfo)]
+    dll.network_get_device_info.restype = c_int
+
+    dll.network_get_device_info_bulk.argtypes = [NetSphereHandle, POINTER(c_char_p), ctypes.c_size_t, POINTER(DeviceInfo)]
+    dll.network_get_device_info_bulk.restype = c_int
+
+    dll.network_find_user_workstations.argtypes = [NetSphereHandle, POINTER(c_char_p), ctypes.c_size_t, c_char_p,
+                                                   POINTER(UserWorkstationRecord), ctypes.c_size_t]
+    dll.network_find_user_workstations.restype = c_int
+
+    dll.network_find_workstations_by_power_on.argtypes = [NetSphereHandle, ctypes.c_int64, ctypes.c_int64, c_char_p,
+                                                          POINTER(PowerOnRecord), ctypes.c_size_t]
+    dll.network_find_workstations_by_power_on.restype = c_int
+
+    dll.network_ingest_power_on.argtypes = [NetSphereHandle, POINTER(c_char_p), POINTER(ctypes.c_int64), ctypes.c_size_t,
+                                            POINTER(PowerOnIngestResult)]
+    dll.network_ingest_power_on.restype = c_int
+
+    dll.network_reserve_capacity.argtypes = [NetSphereHandle, POINTER(NetSphereHandle), POINTER(c_double), ctypes.c_size_t,
+                                             ctypes.c_int64]
+    dll.network_reserve_capacity.restype = ctypes.c_uint64
+
+    dll.network_commit_reservation.argtypes = [NetSphereHandle, ctypes.c_uint64]
+    dll.network_commit_reservation.restype = c_int
+
+    dll.network_release_reservation.argtypes = [NetSphereHandle, ctypes.c_uint64]
+    dll.network_release_reservation.restype = c_int
+
+    dll.cursor_open.argtypes = [NetSphereHandle, c_char_p, c_int]
+    dll.cursor_open.restype = NetSphereHandle
+
+    dll.cursor_next.argtypes = [NetSphereHandle, POINTER(CursorRecord), ctypes.c_size_t]
+    dll.cursor_next.restype = c_int
+
+    dll.cursor_close.argtypes = [NetSphereHandle]
+    dll.cursor_close.restype = None
+
+    dll.network_enable_change_feed.argtypes = [NetSphereHandle, ctypes.c_size_t]
+    dll.network_enable_change_feed.restype = c_int
+
+    dll.network_fetch_changes.argtypes = [NetSphereHandle, ctypes.c_uint64, POINTER(ChangeRecord), ctypes.c_size_t,
+                                          POINTER(ctypes.c_uint64)]
+    dll.network_fetch_changes.restype = c_int
+
+    dll.network_execute_commands.argtypes = [NetSphereHandle, c_char_p, ctypes.c_size_t, POINTER(c_int), ctypes.c_size_t]
+    dll.network_execute_commands.restype = c_int
+
     dll.get_last_error.argtypes = []
     dll.get_last_error.restype = POINTER(c_char)
 
@@ -242,14 +510,14 @@ def decode_error_string(error_ptr):
 class NetworkEntity:
     """Обертка над нативным handle конкретной сущности сети (устройство или домен).
 
-    Внутри хранится `handle` (opaque pointer) и ссылка на загруженную DLL.
+    Внутри хранится `handle` (непрозрачный 64-битный дескриптор) и ссылка на загруженную DLL.
     Для операций используется передача handle обратно в функции DLL.
     """
-    def __init__(self, handle: c_void_p, dll):
+    def __init__(self, handle: NetSphereHandle, dll):
         """Создает Python-обертку над нативной сущностью.
 
         Args:
-            handle: opaque handle (указатель), возвращенный DLL.
+            handle: непрозрачный 64-битный дескриптор, возвращенный DLL.
             dll: объект `ctypes.CDLL`, из которого выполняются вызовы.
         """
         self.handle = handle
@@ -333,6 +601,7 @@ class NetworkEntity:
               - `id`: str
               - `mac`: str (может быть пустой)
               - `type`: DeviceType
+              - поля, зависящие от типа (см. `device_info_to_dict`)
 
             Если DLL не вернула информацию, возвращает пустой словарь `{}`.
 
@@ -342,23 +611,7 @@ class NetworkEntity:
         info = DeviceInfo()
 
         if self.dll.device_get_info(self.handle, byref(info)):
-            id_str = info.id.decode('utf-8').rstrip('\x00')
-            mac_str = info.mac.decode('utf-8').rstrip('\x00') if info.mac else ''
-            
-            result = {
-                'id': id_str,
-                'mac': mac_str,
-                'type': DeviceType(info.type)
-            }
-
-            if result['type'] == DeviceType.DATA_STORAGE:
-                pass
-            elif result['type'] == DeviceType.WORKSTATION:
-                pass
-            elif result['type'] == DeviceType.DOMAIN:
-                pass
-
-            return result
+            return device_info_to_dict(info)
 
         error = self.dll.get_last_error()
         if error:
@@ -551,6 +804,275 @@ class CorporateNetwork:
 
         return True
 
+    def get_device_info(self, device_id: str) -> Dict[str, Any]:
+        """Возвращает сведения о сущности сети по идентификатору.
+
+        Raises:
+            CorporateNetworkError: если сущность не найдена или дескриптор сети недействителен.
+        """
+        info = DeviceInfo()
+        if not self.dll.network_get_device_info(self.handle, device_id.encode('utf-8'), byref(info)):
+            raise CorporateNetworkError(self.get_last_error() or f"Сущность '{device_id}' не найдена")
+        return device_info_to_dict(info)
+
+    def get_device_info_bulk(self, device_ids: List[str]) -> List[Optional[Dict[str, Any]]]:
+        """Возвращает сведения о многих сущностях за один вызов DLL.
+
+        Returns:
+            Список той же длины, что и `device_ids`; для ненайденных сущностей - None.
+
+        Raises:
+            CorporateNetworkError: если дескриптор сети недействителен.
+        """
+        count = len(device_ids)
+        ids = (c_char_p * max(count, 1))(*[device_id.encode('utf-8') for device_id in device_ids])
+        infos = (DeviceInfo * max(count, 1))()
+        if self.dll.network_get_device_info_bulk(self.handle, ids, count, infos) < 0:
+            raise CorporateNetworkError(self.get_last_error() or "Недействительный дескриптор сети")
+        return [device_info_to_dict(infos[i]) if infos[i].id else None for i in range(count)]
+
+    def find_user_workstations(self, users: List[str], domain_id: str = '') -> Dict[str, List[str]]:
+        """Находит рабочие станции сразу для многих пользователей за один вызов DLL.
+
+        Args:
+            users: Идентификаторы пользователей.
+            domain_id: Домен, в поддереве которого ведётся поиск (пустая строка - вся сеть).
+
+        Returns:
+            Словарь пользователь -> список идентификаторов его станций
+            (для пользователей без станций - пустой список).
+
+        Raises:
+            CorporateNetworkError: если домен не найден или дескриптор недействителен.
+        """
+        count = len(users)
+        ids = (c_char_p * max(count, 1))(*[user.encode('utf-8') for user in users])
+        result: Dict[str, List[str]] = {user: [] for user in users}
+        capacity = max(count, 16)
+        while True:
+            records = (UserWorkstationRecord * capacity)()
+            total = self.dll.network_find_user_workstations(self.handle, ids, count,
+                                                            domain_id.encode('utf-8'), records, capacity)
+            if total < 0:
+                raise CorporateNetworkError(self.get_last_error())
+            if total <= capacity:
+                break
+            capacity = total
+        for i in range(total):
+            record = records[i]
+            result[users[record.user_index]].append(record.workstation_id.decode('utf-8'))
+        return result
+
+    def find_workstations_by_power_on(self, from_time: int, to_time: int,
+                                      domain_id: str = '') -> List[Tuple[str, int]]:
+        """Находит рабочие станции, последнее включение которых попадает в [from_time, to_time).
+
+        Args:
+            from_time: Нижняя граница времени включения (Unix-время, включительно).
+            to_time: Верхняя граница времени включения (не включительно).
+            domain_id: Домен, в поддереве которого ведётся поиск (пустая строка - вся сеть).
+
+        Returns:
+            Список пар `(workstation_id, power_on_time)` по возрастанию времени включения.
+
+        Raises:
+            CorporateNetworkError: если домен не найден или дескриптор недействителен.
+        """
+        capacity = 64
+        while True:
+            records = (PowerOnRecord * capacity)()
+            total = self.dll.network_find_workstations_by_power_on(self.handle, from_time, to_time,
+                                                                   domain_id.encode('utf-8'), records, capacity)
+            if total < 0:
+                raise CorporateNetworkError(self.get_last_error())
+            if total <= capacity:
+                break
+            capacity = total
+        return [(records[i].workstation_id.decode('utf-8'), records[i].power_on_time) for i in range(total)]
+
+    def find_stale_workstations(self, older_than: int, domain_id: str = '') -> List[Tuple[str, int]]:
+        """Находит рабочие станции, не включавшиеся с момента `older_than` (самые давние - первыми).
+
+        Raises:
+            CorporateNetworkError: если домен не найден или дескриптор недействителен.
+        """
+        return self.find_workstations_by_power_on(-2 ** 63, older_than, domain_id)
+
+    def ingest_power_on(self, events: List[Tuple[str, int]]) -> Dict[str, int]:
+        """Применяет пакет событий включения рабочих станций за один вызов DLL.
+
+        Повторные события одной станции объединяются (берётся наибольшее время),
+        время, не новее текущего, отбрасывается.
+
+        Args:
+            events: Пары `(workstation_id, power_on_time)`.
+
+        Returns:
+            Статистика пакета: `received`, `unknown`, `coalesced`, `applied`, `stale`.
+
+        Raises:
+            CorporateNetworkError: если дескриптор сети недействителен.
+        """
+        count = len(events)
+        ids = (c_char_p * max(count, 1))(*[workstation_id.encode('utf-8') for workstation_id, _ in events])
+        times = (ctypes.c_int64 * max(count, 1))(*[power_on_time for _, power_on_time in events])
+        result = PowerOnIngestResult()
+        if not self.dll.network_ingest_power_on(self.handle, ids, times, count, byref(result)):
+            raise CorporateNetworkError(self.get_last_error())
+        return {name: getattr(result, name) for name, _ in PowerOnIngestResult._fields_}
+
+    def reserve_capacity(self, requests: List[Tuple[NetworkEntity, float]], ttl_ms: int = 0) -> int:
+        """Резервирует место сразу в нескольких хранилищах по принципу "всё или ничего".
+
+        Args:
+            requests: Пары `(storage, size_mb)`; storage - объект хранилища этой сети.
+            ttl_ms: Срок действия резерва в миллисекундах (0 - значение по умолчанию DLL).
+
+        Returns:
+            Идентификатор резерва для commit_reservation или release_reservation.
+
+        Raises:
+            CorporateNetworkError: если хотя бы в одном хранилище не хватает места
+                (тогда не изменено ни одно) или параметры недействительны.
+        """
+        count = len(requests)
+        storages = (NetSphereHandle * max(count, 1))(*[storage.handle for storage, _ in requests])
+        sizes = (c_double * max(count, 1))(*[size_mb for _, size_mb in requests])
+        token = self.dll.network_reserve_capacity(self.handle, storages, sizes, count, ttl_ms)
+        if not token:
+            raise CorporateNetworkError(self.get_last_error())
+        return token
+
+    def commit_reservation(self, token: int):
+        """Подтверждает резерв: место остаётся занятым записанными данными.
+
+        Raises:
+            CorporateNetworkError: если резерв не найден или истёк.
+        """
+        if not self.dll.network_commit_reservation(self.handle, token):
+            raise CorporateNetworkError(self.get_last_error())
+
+    def release_reservation(self, token: int):
+        """Отменяет резерв и возвращает место в хранилища.
+
+        Raises:
+            CorporateNetworkError: если резерв не найден.
+        """
+        if not self.dll.network_release_reservation(self.handle, token):
+            raise CorporateNetworkError(self.get_last_error())
+
+    def enable_change_feed(self, capacity: int = 0):
+        """Включает ленту изменений сети (повторный вызов ничего не меняет).
+
+        Args:
+            capacity: Число хранимых событий (0 - значение по умолчанию DLL).
+
+        Raises:
+            CorporateNetworkError: если ленту не удалось включить.
+        """
+        if not self.dll.network_enable_change_feed(self.handle, capacity):
+            raise CorporateNetworkError(self.get_last_error())
+
+    def fetch_changes(self, after_sequence: int, max_count: int = 256):
+        """Возвращает события ленты с номерами больше `after_sequence`.
+
+        Args:
+            after_sequence: Номер последнего уже применённого события (0 - с начала).
+            max_count: Максимальное число событий за вызов.
+
+        Returns:
+            Кортеж `(events, last_sequence, resync_required)`. `events` - список словарей
+            с ключами `sequence`, `type` (ChangeType), `entity_type` (DeviceType), `id`,
+            `related_id`, `used_mb`, `power_on_time`. Если `resync_required`, события вытеснены:
+            нужно перечитать сеть целиком и продолжить с `last_sequence`.
+
+        Raises:
+            CorporateNetworkError: если лента не включена или дескриптор недействителен.
+        """
+        records = (ChangeRecord * max(max_count, 1))()
+        last_sequence = ctypes.c_uint64(0)
+        count = self.dll.network_fetch_changes(self.handle, after_sequence, records, max_count,
+                                               byref(last_sequence))
+        if count == CHANGES_RESYNC:
+            return [], last_sequence.value, True
+        if count < 0:
+            raise CorporateNetworkError(self.get_last_error())
+        events = []
+        for i in range(count):
+            record = records[i]
+            events.append({
+                'sequence': record.sequence,
+                'type': ChangeType(record.type),
+                'entity_type': DeviceType(record.entity_type),
+                'id': record.id.decode('utf-8'),
+                'related_id': record.related_id.decode('utf-8'),
+                'used_mb': record.used_mb,
+                'power_on_time': record.power_on_time
+            })
+        return events, last_sequence.value, False
+
+    def iter_entities(self, domain_id: str = '', order: CursorOrder = CursorOrder.CHILDREN,
+                      page_size: int = 256):
+        """Лениво перечисляет детей домена или всё его поддерево.
+
+        Записи запрашиваются у DLL страницами по `page_size`, поэтому для раскрытия
+        огромного домена через границу ctypes передаётся только просмотренная часть.
+
+        Args:
+            domain_id: Начальный домен (пустая строка - корневой).
+            order: `CHILDREN`, `DEPTH_FIRST` или `BREADTH_FIRST`.
+            page_size: Число записей в одной странице.
+
+        Yields:
+            Словари с ключами `id`, `parent_id`, `type` (DeviceType), `depth`, `child_count`.
+
+        Raises:
+            CorporateNetworkError: если домен не найден или сеть изменилась во время перечисления.
+        """
+        cursor = self.dll.cursor_open(self.handle, domain_id.encode('utf-8'), int(order))
+        if not cursor:
+            raise CorporateNetworkError(self.get_last_error() or f"Домен '{domain_id}' не найден")
+        try:
+            page = (CursorRecord * page_size)()
+            while True:
+                count = self.dll.cursor_next(cursor, page, page_size)
+                if count < 0:
+                    raise CorporateNetworkError(self.get_last_error())
+                if count == 0:
+                    return
+                for i in range(count):
+                    record = page[i]
+                    yield {
+                        'id': record.id.decode('utf-8'),
+                        'parent_id': record.parent_id.decode('utf-8'),
+                        'type': DeviceType(record.type),
+                        'depth': record.depth,
+                        'child_count': record.child_count
+                    }
+        finally:
+            self.dll.cursor_close(cursor)
+
+    def execute_commands(self, commands: CommandBuffer) -> List[CommandStatus]:
+        """Выполняет пакет команд за один вызов DLL.
+
+        Args:
+            commands: Заполненный `CommandBuffer`.
+
+        Returns:
+            Статус каждой обработанной команды. Если встретилась неразборчивая команда,
+            список заканчивается статусом `MALFORMED`. Текст последней ошибки доступен
+            через `get_last_error()`.
+
+        Raises:
+            CorporateNetworkError: если дескриптор сети недействителен.
+        """
+        data = commands.to_bytes()
+        statuses = (c_int * max(commands.count, 1))()
+        processed = self.dll.network_execute_commands(self.handle, data, len(data), statuses, commands.count)
+        if processed < 0:
+            raise CorporateNetworkError(self.get_last_error() or "Недействительный дескриптор сети")
+        return [CommandStatus(statuses[i]) for i in range(processed)]
+
     def get_last_error(self) -> str:
         """Возвращает последнюю ошибку, полученную из DLL (в виде строки)."""
         error = self.dll.get_last_error()
@@ -30,55 +30,137 @@ class DeviceTreeWidget(QTreeWidget):
         super().__init__(parent)
         self.setHeaderLabels(['ID', 'Тип', 'MAC', 'Информация'])
         self.itemClicked.connect(self.on_item_clicked)
+        self.itemExpanded.connect(self.on_item_expanded)
         self.network = None
+        self.items = {}
+        self.applied_sequence = 0
+
+    TYPE_NAMES = {
+        cn.DeviceType.DATA_STORAGE: ('DataStorage', 'Хранилище'),
+        cn.DeviceType.WORKSTATION: ('Workstation', 'Рабочая станция'),
+        cn.DeviceType.PRINTER: ('Printer', 'Принтер'),
+        cn.DeviceType.DOMAIN: ('Domain', 'Домен'),
+        cn.DeviceType.UNKNOWN: ('Unknown', '')
+    }
 
     def set_network(self, network):
-        """Перестраивает дерево, отображая список устройств из `network`.
+        """Перестраивает дерево по реальной структуре сети из `network`.
+
+        Дети каждого домена запрашиваются через курсор DLL только при раскрытии узла,
+        поэтому большие домены не загружаются целиком. Дальнейшие изменения сети
+        применяются к дереву по ленте изменений (`apply_changes`).
 
         Args:
-            network: Экземпляр `CorporateNetwork` (или совместимый объект), из которого будут извлечены `devices`.
+            network: Экземпляр `CorporateNetwork` (или совместимый объект) с методом `iter_entities`.
         """
         self.network = network
         self.clear()
+        self.items = {}
 
         if not network:
             return
 
+        # Номер запоминается до обхода: события, пришедшие во время обхода, применятся повторно
+        network.enable_change_feed()
+        _, self.applied_sequence, _ = network.fetch_changes(0, 0)
+
         root = QTreeWidgetItem(self, ['Корневой домен', 'Domain', '', ''])
+        root.setData(0, Qt.UserRole, '')
+        self.items['root_domain'] = root
+        self.populate_children(root)
+        root.setExpanded(True)
+
+    def add_entity_item(self, parent_item, entity_id, device_type, has_children):
+        """Добавляет строку сущности в узел домена и регистрирует её по идентификатору."""
+        type_str, info_str = self.TYPE_NAMES.get(device_type, ('Unknown', ''))
+        mac = ''
+        if device_type != cn.DeviceType.DOMAIN:
+            try:
+                mac = self.network.get_device_info(entity_id).get('mac', '')
+            except cn.CorporateNetworkError:
+                pass
+        item = QTreeWidgetItem(parent_item, [entity_id, type_str, mac, info_str])
+        item.setData(0, Qt.UserRole, entity_id)
+        if device_type == cn.DeviceType.DOMAIN and has_children:
+            # Заглушка показывает стрелку раскрытия до загрузки детей
+            QTreeWidgetItem(item, [''])
+            item.setData(1, Qt.UserRole, False)
+        self.items[entity_id] = item
+        return item
+
+    def forget_items(self, item):
+        """Удаляет узел и всех его потомков из таблицы идентификаторов."""
+        for i in range(item.childCount()):
+            self.forget_items(item.child(i))
+        entity_id = item.data(0, Qt.UserRole)
+        if entity_id and self.items.get(entity_id) is item:
+            del self.items[entity_id]
+
+    def populate_children(self, item):
+        """Заполняет узел домена его непосредственными детьми из DLL."""
+        for i in range(item.childCount()):
+            self.forget_items(item.child(i))
+        item.takeChildren()
+        domain_id = item.data(0, Qt.UserRole)
+        try:
+            for record in self.network.iter_entities(domain_id, cn.CursorOrder.CHILDREN):
+                self.add_entity_item(item, record['id'], record['type'], record['child_count'] > 0)
+        except cn.CorporateNetworkError:
+            pass
+        item.setData(1, Qt.UserRole, True)
+
+    def apply_changes(self):
+        """Применяет к дереву события ленты изменений, накопившиеся с прошлого обновления.
+
+        Стоимость пропорциональна числу изменений; если лента вытеснила нужные события,
+        дерево перестраивается целиком.
+        """
+        if not self.network:
+            return
+        while True:
+            events, last_sequence, resync = self.network.fetch_changes(self.applied_sequence)
+            if resync:
+                self.set_network(self.network)
+                return
+            if not events:
+                return
+            for event in events:
+                if event['type'] == cn.ChangeType.ENTITY_ADDED:
+                    self.apply_entity_added(event)
+                elif event['type'] == cn.ChangeType.ENTITY_REMOVED:
+                    self.apply_entity_removed(event)
+                self.applied_sequence = event['sequence']
+
+    def apply_entity_added(self, event):
+        """Показывает добавленную сущность, если её домен уже загружен в дерево."""
+        parent_item = self.items.get(event['related_id'])
+        if parent_item is None or event['id'] in self.items:
+            return
+        if parent_item.data(1, Qt.UserRole) is False:
+            return  # Дети домена ещё не загружены и будут прочитаны при раскрытии
+        if parent_item.data(1, Qt.UserRole) is None:
+            # Пустой домен без заглушки: показать стрелку раскрытия
+            QTreeWidgetItem(parent_item, [''])
+            parent_item.setData(1, Qt.UserRole, False)
+            return
+        # Домен приходит вместе с поддеревом, поэтому его дети читаются при раскрытии
+        self.add_entity_item(parent_item, event['id'], event['entity_type'],
+                             event['entity_type'] == cn.DeviceType.DOMAIN)
+
+    def apply_entity_removed(self, event):
+        """Убирает удалённую сущность вместе с поддеревом."""
+        item = self.items.get(event['id'])
+        if item is None:
+            return
+        self.forget_items(item)
+        parent_item = item.parent()
+        if parent_item is not None:
+            parent_item.removeChild(item)
 
-        if hasattr(network, 'devices') and network.devices:
-            for device in network.devices:
-                try:
-                    info = device.get_info()
-                    if info and info.get('id'):
-                        device_id = info.get('id', 'Unknown')
-                        device_type = info.get('type', cn.DeviceType.UNKNOWN)
-                        mac = info.get('mac', '')
-                        
-                        type_names = {
-                            cn.DeviceType.DATA_STORAGE: 'DataStorage',
-                            cn.DeviceType.WORKSTATION: 'Workstation',
-                            cn.DeviceType.PRINTER: 'Printer',
-                            cn.DeviceType.DOMAIN: 'Domain',
-                            cn.DeviceType.UNKNOWN: 'Unknown'
-                        }
-                        type_str = type_names.get(device_type, 'Unknown')
-                        
-                        info_str = ''
-                        if device_type == cn.DeviceType.DATA_STORAGE:
-                            info_str = 'Хранилище'
-                        elif device_type == cn.DeviceType.WORKSTATION:
-                            info_str = 'Рабочая станция'
-                        elif device_type == cn.DeviceType.PRINTER:
-                            info_str = 'Принтер'
-                        elif device_type == cn.DeviceType.DOMAIN:
-                            info_str = 'Домен'
-                        
-                        device_item = QTreeWidgetItem(root, [device_id, type_str, mac, info_str])
-                except Exception:
-                    pass
-
-        self.expandAll()
+    def on_item_expanded(self, item):
+        """Загружает детей домена при первом раскрытии узла."""
+        if item.data(1, Qt.UserRole) is False:
+            self.populate_children(item)
 
     def on_item_clicked(self, item, column):
         """Сигнализирует о выборе пользователя по клику на строке дерева."""
@@ -387,7 +469,7 @@ class MainWindow(QMainWindow):
                         type_names = {0: 'Хранилище', 1: 'Рабочая станция', 2: 'Принтер', 3: 'Домен'}
                         type_name = type_names.get(data['type'], 'Unknown')
                         self.log_message(f"Добавлено устройство: {data['id']} (тип: {type_name})")
-                        self.tree_widget.set_network(self.network)
+                        self.tree_widget.apply_changes()
                     else:
                         self.log_message(f"ОШИБКА: Не удалось добавить устройство {data['id']} в домен")
                 except cn.CorporateNetworkError as e:
@@ -436,7 +518,7 @@ class MainWindow(QMainWindow):
                     self.log_message(f"Удалено устройство: {device_id}")
                     self._selected_device = None
                     self._selected_device_info = None
-                    self.tree_widget.set_network(self.network)
+                    self.tree_widget.apply_changes()
                     self.device_id_label.setText("")
                     self.device_type_label.setText("")
                     self.device_mac_label.setText("")
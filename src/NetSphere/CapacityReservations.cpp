@@ -0,0 +1,160 @@
+﻿/**
+ * @file CapacityReservations.cpp
+ * @brief Реализация двухфазных резервов места в нескольких хранилищах.
+ */
+
+#include "CapacityReservations.h"
+#include "DataStorage.h"
+#include "NetworkExceptions.h"
+#include <algorithm>
+#include <limits>
+#include <string>
+
+namespace {
+
+    /**
+     * @brief Вычисляет срок действия резерва без переполнения time_point.
+     * @param[in] ttl Срок действия; отрицательный считается нулевым.
+     * @return now + ttl, ограниченное максимальным представимым моментом.
+     */
+    std::chrono::steady_clock::time_point deadlineAfter(std::chrono::milliseconds ttl) {
+        using Clock = std::chrono::steady_clock;
+        const auto now = Clock::now();
+        const auto room = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::time_point::max() - now);
+        if (ttl >= room) {
+            return Clock::time_point::max();
+        }
+        return now + std::max(ttl, std::chrono::milliseconds::zero());
+    }
+
+}
+
+CapacityReservations::~CapacityReservations() {
+    for (const auto& [token, reservation] : active) {
+        releaseHolds(reservation.holds);
+    }
+}
+
+void CapacityReservations::releaseHolds(const std::vector<CapacityRequest>& holds) noexcept {
+    for (auto it = holds.rbegin(); it != holds.rend(); ++it) {
+        try {
+            it->storage->releaseBytes(it->bytes);
+        }
+        catch (const DeviceOperationException&) {
+            // Занятый объём хранилища был переустановлен извне (operator=): возвращать нечего
+        }
+    }
+}
+
+ReservationToken CapacityReservations::reserve(std::span<const CapacityRequest> requests,
+    std::chrono::milliseconds ttl) {
+    if (requests.empty()) {
+        throw ValidationException("Резерв должен охватывать хотя бы одно хранилище");
+    }
+    std::vector<CapacityRequest> holds(requests.begin(), requests.end());
+    for (const CapacityRequest& request : holds) {
+        if (!request.storage) {
+            throw ValidationException("Хранилище резерва не задано");
+        }
+        if (request.bytes == 0) {
+            throw ValidationException("Размер резерва должен быть положительным");
+        }
+    }
+
+    // Единый порядок обхода и слияние повторов одного хранилища
+    std::sort(holds.begin(), holds.end(), [](const CapacityRequest& left, const CapacityRequest& right) {
+        if (left.storage->getId() != right.storage->getId()) {
+            return left.storage->getId() < right.storage->getId();
+        }
+        return left.storage < right.storage;
+    });
+    size_t merged = 0;
+    for (size_t i = 1; i < holds.size(); ++i) {
+        if (holds[i].storage == holds[merged].storage) {
+            if (holds[i].bytes > std::numeric_limits<uint64_t>::max() - holds[merged].bytes) {
+                throw ValidationException("Суммарный объём резерва хранилища '" + holds[i].storage->getId() +
+                    "' превышает допустимый");
+            }
+            holds[merged].bytes += holds[i].bytes;
+        }
+        else {
+            holds[++merged] = std::move(holds[i]);
+        }
+    }
+    holds.resize(merged + 1);
+
+    // Место брошенных резервов может понадобиться этому запросу
+    collectExpired();
+
+    size_t reserved = 0;
+    try {
+        for (; reserved < holds.size(); ++reserved) {
+            holds[reserved].storage->reserveBytes(holds[reserved].bytes);
+        }
+    }
+    catch (...) {
+        holds.resize(reserved);
+        releaseHolds(holds);
+        throw;
+    }
+
+    try {
+        std::lock_guard lock(mutex);
+        const ReservationToken token = nextToken++;
+        active.emplace(token, Reservation{ std::move(holds), deadlineAfter(ttl) });
+        return token;
+    }
+    catch (...) {
+        releaseHolds(holds);
+        throw;
+    }
+}
+
+CapacityReservations::Reservation CapacityReservations::take(ReservationToken token) {
+    std::lock_guard lock(mutex);
+    auto it = active.find(token);
+    if (it == active.end()) {
+        throw DeviceOperationException("Резерв " + std::to_string(token) + " не найден или уже завершён");
+    }
+    Reservation reservation = std::move(it->second);
+    active.erase(it);
+    return reservation;
+}
+
+void CapacityReservations::commit(ReservationToken token) {
+    const Reservation reservation = take(token);
+    if (std::chrono::steady_clock::now() >= reservation.deadline) {
+        releaseHolds(reservation.holds);
+        throw DeviceOperationException("Резерв " + std::to_string(token) + " истёк");
+    }
+}
+
+void CapacityReservations::release(ReservationToken token) {
+    releaseHolds(take(token).holds);
+}
+
+size_t CapacityReservations::collectExpired() {
+    std::vector<Reservation> expired;
+    {
+        std::lock_guard lock(mutex);
+        const auto now = std::chrono::steady_clock::now();
+        for (auto it = active.begin(); it != active.end();) {
+            if (now >= it->second.deadline) {
+                expired.push_back(std::move(it->second));
+                it = active.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+    for (const Reservation& reservation : expired) {
+        releaseHolds(reservation.holds);
+    }
+    return expired.size();
+}
+
+size_t CapacityReservations::activeCount() const {
+    std::lock_guard lock(mutex);
+    return active.size();
+}
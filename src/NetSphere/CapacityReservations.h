@@ -0,0 +1,133 @@
+﻿/**
+ * @file CapacityReservations.h
+ * @brief Заголовочный файл класса CapacityReservations - двухфазных резервов места в нескольких хранилищах.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+class DataStorage;
+
+/**
+ * @addtogroup storage_module
+ * @{
+ */
+
+ /**
+  * @brief Идентификатор резерва; 0 не выдаётся никогда.
+  */
+using ReservationToken = uint64_t;
+
+/**
+ * @brief Требование места в одном хранилище.
+ */
+struct CapacityRequest {
+    std::shared_ptr<DataStorage> storage;   ///< Хранилище
+    uint64_t bytes = 0;                     ///< Требуемый объём в байтах
+};
+
+/**
+ * @brief Реестр двухфазных резервов места, охватывающих несколько хранилищ.
+ *
+ * reserve() занимает место во всех хранилищах запроса по принципу "всё или ничего":
+ * каждое хранилище резервируется атомарным CAS (DataStorage::reserveBytes), а при
+ * первом отказе уже занятое возвращается в обратном порядке. Блокировки хранилищ
+ * не берутся, поэтому одновременные запросы к пересекающимся наборам хранилищ
+ * не могут взаимно заблокироваться; конкурирующий запрос может лишь получить
+ * отказ, пока чужой резерв откатывается. Хранилища обходятся в порядке
+ * идентификаторов, повторы одного хранилища в запросе складываются.
+ *
+ * Зарезервированное место считается занятым. commit() оставляет его занятым
+ * данными, release() - возвращает. Резерв, не завершённый до истечения срока,
+ * возвращается при следующем reserve() или collectExpired(); завершить его уже нельзя.
+ * Мьютекс реестра защищает только таблицу резервов и не удерживается во время CAS.
+ */
+class CapacityReservations {
+private:
+    /**
+     * @brief Действующий резерв.
+     */
+    struct Reservation {
+        std::vector<CapacityRequest> holds;                     ///< Занятое место по хранилищам
+        std::chrono::steady_clock::time_point deadline;         ///< Срок действия
+    };
+
+    mutable std::mutex mutex;                                   ///< Защищает active и nextToken
+    std::unordered_map<ReservationToken, Reservation> active;   ///< Действующие резервы
+    ReservationToken nextToken = 1;                             ///< Следующий выдаваемый идентификатор
+
+    /**
+     * @brief Возвращает занятое место в хранилища.
+     * @param[in] holds Места резерва.
+     */
+    static void releaseHolds(const std::vector<CapacityRequest>& holds) noexcept;
+
+    /**
+     * @brief Извлекает резерв из таблицы.
+     * @param[in] token Идентификатор резерва.
+     * @return Извлечённый резерв.
+     * @throw DeviceOperationException Если резерв не найден.
+     */
+    Reservation take(ReservationToken token);
+
+public:
+    static constexpr std::chrono::milliseconds DEFAULT_TTL{ 30000 };    ///< Срок действия по умолчанию
+
+    CapacityReservations() = default;
+    CapacityReservations(const CapacityReservations&) = delete;
+    CapacityReservations& operator=(const CapacityReservations&) = delete;
+
+    /**
+     * @brief Деструктор: возвращает место всех незавершённых резервов.
+     */
+    ~CapacityReservations();
+
+    /**
+     * @brief Атомарно резервирует место сразу в нескольких хранилищах.
+     * @param[in] requests Требования по хранилищам.
+     * @param[in] ttl Срок действия резерва; слишком большой срок ограничивается
+     * максимальным представимым моментом (резерв фактически бессрочен).
+     * @return Идентификатор резерва.
+     * @throw ValidationException Если запрос пуст, хранилище не задано, объём нулевой
+     * или суммарный объём повторов одного хранилища не помещается в uint64_t.
+     * @throw DeviceOperationException Если в каком-либо хранилище не хватает места;
+     * в этом случае ни одно хранилище не изменено.
+     */
+    ReservationToken reserve(std::span<const CapacityRequest> requests, std::chrono::milliseconds ttl = DEFAULT_TTL);
+
+    /**
+     * @brief Подтверждает резерв: место остаётся занятым записанными данными.
+     * @param[in] token Идентификатор резерва.
+     * @throw DeviceOperationException Если резерв не найден или истёк (место истёкшего возвращается).
+     */
+    void commit(ReservationToken token);
+
+    /**
+     * @brief Отменяет резерв и возвращает место в хранилища.
+     * @param[in] token Идентификатор резерва.
+     * @throw DeviceOperationException Если резерв не найден.
+     */
+    void release(ReservationToken token);
+
+    /**
+     * @brief Возвращает место всех истёкших резервов.
+     * @return Число отменённых резервов.
+     */
+    size_t collectExpired();
+
+    /**
+     * @brief Возвращает число действующих резервов.
+     * @return Число резервов в таблице.
+     */
+    size_t activeCount() const;
+};
+
+/** @} */ // Конец группы storage_module
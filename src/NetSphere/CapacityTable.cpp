@@ -0,0 +1,236 @@
+﻿/**
+ * @file CapacityTable.cpp
+ * @brief Реализация таблицы ёмкости хранилищ сети.
+ */
+
+#include "CapacityTable.h"
+#include "DataStorage.h"
+#include <algorithm>
+#include <bit>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define NETSPHERE_CAPACITY_SSE2 1
+#endif
+
+namespace {
+
+    /**
+     * @brief Сумма массива: по две пары сумматоров SSE2 скрывают задержку сложения.
+     */
+    double sumColumn(std::span<const double> values) noexcept {
+        size_t i = 0;
+        double result = 0.0;
+#ifdef NETSPHERE_CAPACITY_SSE2
+        __m128d first = _mm_setzero_pd();
+        __m128d second = _mm_setzero_pd();
+        for (; i + 4 <= values.size(); i += 4) {
+            first = _mm_add_pd(first, _mm_loadu_pd(values.data() + i));
+            second = _mm_add_pd(second, _mm_loadu_pd(values.data() + i + 2));
+        }
+        alignas(16) double lanes[2];
+        _mm_store_pd(lanes, _mm_add_pd(first, second));
+        result = lanes[0] + lanes[1];
+#endif
+        for (; i < values.size(); ++i) {
+            result += values[i];
+        }
+        return result;
+    }
+
+
+    /**
+     * @brief Число значений used, превышающих долю ratio от total.
+     */
+    size_t countAbove(std::span<const double> total, std::span<const double> used, double ratio) noexcept {
+        size_t i = 0;
+        size_t count = 0;
+#ifdef NETSPHERE_CAPACITY_SSE2
+        const __m128d threshold = _mm_set1_pd(ratio);
+        for (; i + 2 <= used.size(); i += 2) {
+            const __m128d limit = _mm_mul_pd(_mm_loadu_pd(total.data() + i), threshold);
+            const int mask = _mm_movemask_pd(_mm_cmpgt_pd(_mm_loadu_pd(used.data() + i), limit));
+            count += static_cast<size_t>(std::popcount(static_cast<unsigned>(mask)));
+        }
+#endif
+        for (; i < used.size(); ++i) {
+            count += used[i] > ratio * total[i] ? 1 : 0;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Добавляет доли заполнения в гистограмму.
+     */
+    void addToHistogram(std::span<const double> total, std::span<const double> used, std::vector<size_t>& histogram) noexcept {
+        const double scale = static_cast<double>(histogram.size());
+        const int lastBucket = static_cast<int>(std::min<size_t>(histogram.size(), INT32_MAX) - 1);
+
+        size_t i = 0;
+#ifdef NETSPHERE_CAPACITY_SSE2
+        // Деление и усечение к целому по два хранилища; занятый объём не превышает общий
+        const __m128d scaleVector = _mm_set1_pd(scale);
+        alignas(16) int32_t indices[4];
+        for (; i + 2 <= used.size(); i += 2) {
+            const __m128d fill = _mm_div_pd(_mm_loadu_pd(used.data() + i), _mm_loadu_pd(total.data() + i));
+            _mm_store_si128(reinterpret_cast<__m128i*>(indices), _mm_cvttpd_epi32(_mm_mul_pd(fill, scaleVector)));
+            ++histogram[std::min(indices[0], lastBucket)];
+            ++histogram[std::min(indices[1], lastBucket)];
+        }
+#endif
+        for (; i < used.size(); ++i) {
+            const int bucket = static_cast<int>(used[i] / total[i] * scale);
+            ++histogram[std::min(bucket, lastBucket)];
+        }
+    }
+
+}
+
+CapacityTable::~CapacityTable() {
+    for (const auto& chunk : chunks) {
+        for (DataStorage* storage : chunk->storages) {
+            if (storage) {
+                storage->capacityCell.store(nullptr, std::memory_order_release);
+                storage->capacityTable = nullptr;
+            }
+        }
+    }
+}
+
+template <typename Visitor>
+void CapacityTable::forEachBlock(Visitor&& visit) const {
+    double total[CHUNK_ROWS];
+    double used[CHUNK_ROWS];
+    for (uint32_t first = 0; first < rowCount; first += CHUNK_ROWS) {
+        const Chunk& chunk = *chunks[first / CHUNK_ROWS];
+        const uint32_t rows = std::min(CHUNK_ROWS, rowCount - first);
+        if (chunk.freeCount == 0) {
+            for (uint32_t row = 0; row < rows; ++row) {
+                used[row] = chunk.usedMB[row].load(std::memory_order_relaxed);
+            }
+            visit(std::span<const double>(chunk.totalMB, rows), std::span<const double>(used, rows));
+            continue;
+        }
+        size_t live = 0;
+        for (uint32_t row = 0; row < rows; ++row) {
+            if (chunk.domainSlots[row] != FREE_ROW) {
+                total[live] = chunk.totalMB[row];
+                used[live] = chunk.usedMB[row].load(std::memory_order_relaxed);
+                ++live;
+            }
+        }
+        visit(std::span<const double>(total, live), std::span<const double>(used, live));
+    }
+}
+
+void CapacityTable::add(DataStorage& storage, Symbol domain) {
+    if (storage.capacityTable) {
+        storage.capacityTable->remove(storage);
+    }
+    auto [position, inserted] = domainNumbers.try_emplace(domain, static_cast<uint32_t>(domains.size()));
+    if (inserted) {
+        domains.push_back(domain);
+    }
+
+    uint32_t slot;
+    if (!freeRows.empty()) {
+        slot = freeRows.back();
+        freeRows.pop_back();
+    }
+    else {
+        if (rowCount % CHUNK_ROWS == 0) {
+            freeRows.reserve(size_t(rowCount) + CHUNK_ROWS);
+            chunks.push_back(std::make_unique<Chunk>());
+        }
+        slot = rowCount++;
+    }
+    Chunk& chunk = *chunks[slot / CHUNK_ROWS];
+    const uint32_t row = slot % CHUNK_ROWS;
+    if (chunk.domainSlots[row] == FREE_ROW) {
+        --chunk.freeCount;
+    }
+    chunk.totalMB[row] = storage.getTotalSize();
+    chunk.domainSlots[row] = position->second;
+    chunk.storages[row] = &storage;
+    storage.capacityTable = this;
+    storage.capacitySlot = slot;
+    // Ячейка публикуется до чтения объёма: изменение, не увидевшее ячейку, уже
+    // видно этому чтению (обе стороны упорядочены последовательно)
+    storage.capacityCell.store(&chunk.usedMB[row], std::memory_order_seq_cst);
+    storage.storeLatestUsage(chunk.usedMB[row]);
+}
+
+void CapacityTable::unpublish(DataStorage& storage) noexcept {
+    if (storage.capacityTable == this) {
+        storage.capacityCell.store(nullptr, std::memory_order_seq_cst);
+    }
+}
+
+void CapacityTable::remove(DataStorage& storage) noexcept {
+    if (storage.capacityTable != this) {
+        return;
+    }
+    const uint32_t slot = storage.capacitySlot;
+    Chunk& chunk = *chunks[slot / CHUNK_ROWS];
+    const uint32_t row = slot % CHUNK_ROWS;
+    storage.capacityCell.store(nullptr, std::memory_order_seq_cst);
+    chunk.totalMB[row] = 0.0;
+    chunk.usedMB[row].store(0.0, std::memory_order_relaxed);
+    chunk.domainSlots[row] = FREE_ROW;
+    chunk.storages[row] = nullptr;
+    ++chunk.freeCount;
+    // Место в списке свободных строк выделено вместе с блоком, поэтому вставка не бросает исключений
+    freeRows.push_back(slot);
+    storage.capacityTable = nullptr;
+}
+
+CapacityTotals CapacityTable::sum() const noexcept {
+    CapacityTotals totals{ size(), 0.0, 0.0 };
+    forEachBlock([&](std::span<const double> total, std::span<const double> used) {
+        totals.totalMB += sumColumn(total);
+        totals.usedMB += sumColumn(used);
+    });
+    return totals;
+}
+
+std::vector<DomainCapacity> CapacityTable::sumByDomain() const {
+    std::vector<CapacityTotals> perDomain(domains.size());
+    for (uint32_t slot = 0; slot < rowCount; ++slot) {
+        const Chunk& chunk = *chunks[slot / CHUNK_ROWS];
+        const uint32_t row = slot % CHUNK_ROWS;
+        if (chunk.domainSlots[row] == FREE_ROW) {
+            continue;
+        }
+        CapacityTotals& totals = perDomain[chunk.domainSlots[row]];
+        ++totals.storageCount;
+        totals.totalMB += chunk.totalMB[row];
+        totals.usedMB += chunk.usedMB[row].load(std::memory_order_relaxed);
+    }
+
+    std::vector<DomainCapacity> result;
+    for (size_t number = 0; number < domains.size(); ++number) {
+        if (perDomain[number].storageCount > 0) {
+            result.push_back(DomainCapacity{ domains[number], perDomain[number] });
+        }
+    }
+    return result;
+}
+
+size_t CapacityTable::countAboveFillRatio(double ratio) const noexcept {
+    size_t count = 0;
+    forEachBlock([&](std::span<const double> total, std::span<const double> used) {
+        count += countAbove(total, used, ratio);
+    });
+    return count;
+}
+
+std::vector<size_t> CapacityTable::fillHistogram(size_t buckets) const {
+    if (buckets == 0) {
+        throw ValidationException("Число интервалов гистограммы должно быть положительным");
+    }
+    std::vector<size_t> histogram(buckets, 0);
+    forEachBlock([&](std::span<const double> total, std::span<const double> used) {
+        addToHistogram(total, used, histogram);
+    });
+    return histogram;
+}
@@ -0,0 +1,162 @@
+﻿/**
+ * @file CapacityTable.h
+ * @brief Заголовочный файл класса CapacityTable - плотной таблицы ёмкости хранилищ сети.
+ */
+
+#pragma once
+
+#include "SymbolTable.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+class DataStorage;
+
+/**
+ * @addtogroup storage_module
+ * @{
+ */
+
+ /**
+  * @brief Суммарная ёмкость набора хранилищ.
+  */
+struct CapacityTotals {
+    size_t storageCount = 0; ///< Число хранилищ
+    double totalMB = 0.0;    ///< Общий объём
+    double usedMB = 0.0;     ///< Занятый объём
+
+    /**
+     * @brief Возвращает свободный объём.
+     * @return Разность общего и занятого объёма.
+     */
+    double freeMB() const noexcept { return totalMB - usedMB; }
+};
+
+/**
+ * @brief Суммарная ёмкость хранилищ, непосредственно входящих в домен.
+ */
+struct DomainCapacity {
+    Symbol domain;           ///< Идентификатор домена
+    CapacityTotals totals;   ///< Суммы по хранилищам домена
+};
+
+/**
+ * @brief Таблица ёмкости всех хранилищ сети в виде структуры массивов.
+ *
+ * Общий объём, занятый объём и домен-владелец каждого хранилища лежат в отдельных
+ * плотных массивах, поэтому отчёты по всему парку читают память подряд без
+ * обращения к объектам хранилищ и векторизуются (SSE2 на x86-64).
+ *
+ * Сеть добавляет хранилище в таблицу при присоединении и убирает при отсоединении;
+ * операторы изменения занятого объёма DataStorage обновляют свою ячейку сами, из
+ * любых потоков. Поэтому строки лежат в блоках, которые не перемещаются при росте
+ * таблицы, а ячейки занятого объёма атомарны. Освобождённая строка не заполняется
+ * последней, а уходит в список свободных и достаётся следующему хранилищу, так что
+ * строки не упорядочены. Добавление, удаление и отчёты сериализуются снаружи
+ * (в CorporateNetwork - блокировкой писателя).
+ */
+class CapacityTable {
+private:
+    static constexpr uint32_t CHUNK_ROWS = 1024;        ///< Число строк в блоке
+    static constexpr uint32_t FREE_ROW = UINT32_MAX;    ///< Номер домена свободной строки
+
+    /**
+     * @brief Блок строк таблицы; после создания не перемещается.
+     */
+    struct Chunk {
+        std::atomic<double> usedMB[CHUNK_ROWS];   ///< Занятый объём (пишут потоки хранилищ)
+        double totalMB[CHUNK_ROWS];               ///< Общий объём
+        uint32_t domainSlots[CHUNK_ROWS];         ///< Номер домена-владельца (FREE_ROW - строка свободна)
+        DataStorage* storages[CHUNK_ROWS];        ///< Хранилище строки
+        uint32_t freeCount = 0;                   ///< Число свободных строк блока
+    };
+
+    std::vector<std::unique_ptr<Chunk>> chunks;         ///< Блоки строк
+    uint32_t rowCount = 0;                              ///< Число выданных строк, включая свободные
+    std::vector<uint32_t> freeRows;                     ///< Номера освобождённых строк
+    std::vector<Symbol> domains;                        ///< Идентификаторы доменов по номерам
+    std::unordered_map<Symbol, uint32_t> domainNumbers; ///< Номер домена по идентификатору
+
+    /**
+     * @brief Копирует занятые строки каждого блока в плотные массивы и передаёт их функции.
+     * @param[in] visit Функция вида void(std::span<const double> total, std::span<const double> used).
+     * @details Ячейки занятого объёма читаются атомарно по одной, а векторные ядра
+     * работают уже с копией. Общий объём блока без свободных строк не копируется.
+     */
+    template <typename Visitor>
+    void forEachBlock(Visitor&& visit) const;
+
+public:
+    CapacityTable() = default;
+
+    /**
+     * @brief Отвязывает оставшиеся хранилища от таблицы.
+     */
+    ~CapacityTable();
+
+    CapacityTable(const CapacityTable&) = delete;
+    CapacityTable& operator=(const CapacityTable&) = delete;
+
+    /**
+     * @brief Добавляет хранилище в таблицу.
+     * @param[in,out] storage Хранилище, ещё не входящее ни в одну таблицу.
+     * @param[in] domain Идентификатор домена-владельца.
+     */
+    void add(DataStorage& storage, Symbol domain);
+
+    /**
+     * @brief Снимает ячейку хранилища с публикации: новые изменения объёма в таблицу не пишутся.
+     * @param[in,out] storage Хранилище.
+     * @details Изменения, уже прочитавшие ячейку, ещё могут писать в неё, поэтому строку
+     * освобождает remove() только после EpochManager::synchronize().
+     */
+    void unpublish(DataStorage& storage) noexcept;
+
+    /**
+     * @brief Убирает хранилище из таблицы; ничего не делает, если его там нет.
+     * @param[in,out] storage Хранилище.
+     * @details Если объём хранилища могут менять другие потоки, перед вызовом нужны
+     * unpublish() и EpochManager::synchronize(): иначе запоздавшая запись попадёт
+     * в строку, уже выданную другому хранилищу.
+     */
+    void remove(DataStorage& storage) noexcept;
+
+    /**
+     * @brief Возвращает число хранилищ в таблице.
+     * @return Число занятых строк.
+     */
+    size_t size() const noexcept { return rowCount - freeRows.size(); }
+
+    /**
+     * @brief Суммирует ёмкость всех хранилищ.
+     * @return Суммарные общий и занятый объём.
+     */
+    CapacityTotals sum() const noexcept;
+
+    /**
+     * @brief Суммирует ёмкость хранилищ по доменам-владельцам.
+     * @return Суммы для каждого домена, в котором есть хранилища.
+     * @details Учитываются только непосредственные дети домена, без поддоменов.
+     */
+    std::vector<DomainCapacity> sumByDomain() const;
+
+    /**
+     * @brief Считает хранилища, заполненные сильнее заданной доли.
+     * @param[in] ratio Доля занятого объёма от 0 до 1.
+     * @return Число хранилищ с usedMB > ratio * totalMB.
+     */
+    size_t countAboveFillRatio(double ratio) const noexcept;
+
+    /**
+     * @brief Строит гистограмму заполненности хранилищ.
+     * @param[in] buckets Число равных интервалов на отрезке [0, 1].
+     * @return Число хранилищ в каждом интервале; полностью заполненные попадают в последний.
+     * @throw ValidationException Если buckets равно нулю.
+     */
+    std::vector<size_t> fillHistogram(size_t buckets) const;
+};
+
+/** @} */ // Конец группы storage_module
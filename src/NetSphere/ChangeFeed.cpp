@@ -0,0 +1,66 @@
+﻿/**
+ * @file ChangeFeed.cpp
+ * @brief Реализация последовательной ленты изменений сети.
+ */
+
+#include "ChangeFeed.h"
+#include "DataStorage.h"
+#include "Domain.h"
+#include "NetworkExceptions.h"
+#include "Workstation.h"
+#include <bit>
+
+ChangeFeed::ChangeFeed(size_t capacity) {
+    if (capacity == 0) {
+        throw ValidationException("ёмкость ленты изменений должна быть положительной");
+    }
+    ring.resize(std::bit_ceil(capacity));
+    mask = ring.size() - 1;
+}
+
+void ChangeFeed::publish(const ChangeEvent& event) {
+    std::lock_guard lock(mutex);
+    ChangeEvent& slot = ring[lastSequence & mask];
+    slot = event;
+    slot.sequence = ++lastSequence;
+}
+
+uint64_t ChangeFeed::getLastSequence() const {
+    std::lock_guard lock(mutex);
+    return lastSequence;
+}
+
+ChangeFetchResult ChangeFeed::fetchSince(uint64_t afterSequence, std::span<ChangeEvent> events) const {
+    size_t written = 0;
+    return visitSince(afterSequence, events.size(), [&](const ChangeEvent& event) {
+        events[written++] = event;
+    });
+}
+
+void ChangeFeed::onEntityAdded(const Domain& parent, const NetworkEntity& entity) {
+    publish(ChangeEvent{ 0, ChangeType::EntityAdded, entity.kind(), entity.getIdSymbol(), parent.getIdSymbol() });
+}
+
+void ChangeFeed::onEntityRemoved(const Domain& parent, const NetworkEntity& entity) {
+    publish(ChangeEvent{ 0, ChangeType::EntityRemoved, entity.kind(), entity.getIdSymbol(), parent.getIdSymbol() });
+}
+
+void ChangeFeed::onStorageUsageChanged(const DataStorage& storage, [[maybe_unused]] double previousUsedMB) {
+    ChangeEvent event{ 0, ChangeType::StorageUsageChanged, EntityKind::DataStorage, storage.getIdSymbol(), Symbol() };
+    event.usedMB = storage.getUsedSize();
+    publish(event);
+}
+
+void ChangeFeed::onTrustedUserAdded(const DataStorage& storage, Symbol user) {
+    publish(ChangeEvent{ 0, ChangeType::EntityUpdated, EntityKind::DataStorage, storage.getIdSymbol(), user });
+}
+
+void ChangeFeed::onTrustedUserRemoved(const DataStorage& storage, Symbol user) {
+    publish(ChangeEvent{ 0, ChangeType::EntityUpdated, EntityKind::DataStorage, storage.getIdSymbol(), user });
+}
+
+void ChangeFeed::onPowerOnTimeChanged(const Workstation& workstation, [[maybe_unused]] time_t previousTime) {
+    ChangeEvent event{ 0, ChangeType::PowerOnChanged, EntityKind::Workstation, workstation.getIdSymbol(), Symbol() };
+    event.powerOnTime = workstation.getLastPowerOnTime();
+    publish(event);
+}
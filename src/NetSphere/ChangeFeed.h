@@ -0,0 +1,151 @@
+﻿/**
+ * @file ChangeFeed.h
+ * @brief Заголовочный файл класса ChangeFeed - последовательной ленты изменений сети.
+ */
+
+#pragma once
+
+#include "NetworkEntity.h"
+#include "NetworkObserver.h"
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <span>
+#include <vector>
+
+/**
+ * @addtogroup network_module
+ * @{
+ */
+
+ /**
+  * @brief Вид события ленты изменений.
+  */
+enum class ChangeType : uint8_t {
+    EntityAdded = 1,          ///< Сущность (с поддеревом) добавлена; related - домен-владелец
+    EntityRemoved = 2,        ///< Сущность (с поддеревом) удалена; related - бывший домен-владелец
+    EntityUpdated = 3,        ///< Изменились доверенные пользователи хранилища; related - пользователь
+    StorageUsageChanged = 4,  ///< Изменился занятый объём хранилища; значение в usedMB
+    PowerOnChanged = 5        ///< Изменилось время включения рабочей станции; значение в powerOnTime
+};
+
+/**
+ * @brief Компактное событие ленты изменений.
+ *
+ * Идентификаторы хранятся символами, поэтому запись события не выделяет память.
+ */
+struct ChangeEvent {
+    uint64_t sequence = 0;                   ///< Номер события; строго возрастает, начиная с 1
+    ChangeType type = ChangeType::EntityAdded; ///< Вид события
+    EntityKind kind = EntityKind::Domain;    ///< Вид изменившейся сущности
+    Symbol entity;                           ///< Идентификатор изменившейся сущности
+    Symbol related;                          ///< Домен-владелец или пользователь (см. ChangeType)
+    double usedMB = 0.0;                     ///< Занятый объём после изменения (StorageUsageChanged)
+    time_t powerOnTime = 0;                  ///< Время включения после изменения (PowerOnChanged)
+};
+
+/**
+ * @brief Итог выборки событий из ленты.
+ */
+struct ChangeFetchResult {
+    size_t count = 0;            ///< Число выданных событий
+    uint64_t lastSequence = 0;   ///< Номер последнего события в ленте на момент выборки
+    bool resyncRequired = false; ///< Запрошенные события уже вытеснены; клиенту нужна полная пересинхронизация
+};
+
+/**
+ * @brief Последовательная лента изменений сети в ограниченном кольцевом буфере.
+ *
+ * Лента подписывается на сеть как NetworkObserver и нумерует каждое изменение.
+ * Клиент запоминает номер последнего применённого события и запрашивает только
+ * более новые, так что обновление представления стоит O(изменений), а не O(сети).
+ * Буфер хранит последние capacity событий; если клиент отстал сильнее, выборка
+ * сообщает resyncRequired. Пересинхронизация: запомнить lastSequence, заново
+ * перечислить сеть и продолжить выборку с запомненного номера (события между
+ * ними могут прийти повторно и должны применяться идемпотентно).
+ *
+ * Запись и выборка потокобезопасны и выполняются под коротким внутренним мьютексом.
+ */
+class ChangeFeed : public NetworkObserver {
+private:
+    mutable std::mutex mutex;       ///< Защищает буфер и счётчик
+    std::vector<ChangeEvent> ring;  ///< Кольцевой буфер; событие n лежит в ячейке (n - 1) & mask
+    uint64_t mask;                  ///< Ёмкость буфера минус один (ёмкость - степень двойки)
+    uint64_t lastSequence = 0;      ///< Номер последнего записанного события
+
+    /**
+     * @brief Записывает событие, присваивая ему очередной номер.
+     * @param[in] event Событие без номера.
+     */
+    void publish(const ChangeEvent& event);
+
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 4096; ///< Ёмкость буфера по умолчанию
+
+    /**
+     * @brief Создаёт пустую ленту.
+     * @param[in] capacity Число хранимых событий; округляется вверх до степени двойки.
+     * @throw ValidationException Если capacity равна нулю.
+     */
+    explicit ChangeFeed(size_t capacity = DEFAULT_CAPACITY);
+
+    ChangeFeed(const ChangeFeed&) = delete;
+    ChangeFeed& operator=(const ChangeFeed&) = delete;
+
+    /**
+     * @brief Возвращает ёмкость буфера.
+     * @return Максимальное число хранимых событий.
+     */
+    size_t getCapacity() const noexcept { return ring.size(); }
+
+    /**
+     * @brief Возвращает номер последнего события.
+     * @return Номер или 0, если событий ещё не было.
+     */
+    uint64_t getLastSequence() const;
+
+    /**
+     * @brief Перебирает события с номерами больше afterSequence.
+     * @param[in] afterSequence Номер последнего события, уже известного клиенту (0 - с начала).
+     * @param[in] limit Максимальное число событий.
+     * @param[in] visit Функция, вызываемая для каждого события под мьютексом ленты;
+     * не должна изменять сеть.
+     * @return Итог выборки.
+     * @details Если события после afterSequence уже вытеснены из буфера или номер
+     * больше последнего (лента другой сети), возвращается resyncRequired без событий.
+     */
+    template <typename Visitor>
+    ChangeFetchResult visitSince(uint64_t afterSequence, size_t limit, Visitor&& visit) const {
+        std::lock_guard lock(mutex);
+        ChangeFetchResult result;
+        result.lastSequence = lastSequence;
+        const uint64_t oldest = lastSequence > ring.size() ? lastSequence - ring.size() + 1 : 1;
+        if (afterSequence > lastSequence || afterSequence + 1 < oldest) {
+            result.resyncRequired = true;
+            return result;
+        }
+        const uint64_t available = lastSequence - afterSequence;
+        result.count = available < limit ? static_cast<size_t>(available) : limit;
+        for (uint64_t sequence = afterSequence + 1; sequence <= afterSequence + result.count; ++sequence) {
+            visit(ring[(sequence - 1) & mask]);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Копирует события с номерами больше afterSequence.
+     * @param[in] afterSequence Номер последнего события, уже известного клиенту.
+     * @param[out] events Буфер для событий.
+     * @return Итог выборки (см. visitSince).
+     */
+    ChangeFetchResult fetchSince(uint64_t afterSequence, std::span<ChangeEvent> events) const;
+
+    void onEntityAdded(const Domain& parent, const NetworkEntity& entity) override;
+    void onEntityRemoved(const Domain& parent, const NetworkEntity& entity) override;
+    void onStorageUsageChanged(const DataStorage& storage, double previousUsedMB) override;
+    void onTrustedUserAdded(const DataStorage& storage, Symbol user) override;
+    void onTrustedUserRemoved(const DataStorage& storage, Symbol user) override;
+    void onPowerOnTimeChanged(const Workstation& workstation, time_t previousTime) override;
+};
+
+/** @} */ // Конец группы network_module
@@ -0,0 +1,344 @@
+﻿/**
+ * @file CommandBuffer.cpp
+ * @brief Реализация пакетного буфера команд.
+ */
+
+#include "CommandBuffer.h"
+#include "DataStorage.h"
+#include "Printer.h"
+#include "Workstation.h"
+#include <bit>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+    /**
+     * @brief Последовательное чтение полей команды с проверкой границ.
+     */
+    class CommandReader {
+    private:
+        std::span<const std::byte> buffer;
+        size_t position = 0;
+
+        uint64_t readLittleEndian(size_t width) {
+            if (buffer.size() - position < width) {
+                throw ValidationException("Команда обрезана");
+            }
+            uint64_t value = 0;
+            for (size_t i = 0; i < width; ++i) {
+                value |= uint64_t(std::to_integer<uint8_t>(buffer[position + i])) << (8 * i);
+            }
+            position += width;
+            return value;
+        }
+
+    public:
+        explicit CommandReader(std::span<const std::byte> buffer) : buffer(buffer) {}
+
+        bool atEnd() const { return position == buffer.size(); }
+
+        uint8_t readByte() { return static_cast<uint8_t>(readLittleEndian(1)); }
+
+        void readString(std::string& value) {
+            const size_t length = static_cast<size_t>(readLittleEndian(2));
+            if (buffer.size() - position < length) {
+                throw ValidationException("Строка команды обрезана");
+            }
+            value.assign(reinterpret_cast<const char*>(buffer.data() + position), length);
+            position += length;
+        }
+
+        double readDouble() { return std::bit_cast<double>(readLittleEndian(8)); }
+
+        time_t readTime() { return static_cast<time_t>(static_cast<int64_t>(readLittleEndian(8))); }
+    };
+
+    template <typename T>
+    std::shared_ptr<T> requireEntity(const CorporateNetwork& network, const std::string& id) {
+        auto entity = entityCast<T>(network.findEntity(id));
+        if (!entity) {
+            throw EntityNotFoundException("'" + id + "' отсутствует в сети или имеет другой тип");
+        }
+        return entity;
+    }
+
+    /**
+     * @brief Разобранная команда; строки переиспользуют выделенную память между командами.
+     */
+    struct DecodedCommand {
+        CommandOpcode opcode{};
+        std::string text[5];      ///< Строковые поля в порядке кодирования
+        double number = 0;        ///< Объём или его изменение
+        time_t time = 0;          ///< Время включения
+    };
+
+    /**
+     * @brief Разбирает одну команду.
+     * @details Разбор отделён от выполнения, чтобы ошибка выполнения не путалась с ошибкой формата.
+     */
+    void decode(CommandReader& reader, DecodedCommand& command) {
+        command.opcode = static_cast<CommandOpcode>(reader.readByte());
+        auto readStrings = [&](size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                reader.readString(command.text[i]);
+            }
+        };
+        switch (command.opcode) {
+        case CommandOpcode::AddStorage:
+            readStrings(4);
+            command.number = reader.readDouble();
+            return;
+        case CommandOpcode::AddWorkstation:
+            readStrings(5);
+            command.time = reader.readTime();
+            return;
+        case CommandOpcode::AddPrinter:
+        case CommandOpcode::AddDomain:
+            readStrings(4);
+            return;
+        case CommandOpcode::Remove:
+        case CommandOpcode::TrustedUserAdd:
+        case CommandOpcode::TrustedUserRemove:
+            readStrings(2);
+            return;
+        case CommandOpcode::StorageDelta:
+            readStrings(1);
+            command.number = reader.readDouble();
+            return;
+        case CommandOpcode::PowerOn:
+            readStrings(1);
+            command.time = reader.readTime();
+            return;
+        }
+        throw ValidationException("Неизвестный код команды " + std::to_string(static_cast<int>(command.opcode)));
+    }
+
+    /**
+     * @brief Выполняет разобранную команду над сетью.
+     */
+    void apply(CorporateNetwork& network, const DecodedCommand& command) {
+        const auto& text = command.text;
+        switch (command.opcode) {
+        case CommandOpcode::AddStorage:
+            network.addEntityToDomain(text[0], std::make_shared<DataStorage>(text[2], text[3], command.number), text[1]);
+            break;
+        case CommandOpcode::AddWorkstation:
+            network.addEntityToDomain(text[0],
+                std::make_shared<Workstation>(text[2], text[3], text[4], command.time), text[1]);
+            break;
+        case CommandOpcode::AddPrinter:
+            network.addEntityToDomain(text[0], std::make_shared<Printer>(text[2], text[3]), text[1]);
+            break;
+        case CommandOpcode::AddDomain:
+            network.addEntityToDomain(text[0], std::make_shared<Domain>(text[2], text[3]), text[1]);
+            break;
+        case CommandOpcode::Remove:
+            if (!network.findEntity(text[0])) {
+                throw EntityNotFoundException("'" + text[0] + "' отсутствует в сети");
+            }
+            network.removeEntity(text[0], text[1]);
+            break;
+        case CommandOpcode::StorageDelta: {
+            auto storage = requireEntity<DataStorage>(network, text[0]);
+            if (command.number >= 0) {
+                *storage += command.number;
+            }
+            else {
+                *storage -= -command.number;
+            }
+            break;
+        }
+        case CommandOpcode::TrustedUserAdd:
+            requireEntity<DataStorage>(network, text[0])->addTrustedUser(text[1]);
+            break;
+        case CommandOpcode::TrustedUserRemove:
+            requireEntity<DataStorage>(network, text[0])->removeTrustedUser(text[1]);
+            break;
+        case CommandOpcode::PowerOn:
+            requireEntity<Workstation>(network, text[0])->updatePowerOnTime(command.time);
+            break;
+        }
+    }
+
+    /**
+     * @brief Разбирает и выполняет очередную команду.
+     * @param[in,out] error Текст ошибки; перезаписывается, если команда не выполнена.
+     * @return Статус команды; Malformed означает, что граница следующей команды неизвестна.
+     */
+    CommandStatus executeNext(CorporateNetwork& network, CommandReader& reader, DecodedCommand& command,
+        std::string& error) {
+        try {
+            decode(reader, command);
+        }
+        catch (const std::exception& e) {
+            error = e.what();
+            return CommandStatus::Malformed;
+        }
+
+        try {
+            apply(network, command);
+            return CommandStatus::Ok;
+        }
+        catch (const AccessDeniedException& e) {
+            error = e.what();
+            return CommandStatus::AccessDenied;
+        }
+        catch (const ValidationException& e) {
+            error = e.what();
+            return CommandStatus::Validation;
+        }
+        catch (const DeviceOperationException& e) {
+            error = e.what();
+            return CommandStatus::DeviceOperation;
+        }
+        catch (const DomainOperationException& e) {
+            error = e.what();
+            return CommandStatus::DomainOperation;
+        }
+        catch (const EntityNotFoundException& e) {
+            error = e.what();
+            return CommandStatus::NotFound;
+        }
+        catch (const std::exception& e) {
+            error = e.what();
+            return CommandStatus::Failed;
+        }
+    }
+
+}
+
+void CommandBufferWriter::putOpcode(CommandOpcode opcode) {
+    bytes.push_back(static_cast<std::byte>(opcode));
+    ++commandCount;
+}
+
+void CommandBufferWriter::putString(std::string_view value) {
+    if (value.size() > std::numeric_limits<uint16_t>::max()) {
+        throw ValidationException("Строка команды длиннее 65535 байт");
+    }
+    bytes.push_back(static_cast<std::byte>(value.size() & 0xFF));
+    bytes.push_back(static_cast<std::byte>(value.size() >> 8));
+    const auto* data = reinterpret_cast<const std::byte*>(value.data());
+    bytes.insert(bytes.end(), data, data + value.size());
+}
+
+void CommandBufferWriter::putInt64(int64_t value) {
+    const auto bits = static_cast<uint64_t>(value);
+    for (int i = 0; i < 8; ++i) {
+        bytes.push_back(static_cast<std::byte>((bits >> (8 * i)) & 0xFF));
+    }
+}
+
+void CommandBufferWriter::putDouble(double value) {
+    putInt64(static_cast<int64_t>(std::bit_cast<uint64_t>(value)));
+}
+
+CommandBufferWriter& CommandBufferWriter::addStorage(std::string_view domain, std::string_view user,
+    std::string_view id, std::string_view mac, double totalMB) {
+    putOpcode(CommandOpcode::AddStorage);
+    putString(domain);
+    putString(user);
+    putString(id);
+    putString(mac);
+    putDouble(totalMB);
+    return *this;
+}
+
+CommandBufferWriter& CommandBufferWriter::addWorkstation(std::string_view domain, std::string_view user,
+    std::string_view id, std::string_view mac, std::string_view assignedUser, time_t powerOnTime) {
+    putOpcode(CommandOpcode::AddWorkstation);
+    putString(domain);
+    putString(user);
+    putString(id);
+    putString(mac);
+    putString(assignedUser);
+    putInt64(powerOnTime);
+    return *this;
+}
+
+CommandBufferWriter& CommandBufferWriter::addPrinter(std::string_view domain, std::string_view user,
+    std::string_view id, std::string_view mac) {
+    putOpcode(CommandOpcode::AddPrinter);
+    putString(domain);
+    putString(user);
+    putString(id);
+    putString(mac);
+    return *this;
+}
+
+CommandBufferWriter& CommandBufferWriter::addDomain(std::string_view parent, std::string_view user,
+    std::string_view id, std::string_view admin) {
+    putOpcode(CommandOpcode::AddDomain);
+    putString(parent);
+    putString(user);
+    putString(id);
+    putString(admin);
+    return *this;
+}
+
+CommandBufferWriter& CommandBufferWriter::remove(std::string_view id, std::string_view user) {
+    putOpcode(CommandOpcode::Remove);
+    putString(id);
+    putString(user);
+    return *this;
+}
+
+CommandBufferWriter& CommandBufferWriter::storageDelta(std::string_view id, double deltaMB) {
+    putOpcode(CommandOpcode::StorageDelta);
+    putString(id);
+    putDouble(deltaMB);
+    return *this;
+}
+
+CommandBufferWriter& CommandBufferWriter::addTrustedUser(std::string_view storageId, std::string_view user) {
+    putOpcode(CommandOpcode::TrustedUserAdd);
+    putString(storageId);
+    putString(user);
+    return *this;
+}
+
+CommandBufferWriter& CommandBufferWriter::removeTrustedUser(std::string_view storageId, std::string_view user) {
+    putOpcode(CommandOpcode::TrustedUserRemove);
+    putString(storageId);
+    putString(user);
+    return *this;
+}
+
+CommandBufferWriter& CommandBufferWriter::powerOn(std::string_view workstationId, time_t powerOnTime) {
+    putOpcode(CommandOpcode::PowerOn);
+    putString(workstationId);
+    putInt64(powerOnTime);
+    return *this;
+}
+
+template <typename StatusSink>
+CommandBatchResult CommandBufferExecutor::executeWith(CorporateNetwork& network, std::span<const std::byte> buffer,
+    size_t capacity, StatusSink&& store) {
+    CommandBatchResult result;
+    CommandReader reader(buffer);
+    DecodedCommand command;
+    while (!reader.atEnd() && result.processed < capacity) {
+        const CommandStatus status = executeNext(network, reader, command, result.lastError);
+        store(result.processed++, status);
+        if (status != CommandStatus::Ok) {
+            ++result.failed;
+        }
+        if (status == CommandStatus::Malformed) {
+            break;
+        }
+    }
+    return result;
+}
+
+CommandBatchResult CommandBufferExecutor::execute(CorporateNetwork& network, std::span<const std::byte> buffer,
+    std::span<CommandStatus> statuses) {
+    return executeWith(network, buffer, statuses.size(),
+        [&](size_t position, CommandStatus status) { statuses[position] = status; });
+}
+
+CommandBatchResult CommandBufferExecutor::execute(CorporateNetwork& network, std::span<const std::byte> buffer,
+    std::span<int> statuses) {
+    return executeWith(network, buffer, statuses.size(),
+        [&](size_t position, CommandStatus status) { statuses[position] = static_cast<int>(status); });
+}
@@ -0,0 +1,196 @@
+﻿/**
+ * @file CommandBuffer.h
+ * @brief Заголовочный файл пакетного буфера команд для C API.
+ */
+
+#pragma once
+
+#include "CorporateNetwork.h"
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+ /**
+  * @defgroup command_module Модуль пакетных команд
+  * @brief Выполнение множества изменений сети за один вызов через границу FFI
+  * @{
+  */
+
+  /**
+   * @brief Код команды в буфере.
+   *
+   * Каждая команда - байт кода и поля в указанном порядке. Строки кодируются
+   * как длина (uint16, little-endian) и байты UTF-8, числа с плавающей точкой -
+   * как IEEE-754 double (8 байт, little-endian), время - как int64 (8 байт, little-endian).
+   */
+enum class CommandOpcode : uint8_t {
+    AddStorage = 1,           ///< domain, user, id, mac, totalMB
+    AddWorkstation = 2,       ///< domain, user, id, mac, assignedUser, powerOnTime
+    AddPrinter = 3,           ///< domain, user, id, mac
+    AddDomain = 4,            ///< parent, user, id, admin
+    Remove = 5,               ///< id, user
+    StorageDelta = 6,         ///< id, deltaMB (положительное - запись, отрицательное - освобождение)
+    TrustedUserAdd = 7,       ///< storageId, user
+    TrustedUserRemove = 8,    ///< storageId, user
+    PowerOn = 9               ///< workstationId, powerOnTime
+};
+
+/**
+ * @brief Компактный код результата команды.
+ */
+enum class CommandStatus : int32_t {
+    Ok = 0,                   ///< Команда выполнена
+    AccessDenied = 1,         ///< AccessDeniedException
+    Validation = 2,           ///< ValidationException
+    DeviceOperation = 3,      ///< DeviceOperationException
+    DomainOperation = 4,      ///< DomainOperationException
+    NotFound = 5,             ///< EntityNotFoundException: сущность не найдена или имеет другой тип
+    Malformed = 6,            ///< Команда не разобрана; выполнение пакета прекращено
+    Failed = 7                ///< Прочая ошибка
+};
+
+/**
+ * @brief Построитель буфера команд.
+ */
+class CommandBufferWriter {
+private:
+    std::vector<std::byte> bytes;   ///< Закодированные команды
+    size_t commandCount = 0;        ///< Число команд в буфере
+
+    void putOpcode(CommandOpcode opcode);
+    void putString(std::string_view value);
+    void putDouble(double value);
+    void putInt64(int64_t value);
+
+public:
+    /**
+     * @brief Добавляет команду создания хранилища данных.
+     * @param[in] domain Домен-получатель (пусто - корневой).
+     * @param[in] user Пользователь, выполняющий операцию.
+     * @param[in] id Идентификатор хранилища.
+     * @param[in] mac MAC-адрес.
+     * @param[in] totalMB Общий объём в МБ.
+     * @return Ссылка на построитель.
+     */
+    CommandBufferWriter& addStorage(std::string_view domain, std::string_view user, std::string_view id,
+        std::string_view mac, double totalMB);
+
+    /**
+     * @brief Добавляет команду создания рабочей станции.
+     * @return Ссылка на построитель.
+     */
+    CommandBufferWriter& addWorkstation(std::string_view domain, std::string_view user, std::string_view id,
+        std::string_view mac, std::string_view assignedUser, time_t powerOnTime);
+
+    /**
+     * @brief Добавляет команду создания принтера.
+     * @return Ссылка на построитель.
+     */
+    CommandBufferWriter& addPrinter(std::string_view domain, std::string_view user, std::string_view id,
+        std::string_view mac);
+
+    /**
+     * @brief Добавляет команду создания поддомена.
+     * @return Ссылка на построитель.
+     */
+    CommandBufferWriter& addDomain(std::string_view parent, std::string_view user, std::string_view id,
+        std::string_view admin);
+
+    /**
+     * @brief Добавляет команду удаления сущности.
+     * @return Ссылка на построитель.
+     */
+    CommandBufferWriter& remove(std::string_view id, std::string_view user);
+
+    /**
+     * @brief Добавляет команду изменения занятого объёма хранилища.
+     * @param[in] id Идентификатор хранилища.
+     * @param[in] deltaMB Изменение в МБ: положительное - запись, отрицательное - освобождение.
+     * @return Ссылка на построитель.
+     */
+    CommandBufferWriter& storageDelta(std::string_view id, double deltaMB);
+
+    /**
+     * @brief Добавляет команду добавления доверенного пользователя хранилища.
+     * @return Ссылка на построитель.
+     */
+    CommandBufferWriter& addTrustedUser(std::string_view storageId, std::string_view user);
+
+    /**
+     * @brief Добавляет команду удаления доверенного пользователя хранилища.
+     * @return Ссылка на построитель.
+     */
+    CommandBufferWriter& removeTrustedUser(std::string_view storageId, std::string_view user);
+
+    /**
+     * @brief Добавляет команду обновления времени включения рабочей станции.
+     * @return Ссылка на построитель.
+     */
+    CommandBufferWriter& powerOn(std::string_view workstationId, time_t powerOnTime);
+
+    /**
+     * @brief Возвращает закодированный буфер.
+     * @return Байты команд.
+     */
+    std::span<const std::byte> data() const { return bytes; }
+
+    /**
+     * @brief Возвращает число команд.
+     * @return Число закодированных команд.
+     */
+    size_t size() const { return commandCount; }
+};
+
+/**
+ * @brief Итог выполнения буфера команд.
+ */
+struct CommandBatchResult {
+    size_t processed = 0;        ///< Число обработанных команд (включая неуспешные)
+    size_t failed = 0;           ///< Число команд с ненулевым статусом
+    std::string lastError;       ///< Текст последней ошибки
+};
+
+/**
+ * @brief Исполнитель буфера команд.
+ *
+ * Команды выполняются по порядку; ошибка одной команды записывается в её
+ * статус и не прерывает остальные. Неразборчивая команда получает статус
+ * Malformed, после чего выполнение прекращается, так как граница следующей
+ * команды неизвестна.
+ */
+class CommandBufferExecutor {
+private:
+    /**
+     * @brief Выполняет команды, передавая статус каждой команды в store(позиция, статус).
+     */
+    template <typename StatusSink>
+    static CommandBatchResult executeWith(CorporateNetwork& network, std::span<const std::byte> buffer,
+        size_t capacity, StatusSink&& store);
+
+public:
+    /**
+     * @brief Выполняет команды буфера над сетью.
+     * @param[in,out] network Изменяемая сеть.
+     * @param[in] buffer Закодированные команды.
+     * @param[out] statuses Статус каждой команды; выполняется не больше statuses.size() команд.
+     * @return Итог выполнения.
+     */
+    static CommandBatchResult execute(CorporateNetwork& network, std::span<const std::byte> buffer,
+        std::span<CommandStatus> statuses);
+
+    /**
+     * @brief Выполняет команды буфера, записывая статусы целыми кодами CommandStatus (для C API).
+     * @param[in,out] network Изменяемая сеть.
+     * @param[in] buffer Закодированные команды.
+     * @param[out] statuses Код статуса каждой команды; выполняется не больше statuses.size() команд.
+     * @return Итог выполнения.
+     */
+    static CommandBatchResult execute(CorporateNetwork& network, std::span<const std::byte> buffer,
+        std::span<int> statuses);
+};
+
+/** @} */ // Конец группы command_module
@@ -4,41 +4,191 @@
  */
 
 #include "CorporateNetwork.h"
+#include "ChangeFeed.h"
+#include "DataStorage.h"
+#include "Workstation.h"
 #include <iostream>
+#include <limits>
+#include <unordered_set>
 
-CorporateNetwork::CorporateNetwork(const std::string& rootAdminId) {
+CorporateNetwork::CorporateNetwork(const std::string& rootAdminId)
+    : observers(std::make_unique<NetworkObserverList>()), capacity(std::make_unique<CapacityTable>()),
+    storageAccess(std::make_unique<StorageAccessIndex>()), powerOnTimes(std::make_unique<PowerOnTimeIndex>()),
+    reservations(std::make_unique<CapacityReservations>()) {
+    observers->add(storageAccess.get());
+    observers->add(powerOnTimes.get());
     rootDomain = std::make_shared<Domain>("root_domain", rootAdminId);
     collectAllEntities(rootDomain);
 }
 
+CorporateNetwork::~CorporateNetwork() {
+    releaseObservers();
+}
+
+CorporateNetwork::CorporateNetwork(CorporateNetwork&& other) noexcept
+    : rootDomain(std::move(other.rootDomain)), index(std::move(other.index)), observers(std::move(other.observers)),
+    changeFeed(std::move(other.changeFeed)), capacity(std::move(other.capacity)),
+    storageAccess(std::move(other.storageAccess)), workstationUsers(std::move(other.workstationUsers)),
+    powerOnTimes(std::move(other.powerOnTimes)), reservations(std::move(other.reservations)),
+    version(other.version.load()) {
+}
+
+CorporateNetwork& CorporateNetwork::operator=(CorporateNetwork&& other) noexcept {
+    if (this != &other) {
+        releaseObservers();
+        // Прежние резервы возвращаются, пока таблица ёмкости их хранилищ ещё жива
+        reservations = std::move(other.reservations);
+        rootDomain = std::move(other.rootDomain);
+        index = std::move(other.index);
+        observers = std::move(other.observers);
+        changeFeed = std::move(other.changeFeed);
+        capacity = std::move(other.capacity);
+        storageAccess = std::move(other.storageAccess);
+        workstationUsers = std::move(other.workstationUsers);
+        powerOnTimes = std::move(other.powerOnTimes);
+        version.store(other.version.load());
+    }
+    return *this;
+}
+
+void CorporateNetwork::releaseObservers() noexcept {
+    if (!observers) {
+        return; // Сеть была перемещена
+    }
+    index.forEach([this](const EntityIndexEntry& entry) {
+        NetworkObserver* expected = observers.get();
+        entry.entity->observer.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+        if (auto* storage = entityCast<DataStorage>(entry.entity.get())) {
+            capacity->unpublish(*storage);
+        }
+    });
+    // Список наблюдателей, таблица ёмкости и индексы уничтожаются вместе с сетью
+    // только после завершения изменений, которые устройства уже начали
+    EpochManager::instance().synchronize();
+}
+
+void CorporateNetwork::addObserver(NetworkObserver* observer) {
+    std::lock_guard lock(writerMutex);
+    observers->add(observer);
+}
+
+void CorporateNetwork::removeObserver(NetworkObserver* observer) {
+    {
+        std::lock_guard lock(writerMutex);
+        observers->remove(observer);
+    }
+    EpochManager::instance().synchronize();
+}
+
+ChangeFeed& CorporateNetwork::enableChangeFeed(size_t capacity) {
+    std::lock_guard lock(writerMutex);
+    if (!changeFeed) {
+        changeFeed = std::make_unique<ChangeFeed>(capacity);
+        observers->add(changeFeed.get());
+    }
+    return *changeFeed;
+}
+
+ChangeFeed* CorporateNetwork::getChangeFeed() const {
+    std::lock_guard lock(writerMutex);
+    return changeFeed.get();
+}
+
 std::shared_ptr<Domain> CorporateNetwork::getRootDomain() const {
     return rootDomain;
 }
 
 void CorporateNetwork::addEntityToDomain(const std::string& domainId, std::shared_ptr<NetworkEntity> entity, const std::string& user) {
+    std::lock_guard lock(writerMutex);
+
     // Если domainId пустой, добавляем в корневой домен
-    auto targetDomain = (domainId.empty()) ? rootDomain : findDomainRecursive(rootDomain, domainId);
+    auto targetDomain = findDomain(domainId);
     if (!targetDomain) {
         throw DomainOperationException("Домен с идентификатором '" + domainId + "' не найден");
     }
 
+    if (entity) {
+        ensureNotInNetwork(*entity);
+    }
+
     targetDomain->addEntity(entity, user);
-    allEntities[entity->getId()] = entity;
+    index.assign(entity, targetDomain);
+    bindEntity(*entity, *targetDomain);
 
     // Если добавляется домен, то нужно собрать его сущности
-    if (auto newDomain = std::dynamic_pointer_cast<Domain>(entity)) {
+    if (auto newDomain = entityCast<Domain>(entity)) {
         collectAllEntities(newDomain);
     }
+    bumpVersion();
+    observers->onEntityAdded(*targetDomain, *entity);
+}
+
+void CorporateNetwork::addEntitiesToDomain(const std::string& domainId,
+    std::span<const std::shared_ptr<NetworkEntity>> batch, const std::string& user) {
+    std::lock_guard lock(writerMutex);
+
+    auto targetDomain = findDomain(domainId);
+    if (!targetDomain) {
+        throw DomainOperationException("Домен с идентификатором '" + domainId + "' не найден");
+    }
+    // Права проверяются до поиска дубликатов: иначе сообщения о них раскрывают
+    // идентификаторы сети пользователю без прав
+    targetDomain->checkAdminRights(user);
+
+    // Один проход сбора: сущности пакета и все их вложенные сущности с владельцами
+    DetachedSubtree pending;
+    pending.members.reserve(batch.size());
+    pending.owners.reserve(batch.size());
+    for (const auto& entity : batch) {
+        if (!entity) {
+            continue; // Пустая сущность будет отклонена Domain::addEntities
+        }
+        pending.members.push_back(entity);
+        pending.owners.push_back(targetDomain);
+        if (entity->kind() == EntityKind::Domain) {
+            collectSubtreeMembers(std::static_pointer_cast<Domain>(entity), pending);
+        }
+    }
+
+    // Один проход поиска дубликатов: против сети и внутри пакета
+    std::unordered_set<Symbol> seen;
+    seen.reserve(pending.members.size());
+    for (const auto& member : pending.members) {
+        const Symbol memberId = member->getIdSymbol();
+        if (!seen.insert(memberId).second || index.find(memberId.view())) {
+            throw DomainOperationException("Сущность с идентификатором '" + member->getId() +
+                "' уже существует в сети");
+        }
+    }
+
+    // Права, валидация и дубликаты внутри домена; бросает исключение до изменения домена
+    targetDomain->addEntities(batch, user);
+
+    index.reserveAdditional(pending.size());
+    indexSubtree(pending);
+    bumpVersion();
+
+    if (!observers->empty()) {
+        for (const auto& entity : batch) {
+            observers->onEntityAdded(*targetDomain, *entity);
+        }
+    }
 }
 
 void CorporateNetwork::removeEntity(const std::string& entityId, const std::string& user) {
+    detachSubtree(entityId, user);
+}
+
+DetachedSubtree CorporateNetwork::detachSubtree(const std::string& entityId, const std::string& user) {
+    std::lock_guard lock(writerMutex);
+
     auto entity = findEntity(entityId);
     if (!entity) {
         throw DomainOperationException("Сущность с идентификатором '" + entityId + "' не найдена");
     }
 
     // Находим домен, содержащий эту сущность
-    auto domain = findDomainContainingEntity(rootDomain, entityId);
+    auto domain = getParentDomain(entityId);
     if (!domain) {
         throw DomainOperationException("Не удалось найти домен, содержащий сущность '" + entityId + "'");
     }
@@ -46,20 +196,201 @@ void CorporateNetwork::removeEntity(const std::string& entityId, const std::stri
     // Удаляем из домена (метод бросает исключения при ошибках)
     domain->removeEntity(entityId, user);
 
-    // Удаляем из общего списка
-    allEntities.erase(entityId);
+    DetachedSubtree subtree;
+    subtree.members.push_back(entity);
+    subtree.owners.push_back(nullptr);
+    if (entity->kind() == EntityKind::Domain) {
+        collectSubtreeMembers(std::static_pointer_cast<Domain>(entity), subtree);
+    }
+
+    // Удаляем всё поддерево из общего списка и индексов
+    for (const auto& member : subtree.members) {
+        index.erase(member->getIdSymbol().view());
+    }
+    unbindEntities(subtree.members);
+    bumpVersion();
+    // Записи индекса держат сущности до окончания льготного периода; без активных
+    // читателей они освобождаются сразу, и поддерево остаётся единственным владельцем
+    EpochManager::instance().collect();
+
+    observers->onEntityRemoved(*domain, *entity);
+    return subtree;
+}
+
+void CorporateNetwork::attachSubtree(const std::string& domainId, DetachedSubtree&& subtree, const std::string& user) {
+    if (subtree.empty()) {
+        throw ValidationException("Попытка присоединить пустое поддерево");
+    }
+
+    std::lock_guard lock(writerMutex);
+
+    auto targetDomain = findDomain(domainId);
+    if (!targetDomain) {
+        throw DomainOperationException("Домен с идентификатором '" + domainId + "' не найден");
+    }
+
+    for (const auto& member : subtree.members) {
+        if (index.find(member->getIdSymbol().view())) {
+            throw DomainOperationException("Сущность с идентификатором '" + member->getId() +
+                "' уже существует в сети");
+        }
+    }
+
+    targetDomain->addEntity(subtree.members.front(), user);
+    subtree.owners.front() = targetDomain;
+    index.reserveAdditional(subtree.size());
+    indexSubtree(subtree);
+    bumpVersion();
+    observers->onEntityAdded(*targetDomain, *subtree.members.front());
+
+    subtree.members.clear();
+    subtree.owners.clear();
 }
 
 std::shared_ptr<NetworkEntity> CorporateNetwork::findEntity(const std::string& entityId) const {
-    auto it = allEntities.find(entityId);
-    if (it != allEntities.end()) {
-        return it->second;
+    EpochGuard guard;
+    const EntityIndexEntry* entry = index.find(entityId);
+    return entry ? entry->entity : nullptr;
+}
+
+std::shared_ptr<Domain> CorporateNetwork::getParentDomain(const std::string& entityId) const {
+    EpochGuard guard;
+    const EntityIndexEntry* entry = index.find(entityId);
+    return entry ? entry->parent : nullptr;
+}
+
+std::shared_ptr<Domain> CorporateNetwork::findDomain(const std::string& domainId) const {
+    if (domainId.empty()) {
+        return rootDomain;
+    }
+    EpochGuard guard;
+    const EntityIndexEntry* entry = index.find(domainId);
+    if (entry && entry->entity->kind() == EntityKind::Domain) {
+        return std::static_pointer_cast<Domain>(entry->entity);
     }
     return nullptr;
 }
 
+CapacityTotals CorporateNetwork::getCapacityTotals() const {
+    return readCapacity([](const CapacityTable& table) { return table.sum(); });
+}
+
+DomainSummary CorporateNetwork::getDomainSummary(const std::string& domainId) const {
+    std::lock_guard lock(writerMutex);
+    auto domain = findDomain(domainId);
+    if (!domain) {
+        throw DomainOperationException("Домен с идентификатором '" + domainId + "' не найден");
+    }
+    return domain->getSubtreeSummary();
+}
+
+std::vector<std::shared_ptr<DataStorage>> CorporateNetwork::getStoragesForUser(const std::string& user) const {
+    std::vector<std::shared_ptr<DataStorage>> result;
+    const auto userSymbol = Symbol::lookup(user);
+    if (!userSymbol) {
+        return result;
+    }
+
+    std::lock_guard lock(writerMutex);
+    const std::vector<Symbol> storageIds = storageAccess->storagesFor(*userSymbol);
+    result.reserve(storageIds.size());
+    EpochGuard guard;
+    for (Symbol storageId : storageIds) {
+        if (const EntityIndexEntry* entry = index.find(storageId.view())) {
+            if (auto storage = entityCast<DataStorage>(entry->entity)) {
+                result.push_back(std::move(storage));
+            }
+        }
+    }
+    return result;
+}
+
+const Domain* CorporateNetwork::resolveScope(const std::string& domainId) const {
+    if (domainId.empty()) {
+        return nullptr;
+    }
+    auto domain = findDomain(domainId);
+    if (!domain) {
+        throw DomainOperationException("Домен с идентификатором '" + domainId + "' не найден");
+    }
+    // Поиск во всей сети не требует проверки владельцев
+    return domain == rootDomain ? nullptr : domain.get();
+}
+
+bool CorporateNetwork::isInScope(const NetworkEntity& entity, const Domain* scope) noexcept {
+    if (!scope) {
+        return true;
+    }
+    const Domain* domain = entity.getOwnerDomain();
+    while (domain && domain != scope) {
+        domain = domain->getOwnerDomain();
+    }
+    return domain != nullptr;
+}
+
+void CorporateNetwork::collectUserWorkstations(Symbol user, const Domain* scope,
+    std::vector<std::shared_ptr<Workstation>>& result) const {
+    for (Workstation* workstation : workstationUsers.find(user)) {
+        if (!isInScope(*workstation, scope)) {
+            continue;
+        }
+        if (const EntityIndexEntry* entry = index.find(workstation->getIdSymbol().view())) {
+            result.push_back(std::static_pointer_cast<Workstation>(entry->entity));
+        }
+    }
+}
+
+std::vector<std::shared_ptr<Workstation>> CorporateNetwork::getWorkstationsForUser(const std::string& user,
+    const std::string& domainId) const {
+    return std::move(getWorkstationsForUsers(std::span(&user, 1), domainId).front());
+}
+
+std::vector<std::vector<std::shared_ptr<Workstation>>> CorporateNetwork::getWorkstationsForUsers(
+    std::span<const std::string> users, const std::string& domainId) const {
+    std::lock_guard lock(writerMutex);
+    const Domain* scope = resolveScope(domainId);
+
+    EpochGuard guard;
+    std::vector<std::vector<std::shared_ptr<Workstation>>> result(users.size());
+    for (size_t i = 0; i < users.size(); ++i) {
+        // Строка, отсутствующая в пуле, не может быть пользователем станции
+        if (const auto userSymbol = Symbol::lookup(users[i])) {
+            collectUserWorkstations(*userSymbol, scope, result[i]);
+        }
+    }
+    return result;
+}
+
+std::vector<std::shared_ptr<Workstation>> CorporateNetwork::getWorkstationsPoweredOnBetween(time_t from, time_t to,
+    const std::string& domainId) const {
+    std::lock_guard lock(writerMutex);
+    const Domain* scope = resolveScope(domainId);
+
+    EpochGuard guard;
+    std::vector<std::shared_ptr<Workstation>> result;
+    powerOnTimes->visitRange(from, to, [&](Workstation& workstation) {
+        if (!isInScope(workstation, scope)) {
+            return;
+        }
+        if (const EntityIndexEntry* entry = index.find(workstation.getIdSymbol().view())) {
+            result.push_back(std::static_pointer_cast<Workstation>(entry->entity));
+        }
+    });
+    return result;
+}
+
+std::vector<std::shared_ptr<Workstation>> CorporateNetwork::getWorkstationsPoweredOnBefore(time_t before,
+    const std::string& domainId) const {
+    return getWorkstationsPoweredOnBetween(std::numeric_limits<time_t>::min(), before, domainId);
+}
+
+size_t CorporateNetwork::getEntityCount() const {
+    return index.size();
+}
+
 void CorporateNetwork::printDomainInfo(const std::string& domainId) const {
-    auto domain = (domainId.empty()) ? rootDomain : findDomainRecursive(rootDomain, domainId);
+    std::lock_guard lock(writerMutex);
+    auto domain = findDomain(domainId);
     if (!domain) {
         std::cout << "Домен не найден" << std::endl;
         return;
@@ -69,63 +400,104 @@ void CorporateNetwork::printDomainInfo(const std::string& domainId) const {
 }
 
 void CorporateNetwork::printNetworkInfo() const {
+    std::lock_guard lock(writerMutex);
     std::cout << "=== КОРПОРАТИВНАЯ СЕТЬ ===" << std::endl;
-    std::cout << "Общее количество сущностей: " << allEntities.size() << std::endl;
+    std::cout << "Общее количество сущностей: " << index.size() << std::endl;
     std::cout << "Корневой домен: " << rootDomain->getId() << " (админ: " << rootDomain->getAdminId() << ")" << std::endl;
+    const DomainSummary summary = rootDomain->getSubtreeSummary();
+    std::cout << "Доменов: " << summary.count(EntityKind::Domain)
+        << ", хранилищ: " << summary.count(EntityKind::DataStorage)
+        << ", рабочих станций: " << summary.count(EntityKind::Workstation)
+        << ", принтеров: " << summary.count(EntityKind::Printer) << std::endl;
+    std::cout << "Объём хранилищ: " << summary.usedStorageMB << " / " << summary.totalStorageMB << " MB" << std::endl;
     std::cout << "==========================" << std::endl;
 }
 
-void CorporateNetwork::collectAllEntities(std::shared_ptr<Domain> domain) {
+void CorporateNetwork::bindEntity(NetworkEntity& entity, const Domain& owner) {
+    entity.observer.store(observers.get(), std::memory_order_release);
+    if (auto* storage = entityCast<DataStorage>(&entity)) {
+        capacity->add(*storage, owner.getIdSymbol());
+        storageAccess->addStorage(*storage);
+    }
+    else if (auto* workstation = entityCast<Workstation>(&entity)) {
+        workstationUsers.add(*workstation);
+        powerOnTimes->add(*workstation);
+    }
+}
+
+void CorporateNetwork::unbindEntities(std::span<const std::shared_ptr<NetworkEntity>> members) noexcept {
+    for (const auto& member : members) {
+        member->observer.store(nullptr, std::memory_order_release);
+        if (auto* storage = entityCast<DataStorage>(member.get())) {
+            capacity->unpublish(*storage);
+        }
+    }
+    EpochManager::instance().synchronize();
+    for (const auto& member : members) {
+        unbindEntity(*member);
+    }
+}
+
+void CorporateNetwork::unbindEntity(NetworkEntity& entity) noexcept {
+    if (auto* storage = entityCast<DataStorage>(&entity)) {
+        capacity->remove(*storage);
+        storageAccess->removeStorage(*storage);
+    }
+    else if (auto* workstation = entityCast<Workstation>(&entity)) {
+        workstationUsers.remove(*workstation);
+        powerOnTimes->remove(*workstation);
+    }
+}
+
+void CorporateNetwork::collectAllEntities(const std::shared_ptr<Domain>& domain) {
     if (!domain) return;
 
-    // Добавляем сам домен
-    allEntities[domain->getId()] = domain;
+    // Добавляем сам домен; владелец уже записан вызывающим кодом (для корня - nullptr)
+    if (!index.find(domain->getIdSymbol().view())) {
+        index.assign(domain, nullptr);
+    }
+    domain->observer.store(observers.get(), std::memory_order_release);
 
     // Получаем все сущности домена
     const auto& entities = domain->getAllEntities();
-    for (const auto& pair : entities) {
-        auto entity = pair.second;
-        allEntities[entity->getId()] = entity;
+    for (const auto& [id, entity] : entities) {
+        index.assign(entity, domain);
+        bindEntity(*entity, *domain);
 
         // Если это домен, рекурсивно собираем его сущности
-        if (auto subDomain = std::dynamic_pointer_cast<Domain>(entity)) {
-            collectAllEntities(subDomain);
+        if (entity->kind() == EntityKind::Domain) {
+            collectAllEntities(std::static_pointer_cast<Domain>(entity));
         }
     }
 }
 
-std::shared_ptr<Domain> CorporateNetwork::findDomainRecursive(std::shared_ptr<Domain> domain, const std::string& domainId) const {
-    if (!domain) return nullptr;
-
-    if (domain->getId() == domainId) {
-        return domain;
-    }
-
-    const auto& entities = domain->getAllEntities();
-    for (const auto& pair : entities) {
-        if (auto subDomain = std::dynamic_pointer_cast<Domain>(pair.second)) {
-            auto found = findDomainRecursive(subDomain, domainId);
-            if (found) return found;
+void CorporateNetwork::collectSubtreeMembers(const std::shared_ptr<Domain>& domain, DetachedSubtree& subtree) const {
+    for (const auto& [id, entity] : domain->getAllEntities()) {
+        subtree.members.push_back(entity);
+        subtree.owners.push_back(domain);
+        if (entity->kind() == EntityKind::Domain) {
+            collectSubtreeMembers(std::static_pointer_cast<Domain>(entity), subtree);
         }
     }
-
-    return nullptr;
 }
 
-std::shared_ptr<Domain> CorporateNetwork::findDomainContainingEntity(std::shared_ptr<Domain> domain, const std::string& entityId) const {
-    if (!domain) return nullptr;
+void CorporateNetwork::indexSubtree(const DetachedSubtree& subtree) {
+    for (size_t i = 0; i < subtree.members.size(); ++i) {
+        const auto& member = subtree.members[i];
+        index.assign(member, subtree.owners[i]);
+        bindEntity(*member, *subtree.owners[i]);
+    }
+}
 
-    if (domain->findEntity(entityId)) {
-        return domain;
+void CorporateNetwork::ensureNotInNetwork(const NetworkEntity& entity) const {
+    if (index.find(entity.getIdSymbol().view())) {
+        throw DomainOperationException("Сущность с идентификатором '" + entity.getId() +
+            "' уже существует в сети");
     }
 
-    const auto& entities = domain->getAllEntities();
-    for (const auto& pair : entities) {
-        if (auto subDomain = std::dynamic_pointer_cast<Domain>(pair.second)) {
-            auto found = findDomainContainingEntity(subDomain, entityId);
-            if (found) return found;
+    if (auto domain = entityCast<Domain>(&entity)) {
+        for (const auto& pair : domain->getAllEntities()) {
+            ensureNotInNetwork(*pair.second);
         }
     }
-
-    return nullptr;
 }
\ No newline at end of file
@@ -5,11 +5,28 @@
 
 #pragma once
 
+#include "CapacityReservations.h"
+#include "CapacityTable.h"
 #include "Domain.h"
+#include "DetachedSubtree.h"
+#include "EntityIndex.h"
 #include "NetworkExceptions.h"
-#include <unordered_map>
+#include "NetworkObserver.h"
+#include "PowerOnTimeIndex.h"
+#include "StorageAccessIndex.h"
+#include "WorkstationUserIndex.h"
+#include <atomic>
+#include <cstdint>
+#include <ctime>
 #include <memory>
+#include <mutex>
+#include <span>
 #include <string>
+#include <string_view>
+#include <vector>
+
+class ChangeFeed;
+class Workstation;
 
  /**
   * @defgroup network_module Модуль корпоративной сети
@@ -21,33 +38,113 @@
    * @brief Класс, представляющий корпоративную сеть компании.
    *
    * Содержит корневой домен и обеспечивает управление всей сетью.
+   *
+   * Поиск по идентификатору (findEntity, getParentDomain, findDomain, withEntity)
+   * не берёт блокировок и может выполняться из любого числа потоков параллельно
+   * с изменениями: читатель видит либо состояние до операции, либо после неё.
+   * Изменяющие операции сериализуются внутренним мьютексом. Содержимое доменов
+   * (Domain::getAllEntities) и поля устройств по-прежнему требуют внешней
+   * синхронизации с писателями.
    */
 class CorporateNetwork {
 private:
     std::shared_ptr<Domain> rootDomain; ///< Корневой домен сети
-    std::unordered_map<std::string, std::shared_ptr<NetworkEntity>> allEntities; ///< Все сущности сети для быстрого поиска
+    EntityIndex index; ///< Все сущности сети с доменами-владельцами; читается без блокировок
+    std::unique_ptr<NetworkObserverList> observers; ///< Подписчики на изменения; адрес стабилен при перемещении сети
+    std::unique_ptr<ChangeFeed> changeFeed; ///< Лента изменений; создаётся при первом запросе
+    std::unique_ptr<CapacityTable> capacity; ///< Ёмкость всех хранилищ сети; адрес стабилен при перемещении сети
+    std::unique_ptr<StorageAccessIndex> storageAccess; ///< Хранилища каждого доверенного пользователя; подписан на observers
+    WorkstationUserIndex workstationUsers; ///< Рабочие станции каждого пользователя
+    std::unique_ptr<PowerOnTimeIndex> powerOnTimes; ///< Станции по времени включения; подписан на observers
+    std::unique_ptr<CapacityReservations> reservations; ///< Резервы места в хранилищах; уничтожается раньше индексов ёмкости
+    mutable std::mutex writerMutex; ///< Сериализует изменяющие операции
+    std::atomic<uint64_t> version{ 0 }; ///< Счётчик структурных изменений (добавление, удаление, перенос)
+
+    /**
+     * @brief Отмечает структурное изменение сети. Вызывается под writerMutex.
+     */
+    void bumpVersion() noexcept { version.fetch_add(1, std::memory_order_release); }
+
+    /**
+     * @brief Отвязывает сущности сети от её списка наблюдателей.
+     * @details Возвращается после завершения уведомлений, начатых другими потоками.
+     */
+    void releaseObservers() noexcept;
+
+    /**
+     * @brief Привязывает сущность к наблюдателям и таблице ёмкости сети.
+     * @param entity Присоединяемая сущность.
+     * @param owner Домен-владелец сущности.
+     */
+    void bindEntity(NetworkEntity& entity, const Domain& owner);
+
+    /**
+     * @brief Отвязывает отсоединённые сущности от наблюдателей и таблицы ёмкости сети.
+     * @param members Отсоединяемые сущности.
+     * @details Сначала снимает с публикации наблюдателей и ячейки таблицы ёмкости и
+     * дожидается изменений, уже начатых устройствами, и только затем убирает сущности
+     * из индексов и освобождает строки: иначе запоздавшее уведомление вернуло бы
+     * отсоединённую сущность в индекс, а запоздавшая запись попала бы в чужую строку.
+     */
+    void unbindEntities(std::span<const std::shared_ptr<NetworkEntity>> members) noexcept;
+
+    /**
+     * @brief Убирает отсоединённую сущность из индексов и таблицы ёмкости сети.
+     * @param entity Сущность, уже отвязанная от наблюдателей.
+     */
+    void unbindEntity(NetworkEntity& entity) noexcept;
 
     /**
      * @brief Рекурсивно собирает все сущности из домена и его поддоменов.
      * @param domain Домен, с которого начинается сбор.
+     * @details Для каждой вложенной сущности также запоминается домен-владелец.
      */
-    void collectAllEntities(std::shared_ptr<Domain> domain);
+    void collectAllEntities(const std::shared_ptr<Domain>& domain);
 
     /**
-     * @brief Рекурсивно ищет домен по идентификатору.
-     * @param domain Домен, с которого начинается поиск.
-     * @param domainId Идентификатор искомого домена.
-     * @return Найденный домен или nullptr.
+     * @brief Проверяет, что ни сущность, ни её вложенные сущности ещё не присутствуют в сети.
+     * @param entity Проверяемая сущность.
+     * @throw DomainOperationException Если идентификатор уже занят в сети.
      */
-    std::shared_ptr<Domain> findDomainRecursive(std::shared_ptr<Domain> domain, const std::string& domainId) const;
+    void ensureNotInNetwork(const NetworkEntity& entity) const;
 
     /**
-     * @brief Рекурсивно ищет домен, содержащий сущность с заданным идентификатором.
-     * @param domain Домен, с которого начинается поиск.
-     * @param entityId Идентификатор сущности.
-     * @return Домен, содержащий сущность, или nullptr, если сущность не найдена.
+     * @brief Находит домен, которым ограничен запрос. Вызывается под writerMutex.
+     * @param domainId Идентификатор домена; пустая строка - вся сеть.
+     * @return Домен-ограничитель или nullptr, если ограничение не нужно (вся сеть или корень).
+     * @throw DomainOperationException Если домен не найден.
+     */
+    const Domain* resolveScope(const std::string& domainId) const;
+
+    /**
+     * @brief Проверяет, что сущность лежит в поддереве домена, по цепочке владельцев.
+     * @param entity Присоединённая сущность.
+     * @param scope Домен-ограничитель или nullptr для всей сети.
+     * @return true если сущность входит в поддерево scope.
+     */
+    static bool isInScope(const NetworkEntity& entity, const Domain* scope) noexcept;
+
+    /**
+     * @brief Находит станции пользователя в поддереве домена. Вызывается под writerMutex.
+     * @param user Символ пользователя.
+     * @param scope Домен-ограничитель или nullptr для всей сети.
+     * @param result Вектор, в который добавляются найденные станции.
      */
-    std::shared_ptr<Domain> findDomainContainingEntity(std::shared_ptr<Domain> domain, const std::string& entityId) const;
+    void collectUserWorkstations(Symbol user, const Domain* scope,
+        std::vector<std::shared_ptr<Workstation>>& result) const;
+
+    /**
+     * @brief Собирает сущности поддомена в прямом порядке обхода вместе с их владельцами.
+     * @param domain Домен, потомки которого собираются.
+     * @param subtree Заполняемое поддерево.
+     */
+    void collectSubtreeMembers(const std::shared_ptr<Domain>& domain, DetachedSubtree& subtree) const;
+
+    /**
+     * @brief Добавляет все сущности поддерева в индексы сети.
+     * @param subtree Поддерево с заполненными владельцами.
+     */
+    void indexSubtree(const DetachedSubtree& subtree);
 
 public:
     /**
@@ -56,6 +153,61 @@ public:
      */
     CorporateNetwork(const std::string& rootAdminId);
 
+    /**
+     * @brief Деструктор: отвязывает сущности, которые могут пережить сеть, от её наблюдателей.
+     */
+    ~CorporateNetwork();
+
+    /**
+     * @brief Конструктор перемещения. Перемещаемая сеть не должна использоваться другими потоками.
+     */
+    CorporateNetwork(CorporateNetwork&& other) noexcept;
+
+    /**
+     * @brief Оператор перемещения. Обе сети не должны использоваться другими потоками.
+     */
+    CorporateNetwork& operator=(CorporateNetwork&& other) noexcept;
+    CorporateNetwork(const CorporateNetwork&) = delete;
+    CorporateNetwork& operator=(const CorporateNetwork&) = delete;
+
+    /**
+     * @brief Подписывает наблюдателя на изменения сети.
+     * @param observer Наблюдатель; должен оставаться живым до отписки или уничтожения сети.
+     * @details Уведомления приходят о добавлении и удалении сущностей, изменении занятого
+     * объёма и доверенных пользователей хранилищ, времени включения рабочих станций.
+     */
+    void addObserver(NetworkObserver* observer);
+
+    /**
+     * @brief Отписывает наблюдателя от изменений сети.
+     * @param observer Ранее подписанный наблюдатель.
+     * @details Возвращается после завершения уведомлений, начатых до отписки,
+     * поэтому сразу после вызова наблюдателя можно уничтожить.
+     */
+    void removeObserver(NetworkObserver* observer);
+
+    /**
+     * @brief Включает ленту изменений сети.
+     * @param capacity Число хранимых событий; используется только при первом вызове.
+     * @return Лента изменений, живущая вместе с сетью.
+     * @details До включения изменения не нумеруются и ничего не стоят.
+     */
+    ChangeFeed& enableChangeFeed(size_t capacity);
+
+    /**
+     * @brief Возвращает ленту изменений.
+     * @return Лента или nullptr, если она не включена.
+     */
+    ChangeFeed* getChangeFeed() const;
+
+    /**
+     * @brief Возвращает реестр двухфазных резервов места в хранилищах сети.
+     * @return Реестр, живущий вместе с сетью.
+     * @details Реестр не берёт блокировку писателей: резервы ставятся атомарными
+     * операциями над хранилищами и возвращаются при уничтожении сети.
+     */
+    CapacityReservations& getCapacityReservations() const { return *reservations; }
+
     /**
      * @brief Возвращает корневой домен сети.
      * @return Умный указатель на корневой домен.
@@ -67,18 +219,54 @@ public:
      * @param domainId Идентификатор домена, в который добавляется устройство.
      * @param entity Указатель на сущность (устройство или домен) для добавления.
      * @param user Идентификатор пользователя, выполняющего операцию.
-     * @throw NetworkException В случае ошибки доступа или если домен не найден.
+     * @throw NetworkException В случае ошибки доступа, если домен не найден
+     * или если идентификатор сущности уже используется в сети.
      */
     void addEntityToDomain(const std::string& domainId, std::shared_ptr<NetworkEntity> entity, const std::string& user);
 
+    /**
+     * @brief Добавляет пакет сущностей в указанный домен по принципу "всё или ничего".
+     * @param domainId Идентификатор домена. Если пустой, используется корневой домен.
+     * @param batch Сущности (устройства или домены) для добавления.
+     * @param user Идентификатор пользователя, выполняющего операцию.
+     * @throw NetworkException В случае ошибки доступа, если домен не найден, если сущность
+     * невалидна или если какой-либо идентификатор (включая вложенные) уже используется.
+     * @details Поиск домена и проверка прав выполняются один раз, дубликаты выявляются
+     * за один проход, ёмкость индексов резервируется заранее. При ошибке сеть не изменяется.
+     */
+    void addEntitiesToDomain(const std::string& domainId, std::span<const std::shared_ptr<NetworkEntity>> batch,
+        const std::string& user);
+
     /**
      * @brief Удаляет сущность из сети по идентификатору.
      * @param entityId Идентификатор сущности для удаления.
      * @param user Идентификатор пользователя, выполняющего операцию.
      * @throw NetworkException В случае ошибки доступа или если сущность не найдена.
+     * @details Если удаляется домен, из всех индексов сети удаляются и все его потомки.
      */
     void removeEntity(const std::string& entityId, const std::string& user);
 
+    /**
+     * @brief Отсоединяет сущность вместе со всеми потомками от сети.
+     * @param entityId Идентификатор отсоединяемой сущности.
+     * @param user Идентификатор пользователя, выполняющего операцию.
+     * @return Отсоединённое поддерево, которое можно присоединить в другом месте.
+     * @throw NetworkException В случае ошибки доступа или если сущность не найдена.
+     * @details Выполняется за время, пропорциональное размеру поддерева.
+     */
+    DetachedSubtree detachSubtree(const std::string& entityId, const std::string& user);
+
+    /**
+     * @brief Присоединяет ранее отсоединённое поддерево к указанному домену.
+     * @param domainId Идентификатор домена-получателя. Если пустой, используется корневой домен.
+     * @param subtree Поддерево; после успешного присоединения становится пустым.
+     * @param user Идентификатор пользователя, выполняющего операцию.
+     * @throw NetworkException В случае ошибки доступа, если домен не найден
+     * или если какой-либо идентификатор поддерева уже используется в сети.
+     * @details Сущности не проверяются повторно, проверяется только уникальность идентификаторов.
+     */
+    void attachSubtree(const std::string& domainId, DetachedSubtree&& subtree, const std::string& user);
+
     /**
      * @brief Ищет сущность в сети по идентификатору.
      * @param entityId Идентификатор сущности.
@@ -86,6 +274,165 @@ public:
      */
     std::shared_ptr<NetworkEntity> findEntity(const std::string& entityId) const;
 
+    /**
+     * @brief Вызывает функцию для сущности без копирования умного указателя.
+     * @param entityId Идентификатор сущности.
+     * @param visit Функция, принимающая const NetworkEntity&.
+     * @return true если сущность найдена и функция была вызвана.
+     * @details Сущность гарантированно жива на время вызова. Функция не должна
+     * изменять сеть и сохранять ссылку на сущность после возврата.
+     */
+    template <typename Visitor>
+    bool withEntity(std::string_view entityId, Visitor&& visit) const {
+        EpochGuard guard;
+        const EntityIndexEntry* entry = index.find(entityId);
+        if (!entry) {
+            return false;
+        }
+        visit(static_cast<const NetworkEntity&>(*entry->entity));
+        return true;
+    }
+
+    /**
+     * @brief Находит пакет сущностей под одной эпохой чтения.
+     * @param entityIds Идентификаторы сущностей.
+     * @param visit Функция вида void(size_t, const std::shared_ptr<NetworkEntity>*): позиция
+     * в пакете и указатель на сущность (nullptr, если сущность не найдена).
+     * @details Одна критическая секция на весь пакет вместо секции на каждый поиск.
+     * Указатель действителен только во время вызова; чтобы сохранить сущность,
+     * функция копирует умный указатель. Функция не должна изменять структуру сети.
+     */
+    template <typename Visitor>
+    void withEntities(std::span<const std::string_view> entityIds, Visitor&& visit) const {
+        EpochGuard guard;
+        for (size_t i = 0; i < entityIds.size(); ++i) {
+            const EntityIndexEntry* entry = index.find(entityIds[i]);
+            visit(i, entry ? &entry->entity : nullptr);
+        }
+    }
+
+    /**
+     * @brief Возвращает домен, непосредственно содержащий сущность.
+     * @param entityId Идентификатор сущности.
+     * @return Домен-владелец или nullptr, если сущность не найдена либо является корневым доменом.
+     * @details Выполняется за O(1) по индексу сущностей.
+     */
+    std::shared_ptr<Domain> getParentDomain(const std::string& entityId) const;
+
+    /**
+     * @brief Ищет домен по идентификатору.
+     * @param domainId Идентификатор домена. Если пустой, возвращается корневой домен.
+     * @return Домен или nullptr, если домен не найден.
+     * @details Выполняется за O(1) по индексу сущностей.
+     */
+    std::shared_ptr<Domain> findDomain(const std::string& domainId) const;
+
+    /**
+     * @brief Возвращает версию структуры сети.
+     * @return Значение, которое увеличивается при каждом добавлении, удалении или переносе сущностей.
+     * @details Позволяет дёшево обнаружить, что сеть изменилась с момента предыдущего чтения.
+     */
+    uint64_t getVersion() const noexcept { return version.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Выполняет чтение под блокировкой писателей.
+     * @param visit Функция без аргументов; на время её выполнения сеть не изменяется.
+     * @return Результат функции.
+     * @details Нужна для обхода содержимого доменов, которое не защищено от параллельных писателей.
+     * Функция не должна вызывать изменяющие методы сети.
+     */
+    template <typename Visitor>
+    decltype(auto) readLocked(Visitor&& visit) const {
+        std::lock_guard lock(writerMutex);
+        return visit();
+    }
+
+    /**
+     * @brief Выполняет отчёт по таблице ёмкости хранилищ под блокировкой писателей.
+     * @param visit Функция, принимающая const CapacityTable&.
+     * @return Результат функции.
+     * @details Блокировка исключает добавление и удаление хранилищ во время отчёта;
+     * изменения занятого объёма по-прежнему требуют внешней синхронизации.
+     */
+    template <typename Visitor>
+    decltype(auto) readCapacity(Visitor&& visit) const {
+        std::lock_guard lock(writerMutex);
+        return visit(static_cast<const CapacityTable&>(*capacity));
+    }
+
+    /**
+     * @brief Возвращает суммарную ёмкость всех хранилищ сети.
+     * @return Число хранилищ, общий и занятый объём.
+     */
+    CapacityTotals getCapacityTotals() const;
+
+    /**
+     * @brief Возвращает хранилища сети, в которых пользователь доверенный.
+     * @param user Идентификатор пользователя.
+     * @return Хранилища в произвольном порядке; пустой вектор для неизвестного пользователя.
+     * @details Ответ берётся из обратного индекса, без обхода хранилищ сети.
+     */
+    std::vector<std::shared_ptr<DataStorage>> getStoragesForUser(const std::string& user) const;
+
+    /**
+     * @brief Возвращает рабочие станции, закреплённые за пользователем.
+     * @param user Идентификатор пользователя.
+     * @param domainId Домен, поддеревом которого ограничен поиск; пустая строка - вся сеть.
+     * @return Станции в произвольном порядке.
+     * @throw DomainOperationException Если домен не найден.
+     * @details Ответ берётся из индекса по пользователям; ограничение доменом проверяет
+     * цепочку владельцев каждой станции пользователя (O(глубины)).
+     */
+    std::vector<std::shared_ptr<Workstation>> getWorkstationsForUser(const std::string& user,
+        const std::string& domainId = "") const;
+
+    /**
+     * @brief Возвращает рабочие станции сразу для нескольких пользователей под одной блокировкой.
+     * @param users Идентификаторы пользователей.
+     * @param domainId Домен, поддеревом которого ограничен поиск; пустая строка - вся сеть.
+     * @return Для каждого пользователя (в порядке users) - его станции.
+     * @throw DomainOperationException Если домен не найден.
+     */
+    std::vector<std::vector<std::shared_ptr<Workstation>>> getWorkstationsForUsers(
+        std::span<const std::string> users, const std::string& domainId = "") const;
+
+    /**
+     * @brief Возвращает рабочие станции, последнее включение которых попадает в [from, to).
+     * @param from Нижняя граница времени включения (включительно).
+     * @param to Верхняя граница времени включения (не включительно).
+     * @param domainId Домен, поддеревом которого ограничен поиск; пустая строка - вся сеть.
+     * @return Станции по возрастанию времени включения.
+     * @throw DomainOperationException Если домен не найден.
+     * @details Диапазон берётся из упорядоченного индекса за O(log n + k); ограничение
+     * доменом проверяет цепочку владельцев каждой станции диапазона.
+     */
+    std::vector<std::shared_ptr<Workstation>> getWorkstationsPoweredOnBetween(time_t from, time_t to,
+        const std::string& domainId = "") const;
+
+    /**
+     * @brief Возвращает рабочие станции, не включавшиеся с момента before.
+     * @param before Граница времени включения (не включительно).
+     * @param domainId Домен, поддеревом которого ограничен поиск; пустая строка - вся сеть.
+     * @return Станции по возрастанию времени включения (самые давние - первыми).
+     * @throw DomainOperationException Если домен не найден.
+     */
+    std::vector<std::shared_ptr<Workstation>> getWorkstationsPoweredOnBefore(time_t before,
+        const std::string& domainId = "") const;
+
+    /**
+     * @brief Возвращает сводку по поддереву домена за O(1).
+     * @param domainId Идентификатор домена; пустая строка - корневой домен.
+     * @return Число сущностей каждого вида и ёмкость хранилищ во всех поддоменах.
+     * @throw DomainOperationException Если домен не найден.
+     */
+    DomainSummary getDomainSummary(const std::string& domainId) const;
+
+    /**
+     * @brief Возвращает число сущностей в сети, включая корневой домен.
+     * @return Число сущностей; при параллельных изменениях - приблизительное.
+     */
+    size_t getEntityCount() const;
+
     /**
      * @brief Выводит информацию о домене и всех его поддоменах рекурсивно.
      * @param domainId Идентификатор домена. Если пустой, выводится корневой домен.
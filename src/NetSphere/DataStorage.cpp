@@ -4,8 +4,13 @@
  */
 
 #include "DataStorage.h"
+#include "CapacityTable.h"
+#include "Domain.h"
+#include "EpochReclamation.h"
 #include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
 
  /**
   * @brief Конструктор класса DataStorage.
@@ -15,26 +20,95 @@
   * @throw ValidationException Если параметры невалидны.
   */
 DataStorage::DataStorage(const std::string& id, const std::string& mac, double totalSize)
-    : Device(id, mac), totalSizeMB(totalSize), usedSizeMB(0) {
+    : Device(id, mac, EntityKind::DataStorage), totalBytes(0) {
     validateSize(totalSize);
+    totalBytes = toBytes(totalSize);
+}
+
+DataStorage::DataStorage(const std::string& id, MacAddress mac, double totalSize)
+    : Device(id, mac, EntityKind::DataStorage), totalBytes(0) {
+    validateSize(totalSize);
+    totalBytes = toBytes(totalSize);
+}
+
+DataStorage::DataStorage(Symbol id, MacAddress mac, double totalSize)
+    : Device(id, mac, EntityKind::DataStorage), totalBytes(0) {
+    validateSize(totalSize);
+    totalBytes = toBytes(totalSize);
+}
+
+uint64_t DataStorage::toBytes(double sizeMB) noexcept {
+    // 2^43 МБ = 2^63 байт; большие значения (и NaN) заведомо не помещаются ни в одно хранилище
+    constexpr double MAX_MB = 8796093022208.0;
+    if (!(sizeMB < MAX_MB)) {
+        return std::numeric_limits<uint64_t>::max();
+    }
+    return static_cast<uint64_t>(std::llround(sizeMB * BYTES_PER_MB));
+}
+
+void DataStorage::reserve(uint64_t bytes) {
+    uint64_t previous = usedBytes.load(std::memory_order_relaxed);
+    uint64_t next;
+    do {
+        if (bytes > totalBytes - previous) {
+            throw DeviceOperationException("Превышение общего объема хранилища: невозможно добавить " +
+                std::to_string(toMB(bytes)) + " MB (свободно " +
+                std::to_string(toMB(totalBytes - previous)) + " MB)");
+        }
+        next = previous + bytes;
+    } while (!usedBytes.compare_exchange_weak(previous, next, std::memory_order_seq_cst, std::memory_order_relaxed));
+    publishUsage(previous);
+}
+
+void DataStorage::release(uint64_t bytes) {
+    uint64_t previous = usedBytes.load(std::memory_order_relaxed);
+    uint64_t next;
+    do {
+        if (bytes > previous) {
+            throw DeviceOperationException("Нельзя освободить больше чем используется: запрошено " +
+                std::to_string(toMB(bytes)) + " MB, используется " +
+                std::to_string(toMB(previous)) + " MB");
+        }
+        next = previous - bytes;
+    } while (!usedBytes.compare_exchange_weak(previous, next, std::memory_order_seq_cst, std::memory_order_relaxed));
+    publishUsage(previous);
+}
+
+void DataStorage::publishUsage(uint64_t previousBytes) {
+    // Строка таблицы и сводки доменов получают последнее значение, а не приращение
+    // этого изменения, поэтому порядок публикаций разных потоков не важен
+    EpochGuard guard;
+    if (std::atomic<double>* cell = capacityCell.load(std::memory_order_seq_cst)) {
+        storeLatestUsage(*cell);
+    }
+    Domain::propagateUsage(*this);
+    notifyObserver([&](NetworkObserver& observer) { observer.onStorageUsageChanged(*this, toMB(previousBytes)); });
+}
+
+void DataStorage::storeLatestUsage(std::atomic<double>& cell) const noexcept {
+    // Обмен, а не запись: прочитав значение другого потока, поток видит и объём,
+    // который тот записал в ячейку
+    for (uint64_t used = getUsedBytes();;) {
+        cell.exchange(toMB(used), std::memory_order_acq_rel);
+        const uint64_t latest = getUsedBytes();
+        if (latest == used) {
+            return;
+        }
+        used = latest;
+    }
 }
 
 /**
  * @brief Оператор добавления данных к используемому объёму хранилища.
  * @param[in] additionalSize Дополнительный объём данных в мегабайтах.
  * @return Ссылка на текущий объект для поддержки цепочки вызовов.
- * @throw std::overflow_error Если добавление данных превысит общий объём хранилища.
+ * @throw DeviceOperationException Если добавление данных превысит общий объём хранилища.
  */
 DataStorage& DataStorage::operator+=(double additionalSize) {
     if (additionalSize <= 0) {
         throw DeviceOperationException("Размер добавляемых данных должен быть положительным");
     }
-    if (usedSizeMB + additionalSize > totalSizeMB) {
-        throw DeviceOperationException("Превышение общего объема хранилища: невозможно добавить " +
-            std::to_string(additionalSize) + " MB (свободно " +
-            std::to_string(totalSizeMB - usedSizeMB) + " MB)");
-    }
-    usedSizeMB += additionalSize;
+    reserve(toBytes(additionalSize));
     return *this;
 }
 
@@ -42,18 +116,13 @@ DataStorage& DataStorage::operator+=(double additionalSize) {
  * @brief Оператор освобождения пространства в хранилище.
  * @param[in] sizeToFree Объём данных для освобождения в мегабайтах.
  * @return Ссылка на текущий объект для поддержки цепочки вызовов.
- * @throw std::underflow_error Если пытаемся освободить больше, чем используется.
+ * @throw DeviceOperationException Если пытаемся освободить больше, чем используется.
  */
 DataStorage& DataStorage::operator-=(double sizeToFree) {
     if (sizeToFree <= 0) {
         throw DeviceOperationException("Размер освобождаемых данных должен быть положительным");
     }
-    if (usedSizeMB - sizeToFree < 0) {
-        throw DeviceOperationException("Нельзя освободить больше чем используется: запрошено " +
-            std::to_string(sizeToFree) + " MB, используется " +
-            std::to_string(usedSizeMB) + " MB");
-    }
-    usedSizeMB -= sizeToFree;
+    release(toBytes(sizeToFree));
     return *this;
 }
 
@@ -61,21 +130,37 @@ DataStorage& DataStorage::operator-=(double sizeToFree) {
  * @brief Оператор установки нового значения используемого объёма.
  * @param[in] newSize Новое значение используемого объёма в мегабайтах.
  * @return Ссылка на текущий объект для поддержки цепочки вызовов.
- * @throw std::overflow_error Если новое значение превышает общий объём хранилища.
+ * @throw DeviceOperationException Если новое значение превышает общий объём хранилища.
  */
 DataStorage& DataStorage::operator=(double newSize) {
     if (newSize < 0) {
         throw DeviceOperationException("Размер используемого пространства не может быть отрицательным");
     }
-    if (newSize > totalSizeMB) {
+    const uint64_t bytes = toBytes(newSize);
+    if (bytes > totalBytes) {
         throw DeviceOperationException("Новый размер превышает общий объем хранилища: " +
             std::to_string(newSize) + " MB > " +
-            std::to_string(totalSizeMB) + " MB");
+            std::to_string(getTotalSize()) + " MB");
     }
-    usedSizeMB = newSize;
+    const uint64_t previous = usedBytes.exchange(bytes, std::memory_order_seq_cst);
+    publishUsage(previous);
     return *this;
 }
 
+void DataStorage::reserveBytes(uint64_t bytes) {
+    if (bytes == 0) {
+        throw DeviceOperationException("Размер добавляемых данных должен быть положительным");
+    }
+    reserve(bytes);
+}
+
+void DataStorage::releaseBytes(uint64_t bytes) {
+    if (bytes == 0) {
+        throw DeviceOperationException("Размер освобождаемых данных должен быть положительным");
+    }
+    release(bytes);
+}
+
 /**
  * @brief Оператор "меньше" для сравнения хранилищ по идентификатору.
  * @param[in] other Ссылка на другой объект DataStorage для сравнения.
@@ -111,10 +196,17 @@ void DataStorage::addTrustedUser(const std::string& user) {
     if (user.empty()) {
         throw ValidationException("Имя пользователя не может быть пустым");
     }
-    if (std::find(trustedUsers.begin(), trustedUsers.end(), user) != trustedUsers.end()) {
-        throw DeviceOperationException("Пользователь " + user + " уже есть в списке доверенных");
+    addTrustedUser(Symbol::intern(user));
+}
+
+void DataStorage::addTrustedUser(Symbol user) {
+    if (user.empty()) {
+        throw ValidationException("Имя пользователя не может быть пустым");
+    }
+    if (!trustedUsers.insert(user)) {
+        throw DeviceOperationException("Пользователь " + user.str() + " уже есть в списке доверенных");
     }
-    trustedUsers.push_back(user);
+    notifyObserver([&](NetworkObserver& observer) { observer.onTrustedUserAdded(*this, user); });
 }
 
 /**
@@ -125,11 +217,11 @@ void DataStorage::removeTrustedUser(const std::string& user) {
     if (user.empty()) {
         throw ValidationException("Имя пользователя не может быть пустым");
     }
-    auto it = std::find(trustedUsers.begin(), trustedUsers.end(), user);
-    if (it == trustedUsers.end()) {
+    auto userSymbol = Symbol::lookup(user);
+    if (!userSymbol || !trustedUsers.erase(*userSymbol)) {
         throw DeviceOperationException("Пользователь " + user + " не найден в списке доверенных");
     }
-    trustedUsers.erase(it);
+    notifyObserver([&](NetworkObserver& observer) { observer.onTrustedUserRemoved(*this, *userSymbol); });
 }
 
 /**
@@ -137,7 +229,9 @@ void DataStorage::removeTrustedUser(const std::string& user) {
  * @return true если пользователь найден в списке доверенных, иначе false.
  */
 bool DataStorage::isUserTrusted(const std::string& user) const {
-    return std::find(trustedUsers.begin(), trustedUsers.end(), user) != trustedUsers.end();
+    // Строка, отсутствующая в пуле, заведомо не может быть в списке доверенных
+    auto userSymbol = Symbol::lookup(user);
+    return userSymbol && trustedUsers.contains(*userSymbol);
 }
 
 /**
@@ -145,7 +239,7 @@ bool DataStorage::isUserTrusted(const std::string& user) const {
  * @return Общий объём хранилища в мегабайтах.
  */
 double DataStorage::getTotalSize() const {
-    return totalSizeMB;
+    return toMB(totalBytes);
 }
 
 /**
@@ -153,7 +247,7 @@ double DataStorage::getTotalSize() const {
  * @return Используемый объём хранилища в мегабайтах.
  */
 double DataStorage::getUsedSize() const {
-    return usedSizeMB;
+    return toMB(getUsedBytes());
 }
 
 /**
@@ -161,15 +255,15 @@ double DataStorage::getUsedSize() const {
  * @return Свободный объём хранилища в мегабайтах.
  */
 double DataStorage::getFreeSize() const {
-    return totalSizeMB - usedSizeMB;
+    return toMB(getFreeBytes());
 }
 
 /**
  * @brief Возвращает список доверенных пользователей.
- * @return Константная ссылка на вектор с именами доверенных пользователей.
+ * @return Копия списка символов доверенных пользователей в порядке добавления.
  */
-const std::vector<std::string>& DataStorage::getTrustedUsers() const {
-    return trustedUsers;
+std::vector<Symbol> DataStorage::getTrustedUsers() const {
+    return trustedUsers.inInsertionOrder();
 }
 
 /**
@@ -181,11 +275,9 @@ void DataStorage::printInfo() const {
 
     std::cout << "Хранилище: " << getId() << "\n";
     std::cout << "MAC: " << getMacAddress() << "\n";
-    std::cout << "Объем: " << usedSizeMB << "/" << totalSizeMB << " MB\n";
+    std::cout << "Объем: " << getUsedSize() << "/" << getTotalSize() << " MB\n";
     std::cout << "Доверенные пользователи: ";
-    for (const auto& user : trustedUsers) {
-        std::cout << user << " ";
-    }
+    trustedUsers.forEachInOrder([](Symbol user) { std::cout << user << " "; });
     std::cout << "\n";
 }
 
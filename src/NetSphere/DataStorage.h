@@ -6,9 +6,15 @@
 #pragma once
 
 #include "Device.h"
+#include "TrustedUserSet.h"
+#include <atomic>
+#include <cstdint>
+#include <utility>
 #include <vector>
 #include <compare>
 
+class CapacityTable;
+
  /**
   * @defgroup storage_module Модуль хранилищ данных
   * @brief Классы для работы с устройствами хранения данных
@@ -17,12 +23,67 @@
 
   /**
    * @brief Класс, представляющий хранилище данных в корпоративной сети компании NetSphere.
+   *
+   * Объём учитывается в целых байтах: общий задаётся при создании, а занятый
+   * меняется атомарным сравнением с обменом (CAS). Поэтому несколько потоков
+   * (например, задания резервного копирования) могут одновременно занимать и
+   * освобождать место в одном хранилище без мьютекса и без накопления ошибки
+   * округления: проверка границы и изменение выполняются одной атомарной операцией.
+   * Объёмы в мегабайтах округляются до ближайшего байта.
+   *
+   * Изменение объёма допускается и в то время, когда сеть присоединяет или
+   * отсоединяет хранилище: таблица ёмкости и сводки доменов получают последнее
+   * значение. Список доверенных пользователей такой гарантии не даёт - его
+   * изменения сериализуются снаружи вместе со структурными изменениями сети.
    */
 class DataStorage : public Device {
 private:
-    double totalSizeMB;                     ///< Общий объём хранилища в мегабайтах
-    double usedSizeMB;                      ///< Объём используемого пространства в мегабайтах
-    std::vector<std::string> trustedUsers;  ///< Список доверенных пользователей с доступом к хранилищу
+    uint64_t totalBytes;                    ///< Общий объём хранилища в байтах
+    std::atomic<uint64_t> usedBytes{ 0 };   ///< Занятый объём в байтах
+    TrustedUserSet trustedUsers;            ///< Доверенные пользователи с доступом к хранилищу
+    CapacityTable* capacityTable = nullptr; ///< Таблица ёмкости сети, к которой присоединено хранилище (меняет только таблица)
+    uint32_t capacitySlot = 0;              ///< Номер строки хранилища в capacityTable (меняет только таблица)
+    std::atomic<std::atomic<double>*> capacityCell{ nullptr }; ///< Ячейка занятого объёма в capacityTable для потоков, меняющих объём
+
+    friend class CapacityTable;
+
+    /**
+     * @brief Переводит байты в мегабайты.
+     * @param[in] bytes Объём в байтах.
+     * @return Объём в мегабайтах.
+     */
+    static double toMB(uint64_t bytes) noexcept { return static_cast<double>(bytes) / BYTES_PER_MB; }
+
+    /**
+     * @brief Атомарно увеличивает занятый объём, если хватает места.
+     * @param[in] bytes Добавляемый объём в байтах.
+     * @throw DeviceOperationException Если места не хватает.
+     */
+    void reserve(uint64_t bytes);
+
+    /**
+     * @brief Атомарно уменьшает занятый объём, если столько занято.
+     * @param[in] bytes Освобождаемый объём в байтах.
+     * @throw DeviceOperationException Если занято меньше.
+     */
+    void release(uint64_t bytes);
+
+    /**
+     * @brief Переносит изменение занятого объёма в таблицу ёмкости, сводки доменов-предков
+     * и наблюдателей сети.
+     * @param[in] previousBytes Занятый объём до изменения.
+     * @details Всё, что опубликовала сеть, читается в одной секции EpochGuard: сеть,
+     * отсоединяющая хранилище, дожидается её завершения, прежде чем освободить строку таблицы.
+     */
+    void publishUsage(uint64_t previousBytes);
+
+    /**
+     * @brief Записывает в ячейку таблицы ёмкости последний занятый объём.
+     * @param[in,out] cell Ячейка строки хранилища.
+     * @details Запись повторяется, пока объём не перестанет меняться: поток, записавший
+     * устаревшее значение после более нового, увидит новый объём и перезапишет ячейку.
+     */
+    void storeLatestUsage(std::atomic<double>& cell) const noexcept;
 
     /**
      * @brief Проверяет валидность размера хранилища.
@@ -39,24 +100,101 @@ private:
     }
 
 public:
+    static constexpr uint64_t BYTES_PER_MB = 1024 * 1024;   ///< Байтов в мегабайте
+
+    /**
+     * @brief Переводит мегабайты в байты с округлением; слишком большие значения и NaN - в максимум.
+     * @param[in] sizeMB Объём в мегабайтах (неотрицательный).
+     * @return Объём в байтах.
+     */
+    static uint64_t toBytes(double sizeMB) noexcept;
+
     DataStorage(const std::string& id, const std::string& mac, double totalSize);
 
+    /**
+     * @brief Конструктор хранилища с уже разобранным MAC-адресом.
+     * @param[in] id Уникальный строковый идентификатор хранилища.
+     * @param[in] mac MAC-адрес хранилища.
+     * @param[in] totalSize Общий объём хранилища в мегабайтах.
+     * @throw ValidationException Если идентификатор или размер невалиден.
+     */
+    DataStorage(const std::string& id, MacAddress mac, double totalSize);
+
+    /**
+     * @brief Конструктор хранилища с уже интернированным идентификатором.
+     * @param[in] id Символ идентификатора хранилища.
+     * @param[in] mac MAC-адрес хранилища.
+     * @param[in] totalSize Общий объём хранилища в мегабайтах.
+     * @throw ValidationException Если идентификатор или размер невалиден.
+     */
+    DataStorage(Symbol id, MacAddress mac, double totalSize);
+
+    /**
+     * @brief Проверяет, соответствует ли вид сущности хранилищу данных.
+     * @param[in] kind Проверяемый вид.
+     * @return true для EntityKind::DataStorage.
+     */
+    static constexpr bool isKindOf(EntityKind kind) noexcept { return kind == EntityKind::DataStorage; }
+
     DataStorage& operator+=(double additionalSize);
     DataStorage& operator-=(double sizeToFree);
     DataStorage& operator=(double newSize);
 
+    /**
+     * @brief Атомарно занимает место в хранилище.
+     * @param[in] bytes Объём в байтах.
+     * @throw DeviceOperationException Если объём нулевой или места не хватает.
+     * @details Безопасно вызывается из многих потоков одновременно; граница проверяется
+     * в том же CAS, которым объём изменяется.
+     */
+    void reserveBytes(uint64_t bytes);
+
+    /**
+     * @brief Атомарно освобождает место в хранилище.
+     * @param[in] bytes Объём в байтах.
+     * @throw DeviceOperationException Если объём нулевой или превышает занятый.
+     */
+    void releaseBytes(uint64_t bytes);
+
     bool operator<(const DataStorage& other) const;
     bool operator==(const DataStorage& other) const;
     bool operator!=(const DataStorage& other) const;
 
     void addTrustedUser(const std::string& user);
+
+    /**
+     * @brief Добавляет уже интернированного пользователя в список доверенных.
+     * @param[in] user Символ пользователя.
+     * @throw ValidationException Если символ пустой.
+     * @throw DeviceOperationException Если пользователь уже в списке.
+     */
+    void addTrustedUser(Symbol user);
     void removeTrustedUser(const std::string& user);
     bool isUserTrusted(const std::string& user) const;
 
+    /**
+     * @brief Проверяет доступ уже интернированного пользователя без обращения к пулу строк.
+     * @param[in] user Символ пользователя.
+     * @return true если пользователь доверенный.
+     */
+    bool isUserTrusted(Symbol user) const noexcept { return trustedUsers.contains(user); }
+
     double getTotalSize() const;
     double getUsedSize() const;
     double getFreeSize() const;
-    const std::vector<std::string>& getTrustedUsers() const;
+
+    uint64_t getTotalBytes() const noexcept { return totalBytes; }
+    uint64_t getUsedBytes() const noexcept { return usedBytes.load(std::memory_order_seq_cst); }
+    uint64_t getFreeBytes() const noexcept { return totalBytes - getUsedBytes(); }
+    std::vector<Symbol> getTrustedUsers() const;
+    size_t getTrustedUserCount() const noexcept { return trustedUsers.size(); }
+
+    /**
+     * @brief Обходит доверенных пользователей в порядке добавления без копирования списка.
+     * @param[in] visitor Вызывается для каждого символа пользователя.
+     */
+    template <typename Visitor>
+    void forEachTrustedUser(Visitor&& visitor) const { trustedUsers.forEachInOrder(std::forward<Visitor>(visitor)); }
 
     void printInfo() const override;
     std::string getType() const override;
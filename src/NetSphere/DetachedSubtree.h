@@ -0,0 +1,66 @@
+﻿/**
+ * @file DetachedSubtree.h
+ * @brief Заголовочный файл класса DetachedSubtree - поддерева, отсоединённого от сети.
+ */
+
+#pragma once
+
+#include "Domain.h"
+#include <memory>
+#include <vector>
+
+ /**
+  * @addtogroup network_module
+  * @{
+  */
+
+  /**
+   * @brief Поддерево сущностей, отсоединённое от корпоративной сети.
+   *
+   * Хранит корневую сущность и заранее собранный список всех её потомков
+   * вместе с доменами-владельцами. Это позволяет снова присоединить поддерево
+   * к сети за время, пропорциональное его размеру, без повторной валидации
+   * каждой сущности. Пока поддерево отсоединено, его состав не должен изменяться.
+   */
+class DetachedSubtree {
+private:
+    std::vector<std::shared_ptr<NetworkEntity>> members;   ///< Сущности поддерева в прямом порядке обхода (корень первый)
+    std::vector<std::shared_ptr<Domain>> owners;           ///< Домен-владелец каждой сущности (для корня - nullptr)
+
+    friend class CorporateNetwork;
+
+public:
+    DetachedSubtree() = default;
+    DetachedSubtree(DetachedSubtree&&) noexcept = default;
+    DetachedSubtree& operator=(DetachedSubtree&&) noexcept = default;
+    DetachedSubtree(const DetachedSubtree&) = delete;
+    DetachedSubtree& operator=(const DetachedSubtree&) = delete;
+
+    /**
+     * @brief Возвращает корневую сущность поддерева.
+     * @return Умный указатель на корень или nullptr для пустого поддерева.
+     */
+    std::shared_ptr<NetworkEntity> getRoot() const {
+        return members.empty() ? nullptr : members.front();
+    }
+
+    /**
+     * @brief Возвращает количество сущностей в поддереве, включая корень.
+     * @return Число сущностей.
+     */
+    size_t size() const { return members.size(); }
+
+    /**
+     * @brief Проверяет, пусто ли поддерево.
+     * @return true если поддерево не содержит сущностей.
+     */
+    bool empty() const { return members.empty(); }
+
+    /**
+     * @brief Возвращает все сущности поддерева.
+     * @return Константная ссылка на список сущностей в прямом порядке обхода.
+     */
+    const std::vector<std::shared_ptr<NetworkEntity>>& getMembers() const { return members; }
+};
+
+/** @} */ // Конец группы network_module
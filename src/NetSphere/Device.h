@@ -7,8 +7,8 @@
 
 #include "NetworkEntity.h"
 #include "NetworkExceptions.h"
+#include "MacAddress.h"
 #include <string>
-#include <regex>
 
  /**
   * @defgroup device_module Модуль устройств сети
@@ -24,7 +24,7 @@
    */
 class Device : public NetworkEntity {
 protected:
-    std::string macAddress;   ///< MAC-адрес устройства
+    MacAddress macAddress;   ///< MAC-адрес устройства в упакованном 48-битном виде
 
     /**
      * @brief Проверяет валидность MAC-адреса.
@@ -34,28 +34,26 @@ protected:
      * XX:XX:XX:XX:XX:XX или XX-XX-XX-XX-XX-XX, где X - шестнадцатеричная цифра.
      */
     static bool isValidMacAddress(const std::string& mac) {
-        if (mac.empty()) {
-            return false;
-        }
-        std::regex macPattern("^([0-9A-Fa-f]{2}[:-]){5}([0-9A-Fa-f]{2})$");
-        return std::regex_match(mac, macPattern);
+        MacAddress parsed;
+        return MacAddress::tryParse(mac, parsed);
     }
 
     /**
      * @brief Проверяет валидность идентификатора устройства.
      * @param[in] id Идентификатор для проверки.
      * @throw ValidationException Если идентификатор невалиден.
+     * @details Сама проверка выполняется один раз при интернировании строки,
+     * здесь используется закешированный результат.
      */
-    static void validateId(const std::string& id) {
-        if (id.empty()) {
+    static void validateId(Symbol id) {
+        switch (id.deviceIdStatus()) {
+        case DeviceIdStatus::Valid:
+            return;
+        case DeviceIdStatus::Empty:
             throw ValidationException("Идентификатор устройства не может быть пустым");
-        }
-        if (id.length() > 50) {
+        case DeviceIdStatus::TooLong:
             throw ValidationException("Идентификатор устройства слишком длинный (максимум 50 символов)");
-        }
-        // Проверка на допустимые символы
-        std::regex idPattern("^[a-zA-Z0-9_-]+$");
-        if (!std::regex_match(id, idPattern)) {
+        case DeviceIdStatus::InvalidChars:
             throw ValidationException("Идентификатор устройства содержит недопустимые символы");
         }
     }
@@ -65,22 +63,57 @@ public:
      * @brief Конструктор базового класса Device.
      * @param[in] id Уникальный строковый идентификатор устройства.
      * @param[in] mac MAC-адрес устройства.
+     * @param[in] kind Вид устройства.
      * @throw ValidationException Если передан невалидный MAC-адрес или идентификатор.
      */
-    Device(const std::string& id, const std::string& mac)
-        : NetworkEntity(id), macAddress(mac) {
-        validateId(id);
-        if (!isValidMacAddress(mac)) {
-            throw ValidationException("Неверный формат MAC-адреса: " + mac +
-                " (ожидается формат XX:XX:XX:XX:XX:XX или XX-XX-XX-XX-XX-XX)");
-        }
+    Device(const std::string& id, const std::string& mac, EntityKind kind)
+        : NetworkEntity(id, kind) {
+        validateId(this->id);
+        macAddress = MacAddress::parse(mac);
     }
 
     /**
-     * @brief Возвращает MAC-адрес устройства.
-     * @return Константная ссылка на MAC-адрес устройства в строковом формате.
+     * @brief Конструктор базового класса Device с уже разобранным MAC-адресом.
+     * @param[in] id Уникальный строковый идентификатор устройства.
+     * @param[in] mac MAC-адрес устройства.
+     * @param[in] kind Вид устройства.
+     * @throw ValidationException Если передан невалидный идентификатор.
+     */
+    Device(const std::string& id, MacAddress mac, EntityKind kind)
+        : NetworkEntity(id, kind), macAddress(mac) {
+        validateId(this->id);
+    }
+
+    /**
+     * @brief Конструктор с уже интернированным идентификатором и разобранным MAC-адресом.
+     * @param[in] id Символ идентификатора устройства.
+     * @param[in] mac MAC-адрес устройства.
+     * @param[in] kind Вид устройства.
+     * @throw ValidationException Если передан невалидный идентификатор.
+     */
+    Device(Symbol id, MacAddress mac, EntityKind kind)
+        : NetworkEntity(id, kind), macAddress(mac) {
+        validateId(this->id);
+    }
+
+    /**
+     * @brief Проверяет, относится ли вид сущности к устройствам.
+     * @param[in] kind Проверяемый вид.
+     * @return true для любого вида, кроме домена.
+     */
+    static constexpr bool isKindOf(EntityKind kind) noexcept { return kind != EntityKind::Domain; }
+
+    /**
+     * @brief Возвращает MAC-адрес устройства в текстовом виде.
+     * @return MAC-адрес в каноническом формате XX:XX:XX:XX:XX:XX.
+     */
+    std::string getMacAddress() const { return macAddress.toString(); }
+
+    /**
+     * @brief Возвращает MAC-адрес устройства в упакованном виде.
+     * @return Константная ссылка на MAC-адрес.
      */
-    const std::string& getMacAddress() const { return macAddress; }
+    const MacAddress& getMac() const { return macAddress; }
 
     /**
      * @brief Чисто виртуальная функция для получения типа устройства.
@@ -0,0 +1,120 @@
+﻿/**
+ * @file DeviceInfo.cpp
+ * @brief Заполнение сведений о сущности для C API.
+ */
+
+#include "DeviceInfo.h"
+#include "ChangeFeed.h"
+#include "DataStorage.h"
+#include "Domain.h"
+#include "Workstation.h"
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
+namespace {
+
+    static_assert(sizeof(StorageInfoData) <= sizeof(DeviceInfo::data));
+    static_assert(sizeof(WorkstationInfoData) <= sizeof(DeviceInfo::data));
+    static_assert(sizeof(DomainInfoData) <= sizeof(DeviceInfo::data));
+
+    static_assert(sizeof(CursorRecord::id) > 50, "Идентификатор должен помещаться в запись курсора");
+    static_assert(sizeof(ChangeRecord::id) > 50, "Идентификатор должен помещаться в событие ленты");
+    static_assert(sizeof(UserWorkstationRecord::workstation_id) > 50, "Идентификатор должен помещаться в запись станции");
+    static_assert(sizeof(PowerOnRecord::workstation_id) > 50, "Идентификатор должен помещаться в запись включения");
+
+    template <size_t N>
+    void copyString(char (&target)[N], std::string_view value) noexcept {
+        const size_t length = std::min(value.size(), N - 1);
+        std::memcpy(target, value.data(), length);
+        target[length] = '\0';
+    }
+
+    template <typename Data>
+    void storeData(DeviceInfo& info, const Data& data) noexcept {
+        // data не выровнено по 8 байт, поэтому структура копируется побайтно
+        std::memcpy(info.data, &data, sizeof(Data));
+    }
+
+}
+
+DeviceInfoType toDeviceInfoType(EntityKind kind) noexcept {
+    switch (kind) {
+    case EntityKind::DataStorage: return DEVICE_INFO_DATA_STORAGE;
+    case EntityKind::Workstation: return DEVICE_INFO_WORKSTATION;
+    case EntityKind::Printer: return DEVICE_INFO_PRINTER;
+    case EntityKind::Domain: return DEVICE_INFO_DOMAIN;
+    }
+    return DEVICE_INFO_UNKNOWN;
+}
+
+void fillDeviceInfo(const NetworkEntity& entity, DeviceInfo& info) noexcept {
+    std::memset(&info, 0, sizeof(info));
+    copyString(info.id, entity.getId());
+    if (auto device = entityCast<Device>(&entity)) {
+        device->getMac().format(info.mac);
+    }
+
+    info.type = toDeviceInfoType(entity.kind());
+    switch (entity.kind()) {
+    case EntityKind::DataStorage: {
+        const auto& storage = static_cast<const DataStorage&>(entity);
+        StorageInfoData data{};
+        data.total_mb = storage.getTotalSize();
+        data.used_mb = storage.getUsedSize();
+        data.trusted_user_count = static_cast<uint32_t>(storage.getTrustedUserCount());
+        storeData(info, data);
+        break;
+    }
+    case EntityKind::Workstation: {
+        const auto& workstation = static_cast<const Workstation&>(entity);
+        WorkstationInfoData data{};
+        data.power_on_time = static_cast<int64_t>(workstation.getLastPowerOnTime());
+        copyString(data.user_id, workstation.getUserId());
+        storeData(info, data);
+        break;
+    }
+    case EntityKind::Printer:
+        break;
+    case EntityKind::Domain: {
+        const auto& domain = static_cast<const Domain&>(entity);
+        DomainInfoData data{};
+        data.child_count = static_cast<uint32_t>(domain.getEntityCount());
+        copyString(data.admin_id, domain.getAdminId());
+        storeData(info, data);
+        break;
+    }
+    }
+}
+
+void fillCursorRecord(const NetworkEntity& entity, const NetworkEntity& parent, uint32_t depth,
+    CursorRecord& record) noexcept {
+    copyString(record.id, entity.getId());
+    copyString(record.parent_id, parent.getId());
+    record.type = toDeviceInfoType(entity.kind());
+    record.depth = depth;
+    const auto* domain = entityCast<Domain>(&entity);
+    record.child_count = domain ? static_cast<uint32_t>(domain->getEntityCount()) : 0;
+}
+
+void fillChangeRecord(const ChangeEvent& event, ChangeRecord& record) noexcept {
+    record.sequence = event.sequence;
+    record.type = static_cast<int>(event.type);
+    record.entity_type = toDeviceInfoType(event.kind);
+    copyString(record.id, event.entity.view());
+    copyString(record.related_id, event.related.view());
+    record.used_mb = event.usedMB;
+    record.power_on_time = static_cast<int64_t>(event.powerOnTime);
+}
+
+void fillUserWorkstationRecord(const Workstation& workstation, uint32_t userIndex,
+    UserWorkstationRecord& record) noexcept {
+    record.user_index = userIndex;
+    copyString(record.workstation_id, workstation.getId());
+    record.power_on_time = static_cast<int64_t>(workstation.getLastPowerOnTime());
+}
+
+void fillPowerOnRecord(const Workstation& workstation, PowerOnRecord& record) noexcept {
+    copyString(record.workstation_id, workstation.getId());
+    record.power_on_time = static_cast<int64_t>(workstation.getLastPowerOnTime());
+}
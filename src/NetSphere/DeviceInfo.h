@@ -0,0 +1,167 @@
+﻿/**
+ * @file DeviceInfo.h
+ * @brief Структуры сведений о сущности и записей перечисления с фиксированной раскладкой для C API.
+ *
+ * Заголовок совместим с C: структуры передаются через границу FFI без
+ * преобразований и повторяют DeviceInfo из python/corporate_network.py.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+#include <cstdint>
+extern "C" {
+#else
+#include <stdint.h>
+#endif
+
+    // Тип сущности в DeviceInfo::type (совпадает с DeviceType в Python)
+    enum DeviceInfoType {
+        DEVICE_INFO_UNKNOWN = 0,
+        DEVICE_INFO_DATA_STORAGE = 1,
+        DEVICE_INFO_WORKSTATION = 2,
+        DEVICE_INFO_PRINTER = 3,
+        DEVICE_INFO_DOMAIN = 4
+    };
+
+    // Сведения о сущности. Строки завершаются нулём; более длинные значения усекаются.
+    // Поле data содержит байты одной из структур ниже в зависимости от type.
+    typedef struct DeviceInfo {
+        char id[256];
+        char mac[256];              // Пусто для домена
+        int type;                   // DeviceInfoType
+        unsigned char data[256];
+    } DeviceInfo;
+
+    // data для DEVICE_INFO_DATA_STORAGE
+    typedef struct StorageInfoData {
+        double total_mb;
+        double used_mb;
+        uint32_t trusted_user_count;
+    } StorageInfoData;
+
+    // data для DEVICE_INFO_WORKSTATION
+    typedef struct WorkstationInfoData {
+        int64_t power_on_time;
+        char user_id[248];
+    } WorkstationInfoData;
+
+    // data для DEVICE_INFO_DOMAIN
+    typedef struct DomainInfoData {
+        uint32_t child_count;
+        char admin_id[252];
+    } DomainInfoData;
+
+    // Компактная запись страницы курсора перечисления (идентификаторы не длиннее 50 символов)
+    typedef struct CursorRecord {
+        char id[64];
+        char parent_id[64];         // Домен-владелец записи
+        int type;                   // DeviceInfoType
+        uint32_t depth;             // Глубина относительно начального домена (его дети - 1)
+        uint32_t child_count;       // Число непосредственных детей для домена, иначе 0
+    } CursorRecord;
+
+    // Вид события ленты изменений в ChangeRecord::type
+    enum ChangeRecordType {
+        CHANGE_ENTITY_ADDED = 1,      // related_id - домен-владелец
+        CHANGE_ENTITY_REMOVED = 2,    // related_id - бывший домен-владелец; удалено всё поддерево
+        CHANGE_ENTITY_UPDATED = 3,    // Изменились доверенные пользователи хранилища; related_id - пользователь
+        CHANGE_STORAGE_USAGE = 4,     // Новое значение в used_mb
+        CHANGE_POWER_ON = 5           // Новое значение в power_on_time
+    };
+
+    // Событие ленты изменений сети
+    typedef struct ChangeRecord {
+        uint64_t sequence;          // Номер события; строго возрастает
+        int type;                   // ChangeRecordType
+        int entity_type;            // DeviceInfoType изменившейся сущности
+        char id[64];
+        char related_id[64];
+        double used_mb;
+        int64_t power_on_time;
+    } ChangeRecord;
+
+    // Рабочая станция, найденная по пользователю (network_find_user_workstations)
+    typedef struct UserWorkstationRecord {
+        uint32_t user_index;        // Индекс пользователя во входном массиве
+        char workstation_id[64];
+        int64_t power_on_time;
+    } UserWorkstationRecord;
+
+    // Рабочая станция из диапазона времени включения (network_find_workstations_by_power_on)
+    typedef struct PowerOnRecord {
+        char workstation_id[64];
+        int64_t power_on_time;
+    } PowerOnRecord;
+
+    // Статистика пакета телеметрии включения (network_ingest_power_on)
+    typedef struct PowerOnIngestResult {
+        uint64_t received;          // Событий в пакете
+        uint64_t unknown;           // Идентификатор не найден или не рабочая станция
+        uint64_t coalesced;         // Повторных событий той же станции в пакете
+        uint64_t applied;           // Станций с обновлённым временем
+        uint64_t stale;             // Станций, чьё время не новее текущего
+    } PowerOnIngestResult;
+
+#ifdef __cplusplus
+}
+
+class NetworkEntity;
+class Workstation;
+struct ChangeEvent;
+enum class EntityKind : uint8_t;
+
+/**
+ * @addtogroup network_module
+ * @{
+ */
+
+ /**
+  * @brief Заполняет сведения о сущности без выделения памяти.
+  * @param[in] entity Сущность.
+  * @param[out] info Заполняемая структура; неиспользуемые байты обнуляются.
+  */
+void fillDeviceInfo(const NetworkEntity& entity, DeviceInfo& info) noexcept;
+
+/**
+ * @brief Заполняет запись страницы курсора без выделения памяти.
+ * @param[in] entity Сущность.
+ * @param[in] parent Домен-владелец сущности.
+ * @param[in] depth Глубина сущности относительно начального домена перечисления.
+ * @param[out] record Заполняемая запись.
+ */
+void fillCursorRecord(const NetworkEntity& entity, const NetworkEntity& parent, uint32_t depth,
+    CursorRecord& record) noexcept;
+
+/**
+ * @brief Заполняет запись события ленты изменений без выделения памяти.
+ * @param[in] event Событие ленты.
+ * @param[out] record Заполняемая запись.
+ */
+void fillChangeRecord(const ChangeEvent& event, ChangeRecord& record) noexcept;
+
+/**
+ * @brief Заполняет запись станции, найденной по пользователю, без выделения памяти.
+ * @param[in] workstation Рабочая станция.
+ * @param[in] userIndex Индекс пользователя во входном массиве запроса.
+ * @param[out] record Заполняемая запись.
+ */
+void fillUserWorkstationRecord(const Workstation& workstation, uint32_t userIndex,
+    UserWorkstationRecord& record) noexcept;
+
+/**
+ * @brief Заполняет запись станции из диапазона времени включения без выделения памяти.
+ * @param[in] workstation Рабочая станция.
+ * @param[out] record Заполняемая запись.
+ */
+void fillPowerOnRecord(const Workstation& workstation, PowerOnRecord& record) noexcept;
+
+/**
+ * @brief Преобразует вид сущности в код типа C API.
+ * @param[in] kind Вид сущности.
+ * @return Значение DeviceInfoType.
+ */
+DeviceInfoType toDeviceInfoType(EntityKind kind) noexcept;
+
+/** @} */ // Конец группы network_module
+#endif
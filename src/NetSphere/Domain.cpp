@@ -4,10 +4,14 @@
  */
 
 #include "Domain.h"
+#include "DataStorage.h"
+#include "EpochReclamation.h"
+#include "GrowthPolicy.h"
 #include <iostream>
+#include <unordered_set>
 
 Domain::Domain(const std::string& id, const std::string& admin)
-    : NetworkEntity(id), adminId(admin) {
+    : NetworkEntity(id, EntityKind::Domain), adminId(Symbol::intern(admin)) {
     if (id.empty()) {
         throw ValidationException("Идентификатор домена не может быть пустым");
     }
@@ -16,6 +20,124 @@ Domain::Domain(const std::string& id, const std::string& admin)
     }
 }
 
+Domain::Domain(Symbol id, Symbol admin)
+    : NetworkEntity(id, EntityKind::Domain), adminId(admin) {
+    if (id.empty()) {
+        throw ValidationException("Идентификатор домена не может быть пустым");
+    }
+    if (admin.empty()) {
+        throw ValidationException("Идентификатор администратора домена не может быть пустым");
+    }
+}
+
+Domain::~Domain() {
+    bool shared = false;
+    for (const auto& [id, entity] : entities) {
+        Domain* expected = this;
+        entity->ownerDomain.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+        shared = shared || entity.use_count() > 1;
+    }
+    // Дети, уничтожаемые вместе с доменом, не могут менять объём; пережившие домен
+    // могли уже прочитать указатель на него
+    if (shared) {
+        EpochManager::instance().synchronize();
+    }
+}
+
+DomainSummary& DomainSummary::operator+=(const DomainSummary& other) noexcept {
+    for (size_t i = 0; i < counts.size(); ++i) {
+        counts[i] += other.counts[i];
+    }
+    totalStorageMB += other.totalStorageMB;
+    usedStorageMB += other.usedStorageMB;
+    return *this;
+}
+
+DomainSummary& DomainSummary::operator-=(const DomainSummary& other) noexcept {
+    for (size_t i = 0; i < counts.size(); ++i) {
+        counts[i] -= other.counts[i];
+    }
+    totalStorageMB -= other.totalStorageMB;
+    usedStorageMB -= other.usedStorageMB;
+    return *this;
+}
+
+DomainSummary Domain::contributionOf(const NetworkEntity& entity) noexcept {
+    DomainSummary contribution;
+    if (const auto* domain = entityCast<Domain>(&entity)) {
+        contribution = domain->subtree;
+    }
+    else if (const auto* storage = entityCast<DataStorage>(&entity)) {
+        contribution.totalStorageMB = storage->getTotalSize();
+    }
+    ++contribution.counts[static_cast<size_t>(entity.kind())];
+    return contribution;
+}
+
+void Domain::addToSummaries(const DomainSummary& delta) noexcept {
+    for (Domain* domain = this; domain; domain = domain->getOwnerDomain()) {
+        domain->subtree += delta;
+    }
+}
+
+void Domain::subtractFromSummaries(const DomainSummary& delta) noexcept {
+    for (Domain* domain = this; domain; domain = domain->getOwnerDomain()) {
+        domain->subtree -= delta;
+    }
+}
+
+uint64_t Domain::usedBytesOf(const NetworkEntity& entity) noexcept {
+    if (const auto* storage = entityCast<DataStorage>(&entity)) {
+        return storage->getUsedBytes();
+    }
+    if (const auto* domain = entityCast<Domain>(&entity)) {
+        return domain->subtreeUsedBytes.load(std::memory_order_seq_cst);
+    }
+    return 0;
+}
+
+bool Domain::reconcileUsage(NetworkEntity& entity, Domain& owner) noexcept {
+    // Обмен возвращает объём, учтённый предыдущим сверявшим потоком, поэтому приращения
+    // всех потоков в сумме дают последний учтённый объём (беззнаковая арифметика по модулю)
+    bool changed = false;
+    for (uint64_t used = usedBytesOf(entity);
+        used != entity.reportedUsedBytes.load(std::memory_order_acquire);
+        used = usedBytesOf(entity)) {
+        const uint64_t previous = entity.reportedUsedBytes.exchange(used, std::memory_order_acq_rel);
+        owner.subtreeUsedBytes.fetch_add(used - previous, std::memory_order_seq_cst);
+        changed = true;
+    }
+    return changed;
+}
+
+void Domain::propagateUsage(NetworkEntity& entity) noexcept {
+    EpochGuard guard;
+    NetworkEntity* current = &entity;
+    while (Domain* owner = current->getOwnerDomain()) {
+        if (!reconcileUsage(*current, *owner)) {
+            return;
+        }
+        current = owner;
+    }
+}
+
+void Domain::adopt(NetworkEntity& entity) noexcept {
+    // Запись владельца и последующее чтение объёма последовательно согласованы с
+    // изменением объёма и чтением владельца в потоке хранилища: хотя бы одна
+    // сторона видит запись другой, и объём не теряется
+    entity.reportedUsedBytes.store(0, std::memory_order_relaxed);
+    entity.ownerDomain.store(this, std::memory_order_seq_cst);
+    noteOwnerChanged(entity);
+    addToSummaries(contributionOf(entity));
+    propagateUsage(entity);
+}
+
+void Domain::noteOwnerChanged(NetworkEntity& entity) noexcept {
+    if (entity.kind() == EntityKind::Domain) {
+        static_cast<Domain&>(entity).bumpStructureVersion();
+    }
+}
+
 void Domain::addEntity(std::shared_ptr<NetworkEntity> entity, const std::string& user) {
     checkAdminRights(user);
     validateEntity(entity);
@@ -26,7 +148,45 @@ void Domain::addEntity(std::shared_ptr<NetworkEntity> entity, const std::string&
                                      "' уже существует в домене '" + getId() + "'");
     }
     
-    entities[entity->getId()] = entity;
+    entities[entity->getIdSymbol().view()] = entity;
+    bumpStructureVersion();
+    adopt(*entity);
+}
+
+void Domain::addEntities(std::span<const std::shared_ptr<NetworkEntity>> batch, const std::string& user) {
+    checkAdminRights(user);
+
+    // Один проход: валидация, поиск дубликатов в домене и внутри пакета
+    std::unordered_set<Symbol> batchIds;
+    batchIds.reserve(batch.size());
+    for (const auto& entity : batch) {
+        validateEntity(entity);
+        const Symbol entityId = entity->getIdSymbol();
+        if (entities.find(entityId.view()) != entities.end() || !batchIds.insert(entityId).second) {
+            throw DomainOperationException("Сущность с идентификатором '" + entity->getId() +
+                "' уже существует в домене '" + getId() + "'");
+        }
+    }
+
+    reserveAdditional(entities, batch.size());
+    bumpStructureVersion();
+    // Вклад пакета поднимается к предкам одним проходом
+    DomainSummary added;
+    for (const auto& entity : batch) {
+        entities.emplace(entity->getIdSymbol().view(), entity);
+        entity->reportedUsedBytes.store(0, std::memory_order_relaxed);
+        entity->ownerDomain.store(this, std::memory_order_seq_cst);
+        noteOwnerChanged(*entity);
+        added += contributionOf(*entity);
+    }
+    addToSummaries(added);
+    bool usageChanged = false;
+    for (const auto& entity : batch) {
+        usageChanged = reconcileUsage(*entity, *this) || usageChanged;
+    }
+    if (usageChanged) {
+        propagateUsage(*this);
+    }
 }
 
 void Domain::removeEntity(const std::string& entityId, const std::string& user) {
@@ -42,6 +202,17 @@ void Domain::removeEntity(const std::string& entityId, const std::string& user)
                                      "' не найдена в домене '" + getId() + "'");
     }
     
+    NetworkEntity& entity = *it->second;
+    Domain* expected = this;
+    entity.ownerDomain.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+    // Потоки, уже прочитавшие владельца, заканчивают перенос объёма; после этого
+    // учтённый объём сущности больше не меняется и вычитается одним снимком
+    EpochManager::instance().synchronize();
+    noteOwnerChanged(entity);
+    subtractFromSummaries(contributionOf(entity));
+    subtreeUsedBytes.fetch_sub(entity.reportedUsedBytes.load(std::memory_order_acquire), std::memory_order_seq_cst);
+    propagateUsage(*this);
+    bumpStructureVersion();
     entities.erase(it);
 }
 
@@ -58,6 +229,10 @@ std::shared_ptr<NetworkEntity> Domain::findEntity(const std::string& entityId) c
 }
 
 const std::string& Domain::getAdminId() const {
+    return adminId.str();
+}
+
+const Symbol& Domain::getAdminSymbol() const noexcept {
     return adminId;
 }
 
@@ -65,7 +240,13 @@ size_t Domain::getEntityCount() const {
     return entities.size();
 }
 
-const std::unordered_map<std::string, std::shared_ptr<NetworkEntity>>& Domain::getAllEntities() const {
+DomainSummary Domain::getSubtreeSummary() const noexcept {
+    DomainSummary summary = subtree;
+    summary.usedStorageMB = static_cast<double>(subtreeUsedBytes.load(std::memory_order_acquire)) / DataStorage::BYTES_PER_MB;
+    return summary;
+}
+
+const std::unordered_map<std::string_view, std::shared_ptr<NetworkEntity>>& Domain::getAllEntities() const {
     return entities;
 }
 
@@ -73,6 +254,12 @@ void Domain::printInfo() const {
     std::cout << "Домен: " << getId() << "\n";
     std::cout << "Администратор: " << adminId << "\n";
     std::cout << "Количество сущностей: " << entities.size() << "\n";
+    const DomainSummary summary = getSubtreeSummary();
+    std::cout << "Всего в поддереве: " << summary.entityCount() << " (хранилищ: "
+        << summary.count(EntityKind::DataStorage) << ", рабочих станций: "
+        << summary.count(EntityKind::Workstation) << ", принтеров: "
+        << summary.count(EntityKind::Printer) << ", доменов: "
+        << summary.count(EntityKind::Domain) << ")\n";
 }
 
 std::string Domain::getType() const {
@@ -7,8 +7,12 @@
 
 #include "NetworkEntity.h"
 #include "NetworkExceptions.h"
+#include <array>
+#include <atomic>
 #include <unordered_map>
 #include <memory>
+#include <span>
+#include <string_view>
 
  /**
   * @defgroup domain_module Модуль доменов
@@ -16,28 +20,118 @@
   * @{
   */
 
+  /**
+   * @brief Сводка по поддереву домена: число сущностей каждого вида и ёмкость хранилищ.
+   */
+struct DomainSummary {
+    std::array<size_t, 4> counts{};   ///< Число сущностей каждого вида; индекс - EntityKind
+    double totalStorageMB = 0.0;      ///< Общий объём хранилищ
+    double usedStorageMB = 0.0;       ///< Занятый объём хранилищ
+
+    /**
+     * @brief Возвращает число сущностей заданного вида.
+     * @param[in] kind Вид сущности.
+     * @return Число сущностей.
+     */
+    size_t count(EntityKind kind) const noexcept { return counts[static_cast<size_t>(kind)]; }
+
+    /**
+     * @brief Возвращает общее число сущностей всех видов.
+     * @return Сумма counts.
+     */
+    size_t entityCount() const noexcept { return counts[0] + counts[1] + counts[2] + counts[3]; }
+
+    DomainSummary& operator+=(const DomainSummary& other) noexcept;
+    DomainSummary& operator-=(const DomainSummary& other) noexcept;
+};
+
   /**
    * @brief Класс, представляющий домен в корпоративной сети.
    *
    * Домен может содержать устройства (хранилища, рабочие станции, принтеры)
    * и другие домены (поддомены). Имеет администратора, который управляет доменом.
+   *
+   * Домен поддерживает сводку по всему своему поддереву (DomainSummary): добавление
+   * и удаление сущностей переносят её вклад во все домены-предки, а изменения
+   * занятого объёма хранилищ - только разность объёмов. Поэтому сводка по поддереву
+   * читается за O(1), а изменение стоит O(глубины).
+   *
+   * Занятый объём учитывается в байтах. Каждая сущность помнит объём, уже учтённый
+   * в сводке владельца (reportedUsedBytes), и поток хранилища сверяет его с текущим
+   * уровень за уровнем, поэтому одновременные изменения объёма и отсоединение
+   * сходятся к точной сумме. Отсоединение снимает указатель на владельца и дожидается
+   * потоков, уже прочитавших его, а затем вычитает учтённый объём одним снимком.
+   * Структурные изменения одного дерева сериализуются снаружи (в CorporateNetwork -
+   * блокировкой писателя); дерево вне сети тоже требует единственного писателя.
    */
 class Domain : public NetworkEntity {
 private:
-    std::string adminId;   ///< Идентификатор администратора домена
-    std::unordered_map<std::string, std::shared_ptr<NetworkEntity>> entities;   ///< Хэш-таблица для хранения и быстрого поиска сущностей
+    Symbol adminId;   ///< Идентификатор администратора домена (интернированная строка)
+    std::unordered_map<std::string_view, std::shared_ptr<NetworkEntity>> entities;   ///< Хэш-таблица сущностей; ключи ссылаются на строки пула символов
+    DomainSummary subtree;                    ///< Сводка по поддереву (без самого домена); занятый объём - в subtreeUsedBytes
+    std::atomic<uint64_t> subtreeUsedBytes{ 0 }; ///< Занятый объём хранилищ поддерева в байтах; меняется хранилищами без блокировок
+    std::atomic<uint64_t> structureVersion{ 0 }; ///< Счётчик изменений набора детей и привязки домена к владельцу
+
+    friend class DataStorage;
 
     /**
-     * @brief Проверяет права доступа пользователя на выполнение операций в домене.
-     * @param[in] user Идентификатор пользователя.
-     * @throw AccessDeniedException Если пользователь не является администратором.
+     * @brief Возвращает вклад сущности в сводку содержащего её домена без занятого объёма.
+     * @param[in] entity Сущность.
+     * @return Сама сущность и, для домена, всё его поддерево.
      */
-    void checkAdminRights(const std::string& user) const {
-        if (user != adminId) {
-            throw AccessDeniedException("Пользователь '" + user + "' не является администратором домена '" +
-                getId() + "'. Требуются права администратора '" + adminId + "'");
-        }
-    }
+    static DomainSummary contributionOf(const NetworkEntity& entity) noexcept;
+
+    /**
+     * @brief Прибавляет вклад к сводкам этого домена и всех его предков.
+     * @param[in] delta Вклад.
+     */
+    void addToSummaries(const DomainSummary& delta) noexcept;
+
+    /**
+     * @brief Вычитает вклад из сводок этого домена и всех его предков.
+     * @param[in] delta Вклад.
+     */
+    void subtractFromSummaries(const DomainSummary& delta) noexcept;
+
+    /**
+     * @brief Возвращает занятый объём, который сущность вносит в сводку владельца.
+     * @param[in] entity Сущность.
+     * @return Занятый объём хранилища или поддерева домена в байтах.
+     */
+    static uint64_t usedBytesOf(const NetworkEntity& entity) noexcept;
+
+    /**
+     * @brief Сверяет учтённый владельцем занятый объём сущности с текущим.
+     * @param[in,out] entity Сущность.
+     * @param[in,out] owner Домен, в сводке которого учтена сущность.
+     * @return true если сводка владельца изменилась.
+     */
+    static bool reconcileUsage(NetworkEntity& entity, Domain& owner) noexcept;
+
+    /**
+     * @brief Переносит изменение занятого объёма сущности в сводки всех доменов-предков.
+     * @param[in,out] entity Хранилище или домен, объём которого изменился.
+     * @details Подъём прекращается на уровне, где сводка уже совпадает: её дальше
+     * переносит поток, который её изменил.
+     */
+    static void propagateUsage(NetworkEntity& entity) noexcept;
+
+    /**
+     * @brief Делает домен владельцем сущности и учитывает её в сводках.
+     * @param[in] entity Добавленная сущность.
+     */
+    void adopt(NetworkEntity& entity) noexcept;
+
+    /**
+     * @brief Отмечает изменение структуры домена.
+     */
+    void bumpStructureVersion() noexcept { structureVersion.fetch_add(1, std::memory_order_release); }
+
+    /**
+     * @brief Отмечает смену владельца сущности: для домена увеличивает его версию.
+     * @param[in] entity Добавленная или удалённая сущность.
+     */
+    static void noteOwnerChanged(NetworkEntity& entity) noexcept;
 
     /**
      * @brief Проверяет валидность сущности перед добавлением.
@@ -62,6 +156,43 @@ public:
      */
     Domain(const std::string& id, const std::string& admin);
 
+    /**
+     * @brief Конструктор домена с уже интернированными идентификаторами.
+     * @param[in] id Символ идентификатора домена.
+     * @param[in] admin Символ идентификатора администратора.
+     * @throw ValidationException Если параметры невалидны.
+     */
+    Domain(Symbol id, Symbol admin);
+
+    /**
+     * @brief Деструктор: отвязывает переживших домен детей от него.
+     * @details Если дети используются где-то ещё, дожидается потоков, которые уже
+     * переносят изменение их объёма через этот домен.
+     */
+    ~Domain() override;
+
+    /**
+     * @brief Проверяет права доступа пользователя на выполнение операций в домене.
+     * @param[in] user Идентификатор пользователя.
+     * @throw AccessDeniedException Если пользователь не является администратором.
+     * @details Строка пользователя только ищется в пуле символов (без добавления),
+     * после чего выполняется сравнение целых чисел.
+     */
+    void checkAdminRights(const std::string& user) const {
+        auto userSymbol = Symbol::lookup(user);
+        if (!userSymbol || *userSymbol != adminId) {
+            throw AccessDeniedException("Пользователь '" + user + "' не является администратором домена '" +
+                getId() + "'. Требуются права администратора '" + adminId.str() + "'");
+        }
+    }
+
+    /**
+     * @brief Проверяет, соответствует ли вид сущности домену.
+     * @param[in] kind Проверяемый вид.
+     * @return true для EntityKind::Domain.
+     */
+    static constexpr bool isKindOf(EntityKind kind) noexcept { return kind == EntityKind::Domain; }
+
     /**
      * @brief Добавляет сущность в домен.
      * @param[in] entity Указатель на сущность для добавления.
@@ -71,6 +202,18 @@ public:
      */
     void addEntity(std::shared_ptr<NetworkEntity> entity, const std::string& user);
 
+    /**
+     * @brief Добавляет пакет сущностей в домен по принципу "всё или ничего".
+     * @param[in] batch Сущности для добавления.
+     * @param[in] user Идентификатор пользователя, пытающегося добавить сущности.
+     * @throw AccessDeniedException Если пользователь не имеет прав администратора.
+     * @throw ValidationException Если какая-либо сущность невалидна.
+     * @throw DomainOperationException Если какой-либо идентификатор уже есть в домене или повторяется в пакете.
+     * @details Права проверяются один раз, ёмкость хэш-таблицы резервируется заранее.
+     * При любой ошибке домен остаётся без изменений.
+     */
+    void addEntities(std::span<const std::shared_ptr<NetworkEntity>> batch, const std::string& user);
+
     /**
      * @brief Удаляет сущность из домена по идентификатору.
      * @param[in] entityId Идентификатор сущности для удаления.
@@ -93,17 +236,40 @@ public:
      */
     const std::string& getAdminId() const;
 
+    /**
+     * @brief Возвращает интернированный идентификатор администратора домена.
+     * @return Символ администратора.
+     */
+    const Symbol& getAdminSymbol() const noexcept;
+
     /**
      * @brief Возвращает количество сущностей в домене.
      * @return Количество сущностей.
      */
     size_t getEntityCount() const;
 
+    /**
+     * @brief Возвращает сводку по всему поддереву домена за O(1).
+     * @return Число сущностей каждого вида и ёмкость хранилищ во всех поддоменах;
+     * сам домен не учитывается.
+     */
+    DomainSummary getSubtreeSummary() const noexcept;
+
+    /**
+     * @brief Возвращает версию структуры домена.
+     * @return Значение, которое увеличивается при каждом добавлении или удалении детей
+     * домена (в том числе при перестроении их таблицы) и при добавлении или удалении
+     * самого домена из родителя.
+     * @details Позволяет обходам, запомнившим итераторы по детям, обнаружить изменение
+     * только этого домена, не реагируя на изменения остальной сети.
+     */
+    uint64_t getStructureVersion() const noexcept { return structureVersion.load(std::memory_order_acquire); }
+
     /**
      * @brief Возвращает все сущности домена.
      * @return Константная ссылка на хэш-таблицу сущностей.
      */
-    const std::unordered_map<std::string, std::shared_ptr<NetworkEntity>>& getAllEntities() const;
+    const std::unordered_map<std::string_view, std::shared_ptr<NetworkEntity>>& getAllEntities() const;
 
     void printInfo() const override;
     std::string getType() const override;
@@ -0,0 +1,216 @@
+﻿/**
+ * @file EntityIndex.cpp
+ * @brief Реализация шардированного индекса сущностей с чтением без блокировок.
+ */
+
+#include "EntityIndex.h"
+#include "NetworkEntity.h"
+#include "Domain.h"
+#include "GrowthPolicy.h"
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <limits>
+#include <utility>
+
+namespace {
+
+    constexpr size_t MIN_SHARD_CAPACITY = 16;
+    constexpr int SHARD_SHIFT = std::numeric_limits<size_t>::digits - std::countr_zero(EntityIndex::SHARD_COUNT);
+
+    static_assert(std::has_single_bit(EntityIndex::SHARD_COUNT), "SHARD_COUNT должен быть степенью двойки");
+
+}
+
+const EntityIndexEntry EntityIndex::TOMBSTONE{};
+
+EntityIndex::Table::Table(size_t capacity)
+    : mask(capacity - 1), slots(new std::atomic<const EntityIndexEntry*>[capacity]) {
+    for (size_t i = 0; i < capacity; ++i) {
+        slots[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+void EntityIndex::Shard::rebuild(size_t expectedCount) {
+    // Заполнение не выше 1/2, чтобы у читателей всегда был пустой слот в конце цепочки
+    const size_t capacity = std::max(MIN_SHARD_CAPACITY, std::bit_ceil(expectedCount * 2 + 1));
+    Table* old = table.load(std::memory_order_relaxed);
+    auto* fresh = new Table(capacity);
+    for (size_t i = 0; i <= old->mask; ++i) {
+        const EntityIndexEntry* entry = old->slots[i].load(std::memory_order_relaxed);
+        if (!entry || entry == &TOMBSTONE) {
+            continue;
+        }
+        size_t slot = hashOf(entry->id) & fresh->mask;
+        while (fresh->slots[slot].load(std::memory_order_relaxed)) {
+            slot = (slot + 1) & fresh->mask;
+        }
+        fresh->slots[slot].store(entry, std::memory_order_relaxed);
+    }
+    usedCount = liveCount.load(std::memory_order_relaxed);
+
+    // Записи переходят в новую таблицу, старая освобождается после льготного периода
+    table.store(fresh, std::memory_order_release);
+    EpochManager::instance().retireObject(old);
+}
+
+EntityIndex::EntityIndex() : shards(new Shard[SHARD_COUNT]) {
+    for (size_t s = 0; s < SHARD_COUNT; ++s) {
+        shards[s].table.store(new Table(MIN_SHARD_CAPACITY), std::memory_order_relaxed);
+    }
+}
+
+EntityIndex::~EntityIndex() {
+    destroy();
+}
+
+EntityIndex::EntityIndex(EntityIndex&& other) noexcept : shards(std::move(other.shards)) {
+}
+
+EntityIndex& EntityIndex::operator=(EntityIndex&& other) noexcept {
+    if (this != &other) {
+        destroy();
+        shards = std::move(other.shards);
+    }
+    return *this;
+}
+
+void EntityIndex::destroy() noexcept {
+    if (!shards) {
+        return;
+    }
+    for (size_t s = 0; s < SHARD_COUNT; ++s) {
+        Table* current = shards[s].table.exchange(nullptr);
+        for (size_t i = 0; i <= current->mask; ++i) {
+            const EntityIndexEntry* entry = current->slots[i].load(std::memory_order_relaxed);
+            if (entry && entry != &TOMBSTONE) {
+                delete entry;
+            }
+        }
+        delete current;
+    }
+    shards.reset();
+}
+
+size_t EntityIndex::hashOf(std::string_view id) noexcept {
+    return std::hash<std::string_view>{}(id);
+}
+
+EntityIndex::Shard& EntityIndex::shardFor(size_t hash) const noexcept {
+    // Старшие биты выбирают шард, младшие - слот внутри таблицы шарда
+    return shards[hash >> SHARD_SHIFT];
+}
+
+const EntityIndexEntry* EntityIndex::find(std::string_view id) const noexcept {
+    const size_t hash = hashOf(id);
+    const Table* current = shardFor(hash).table.load(std::memory_order_acquire);
+    for (size_t i = hash & current->mask;; i = (i + 1) & current->mask) {
+        const EntityIndexEntry* entry = current->slots[i].load(std::memory_order_acquire);
+        if (!entry) {
+            return nullptr;
+        }
+        if (entry != &TOMBSTONE && entry->id == id) {
+            return entry;
+        }
+    }
+}
+
+size_t EntityIndex::size() const noexcept {
+    size_t total = 0;
+    for (size_t s = 0; s < SHARD_COUNT; ++s) {
+        total += shards[s].liveCount.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void EntityIndex::reserveAdditional(size_t additional) {
+    if (additional < SHARD_COUNT) {
+        return; // Небольшие пакеты укладываются в обычный рост шардов
+    }
+    const size_t perShard = (additional + SHARD_COUNT - 1) / SHARD_COUNT;
+    for (size_t s = 0; s < SHARD_COUNT; ++s) {
+        Shard& shard = shards[s];
+        std::lock_guard lock(shard.writerMutex);
+        const size_t live = shard.liveCount.load(std::memory_order_relaxed);
+        const Table* current = shard.table.load(std::memory_order_relaxed);
+        if ((shard.usedCount + perShard) * 2 >= current->mask + 1) {
+            shard.rebuild(grownCapacity(live, perShard));
+        }
+    }
+}
+
+bool EntityIndex::store(std::shared_ptr<NetworkEntity> entity, std::shared_ptr<Domain> parent, bool replaceExisting) {
+    const std::string_view id = entity->getIdSymbol().view();
+    const size_t hash = hashOf(id);
+    Shard& shard = shardFor(hash);
+    std::lock_guard lock(shard.writerMutex);
+
+    const size_t live = shard.liveCount.load(std::memory_order_relaxed);
+    Table* current = shard.table.load(std::memory_order_relaxed);
+    if ((shard.usedCount + 1) * 2 >= current->mask + 1) {
+        shard.rebuild(std::max(live + 1, live * 2));
+        current = shard.table.load(std::memory_order_relaxed);
+    }
+
+    std::atomic<const EntityIndexEntry*>* freeSlot = nullptr;
+    bool consumesEmptySlot = false;
+    for (size_t i = hash & current->mask;; i = (i + 1) & current->mask) {
+        const EntityIndexEntry* existing = current->slots[i].load(std::memory_order_relaxed);
+        if (!existing) {
+            if (!freeSlot) {
+                freeSlot = &current->slots[i];
+                consumesEmptySlot = true;
+            }
+            break;
+        }
+        if (existing == &TOMBSTONE) {
+            if (!freeSlot) {
+                freeSlot = &current->slots[i];
+            }
+            continue;
+        }
+        if (existing->id == id) {
+            if (!replaceExisting) {
+                return false;
+            }
+            current->slots[i].store(new EntityIndexEntry{ id, std::move(entity), std::move(parent) },
+                std::memory_order_release);
+            EpochManager::instance().retireObject(existing);
+            return true;
+        }
+    }
+
+    freeSlot->store(new EntityIndexEntry{ id, std::move(entity), std::move(parent) }, std::memory_order_release);
+    if (consumesEmptySlot) {
+        ++shard.usedCount;
+    }
+    shard.liveCount.store(live + 1, std::memory_order_relaxed);
+    return true;
+}
+
+void EntityIndex::assign(std::shared_ptr<NetworkEntity> entity, std::shared_ptr<Domain> parent) {
+    store(std::move(entity), std::move(parent), true);
+}
+
+bool EntityIndex::insert(std::shared_ptr<NetworkEntity> entity, std::shared_ptr<Domain> parent) {
+    return store(std::move(entity), std::move(parent), false);
+}
+
+bool EntityIndex::erase(std::string_view id) {
+    const size_t hash = hashOf(id);
+    Shard& shard = shardFor(hash);
+    std::lock_guard lock(shard.writerMutex);
+    Table* current = shard.table.load(std::memory_order_relaxed);
+    for (size_t i = hash & current->mask;; i = (i + 1) & current->mask) {
+        const EntityIndexEntry* existing = current->slots[i].load(std::memory_order_relaxed);
+        if (!existing) {
+            return false;
+        }
+        if (existing != &TOMBSTONE && existing->id == id) {
+            current->slots[i].store(&TOMBSTONE, std::memory_order_release);
+            EpochManager::instance().retireObject(existing);
+            shard.liveCount.store(shard.liveCount.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+}
@@ -0,0 +1,166 @@
+﻿/**
+ * @file EntityIndex.h
+ * @brief Заголовочный файл класса EntityIndex - шардированного индекса сущностей сети с чтением без блокировок.
+ */
+
+#pragma once
+
+#include "EpochReclamation.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string_view>
+
+class NetworkEntity;
+class Domain;
+
+/**
+ * @addtogroup concurrency_module
+ * @{
+ */
+
+ /**
+  * @brief Неизменяемая запись индекса: сущность и её домен-владелец.
+  */
+struct EntityIndexEntry {
+    std::string_view id;                        ///< Идентификатор (ссылается на строку пула символов)
+    std::shared_ptr<NetworkEntity> entity;      ///< Сущность
+    std::shared_ptr<Domain> parent;             ///< Домен-владелец (nullptr для корневого домена)
+};
+
+/**
+ * @brief Шардированный хэш-индекс сущностей по идентификатору с чтением без блокировок (RCU).
+ *
+ * Идентификаторы распределяются по SHARD_COUNT шардам по старшим битам хэша.
+ * Каждый шард - таблица с открытой адресацией из атомарных указателей на
+ * неизменяемые записи, со своим мьютексом писателей и собственным расширением.
+ * Вставки и удаления разных идентификаторов в большинстве случаев берут разные
+ * мьютексы и не конкурируют, а расширение одного шарда не задерживает остальные.
+ *
+ * Писатель публикует новую запись одной атомарной записью указателя. Заменённые
+ * и удалённые записи, а также старые таблицы после расширения передаются
+ * EpochManager и освобождаются после окончания льготного периода.
+ * Читатели вызывают find() внутри EpochGuard и никогда не ждут.
+ */
+class EntityIndex {
+public:
+    static constexpr size_t SHARD_COUNT = 64;   ///< Число шардов (степень двойки)
+
+private:
+    /**
+     * @brief Таблица слотов; после замены на более крупную не изменяется.
+     */
+    struct Table {
+        size_t mask;                                                ///< Ёмкость - 1 (ёмкость - степень двойки)
+        std::unique_ptr<std::atomic<const EntityIndexEntry*>[]> slots; ///< Слоты (nullptr - пусто)
+
+        explicit Table(size_t capacity);
+    };
+
+    /**
+     * @brief Шард индекса; занимает собственную строку кэша.
+     */
+    struct alignas(64) Shard {
+        std::mutex writerMutex;                 ///< Сериализует изменения шарда
+        std::atomic<Table*> table{ nullptr };   ///< Опубликованная таблица
+        std::atomic<size_t> liveCount{ 0 };     ///< Число живых записей (пишется под writerMutex)
+        size_t usedCount = 0;                   ///< Занятые слоты: живые записи и метки удаления
+
+        /**
+         * @brief Перестраивает таблицу под заданное число записей и публикует её.
+         * @details Вызывается под writerMutex.
+         */
+        void rebuild(size_t expectedCount);
+    };
+
+    static const EntityIndexEntry TOMBSTONE;   ///< Метка удалённого слота
+
+    std::unique_ptr<Shard[]> shards;           ///< Шарды индекса
+
+    static size_t hashOf(std::string_view id) noexcept;
+    Shard& shardFor(size_t hash) const noexcept;
+
+    /**
+     * @brief Добавляет запись или, если разрешено, заменяет существующую.
+     * @return false если идентификатор занят и замена не разрешена.
+     */
+    bool store(std::shared_ptr<NetworkEntity> entity, std::shared_ptr<Domain> parent, bool replaceExisting);
+
+    /**
+     * @brief Удаляет таблицы и все живые записи без льготного периода.
+     */
+    void destroy() noexcept;
+
+public:
+    EntityIndex();
+    ~EntityIndex();
+
+    EntityIndex(EntityIndex&& other) noexcept;
+    EntityIndex& operator=(EntityIndex&& other) noexcept;
+    EntityIndex(const EntityIndex&) = delete;
+    EntityIndex& operator=(const EntityIndex&) = delete;
+
+    /**
+     * @brief Ищет запись по идентификатору.
+     * @param[in] id Идентификатор сущности.
+     * @return Запись или nullptr. Читатели должны держать EpochGuard, пока используют запись.
+     */
+    const EntityIndexEntry* find(std::string_view id) const noexcept;
+
+    /**
+     * @brief Добавляет или заменяет запись сущности.
+     * @param[in] entity Сущность.
+     * @param[in] parent Домен-владелец.
+     * @details Потокобезопасно; блокирует только шард идентификатора.
+     */
+    void assign(std::shared_ptr<NetworkEntity> entity, std::shared_ptr<Domain> parent);
+
+    /**
+     * @brief Добавляет запись, только если идентификатор ещё не занят.
+     * @param[in] entity Сущность.
+     * @param[in] parent Домен-владелец.
+     * @return true если запись добавлена, false если идентификатор уже есть в индексе.
+     * @details Потокобезопасно; проверка и вставка атомарны в пределах шарда.
+     */
+    bool insert(std::shared_ptr<NetworkEntity> entity, std::shared_ptr<Domain> parent);
+
+    /**
+     * @brief Удаляет запись по идентификатору.
+     * @param[in] id Идентификатор сущности.
+     * @return true если запись была удалена.
+     * @details Потокобезопасно; блокирует только шард идентификатора.
+     */
+    bool erase(std::string_view id);
+
+    /**
+     * @brief Резервирует место под additional новых записей с геометрическим ростом.
+     * @param[in] additional Ожидаемое число добавляемых записей (распределяется по шардам).
+     */
+    void reserveAdditional(size_t additional);
+
+    /**
+     * @brief Возвращает число записей.
+     * @return Число живых записей; при параллельных изменениях - приблизительное.
+     */
+    size_t size() const noexcept;
+
+    /**
+     * @brief Обходит все записи.
+     * @param[in] visit Функция, вызываемая для каждой записи.
+     * @details Не должен выполняться параллельно с изменениями индекса.
+     */
+    template <typename Visitor>
+    void forEach(Visitor&& visit) const {
+        for (size_t s = 0; s < SHARD_COUNT; ++s) {
+            const Table* current = shards[s].table.load(std::memory_order_acquire);
+            for (size_t i = 0; i <= current->mask; ++i) {
+                const EntityIndexEntry* entry = current->slots[i].load(std::memory_order_relaxed);
+                if (entry && entry != &TOMBSTONE) {
+                    visit(*entry);
+                }
+            }
+        }
+    }
+};
+
+/** @} */ // Конец группы concurrency_module
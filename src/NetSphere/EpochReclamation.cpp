@@ -0,0 +1,146 @@
+﻿/**
+ * @file EpochReclamation.cpp
+ * @brief Реализация отложенного освобождения памяти по эпохам.
+ */
+
+#include "EpochReclamation.h"
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+namespace {
+
+    /**
+     * @brief Закрепление записи за потоком; при завершении потока запись возвращается в список.
+     */
+    template <typename Record>
+    struct RecordLease {
+        Record* record = nullptr;
+
+        ~RecordLease() {
+            if (record) {
+                record->activeEpoch.store(0, std::memory_order_release);
+                record->inUse.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+}
+
+EpochManager& EpochManager::instance() {
+    // Намеренно не уничтожается: потоки могут завершаться после выхода из main
+    static EpochManager* manager = new EpochManager();
+    return *manager;
+}
+
+EpochManager::ThreadRecord* EpochManager::acquireRecord() {
+    for (ThreadRecord* record = records.load(std::memory_order_acquire); record; record = record->next) {
+        bool expected = false;
+        if (!record->inUse.load(std::memory_order_relaxed) &&
+            record->inUse.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            return record;
+        }
+    }
+
+    auto* record = new ThreadRecord();
+    record->inUse.store(true, std::memory_order_relaxed);
+    ThreadRecord* head = records.load(std::memory_order_relaxed);
+    do {
+        record->next = head;
+    } while (!records.compare_exchange_weak(head, record, std::memory_order_release, std::memory_order_relaxed));
+    return record;
+}
+
+EpochManager::ThreadRecord& EpochManager::localRecord() {
+    thread_local RecordLease<ThreadRecord> lease;
+    if (!lease.record) {
+        lease.record = instance().acquireRecord();
+    }
+    return *lease.record;
+}
+
+void EpochManager::retire(void* object, void (*deleter)(void*)) {
+    std::vector<Retired> reclaimable;
+    {
+        std::lock_guard lock(retireMutex);
+        limbo.push_back({ globalEpoch.fetch_add(1, std::memory_order_seq_cst), object, deleter });
+        if (limbo.size() >= COLLECT_THRESHOLD) {
+            reclaimable = collectLocked();
+        }
+    }
+    reclaim(reclaimable);
+}
+
+void EpochManager::collect() {
+    std::vector<Retired> reclaimable;
+    {
+        std::lock_guard lock(retireMutex);
+        reclaimable = collectLocked();
+    }
+    reclaim(reclaimable);
+}
+
+void EpochManager::reclaim(const std::vector<Retired>& reclaimable) noexcept {
+    for (const Retired& retired : reclaimable) {
+        retired.deleter(retired.object);
+    }
+}
+
+std::vector<EpochManager::Retired> EpochManager::collectLocked() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t oldestActive = std::numeric_limits<uint64_t>::max();
+    for (ThreadRecord* record = records.load(std::memory_order_acquire); record; record = record->next) {
+        const uint64_t epoch = record->activeEpoch.load(std::memory_order_relaxed);
+        if (epoch != 0) {
+            oldestActive = std::min(oldestActive, epoch);
+        }
+    }
+
+    // Объект, удалённый в эпоху e, недостижим для читателей, вошедших в эпоху больше e
+    auto reclaimable = std::partition(limbo.begin(), limbo.end(),
+        [oldestActive](const Retired& retired) { return retired.epoch >= oldestActive; });
+    std::vector<Retired> result(reclaimable, limbo.end());
+    limbo.erase(reclaimable, limbo.end());
+    return result;
+}
+
+void EpochManager::synchronize() {
+    // Продвижение эпохи и барьер парны барьеру EpochGuard: читатель, вошедший позже,
+    // видит все изменения, сделанные до вызова
+    const uint64_t target = globalEpoch.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const ThreadRecord* self = &localRecord();
+    for (ThreadRecord* record = records.load(std::memory_order_acquire); record; record = record->next) {
+        if (record == self) {
+            continue;
+        }
+        for (uint64_t epoch = record->activeEpoch.load(std::memory_order_acquire);
+            epoch != 0 && epoch <= target;
+            epoch = record->activeEpoch.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+size_t EpochManager::pendingCount() {
+    std::lock_guard lock(retireMutex);
+    return limbo.size();
+}
+
+EpochGuard::EpochGuard() : record(EpochManager::localRecord()) {
+    if (record.depth++ != 0) {
+        return;
+    }
+    // Эпоха читается с acquire: если она уже продвинута после удаления объекта,
+    // читатель гарантированно видит структуру без этого объекта. Барьер упорядочивает
+    // публикацию эпохи перед последующими чтениями структуры (парный барьер в collectLocked)
+    const uint64_t epoch = EpochManager::instance().globalEpoch.load(std::memory_order_acquire);
+    record.activeEpoch.store(epoch, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+EpochGuard::~EpochGuard() {
+    if (--record.depth == 0) {
+        record.activeEpoch.store(0, std::memory_order_release);
+    }
+}
@@ -0,0 +1,141 @@
+﻿/**
+ * @file EpochReclamation.h
+ * @brief Заголовочный файл механизма отложенного освобождения памяти по эпохам.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+ /**
+  * @defgroup concurrency_module Модуль конкурентного доступа
+  * @brief Чтение структур сети без блокировок при одновременных изменениях
+  * @{
+  */
+
+  /**
+   * @brief Глобальный менеджер эпох для безопасного освобождения памяти (epoch-based reclamation).
+   *
+   * Читатель входит в критическую секцию через EpochGuard: публикует текущую
+   * глобальную эпоху в своей записи потока и больше не пишет в разделяемую
+   * память, поэтому чтение не ждёт писателей и не конфликтует с другими
+   * читателями. Писатель, удаливший объект из структуры, передаёт его в retire():
+   * объект помечается эпохой удаления, а глобальная эпоха продвигается.
+   * Объект освобождается, когда все активные читатели вошли в более позднюю эпоху.
+   */
+class EpochManager {
+private:
+    /**
+     * @brief Запись потока-читателя; занимает собственную строку кэша.
+     */
+    struct alignas(64) ThreadRecord {
+        std::atomic<uint64_t> activeEpoch{ 0 };   ///< Эпоха входа в критическую секцию (0 - вне секции)
+        std::atomic<bool> inUse{ false };         ///< Запись закреплена за живым потоком
+        uint32_t depth = 0;                       ///< Глубина вложенных секций (меняет только владелец)
+        ThreadRecord* next = nullptr;             ///< Следующая запись списка (записи не удаляются)
+    };
+
+    /**
+     * @brief Объект, ожидающий освобождения.
+     */
+    struct Retired {
+        uint64_t epoch;                 ///< Эпоха удаления из структуры
+        void* object;                   ///< Освобождаемый объект
+        void (*deleter)(void*);         ///< Функция освобождения
+    };
+
+    static constexpr size_t COLLECT_THRESHOLD = 128;   ///< Размер очереди, при котором запускается сборка
+
+    std::atomic<uint64_t> globalEpoch{ 1 };            ///< Текущая глобальная эпоха
+    std::atomic<ThreadRecord*> records{ nullptr };     ///< Список записей потоков
+    std::mutex retireMutex;                            ///< Защищает очередь освобождения
+    std::vector<Retired> limbo;                        ///< Объекты, ожидающие окончания льготного периода
+
+    EpochManager() = default;
+
+    ThreadRecord* acquireRecord();
+    static ThreadRecord& localRecord();
+
+    /**
+     * @brief Извлекает из очереди объекты, которые уже не может видеть ни один читатель.
+     * @return Извлечённые объекты.
+     * @details Вызывается под retireMutex. Освобождаются объекты уже после снятия
+     * блокировки: деструктор может сам ждать читателей через synchronize().
+     */
+    std::vector<Retired> collectLocked();
+
+    /**
+     * @brief Освобождает извлечённые объекты.
+     * @param[in] reclaimable Объекты, полученные от collectLocked().
+     */
+    static void reclaim(const std::vector<Retired>& reclaimable) noexcept;
+
+    friend class EpochGuard;
+
+public:
+    EpochManager(const EpochManager&) = delete;
+    EpochManager& operator=(const EpochManager&) = delete;
+
+    /**
+     * @brief Возвращает единственный экземпляр менеджера.
+     * @return Ссылка на глобальный менеджер эпох.
+     */
+    static EpochManager& instance();
+
+    /**
+     * @brief Откладывает освобождение объекта до окончания льготного периода.
+     * @param[in] object Объект, уже недостижимый из опубликованных структур.
+     * @param[in] deleter Функция освобождения.
+     */
+    void retire(void* object, void (*deleter)(void*));
+
+    /**
+     * @brief Откладывает удаление объекта, созданного через new.
+     * @param[in] object Объект, уже недостижимый из опубликованных структур.
+     */
+    template <typename T>
+    void retireObject(const T* object) {
+        retire(const_cast<T*>(object), [](void* pointer) { delete static_cast<T*>(pointer); });
+    }
+
+    /**
+     * @brief Освобождает всё, что уже безопасно освободить.
+     */
+    void collect();
+
+    /**
+     * @brief Ждёт завершения всех секций чтения, начатых до вызова.
+     * @details После возврата ни один читатель другого потока не держит указатель,
+     * снятый с публикации до вызова. Секция вызывающего потока не учитывается.
+     * Нельзя вызывать, удерживая блокировку, которую читатели берут внутри EpochGuard.
+     */
+    void synchronize();
+
+    /**
+     * @brief Возвращает число объектов, ожидающих освобождения.
+     * @return Размер очереди освобождения.
+     */
+    size_t pendingCount();
+};
+
+/**
+ * @brief RAII-секция чтения: пока объект жив, прочитанные указатели не будут освобождены.
+ * @details Секции могут быть вложенными. Вход не содержит циклов ожидания и пишет
+ * только в запись своего потока, поэтому чтение не ждёт (wait-free).
+ */
+class EpochGuard {
+private:
+    EpochManager::ThreadRecord& record;   ///< Запись текущего потока
+
+public:
+    EpochGuard();
+    ~EpochGuard();
+
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+};
+
+/** @} */ // Конец группы concurrency_module
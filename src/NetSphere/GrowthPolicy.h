@@ -0,0 +1,36 @@
+﻿/**
+ * @file GrowthPolicy.h
+ * @brief Политика роста хеш-таблиц перед пакетной вставкой.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+/**
+ * @brief Возвращает ёмкость, под которую резервируется таблица перед вставкой пакета.
+ * @param[in] size Текущее число элементов.
+ * @param[in] additional Размер пакета.
+ * @return Не меньше size + additional и не меньше удвоенного size.
+ * @details Прямой reserve(size + n) на каждом пакете перестраивает таблицу при
+ * каждом вызове, и серия пакетных вставок становится квадратичной; геометрический
+ * рост сохраняет амортизированную стоимость вставки постоянной.
+ */
+constexpr size_t grownCapacity(size_t size, size_t additional) noexcept {
+    return std::max(size + additional, size * 2);
+}
+
+/**
+ * @brief Резервирует место под additional новых элементов, если его не хватает.
+ * @tparam Map Неупорядоченный контейнер стандартной библиотеки.
+ * @param[in,out] map Контейнер.
+ * @param[in] additional Размер пакета.
+ */
+template <typename Map>
+void reserveAdditional(Map& map, size_t additional) {
+    const size_t required = map.size() + additional;
+    if (required > map.bucket_count() * map.max_load_factor()) {
+        map.reserve(grownCapacity(map.size(), additional));
+    }
+}
@@ -0,0 +1,203 @@
+﻿/**
+ * @file HandleTable.h
+ * @brief Заголовочный файл шаблона HandleTable - таблицы дескрипторов с поколениями.
+ */
+
+#pragma once
+
+#include "EpochReclamation.h"
+#include "NetworkExceptions.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @addtogroup concurrency_module
+ * @{
+ */
+
+ /**
+  * @brief Таблица непрозрачных дескрипторов вида (слот, поколение) для C API.
+  *
+  * Дескриптор - 64-битное значение одинаковой раскладки на всех платформах:
+  * младшие 28 бит - номер слота, следующие 4 - тег таблицы, старшие 32 - поколение
+  * слота. Проверка
+  * дескриптора выполняется за O(1) без блокировок: слот находится по номеру,
+  * поколение сравнивается с записанным в слоте. После освобождения поколение
+  * слота увеличивается, поэтому устаревший дескриптор обнаруживается, а не
+  * разыменовывается, даже если слот уже занят новым объектом. Тег не даёт
+  * принять дескриптор одной таблицы за дескриптор другой.
+  *
+  * Выделение и освобождение слотов сериализуются мьютексом таблицы;
+  * освобождённые записи слотов передаются EpochManager и освобождаются его
+  * пороговой сборкой, а не при каждом erase(): объект дескриптора может
+  * пережить освобождение дескриптора до ближайшей сборки.
+  *
+  * @tparam T Тип объектов, на которые указывают дескрипторы.
+  */
+template <typename T>
+class HandleTable {
+public:
+    using Handle = uint64_t;    ///< Значение дескриптора; 0 - недействительный дескриптор
+
+private:
+    static constexpr int HANDLE_BITS = std::numeric_limits<Handle>::digits;
+    static constexpr int TAG_BITS = 4;
+    static constexpr int INDEX_BITS = 28;
+    static constexpr int GENERATION_SHIFT = INDEX_BITS + TAG_BITS;
+    static constexpr Handle INDEX_MASK = (Handle(1) << INDEX_BITS) - 1;
+    static constexpr Handle GENERATION_MASK = (Handle(1) << (HANDLE_BITS - GENERATION_SHIFT)) - 1;
+    static constexpr size_t CHUNK_SIZE = 1024;
+    static constexpr size_t MAX_CHUNKS = std::min<size_t>(4096, (size_t(INDEX_MASK) + 1) / CHUNK_SIZE);
+
+    /**
+     * @brief Неизменяемое содержимое занятого слота.
+     */
+    struct Payload {
+        std::shared_ptr<T> object;   ///< Объект дескриптора
+        Handle generation;           ///< Поколение, под которым выдан дескриптор
+    };
+
+    /**
+     * @brief Слот таблицы.
+     */
+    struct Slot {
+        std::atomic<const Payload*> payload{ nullptr };   ///< Текущее содержимое (nullptr - свободен)
+        Handle generation = 0;                            ///< Последнее выданное поколение (под allocationMutex)
+    };
+
+    /**
+     * @brief Блок слотов; выделяется по мере роста и не перемещается.
+     */
+    struct Chunk {
+        Slot slots[CHUNK_SIZE];
+    };
+
+    const Handle tag;                                    ///< Тег таблицы в дескрипторах
+    std::unique_ptr<std::atomic<Chunk*>[]> chunks;       ///< Блоки слотов
+    std::mutex allocationMutex;                          ///< Защищает выделение и освобождение слотов
+    std::vector<size_t> freeSlots;                       ///< Освобождённые слоты для повторного использования
+    size_t nextUnused = 0;                               ///< Первый ни разу не выданный слот
+
+    Slot* slotAt(size_t index) const noexcept {
+        if (index >= MAX_CHUNKS * CHUNK_SIZE) {
+            return nullptr;
+        }
+        Chunk* chunk = chunks[index / CHUNK_SIZE].load(std::memory_order_acquire);
+        return chunk ? &chunk->slots[index % CHUNK_SIZE] : nullptr;
+    }
+
+public:
+    /**
+     * @brief Конструктор таблицы.
+     * @param[in] tag Тег таблицы (0..15), различающий дескрипторы разных таблиц.
+     */
+    explicit HandleTable(unsigned tag)
+        : tag(Handle(tag) & ((Handle(1) << TAG_BITS) - 1)), chunks(new std::atomic<Chunk*>[MAX_CHUNKS]) {
+        for (size_t i = 0; i < MAX_CHUNKS; ++i) {
+            chunks[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~HandleTable() {
+        for (size_t c = 0; c < MAX_CHUNKS; ++c) {
+            Chunk* chunk = chunks[c].load(std::memory_order_relaxed);
+            if (!chunk) {
+                continue;
+            }
+            for (Slot& slot : chunk->slots) {
+                delete slot.payload.load(std::memory_order_relaxed);
+            }
+            delete chunk;
+        }
+    }
+
+    HandleTable(const HandleTable&) = delete;
+    HandleTable& operator=(const HandleTable&) = delete;
+
+    /**
+     * @brief Выдаёт дескриптор для объекта.
+     * @param[in] object Объект; таблица владеет им до освобождения дескриптора.
+     * @return Ненулевой дескриптор.
+     * @throw NetworkException Если свободные слоты исчерпаны.
+     */
+    Handle insert(std::shared_ptr<T> object) {
+        std::lock_guard lock(allocationMutex);
+        size_t index;
+        if (!freeSlots.empty()) {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else {
+            if (nextUnused == MAX_CHUNKS * CHUNK_SIZE) {
+                throw NetworkException("Исчерпан лимит дескрипторов");
+            }
+            index = nextUnused++;
+            if (index % CHUNK_SIZE == 0) {
+                chunks[index / CHUNK_SIZE].store(new Chunk(), std::memory_order_release);
+            }
+        }
+
+        Slot& slot = *slotAt(index);
+        // Поколение 0 не выдаётся, поэтому дескриптор никогда не равен 0
+        slot.generation = (slot.generation + 1) & GENERATION_MASK;
+        if (slot.generation == 0) {
+            slot.generation = 1;
+        }
+        slot.payload.store(new Payload{ std::move(object), slot.generation }, std::memory_order_release);
+        return (slot.generation << GENERATION_SHIFT) | (tag << INDEX_BITS) | Handle(index);
+    }
+
+    /**
+     * @brief Возвращает объект по дескриптору.
+     * @param[in] handle Дескриптор.
+     * @return Объект или nullptr, если дескриптор недействителен, устарел или принадлежит другой таблице.
+     * @details Не берёт блокировок.
+     */
+    std::shared_ptr<T> get(Handle handle) const {
+        if (((handle >> INDEX_BITS) & ((Handle(1) << TAG_BITS) - 1)) != tag) {
+            return nullptr;
+        }
+        const Slot* slot = slotAt(size_t(handle & INDEX_MASK));
+        if (!slot) {
+            return nullptr;
+        }
+        EpochGuard guard;
+        const Payload* payload = slot->payload.load(std::memory_order_acquire);
+        if (!payload || payload->generation != (handle >> GENERATION_SHIFT)) {
+            return nullptr;
+        }
+        return payload->object;
+    }
+
+    /**
+     * @brief Освобождает дескриптор.
+     * @param[in] handle Дескриптор.
+     * @return true если дескриптор был действителен и освобождён.
+     */
+    bool erase(Handle handle) {
+        if (((handle >> INDEX_BITS) & ((Handle(1) << TAG_BITS) - 1)) != tag) {
+            return false;
+        }
+        const size_t index = size_t(handle & INDEX_MASK);
+        std::lock_guard lock(allocationMutex);
+        Slot* slot = slotAt(index);
+        if (!slot) {
+            return false;
+        }
+        const Payload* payload = slot->payload.load(std::memory_order_relaxed);
+        if (!payload || payload->generation != (handle >> GENERATION_SHIFT)) {
+            return false;
+        }
+        slot->payload.store(nullptr, std::memory_order_release);
+        EpochManager::instance().retireObject(payload);
+        freeSlots.push_back(index);
+        return true;
+    }
+};
+
+/** @} */ // Конец группы concurrency_module
@@ -0,0 +1,752 @@
+﻿/**
+ * @file InventoryLoader.cpp
+ * @brief Реализация потокового параллельного загрузчика инвентаря сети.
+ */
+
+#include "InventoryLoader.h"
+#include "DataStorage.h"
+#include "Workstation.h"
+#include "Printer.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+
+    /**
+     * @brief Известные поля строки инвентаря.
+     */
+    enum class Field : size_t {
+        Type, Id, Parent, Admin, Mac, TotalMb, UsedMb, TrustedUsers, User, PowerOn, Count
+    };
+
+    constexpr std::array<std::string_view, static_cast<size_t>(Field::Count)> FIELD_NAMES = {
+        "type", "id", "parent", "admin", "mac", "total_mb", "used_mb", "trusted_users", "user", "power_on"
+    };
+
+    /**
+     * @brief Возвращает поле по имени столбца или ключа JSON.
+     * @return Поле или Field::Count для неизвестного имени.
+     */
+    Field fieldByName(std::string_view name) {
+        for (size_t i = 0; i < FIELD_NAMES.size(); ++i) {
+            if (FIELD_NAMES[i] == name) {
+                return static_cast<Field>(i);
+            }
+        }
+        return Field::Count;
+    }
+
+    /**
+     * @brief Значения полей одной строки инвентаря.
+     */
+    struct RowFields {
+        std::array<std::string, static_cast<size_t>(Field::Count)> values;
+
+        std::string& operator[](Field field) { return values[static_cast<size_t>(field)]; }
+        const std::string& operator[](Field field) const { return values[static_cast<size_t>(field)]; }
+    };
+
+    /**
+     * @brief Результат разбора одной строки.
+     *
+     * Потоки разбора заполняют поля и числовые значения, не обращаясь к пулу
+     * строк; символы интернируются потребителем один раз на блок, после чего
+     * сущность строится по ним снова на пуле потоков.
+     */
+    struct ParsedRow {
+        size_t line = 0;                            ///< Номер строки в файле
+        EntityKind kind = EntityKind::Domain;       ///< Вид сущности
+        RowFields fields;                           ///< Текстовые поля строки
+        MacAddress mac;                             ///< Разобранный MAC-адрес (для устройств)
+        double totalMb = 0;                         ///< Общий объём (для хранилищ)
+        std::optional<double> usedMb;               ///< Занятый объём, если указан
+        time_t powerOnTime = 0;                     ///< Время включения (для рабочих станций)
+        size_t firstSymbol = 0;                     ///< Начало символов строки в общем массиве блока
+        size_t symbolCount = 0;                     ///< Число символов строки: id, parent, admin/user, доверенные
+        Symbol parent;                              ///< Родительский домен (пустой символ - корневой)
+        std::shared_ptr<NetworkEntity> entity;      ///< Построенная сущность (nullptr при ошибке)
+        std::string error;                          ///< Текст ошибки разбора или валидации
+    };
+
+    /**
+     * @brief Строка, ожидающая загрузки родительского домена.
+     */
+    struct PendingRow {
+        size_t line = 0;                            ///< Номер строки в файле
+        size_t chunk = 0;                           ///< Номер блока, в котором строка прочитана
+        std::shared_ptr<NetworkEntity> entity;      ///< Построенная сущность
+    };
+
+    /**
+     * @brief Разбивает строку CSV на ячейки с поддержкой кавычек и экранирования "".
+     * @throw ValidationException При незакрытой кавычке.
+     */
+    void splitCsvLine(std::string_view line, std::vector<std::string>& cells) {
+        cells.clear();
+        std::string current;
+        bool quoted = false;
+        for (size_t i = 0; i < line.size(); ++i) {
+            const char c = line[i];
+            if (quoted) {
+                if (c == '"') {
+                    if (i + 1 < line.size() && line[i + 1] == '"') {
+                        current.push_back('"');
+                        ++i;
+                    }
+                    else {
+                        quoted = false;
+                    }
+                }
+                else {
+                    current.push_back(c);
+                }
+            }
+            else if (c == '"') {
+                quoted = true;
+            }
+            else if (c == ',') {
+                cells.push_back(std::move(current));
+                current.clear();
+            }
+            else if (c != '\r') {
+                current.push_back(c);
+            }
+        }
+        if (quoted) {
+            throw ValidationException("незакрытая кавычка в строке CSV");
+        }
+        cells.push_back(std::move(current));
+    }
+
+    /**
+     * @brief Минимальный разборщик плоского JSON-объекта одной строки.
+     *
+     * Поддерживает строковые, числовые и логические значения, а также массивы
+     * строк (элементы объединяются через ';').
+     */
+    class JsonLineParser {
+    private:
+        std::string_view text;
+        size_t pos = 0;
+
+        void skipSpaces() {
+            while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\r')) {
+                ++pos;
+            }
+        }
+
+        void expect(char c) {
+            skipSpaces();
+            if (pos >= text.size() || text[pos] != c) {
+                throw ValidationException(std::string("ожидался символ '") + c + "' в позиции " + std::to_string(pos));
+            }
+            ++pos;
+        }
+
+        static void appendUtf8(std::string& out, unsigned codePoint) {
+            if (codePoint < 0x80) {
+                out.push_back(static_cast<char>(codePoint));
+            }
+            else if (codePoint < 0x800) {
+                out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+                out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+            }
+            else {
+                out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+                out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+            }
+        }
+
+        std::string parseString() {
+            expect('"');
+            std::string result;
+            while (pos < text.size() && text[pos] != '"') {
+                char c = text[pos++];
+                if (c != '\\') {
+                    result.push_back(c);
+                    continue;
+                }
+                if (pos >= text.size()) {
+                    break;
+                }
+                c = text[pos++];
+                switch (c) {
+                case 'n': result.push_back('\n'); break;
+                case 't': result.push_back('\t'); break;
+                case 'r': result.push_back('\r'); break;
+                case 'b': result.push_back('\b'); break;
+                case 'f': result.push_back('\f'); break;
+                case 'u': {
+                    unsigned codePoint = 0;
+                    if (pos + 4 > text.size() ||
+                        std::from_chars(text.data() + pos, text.data() + pos + 4, codePoint, 16).ptr != text.data() + pos + 4) {
+                        throw ValidationException("неверная escape-последовательность \\u");
+                    }
+                    pos += 4;
+                    appendUtf8(result, codePoint);
+                    break;
+                }
+                default: result.push_back(c); break;
+                }
+            }
+            if (pos >= text.size()) {
+                throw ValidationException("незакрытая строка JSON");
+            }
+            ++pos;
+            return result;
+        }
+
+        std::string parseValue() {
+            skipSpaces();
+            if (pos < text.size() && text[pos] == '"') {
+                return parseString();
+            }
+            if (pos < text.size() && text[pos] == '[') {
+                ++pos;
+                std::string joined;
+                skipSpaces();
+                if (pos < text.size() && text[pos] == ']') {
+                    ++pos;
+                    return joined;
+                }
+                while (true) {
+                    if (!joined.empty()) {
+                        joined.push_back(';');
+                    }
+                    joined += parseString();
+                    skipSpaces();
+                    if (pos < text.size() && text[pos] == ',') {
+                        ++pos;
+                        continue;
+                    }
+                    expect(']');
+                    return joined;
+                }
+            }
+            const size_t start = pos;
+            while (pos < text.size() && text[pos] != ',' && text[pos] != '}' &&
+                text[pos] != ' ' && text[pos] != '\t' && text[pos] != '\r') {
+                ++pos;
+            }
+            std::string literal(text.substr(start, pos - start));
+            if (literal.empty()) {
+                throw ValidationException("пустое значение JSON в позиции " + std::to_string(start));
+            }
+            return literal == "null" ? std::string() : literal;
+        }
+
+    public:
+        explicit JsonLineParser(std::string_view line) : text(line) {}
+
+        void parse(RowFields& fields) {
+            expect('{');
+            skipSpaces();
+            if (pos < text.size() && text[pos] == '}') {
+                return;
+            }
+            while (true) {
+                skipSpaces();
+                std::string key = parseString();
+                expect(':');
+                std::string value = parseValue();
+                const Field field = fieldByName(key);
+                if (field != Field::Count) {
+                    fields[field] = std::move(value);
+                }
+                skipSpaces();
+                if (pos < text.size() && text[pos] == ',') {
+                    ++pos;
+                    continue;
+                }
+                expect('}');
+                return;
+            }
+        }
+    };
+
+    double parseDouble(const std::string& text, const char* fieldName) {
+        double value = 0;
+        auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (ec != std::errc() || ptr != text.data() + text.size()) {
+            throw ValidationException(std::string("поле ") + fieldName + " должно быть числом: '" + text + "'");
+        }
+        return value;
+    }
+
+    long long parseInteger(const std::string& text, const char* fieldName) {
+        long long value = 0;
+        auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (ec != std::errc() || ptr != text.data() + text.size()) {
+            throw ValidationException(std::string("поле ") + fieldName + " должно быть целым числом: '" + text + "'");
+        }
+        return value;
+    }
+
+    /**
+     * @brief Проверяет тип строки и разбирает её числовые поля и MAC-адрес.
+     * @throw std::exception При любой ошибке разбора.
+     */
+    void parseValues(ParsedRow& row) {
+        const RowFields& fields = row.fields;
+        const std::string& type = fields[Field::Type];
+
+        if (type == "Domain") {
+            row.kind = EntityKind::Domain;
+            return;
+        }
+        if (type == "DataStorage") {
+            row.kind = EntityKind::DataStorage;
+        }
+        else if (type == "Workstation") {
+            row.kind = EntityKind::Workstation;
+        }
+        else if (type == "Printer") {
+            row.kind = EntityKind::Printer;
+        }
+        else {
+            throw ValidationException("неизвестный тип сущности '" + type + "'");
+        }
+
+        row.mac = MacAddress::parse(fields[Field::Mac]);
+        if (row.kind == EntityKind::DataStorage) {
+            row.totalMb = parseDouble(fields[Field::TotalMb], "total_mb");
+            if (!fields[Field::UsedMb].empty()) {
+                row.usedMb = parseDouble(fields[Field::UsedMb], "used_mb");
+            }
+        }
+        else if (row.kind == EntityKind::Workstation) {
+            const std::string& powerOn = fields[Field::PowerOn];
+            row.powerOnTime = powerOn.empty() ? 0 : static_cast<time_t>(parseInteger(powerOn, "power_on"));
+        }
+    }
+
+    /**
+     * @brief Добавляет тексты строки, которые нужно интернировать, в общий список блока.
+     * @details Порядок: id, parent, затем admin (домен) или user (станция),
+     * затем доверенные пользователи хранилища.
+     */
+    void collectTexts(ParsedRow& row, std::vector<std::string_view>& texts) {
+        const RowFields& fields = row.fields;
+        row.firstSymbol = texts.size();
+        texts.push_back(fields[Field::Id]);
+        texts.push_back(fields[Field::Parent]);
+        if (row.kind == EntityKind::Domain) {
+            texts.push_back(fields[Field::Admin]);
+        }
+        else if (row.kind == EntityKind::Workstation) {
+            texts.push_back(fields[Field::User]);
+        }
+        else if (row.kind == EntityKind::DataStorage) {
+            std::string_view users = fields[Field::TrustedUsers];
+            while (!users.empty()) {
+                const size_t separator = users.find(';');
+                std::string_view user = users.substr(0, separator);
+                if (!user.empty()) {
+                    texts.push_back(user);
+                }
+                users = (separator == std::string_view::npos) ? std::string_view() : users.substr(separator + 1);
+            }
+        }
+        row.symbolCount = texts.size() - row.firstSymbol;
+    }
+
+    /**
+     * @brief Строит сущность по разобранной строке и её интернированным символам.
+     * @throw std::exception При любой ошибке валидации.
+     */
+    std::shared_ptr<NetworkEntity> buildEntity(const ParsedRow& row, std::span<const Symbol> symbols) {
+        const Symbol id = symbols[0];
+        switch (row.kind) {
+        case EntityKind::Domain:
+            return std::make_shared<Domain>(id, symbols[2]);
+        case EntityKind::DataStorage: {
+            auto storage = std::make_shared<DataStorage>(id, row.mac, row.totalMb);
+            if (row.usedMb) {
+                *storage = *row.usedMb;
+            }
+            for (const Symbol& user : symbols.subspan(2)) {
+                storage->addTrustedUser(user);
+            }
+            return storage;
+        }
+        case EntityKind::Workstation:
+            return std::make_shared<Workstation>(id, row.mac, symbols[2], row.powerOnTime);
+        case EntityKind::Printer:
+            return std::make_shared<Printer>(id, row.mac);
+        }
+        throw ValidationException("неизвестный вид сущности");
+    }
+
+    /**
+     * @brief Простой пул потоков для параллельной обработки диапазона индексов.
+     */
+    class WorkerPool {
+    private:
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable wakeUp;
+        std::condition_variable finished;
+        const std::function<void(size_t)>* job = nullptr;
+        size_t jobSize = 0;
+        std::atomic<size_t> nextIndex{ 0 };
+        size_t generation = 0;
+        size_t busyWorkers = 0;
+        bool stopping = false;
+
+        void drain() {
+            const auto& work = *job;
+            for (size_t i = nextIndex.fetch_add(1); i < jobSize; i = nextIndex.fetch_add(1)) {
+                work(i);
+            }
+        }
+
+        void workerLoop() {
+            size_t seenGeneration = 0;
+            while (true) {
+                {
+                    std::unique_lock lock(mutex);
+                    wakeUp.wait(lock, [&] { return stopping || generation != seenGeneration; });
+                    if (stopping) {
+                        return;
+                    }
+                    seenGeneration = generation;
+                    ++busyWorkers;
+                }
+                drain();
+                {
+                    std::lock_guard lock(mutex);
+                    if (--busyWorkers == 0) {
+                        finished.notify_all();
+                    }
+                }
+            }
+        }
+
+    public:
+        explicit WorkerPool(unsigned threadCount) {
+            // Вызывающий поток тоже участвует в работе
+            for (unsigned i = 1; i < threadCount; ++i) {
+                workers.emplace_back([this] { workerLoop(); });
+            }
+        }
+
+        ~WorkerPool() {
+            {
+                std::lock_guard lock(mutex);
+                stopping = true;
+            }
+            wakeUp.notify_all();
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        }
+
+        void run(size_t count, const std::function<void(size_t)>& work) {
+            {
+                std::lock_guard lock(mutex);
+                job = &work;
+                jobSize = count;
+                nextIndex.store(0);
+                ++generation;
+            }
+            wakeUp.notify_all();
+            drain();
+            std::unique_lock lock(mutex);
+            finished.wait(lock, [&] { return busyWorkers == 0; });
+        }
+    };
+
+    constexpr size_t PARSE_BLOCK = 256;   ///< Число строк, обрабатываемых потоком за одно взятие задания
+
+}
+
+InventoryLoader::InventoryLoader(CorporateNetwork& network, InventoryLoadOptions options)
+    : network(network), options(options) {
+    if (this->options.chunkLines == 0) {
+        this->options.chunkLines = 1;
+    }
+    if (this->options.threadCount == 0) {
+        this->options.threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+InventoryLoadReport InventoryLoader::loadFile(const std::string& path) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        throw NetworkException("Не удалось открыть файл инвентаря: " + path);
+    }
+    return load(input);
+}
+
+InventoryLoadReport InventoryLoader::load(std::istream& input) {
+    InventoryLoadReport report;
+    auto recordError = [&](size_t line, std::string message) {
+        ++report.errorCount;
+        if (report.errors.size() < options.maxReportedErrors) {
+            report.errors.push_back({ line, std::move(message) });
+        }
+    };
+
+    // Сопоставление столбцов CSV полям строки
+    std::vector<Field> columns;
+    size_t lineNumber = 0;
+    std::string line;
+    if (options.format == InventoryFormat::Csv) {
+        while (std::getline(input, line)) {
+            ++lineNumber;
+            if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+            if (lineNumber == 1 && line.rfind("\xEF\xBB\xBF", 0) == 0) {
+                line.erase(0, 3);
+            }
+            std::vector<std::string> header;
+            splitCsvLine(line, header);
+            for (const auto& name : header) {
+                columns.push_back(fieldByName(name));
+            }
+            break;
+        }
+        const bool hasType = std::find(columns.begin(), columns.end(), Field::Type) != columns.end();
+        const bool hasId = std::find(columns.begin(), columns.end(), Field::Id) != columns.end();
+        if (!hasType || !hasId) {
+            throw ValidationException("В заголовке CSV отсутствуют обязательные столбцы type и id");
+        }
+    }
+
+    WorkerPool pool(options.threadCount);
+    std::vector<std::pair<size_t, std::string>> chunk;
+    std::vector<ParsedRow> parsed;
+    std::vector<std::string_view> texts;
+    std::vector<Symbol> symbols;
+    chunk.reserve(options.chunkLines);
+
+    // Строки, чей родительский домен ещё не загружен, по родителю; внутри - в порядке чтения
+    std::unordered_map<Symbol, std::deque<PendingRow>> waiting;
+    // Родители, получившие ожидающие строки в каждом из ещё не вытесненных блоков
+    std::deque<std::pair<size_t, std::vector<Symbol>>> waitingByChunk;
+    size_t chunkNumber = 0;
+
+    auto parseLine = [&](size_t index) {
+        const auto& [number, text] = chunk[index];
+        ParsedRow& row = parsed[index];
+        row.line = number;
+        try {
+            if (options.format == InventoryFormat::Csv) {
+                std::vector<std::string> cells;
+                splitCsvLine(text, cells);
+                for (size_t i = 0; i < cells.size() && i < columns.size(); ++i) {
+                    if (columns[i] != Field::Count) {
+                        row.fields[columns[i]] = std::move(cells[i]);
+                    }
+                }
+            }
+            else {
+                JsonLineParser(text).parse(row.fields);
+            }
+            parseValues(row);
+        }
+        catch (const std::exception& e) {
+            row.error = e.what();
+        }
+    };
+
+    auto buildLine = [&](size_t index) {
+        ParsedRow& row = parsed[index];
+        if (!row.error.empty()) {
+            return;
+        }
+        const std::span<const Symbol> rowSymbols(symbols.data() + row.firstSymbol, row.symbolCount);
+        row.parent = rowSymbols[1];
+        try {
+            row.entity = buildEntity(row, rowSymbols);
+        }
+        catch (const std::exception& e) {
+            row.entity.reset();
+            row.error = e.what();
+        }
+    };
+
+    const std::function<void(size_t)> parseBlock = [&](size_t block) {
+        const size_t end = std::min(chunk.size(), (block + 1) * PARSE_BLOCK);
+        for (size_t i = block * PARSE_BLOCK; i < end; ++i) {
+            parseLine(i);
+        }
+    };
+
+    const std::function<void(size_t)> buildBlock = [&](size_t block) {
+        const size_t end = std::min(chunk.size(), (block + 1) * PARSE_BLOCK);
+        for (size_t i = block * PARSE_BLOCK; i < end; ++i) {
+            buildLine(i);
+        }
+    };
+
+    // Присоединяет строки к существующему домену; загруженные домены добавляет в resolved
+    auto attach = [&](const Domain& parent, std::vector<PendingRow>& rows, std::vector<Symbol>& resolved) {
+        const std::string& parentId = parent.getId();
+        const std::string& admin = parent.getAdminId();
+        auto noteDomain = [&](const PendingRow& row) {
+            if (row.entity->kind() == EntityKind::Domain) {
+                resolved.push_back(row.entity->getIdSymbol());
+            }
+        };
+
+        std::vector<std::shared_ptr<NetworkEntity>> batch;
+        batch.reserve(rows.size());
+        for (const PendingRow& row : rows) {
+            batch.push_back(row.entity);
+        }
+        try {
+            network.addEntitiesToDomain(parentId, batch, admin);
+            report.entitiesLoaded += batch.size();
+            for (const PendingRow& row : rows) {
+                noteDomain(row);
+            }
+        }
+        catch (const std::exception&) {
+            // Пакет отклонён целиком - повторяем поштучно, чтобы указать конкретные строки
+            for (const PendingRow& row : rows) {
+                try {
+                    network.addEntityToDomain(parentId, row.entity, admin);
+                    ++report.entitiesLoaded;
+                    noteDomain(row);
+                }
+                catch (const std::exception& e) {
+                    recordError(row.line, e.what());
+                }
+            }
+        }
+    };
+
+    // Присоединяет строки блока, чьи родители уже существуют, и всё, что ждало загруженных доменов.
+    // Каждая строка просматривается один раз при поступлении и один раз при появлении родителя.
+    auto attachChunk = [&]() {
+        std::vector<Symbol> parentOrder;
+        std::unordered_map<Symbol, std::vector<PendingRow>> byParent;
+        for (ParsedRow& row : parsed) {
+            if (!row.entity) {
+                continue;
+            }
+            auto [it, inserted] = byParent.try_emplace(row.parent);
+            if (inserted) {
+                parentOrder.push_back(row.parent);
+            }
+            it->second.push_back(PendingRow{ row.line, chunkNumber, std::move(row.entity) });
+        }
+
+        std::vector<Symbol> resolved;
+        std::vector<Symbol> waitingParents;
+        for (const Symbol& parentId : parentOrder) {
+            std::vector<PendingRow>& rows = byParent[parentId];
+            if (auto domain = network.findDomain(parentId.str())) {
+                attach(*domain, rows, resolved);
+                continue;
+            }
+            auto& queue = waiting[parentId];
+            queue.insert(queue.end(), std::make_move_iterator(rows.begin()), std::make_move_iterator(rows.end()));
+            waitingParents.push_back(parentId);
+        }
+        waitingByChunk.emplace_back(chunkNumber, std::move(waitingParents));
+
+        while (!resolved.empty()) {
+            const Symbol domainId = resolved.back();
+            resolved.pop_back();
+            auto it = waiting.find(domainId);
+            if (it == waiting.end()) {
+                continue;
+            }
+            std::vector<PendingRow> rows(std::make_move_iterator(it->second.begin()),
+                std::make_move_iterator(it->second.end()));
+            waiting.erase(it);
+            if (auto domain = network.findDomain(domainId.str())) {
+                attach(*domain, rows, resolved);
+            }
+        }
+    };
+
+    // Сообщает о строках блока, так и не дождавшихся родителя
+    auto reportOrphans = [&](size_t chunkIndex, const std::vector<Symbol>& parents) {
+        for (const Symbol& parentId : parents) {
+            auto it = waiting.find(parentId);
+            if (it == waiting.end()) {
+                continue;
+            }
+            auto& queue = it->second;
+            while (!queue.empty() && queue.front().chunk == chunkIndex) {
+                recordError(queue.front().line, "Родительский домен '" + parentId.str() + "' не найден");
+                queue.pop_front();
+            }
+            if (queue.empty()) {
+                waiting.erase(it);
+            }
+        }
+    };
+
+    auto processChunk = [&]() {
+        parsed.clear();
+        parsed.resize(chunk.size());
+        const size_t blocks = (chunk.size() + PARSE_BLOCK - 1) / PARSE_BLOCK;
+        pool.run(blocks, parseBlock);
+
+        // Все символы блока интернируются одним вызовом в этом потоке
+        texts.clear();
+        for (ParsedRow& row : parsed) {
+            if (row.error.empty()) {
+                collectTexts(row, texts);
+            }
+        }
+        symbols.resize(texts.size());
+        Symbol::internAll(texts, symbols);
+        pool.run(blocks, buildBlock);
+
+        for (ParsedRow& row : parsed) {
+            if (!row.entity) {
+                recordError(row.line, std::move(row.error));
+            }
+        }
+        attachChunk();
+        parsed.clear();
+        chunk.clear();
+
+        while (!waitingByChunk.empty() && waitingByChunk.front().first + options.maxPendingChunks <= chunkNumber) {
+            reportOrphans(waitingByChunk.front().first, waitingByChunk.front().second);
+            waitingByChunk.pop_front();
+        }
+        ++chunkNumber;
+    };
+
+    while (std::getline(input, line)) {
+        ++lineNumber;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        ++report.linesRead;
+        chunk.emplace_back(lineNumber, std::move(line));
+        if (chunk.size() >= options.chunkLines) {
+            processChunk();
+        }
+    }
+    if (!chunk.empty()) {
+        processChunk();
+    }
+
+    for (const auto& [chunkIndex, parents] : waitingByChunk) {
+        reportOrphans(chunkIndex, parents);
+    }
+
+    std::stable_sort(report.errors.begin(), report.errors.end(),
+        [](const InventoryError& a, const InventoryError& b) { return a.line < b.line; });
+    return report;
+}
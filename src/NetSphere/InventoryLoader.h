@@ -0,0 +1,107 @@
+﻿/**
+ * @file InventoryLoader.h
+ * @brief Заголовочный файл класса InventoryLoader - потокового загрузчика инвентаря сети.
+ */
+
+#pragma once
+
+#include "CorporateNetwork.h"
+#include <istream>
+#include <string>
+#include <vector>
+
+ /**
+  * @defgroup inventory_module Модуль загрузки инвентаря
+  * @brief Массовое построение корпоративной сети из выгрузки инвентаря
+  * @{
+  */
+
+  /**
+   * @brief Формат файла инвентаря.
+   */
+enum class InventoryFormat {
+    Csv,        ///< CSV с обязательной строкой заголовка
+    JsonLines   ///< Один плоский JSON-объект на строку
+};
+
+/**
+ * @brief Параметры загрузки инвентаря.
+ */
+struct InventoryLoadOptions {
+    InventoryFormat format = InventoryFormat::Csv;   ///< Формат входных данных
+    size_t chunkLines = 65536;                       ///< Число строк, разбираемых за один проход
+    unsigned threadCount = 0;                        ///< Число потоков разбора (0 - по числу ядер)
+    size_t maxReportedErrors = 1000;                 ///< Максимум сохраняемых сообщений об ошибках
+    size_t maxPendingChunks = 16;                    ///< Сколько следующих блоков строка ждёт своего родителя
+};
+
+/**
+ * @brief Ошибка в конкретной строке инвентаря.
+ */
+struct InventoryError {
+    size_t line;            ///< Номер строки (с единицы)
+    std::string message;    ///< Описание ошибки
+};
+
+/**
+ * @brief Итог загрузки инвентаря.
+ */
+struct InventoryLoadReport {
+    size_t linesRead = 0;                  ///< Прочитано строк данных (без заголовка и пустых строк)
+    size_t entitiesLoaded = 0;             ///< Сущностей добавлено в сеть
+    size_t errorCount = 0;                 ///< Общее число ошибочных строк
+    std::vector<InventoryError> errors;    ///< Первые maxReportedErrors ошибок
+};
+
+/**
+ * @brief Потоковый параллельный загрузчик инвентаря (CSV / JSON Lines).
+ *
+ * Поля строки: `type` (Domain, DataStorage, Workstation, Printer), `id`,
+ * `parent` (идентификатор родительского домена, пусто - корневой),
+ * `admin` (для доменов), `mac` (для устройств), `total_mb`, `used_mb`,
+ * `trusted_users` (через ';' или JSON-массив) для хранилищ, `user`
+ * и `power_on` (секунды Unix) для рабочих станций.
+ *
+ * Вход читается блоками по chunkLines строк. Каждый блок разбирается на пуле
+ * потоков; строки всего блока интернируются вызывающим потоком за одно взятие
+ * блокировки пула строк, после чего сущности строятся снова параллельно и
+ * присоединяются к сети в порядке зависимостей: домен всегда появляется
+ * раньше своих детей. Строки, чей родитель ещё не загружен, откладываются
+ * не более чем на maxPendingChunks следующих блоков (так что отложено не
+ * больше maxPendingChunks * chunkLines строк), а затем сообщаются как
+ * ошибки "родительский домен не найден". Отложенные строки сгруппированы по
+ * родителю и присоединяются, как только он загружен, без повторного
+ * просмотра остальных. Сущности присоединяются от имени администратора
+ * родительского домена. Ошибки фиксируются построчно и не прерывают загрузку.
+ */
+class InventoryLoader {
+private:
+    CorporateNetwork& network;       ///< Заполняемая сеть
+    InventoryLoadOptions options;    ///< Параметры загрузки
+
+public:
+    /**
+     * @brief Конструктор загрузчика.
+     * @param[in] network Сеть, в которую добавляются сущности.
+     * @param[in] options Параметры загрузки.
+     */
+    InventoryLoader(CorporateNetwork& network, InventoryLoadOptions options = {});
+
+    /**
+     * @brief Загружает инвентарь из потока.
+     * @param[in] input Входной поток.
+     * @return Итог загрузки с построчными ошибками.
+     * @throw ValidationException Если в CSV отсутствует строка заголовка или столбец type/id.
+     */
+    InventoryLoadReport load(std::istream& input);
+
+    /**
+     * @brief Загружает инвентарь из файла.
+     * @param[in] path Путь к файлу.
+     * @return Итог загрузки с построчными ошибками.
+     * @throw NetworkException Если файл не удалось открыть.
+     */
+    InventoryLoadReport loadFile(const std::string& path);
+};
+
+/** @} */ // Конец группы inventory_module
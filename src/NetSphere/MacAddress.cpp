@@ -0,0 +1,73 @@
+﻿/**
+ * @file MacAddress.cpp
+ * @brief Реализация класса MacAddress - упакованного 48-битного MAC-адреса.
+ */
+
+#include "MacAddress.h"
+#include "NetworkExceptions.h"
+
+namespace {
+
+    /**
+     * @brief Преобразует шестнадцатеричный символ в его числовое значение.
+     * @return Значение 0..15 или -1, если символ не является шестнадцатеричной цифрой.
+     */
+    int hexDigitValue(char c) noexcept {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return -1;
+    }
+
+    constexpr char HEX_DIGITS[] = "0123456789ABCDEF";
+    constexpr size_t MAC_TEXT_LENGTH = 17;   ///< Длина строки XX:XX:XX:XX:XX:XX
+
+}
+
+bool MacAddress::tryParse(std::string_view text, MacAddress& result) noexcept {
+    if (text.size() != MAC_TEXT_LENGTH) {
+        return false;
+    }
+
+    uint64_t parsed = 0;
+    for (size_t octet = 0; octet < 6; ++octet) {
+        const size_t pos = octet * 3;
+        const int high = hexDigitValue(text[pos]);
+        const int low = hexDigitValue(text[pos + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        // Разделитель допускается как ':' так и '-' в каждой позиции
+        if (octet < 5 && text[pos + 2] != ':' && text[pos + 2] != '-') {
+            return false;
+        }
+        parsed = (parsed << 8) | static_cast<uint64_t>((high << 4) | low);
+    }
+
+    result = MacAddress(parsed);
+    return true;
+}
+
+MacAddress MacAddress::parse(std::string_view text) {
+    MacAddress result;
+    if (!tryParse(text, result)) {
+        throw ValidationException("Неверный формат MAC-адреса: " + std::string(text) +
+            " (ожидается формат XX:XX:XX:XX:XX:XX или XX-XX-XX-XX-XX-XX)");
+    }
+    return result;
+}
+
+std::string MacAddress::toString() const {
+    char buffer[MAC_TEXT_LENGTH + 1];
+    format(buffer);
+    return std::string(buffer, MAC_TEXT_LENGTH);
+}
+
+void MacAddress::format(char* buffer) const noexcept {
+    for (size_t octet = 0; octet < 6; ++octet) {
+        const auto byte = static_cast<unsigned>((value >> (8 * (5 - octet))) & 0xFF);
+        buffer[octet * 3] = HEX_DIGITS[byte >> 4];
+        buffer[octet * 3 + 1] = HEX_DIGITS[byte & 0x0F];
+        buffer[octet * 3 + 2] = (octet < 5) ? ':' : '\0';
+    }
+}
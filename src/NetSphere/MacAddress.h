@@ -0,0 +1,94 @@
+﻿/**
+ * @file MacAddress.h
+ * @brief Заголовочный файл класса MacAddress - упакованного 48-битного MAC-адреса.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <compare>
+#include <functional>
+#include <string>
+#include <string_view>
+
+ /**
+  * @addtogroup device_module
+  * @{
+  */
+
+  /**
+   * @brief Значимый тип, хранящий MAC-адрес в виде 48-битного целого числа.
+   *
+   * Разбор выполняется вручную без регулярных выражений, текстовое представление
+   * формируется только по запросу. Сравнение, упорядочивание и хеширование
+   * работают над целым числом.
+   */
+class MacAddress {
+private:
+    uint64_t value = 0;   ///< Канонический 48-битный MAC-адрес (старшие 16 бит всегда нулевые)
+
+    explicit constexpr MacAddress(uint64_t raw) : value(raw) {}
+
+public:
+    static constexpr uint64_t MAX_VALUE = 0xFFFFFFFFFFFFull;   ///< Максимальное значение 48-битного адреса
+
+    /**
+     * @brief Создаёт нулевой MAC-адрес 00:00:00:00:00:00.
+     */
+    constexpr MacAddress() = default;
+
+    /**
+     * @brief Пытается разобрать MAC-адрес из строки.
+     * @param[in] text Строка формата XX:XX:XX:XX:XX:XX или XX-XX-XX-XX-XX-XX.
+     * @param[out] result Разобранный адрес (изменяется только при успехе).
+     * @return true если строка является валидным MAC-адресом, иначе false.
+     */
+    static bool tryParse(std::string_view text, MacAddress& result) noexcept;
+
+    /**
+     * @brief Разбирает MAC-адрес из строки.
+     * @param[in] text Строка формата XX:XX:XX:XX:XX:XX или XX-XX-XX-XX-XX-XX.
+     * @return Разобранный MAC-адрес.
+     * @throw ValidationException Если строка не является валидным MAC-адресом.
+     */
+    static MacAddress parse(std::string_view text);
+
+    /**
+     * @brief Создаёт MAC-адрес из 48-битного целого числа.
+     * @param[in] raw Значение адреса (старшие 16 бит отбрасываются).
+     * @return MAC-адрес.
+     */
+    static constexpr MacAddress fromUInt64(uint64_t raw) noexcept { return MacAddress(raw & MAX_VALUE); }
+
+    /**
+     * @brief Возвращает адрес в виде 48-битного целого числа.
+     * @return Значение адреса.
+     */
+    constexpr uint64_t toUInt64() const noexcept { return value; }
+
+    /**
+     * @brief Форматирует адрес в каноническом виде XX:XX:XX:XX:XX:XX (верхний регистр).
+     * @return Строковое представление адреса.
+     */
+    std::string toString() const;
+
+    /**
+     * @brief Записывает адрес в канонической форме в буфер без выделения памяти.
+     * @param[out] buffer Буфер размером не менее 18 байт (включая завершающий ноль).
+     */
+    void format(char* buffer) const noexcept;
+
+    constexpr auto operator<=>(const MacAddress&) const = default;
+};
+
+/**
+ * @brief Специализация std::hash для MacAddress.
+ */
+template<>
+struct std::hash<MacAddress> {
+    size_t operator()(const MacAddress& mac) const noexcept {
+        return std::hash<uint64_t>{}(mac.toUInt64());
+    }
+};
+
+/** @} */ // Конец группы device_module
@@ -0,0 +1,137 @@
+﻿/**
+ * @file MappedFile.cpp
+ * @brief Реализация класса MappedFile для Windows и POSIX-систем.
+ */
+
+#include "MappedFile.h"
+#include "NetworkExceptions.h"
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path) {
+    fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        fileHandle = nullptr;
+        throw NetworkException("Не удалось открыть файл: " + path);
+    }
+
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+        release();
+        throw NetworkException("Файл пуст или недоступен: " + path);
+    }
+    length = static_cast<size_t>(fileSize.QuadPart);
+
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle == nullptr) {
+        release();
+        throw NetworkException("Не удалось отобразить файл в память: " + path);
+    }
+    bytes = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (bytes == nullptr) {
+        release();
+        throw NetworkException("Не удалось отобразить файл в память: " + path);
+    }
+}
+
+void MappedFile::release() noexcept {
+    if (bytes != nullptr) {
+        UnmapViewOfFile(bytes);
+    }
+    if (mappingHandle != nullptr) {
+        CloseHandle(mappingHandle);
+    }
+    if (fileHandle != nullptr) {
+        CloseHandle(fileHandle);
+    }
+    bytes = nullptr;
+    length = 0;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : bytes(std::exchange(other.bytes, nullptr)), length(std::exchange(other.length, 0)),
+    fileHandle(std::exchange(other.fileHandle, nullptr)), mappingHandle(std::exchange(other.mappingHandle, nullptr)) {
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        bytes = std::exchange(other.bytes, nullptr);
+        length = std::exchange(other.length, 0);
+        fileHandle = std::exchange(other.fileHandle, nullptr);
+        mappingHandle = std::exchange(other.mappingHandle, nullptr);
+    }
+    return *this;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path) {
+    descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        throw NetworkException("Не удалось открыть файл: " + path);
+    }
+
+    struct stat info {};
+    if (::fstat(descriptor, &info) != 0 || info.st_size == 0) {
+        release();
+        throw NetworkException("Файл пуст или недоступен: " + path);
+    }
+    length = static_cast<size_t>(info.st_size);
+
+    void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (mapping == MAP_FAILED) {
+        release();
+        throw NetworkException("Не удалось отобразить файл в память: " + path);
+    }
+    bytes = static_cast<const char*>(mapping);
+}
+
+void MappedFile::release() noexcept {
+    if (bytes != nullptr) {
+        ::munmap(const_cast<char*>(bytes), length);
+    }
+    if (descriptor >= 0) {
+        ::close(descriptor);
+    }
+    bytes = nullptr;
+    length = 0;
+    descriptor = -1;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : bytes(std::exchange(other.bytes, nullptr)), length(std::exchange(other.length, 0)),
+    descriptor(std::exchange(other.descriptor, -1)) {
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        bytes = std::exchange(other.bytes, nullptr);
+        length = std::exchange(other.length, 0);
+        descriptor = std::exchange(other.descriptor, -1);
+    }
+    return *this;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+    release();
+}
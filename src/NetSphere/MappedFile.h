@@ -0,0 +1,67 @@
+﻿/**
+ * @file MappedFile.h
+ * @brief Заголовочный файл класса MappedFile - файла, отображённого в память только для чтения.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+ /**
+  * @defgroup snapshot_module Модуль снимков сети
+  * @brief Сохранение и мгновенная загрузка корпоративной сети из двоичного файла
+  * @{
+  */
+
+  /**
+   * @brief Файл, целиком отображённый в адресное пространство процесса только для чтения.
+   *
+   * Использует mmap в POSIX-системах и MapViewOfFile в Windows. Объект владеет
+   * отображением и освобождает его в деструкторе; копирование запрещено.
+   */
+class MappedFile {
+private:
+    const char* bytes = nullptr;    ///< Начало отображения
+    size_t length = 0;              ///< Размер отображения в байтах
+#ifdef _WIN32
+    void* fileHandle = nullptr;     ///< Дескриптор открытого файла
+    void* mappingHandle = nullptr;  ///< Дескриптор объекта отображения
+#else
+    int descriptor = -1;            ///< Дескриптор открытого файла
+#endif
+
+    /**
+     * @brief Освобождает отображение и закрывает файл.
+     */
+    void release() noexcept;
+
+public:
+    /**
+     * @brief Отображает файл в память.
+     * @param[in] path Путь к файлу.
+     * @throw NetworkException Если файл не удалось открыть или отобразить.
+     */
+    explicit MappedFile(const std::string& path);
+
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Возвращает указатель на начало отображённых данных.
+     * @return Указатель на первый байт файла.
+     */
+    const char* data() const noexcept { return bytes; }
+
+    /**
+     * @brief Возвращает размер отображённого файла.
+     * @return Размер в байтах.
+     */
+    size_t size() const noexcept { return length; }
+};
+
+/** @} */ // Конец группы snapshot_module
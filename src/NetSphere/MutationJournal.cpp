@@ -0,0 +1,729 @@
+﻿/**
+ * @file MutationJournal.cpp
+ * @brief Реализация журнала изменений сети с групповой фиксацией и воспроизведением.
+ */
+
+#include "MutationJournal.h"
+#include "DataStorage.h"
+#include "MappedFile.h"
+#include "NetworkSnapshot.h"
+#include "Printer.h"
+#include "Workstation.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    constexpr char JOURNAL_MAGIC[8] = { 'N', 'S', 'P', 'J', 'R', 'N', 'L', '\0' };
+    constexpr uint32_t JOURNAL_VERSION = 1;
+    constexpr size_t HEADER_SIZE = 16;          ///< Сигнатура, версия и резерв
+    constexpr size_t FRAME_SIZE = 8;            ///< Длина тела и CRC32 перед каждой записью
+    constexpr uint32_t MAX_RECORD_SIZE = 1u << 30;
+
+    /**
+     * @brief Тип записи журнала.
+     */
+    enum class RecordType : uint8_t {
+        EntityAdded = 1,
+        EntityRemoved = 2,
+        StorageUsage = 3,
+        TrustedUserAdded = 4,
+        TrustedUserRemoved = 5,
+        PowerOnTime = 6
+    };
+
+    uint32_t crc32(const char* data, size_t size) noexcept {
+        static const std::array<uint32_t, 256> table = [] {
+            std::array<uint32_t, 256> result{};
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t value = i;
+                for (int bit = 0; bit < 8; ++bit) {
+                    value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+                }
+                result[i] = value;
+            }
+            return result;
+        }();
+
+        uint32_t crc = 0xFFFFFFFFu;
+        for (size_t i = 0; i < size; ++i) {
+            crc = table[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (crc >> 8);
+        }
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    void putUInt32(std::vector<char>& out, uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            out.push_back(static_cast<char>(value >> (8 * i)));
+        }
+    }
+
+    uint32_t getUInt32(const char* data) noexcept {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) {
+            value |= uint32_t(static_cast<uint8_t>(data[i])) << (8 * i);
+        }
+        return value;
+    }
+
+    /**
+     * @brief Кодировщик тела записи.
+     */
+    class RecordWriter {
+    private:
+        std::string bytes;
+
+    public:
+        RecordWriter& byte(uint8_t value) {
+            bytes.push_back(static_cast<char>(value));
+            return *this;
+        }
+
+        RecordWriter& varint(uint64_t value) {
+            while (value >= 0x80) {
+                bytes.push_back(static_cast<char>((value & 0x7F) | 0x80));
+                value >>= 7;
+            }
+            bytes.push_back(static_cast<char>(value));
+            return *this;
+        }
+
+        RecordWriter& signedVarint(int64_t value) {
+            return varint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+        }
+
+        RecordWriter& real(double value) {
+            uint64_t raw;
+            std::memcpy(&raw, &value, sizeof(raw));
+            for (int i = 0; i < 8; ++i) {
+                bytes.push_back(static_cast<char>(raw >> (8 * i)));
+            }
+            return *this;
+        }
+
+        RecordWriter& text(std::string_view value) {
+            varint(value.size());
+            bytes.append(value);
+            return *this;
+        }
+
+        /**
+         * @brief Кодирует сущность вместе со всем поддеревом.
+         */
+        RecordWriter& entity(const NetworkEntity& entity) {
+            byte(static_cast<uint8_t>(entity.kind()));
+            text(entity.getIdSymbol().view());
+            switch (entity.kind()) {
+            case EntityKind::Domain: {
+                const auto& domain = static_cast<const Domain&>(entity);
+                text(domain.getAdminSymbol().view());
+                varint(domain.getEntityCount());
+                for (const auto& [id, child] : domain.getAllEntities()) {
+                    this->entity(*child);
+                }
+                break;
+            }
+            case EntityKind::DataStorage: {
+                const auto& storage = static_cast<const DataStorage&>(entity);
+                varint(storage.getMac().toUInt64());
+                real(storage.getTotalSize());
+                real(storage.getUsedSize());
+                varint(storage.getTrustedUserCount());
+                storage.forEachTrustedUser([&](Symbol user) { text(user.view()); });
+                break;
+            }
+            case EntityKind::Workstation: {
+                const auto& workstation = static_cast<const Workstation&>(entity);
+                varint(workstation.getMac().toUInt64());
+                text(workstation.getUserSymbol().view());
+                signedVarint(static_cast<int64_t>(workstation.getLastPowerOnTime()));
+                break;
+            }
+            case EntityKind::Printer:
+                varint(static_cast<const Printer&>(entity).getMac().toUInt64());
+                break;
+            }
+            return *this;
+        }
+
+        std::string_view view() const noexcept { return bytes; }
+    };
+
+    /**
+     * @brief Декодировщик тела записи; при выходе за границы бросает ValidationException.
+     */
+    class RecordReader {
+    private:
+        const char* position;
+        const char* end;
+
+        void require(size_t count) const {
+            if (static_cast<size_t>(end - position) < count) {
+                throw ValidationException("Запись журнала обрывается");
+            }
+        }
+
+    public:
+        RecordReader(const char* data, size_t size) : position(data), end(data + size) {}
+
+        uint8_t byte() {
+            require(1);
+            return static_cast<uint8_t>(*position++);
+        }
+
+        uint64_t varint() {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                const uint8_t next = byte();
+                value |= uint64_t(next & 0x7F) << shift;
+                if (!(next & 0x80)) {
+                    return value;
+                }
+            }
+            throw ValidationException("Слишком длинное число в записи журнала");
+        }
+
+        int64_t signedVarint() {
+            const uint64_t raw = varint();
+            return static_cast<int64_t>((raw >> 1) ^ (~(raw & 1) + 1));
+        }
+
+        double real() {
+            require(8);
+            uint64_t raw = 0;
+            for (int i = 0; i < 8; ++i) {
+                raw |= uint64_t(static_cast<uint8_t>(position[i])) << (8 * i);
+            }
+            position += 8;
+            double value;
+            std::memcpy(&value, &raw, sizeof(value));
+            return value;
+        }
+
+        std::string text() {
+            const uint64_t length = varint();
+            require(length);
+            std::string value(position, length);
+            position += length;
+            return value;
+        }
+
+        /**
+         * @brief Декодирует сущность вместе с поддеревом.
+         */
+        std::shared_ptr<NetworkEntity> entity() {
+            const uint8_t kind = byte();
+            const std::string id = text();
+            switch (static_cast<EntityKind>(kind)) {
+            case EntityKind::Domain: {
+                auto domain = std::make_shared<Domain>(id, text());
+                const uint64_t childCount = varint();
+                std::vector<std::shared_ptr<NetworkEntity>> children;
+                for (uint64_t i = 0; i < childCount; ++i) {
+                    children.push_back(entity());
+                }
+                domain->addEntities(children, domain->getAdminId());
+                return domain;
+            }
+            case EntityKind::DataStorage: {
+                const MacAddress mac = MacAddress::fromUInt64(varint());
+                const double total = real();
+                const double used = real();
+                auto storage = std::make_shared<DataStorage>(id, mac, total);
+                if (used > 0) {
+                    *storage = used;
+                }
+                const uint64_t trustedCount = varint();
+                for (uint64_t i = 0; i < trustedCount; ++i) {
+                    storage->addTrustedUser(text());
+                }
+                return storage;
+            }
+            case EntityKind::Workstation: {
+                const MacAddress mac = MacAddress::fromUInt64(varint());
+                const std::string user = text();
+                return std::make_shared<Workstation>(id, mac, user, static_cast<time_t>(signedVarint()));
+            }
+            case EntityKind::Printer:
+                return std::make_shared<Printer>(id, MacAddress::fromUInt64(varint()));
+            }
+            throw ValidationException("Неизвестный вид сущности в записи журнала");
+        }
+    };
+
+    /**
+     * @brief Возвращает длину корректного префикса журнала и вызывает visit для каждой записи.
+     * @return Смещение первого байта после последней целой записи.
+     */
+    template <typename Visitor>
+    size_t scanRecords(const char* data, size_t size, Visitor&& visit) {
+        size_t offset = HEADER_SIZE;
+        while (size - offset >= FRAME_SIZE) {
+            const uint32_t length = getUInt32(data + offset);
+            const uint32_t checksum = getUInt32(data + offset + 4);
+            if (length == 0 || length > MAX_RECORD_SIZE || length > size - offset - FRAME_SIZE ||
+                crc32(data + offset + FRAME_SIZE, length) != checksum) {
+                break;
+            }
+            visit(data + offset + FRAME_SIZE, length);
+            offset += FRAME_SIZE + length;
+        }
+        return offset;
+    }
+
+    void checkHeader(const char* data, size_t size) {
+        if (size < HEADER_SIZE || std::memcmp(data, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0) {
+            throw ValidationException("Файл не является журналом изменений NetSphere");
+        }
+        if (getUInt32(data + 8) != JOURNAL_VERSION) {
+            throw ValidationException("Неподдерживаемая версия журнала: " + std::to_string(getUInt32(data + 8)));
+        }
+    }
+
+    /**
+     * @brief Применяет одну запись журнала к сети.
+     */
+    void applyRecord(RecordReader& reader, CorporateNetwork& network) {
+        auto requireEntity = [&network](const std::string& id) {
+            auto entity = network.findEntity(id);
+            if (!entity) {
+                throw DomainOperationException("Сущность '" + id + "' из журнала не найдена в сети");
+            }
+            return entity;
+        };
+        auto requireKind = [](auto entity, const std::string& id) {
+            if (!entity) {
+                throw DomainOperationException("Сущность '" + id + "' из журнала имеет другой вид");
+            }
+            return entity;
+        };
+
+        switch (static_cast<RecordType>(reader.byte())) {
+        case RecordType::EntityAdded: {
+            const std::string parentId = reader.text();
+            auto parent = network.findDomain(parentId);
+            if (!parent) {
+                throw DomainOperationException("Домен '" + parentId + "' из журнала не найден в сети");
+            }
+            network.addEntityToDomain(parentId, reader.entity(), parent->getAdminId());
+            break;
+        }
+        case RecordType::EntityRemoved: {
+            const std::string id = reader.text();
+            auto parent = network.getParentDomain(id);
+            if (!parent) {
+                throw DomainOperationException("Сущность '" + id + "' из журнала не найдена в сети");
+            }
+            network.removeEntity(id, parent->getAdminId());
+            break;
+        }
+        case RecordType::StorageUsage: {
+            const std::string id = reader.text();
+            auto storage = requireKind(entityCast<DataStorage>(requireEntity(id)), id);
+            *storage = reader.real();
+            break;
+        }
+        case RecordType::TrustedUserAdded: {
+            const std::string id = reader.text();
+            requireKind(entityCast<DataStorage>(requireEntity(id)), id)->addTrustedUser(reader.text());
+            break;
+        }
+        case RecordType::TrustedUserRemoved: {
+            const std::string id = reader.text();
+            requireKind(entityCast<DataStorage>(requireEntity(id)), id)->removeTrustedUser(reader.text());
+            break;
+        }
+        case RecordType::PowerOnTime: {
+            const std::string id = reader.text();
+            requireKind(entityCast<Workstation>(requireEntity(id)), id)
+                ->updatePowerOnTime(static_cast<time_t>(reader.signedVarint()));
+            break;
+        }
+        default:
+            throw ValidationException("Неизвестный тип записи журнала");
+        }
+    }
+
+}
+
+/**
+ * @brief Файл журнала с дозаписью, усечением и синхронизацией с диском.
+ */
+class MutationJournal::JournalFile {
+private:
+#ifdef _WIN32
+    HANDLE handle = INVALID_HANDLE_VALUE;
+#else
+    int descriptor = -1;
+#endif
+    std::string path;
+
+    [[noreturn]] void fail(const char* action) const {
+        throw NetworkException(std::string("Ошибка журнала (") + action + "): " + path);
+    }
+
+public:
+    explicit JournalFile(const std::string& filePath) : path(filePath) {
+#ifdef _WIN32
+        handle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+            OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) {
+            fail("открытие");
+        }
+#else
+        descriptor = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+        if (descriptor < 0) {
+            fail("открытие");
+        }
+#endif
+    }
+
+    ~JournalFile() {
+#ifdef _WIN32
+        CloseHandle(handle);
+#else
+        ::close(descriptor);
+#endif
+    }
+
+    JournalFile(const JournalFile&) = delete;
+    JournalFile& operator=(const JournalFile&) = delete;
+
+    uint64_t size() const {
+#ifdef _WIN32
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(handle, &fileSize)) {
+            fail("размер");
+        }
+        return static_cast<uint64_t>(fileSize.QuadPart);
+#else
+        struct stat info {};
+        if (::fstat(descriptor, &info) != 0) {
+            fail("размер");
+        }
+        return static_cast<uint64_t>(info.st_size);
+#endif
+    }
+
+    void append(const char* data, size_t size) {
+#ifdef _WIN32
+        LARGE_INTEGER zero{};
+        if (!SetFilePointerEx(handle, zero, nullptr, FILE_END)) {
+            fail("позиционирование");
+        }
+        while (size > 0) {
+            DWORD written = 0;
+            const DWORD chunk = static_cast<DWORD>(std::min<size_t>(size, 1u << 30));
+            if (!WriteFile(handle, data, chunk, &written, nullptr)) {
+                fail("запись");
+            }
+            data += written;
+            size -= written;
+        }
+#else
+        while (size > 0) {
+            const ssize_t written = ::write(descriptor, data, size);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                fail("запись");
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+#endif
+    }
+
+    void truncate(uint64_t size) {
+#ifdef _WIN32
+        LARGE_INTEGER position{};
+        position.QuadPart = static_cast<LONGLONG>(size);
+        if (!SetFilePointerEx(handle, position, nullptr, FILE_BEGIN) || !SetEndOfFile(handle)) {
+            fail("усечение");
+        }
+#else
+        if (::ftruncate(descriptor, static_cast<off_t>(size)) != 0) {
+            fail("усечение");
+        }
+#endif
+    }
+
+    void sync() {
+#ifdef _WIN32
+        if (!FlushFileBuffers(handle)) {
+            fail("синхронизация");
+        }
+#else
+        if (::fsync(descriptor) != 0) {
+            fail("синхронизация");
+        }
+#endif
+    }
+
+    /**
+     * @brief Синхронизирует с диском содержимое файла и запись о нём в каталоге.
+     */
+    static void syncPath(const std::string& filePath) {
+        JournalFile(filePath).sync();
+#ifndef _WIN32
+        const std::string directory = std::filesystem::path(filePath).parent_path().string();
+        const int directoryDescriptor = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+        if (directoryDescriptor >= 0) {
+            ::fsync(directoryDescriptor);
+            ::close(directoryDescriptor);
+        }
+#endif
+    }
+};
+
+MutationJournal::MutationJournal(const std::string& path, JournalOptions options)
+    : file(std::make_unique<JournalFile>(path)), options(options) {
+    const uint64_t existingSize = file->size();
+    if (existingSize == 0) {
+        std::vector<char> header(JOURNAL_MAGIC, JOURNAL_MAGIC + sizeof(JOURNAL_MAGIC));
+        putUInt32(header, JOURNAL_VERSION);
+        putUInt32(header, 0);
+        file->append(header.data(), header.size());
+        file->sync();
+    }
+    else {
+        // Отбрасываем хвост, оставшийся от прерванной записи
+        MappedFile existing(path);
+        checkHeader(existing.data(), existing.size());
+        const size_t validSize = scanRecords(existing.data(), existing.size(), [](const char*, size_t) {});
+        if (validSize != existing.size()) {
+            file->truncate(validSize);
+            file->sync();
+        }
+    }
+
+    if (this->options.durability == JournalDurability::Periodic) {
+        flusher = std::thread([this] { flusherLoop(); });
+    }
+}
+
+MutationJournal::~MutationJournal() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    flushRequested.notify_all();
+    if (flusher.joinable()) {
+        flusher.join();
+    }
+    try {
+        flush();
+    }
+    catch (const NetworkException&) {
+        // Деструктор не должен бросать; ошибка уже переведёт журнал в состояние отказа
+    }
+}
+
+void MutationJournal::commitPending(std::unique_lock<std::mutex>& lock, bool sync) {
+    flushInProgress = true;
+    std::vector<char> batch;
+    batch.swap(pending);
+    const uint64_t target = appendedSequence;
+    lock.unlock();
+
+    bool success = true;
+    try {
+        if (!batch.empty()) {
+            file->append(batch.data(), batch.size());
+        }
+        if (sync) {
+            file->sync();
+        }
+    }
+    catch (const NetworkException&) {
+        success = false;
+    }
+
+    lock.lock();
+    flushInProgress = false;
+    if (success) {
+        writtenSequence = target;
+        if (sync) {
+            durableSequence = target;
+        }
+    }
+    else {
+        failed = true;
+    }
+    flushed.notify_all();
+    if (!success) {
+        throw NetworkException("Журнал изменений в состоянии отказа после ошибки записи");
+    }
+}
+
+void MutationJournal::append(std::string_view payload) {
+    std::unique_lock lock(mutex);
+    if (failed) {
+        throw NetworkException("Журнал изменений в состоянии отказа после ошибки записи");
+    }
+
+    putUInt32(pending, static_cast<uint32_t>(payload.size()));
+    putUInt32(pending, crc32(payload.data(), payload.size()));
+    pending.insert(pending.end(), payload.begin(), payload.end());
+    const uint64_t sequence = ++appendedSequence;
+
+    switch (options.durability) {
+    case JournalDurability::Sync:
+        // Групповая фиксация: первый свободный писатель фиксирует всех накопившихся
+        while (durableSequence < sequence) {
+            if (failed) {
+                throw NetworkException("Журнал изменений в состоянии отказа после ошибки записи");
+            }
+            if (flushInProgress) {
+                flushed.wait(lock);
+            }
+            else {
+                commitPending(lock, true);
+            }
+        }
+        break;
+    case JournalDurability::Periodic:
+        if (pending.size() >= options.bufferLimit) {
+            flushRequested.notify_one();
+        }
+        break;
+    case JournalDurability::Buffered:
+        if (pending.size() >= options.bufferLimit && !flushInProgress) {
+            commitPending(lock, false);
+        }
+        break;
+    }
+}
+
+void MutationJournal::flusherLoop() {
+    std::unique_lock lock(mutex);
+    while (!stopping) {
+        flushRequested.wait_for(lock, options.flushInterval);
+        if (failed || flushInProgress || durableSequence == appendedSequence) {
+            continue;
+        }
+        try {
+            commitPending(lock, true);
+        }
+        catch (const NetworkException&) {
+            // Состояние отказа увидят писатели при следующей записи
+        }
+    }
+}
+
+void MutationJournal::flush() {
+    std::unique_lock lock(mutex);
+    flushed.wait(lock, [this] { return !flushInProgress; });
+    if (failed) {
+        throw NetworkException("Журнал изменений в состоянии отказа после ошибки записи");
+    }
+    if (durableSequence != appendedSequence || writtenSequence != durableSequence) {
+        commitPending(lock, true);
+    }
+}
+
+uint64_t MutationJournal::getDurableSequence() {
+    std::lock_guard lock(mutex);
+    return durableSequence;
+}
+
+void MutationJournal::checkpoint(const CorporateNetwork& network, const std::string& snapshotPath) {
+    std::unique_lock lock(mutex);
+    flushed.wait(lock, [this] { return !flushInProgress; });
+    if (failed) {
+        throw NetworkException("Журнал изменений в состоянии отказа после ошибки записи");
+    }
+
+    // Снимок включает все изменения из буфера, поэтому после его сохранения журнал не нужен
+    NetworkSnapshot::write(network, snapshotPath);
+    JournalFile::syncPath(snapshotPath);
+
+    pending.clear();
+    file->truncate(HEADER_SIZE);
+    file->sync();
+    writtenSequence = durableSequence = appendedSequence;
+}
+
+JournalReplayResult MutationJournal::replay(const std::string& path, CorporateNetwork& network) {
+    JournalReplayResult result;
+    if (!std::filesystem::exists(path) || std::filesystem::file_size(path) == 0) {
+        return result;
+    }
+
+    MappedFile journal(path);
+    checkHeader(journal.data(), journal.size());
+    const size_t validSize = scanRecords(journal.data(), journal.size(), [&](const char* data, size_t size) {
+        try {
+            RecordReader reader(data, size);
+            applyRecord(reader, network);
+            ++result.recordsApplied;
+        }
+        catch (const std::exception&) {
+            ++result.recordsFailed;
+        }
+    });
+    result.truncatedTail = validSize != journal.size();
+    return result;
+}
+
+CorporateNetwork MutationJournal::recover(const std::string& snapshotPath, const std::string& journalPath,
+    const std::string& rootAdminId) {
+    CorporateNetwork network = std::filesystem::exists(snapshotPath)
+        ? NetworkSnapshot(snapshotPath).restore()
+        : CorporateNetwork(rootAdminId);
+    replay(journalPath, network);
+    return network;
+}
+
+void MutationJournal::onEntityAdded(const Domain& parent, const NetworkEntity& entity) {
+    RecordWriter record;
+    record.byte(static_cast<uint8_t>(RecordType::EntityAdded)).text(parent.getIdSymbol().view()).entity(entity);
+    append(record.view());
+}
+
+void MutationJournal::onEntityRemoved([[maybe_unused]] const Domain& parent, const NetworkEntity& entity) {
+    RecordWriter record;
+    record.byte(static_cast<uint8_t>(RecordType::EntityRemoved)).text(entity.getIdSymbol().view());
+    append(record.view());
+}
+
+void MutationJournal::onStorageUsageChanged(const DataStorage& storage, [[maybe_unused]] double previousUsedMB) {
+    RecordWriter record;
+    record.byte(static_cast<uint8_t>(RecordType::StorageUsage)).text(storage.getIdSymbol().view())
+        .real(storage.getUsedSize());
+    append(record.view());
+}
+
+void MutationJournal::onTrustedUserAdded(const DataStorage& storage, Symbol user) {
+    RecordWriter record;
+    record.byte(static_cast<uint8_t>(RecordType::TrustedUserAdded)).text(storage.getIdSymbol().view()).text(user.view());
+    append(record.view());
+}
+
+void MutationJournal::onTrustedUserRemoved(const DataStorage& storage, Symbol user) {
+    RecordWriter record;
+    record.byte(static_cast<uint8_t>(RecordType::TrustedUserRemoved)).text(storage.getIdSymbol().view()).text(user.view());
+    append(record.view());
+}
+
+void MutationJournal::onPowerOnTimeChanged(const Workstation& workstation, [[maybe_unused]] time_t previousTime) {
+    RecordWriter record;
+    record.byte(static_cast<uint8_t>(RecordType::PowerOnTime)).text(workstation.getIdSymbol().view())
+        .signedVarint(static_cast<int64_t>(workstation.getLastPowerOnTime()));
+    append(record.view());
+}
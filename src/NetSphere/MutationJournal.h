@@ -0,0 +1,178 @@
+﻿/**
+ * @file MutationJournal.h
+ * @brief Заголовочный файл класса MutationJournal - журнала изменений сети с упреждающей записью.
+ */
+
+#pragma once
+
+#include "CorporateNetwork.h"
+#include "NetworkObserver.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+ /**
+  * @defgroup journal_module Модуль журнала изменений
+  * @brief Долговечность изменений сети между перезапусками
+  * @{
+  */
+
+  /**
+   * @brief Режим долговечности журнала.
+   */
+enum class JournalDurability {
+    Buffered,   ///< Записи накапливаются в памяти и сбрасываются при заполнении буфера или вызове flush()
+    Periodic,   ///< Фоновый поток сбрасывает и синхронизирует журнал каждые flushInterval
+    Sync        ///< Изменение возвращает управление только после fsync; одновременные писатели разделяют один fsync
+};
+
+/**
+ * @brief Параметры журнала.
+ */
+struct JournalOptions {
+    JournalDurability durability = JournalDurability::Sync;   ///< Режим долговечности
+    std::chrono::milliseconds flushInterval{ 10 };            ///< Период фонового сброса для режима Periodic
+    size_t bufferLimit = 1 << 20;                             ///< Размер буфера (байт), при котором запись сбрасывается на диск
+};
+
+/**
+ * @brief Итог воспроизведения журнала.
+ */
+struct JournalReplayResult {
+    size_t recordsApplied = 0;     ///< Успешно применённые записи
+    size_t recordsFailed = 0;      ///< Записи, которые не удалось применить к текущему состоянию
+    bool truncatedTail = false;    ///< Найден недописанный или повреждённый хвост (прерванная запись)
+};
+
+/**
+ * @brief Журнал изменений сети с упреждающей записью и групповой фиксацией.
+ *
+ * Журнал подписывается на изменения сети как NetworkObserver и пишет каждое
+ * изменение компактной двоичной записью (varint-поля, строки с длиной)
+ * с заголовком из длины и CRC32. Записи от одновременных писателей копятся
+ * в общем буфере: первый из ожидающих становится ведущим и одним write+fsync
+ * фиксирует всех накопившихся, остальные ждут его завершения.
+ *
+ * Журналируются: добавление и удаление сущностей (с поддеревом), изменения
+ * занятого объёма и доверенных пользователей хранилищ, время включения
+ * рабочих станций. При ошибке ввода-вывода журнал переходит в состояние
+ * отказа, и все последующие записи бросают NetworkException.
+ *
+ * Типичный запуск: recover() восстанавливает сеть из снимка и журнала,
+ * затем журнал открывается и подписывается на сеть; checkpoint() записывает
+ * свежий снимок и усекает журнал.
+ */
+class MutationJournal : public NetworkObserver {
+private:
+    class JournalFile;
+
+    std::unique_ptr<JournalFile> file;      ///< Открытый файл журнала
+    JournalOptions options;                 ///< Параметры журнала
+
+    std::mutex mutex;                       ///< Защищает буфер и счётчики
+    std::condition_variable flushed;        ///< Сигнал о завершении очередной фиксации
+    std::condition_variable flushRequested; ///< Пробуждение фонового потока
+    std::vector<char> pending;              ///< Записи, ещё не переданные в файл
+    uint64_t appendedSequence = 0;          ///< Номер последней добавленной записи
+    uint64_t writtenSequence = 0;           ///< Номер последней записи, переданной в файл
+    uint64_t durableSequence = 0;           ///< Номер последней записи, гарантированно сохранённой на диске
+    bool flushInProgress = false;           ///< Идёт фиксация (ведущий писатель вне блокировки)
+    bool failed = false;                    ///< Журнал в состоянии отказа после ошибки ввода-вывода
+    bool stopping = false;                  ///< Остановка фонового потока
+    std::thread flusher;                    ///< Фоновый поток режима Periodic
+
+    /**
+     * @brief Добавляет закодированную запись и выполняет политику долговечности.
+     * @param[in] payload Тело записи.
+     */
+    void append(std::string_view payload);
+
+    /**
+     * @brief Передаёт накопленный буфер в файл вне блокировки.
+     * @param[in,out] lock Захваченная блокировка mutex.
+     * @param[in] sync Выполнить fsync после записи.
+     */
+    void commitPending(std::unique_lock<std::mutex>& lock, bool sync);
+
+    /**
+     * @brief Цикл фонового потока режима Periodic.
+     */
+    void flusherLoop();
+
+public:
+    /**
+     * @brief Открывает или создаёт журнал.
+     * @param[in] path Путь к файлу журнала.
+     * @param[in] options Параметры журнала.
+     * @throw NetworkException Если файл не удалось открыть.
+     * @throw ValidationException Если файл не является журналом NetSphere.
+     * @details Недописанный хвост, оставшийся после сбоя, отбрасывается.
+     */
+    explicit MutationJournal(const std::string& path, JournalOptions options = {});
+
+    /**
+     * @brief Сбрасывает накопленные записи и закрывает журнал.
+     */
+    ~MutationJournal() override;
+
+    MutationJournal(const MutationJournal&) = delete;
+    MutationJournal& operator=(const MutationJournal&) = delete;
+
+    /**
+     * @brief Записывает и синхронизирует с диском все накопленные записи.
+     * @throw NetworkException При ошибке ввода-вывода.
+     */
+    void flush();
+
+    /**
+     * @brief Записывает снимок сети и усекает журнал.
+     * @param[in] network Сеть, состояние которой включает все журналированные изменения.
+     * @param[in] snapshotPath Путь к файлу снимка.
+     * @throw NetworkException При ошибке ввода-вывода.
+     * @details Снимок синхронизируется с диском до усечения журнала. На время
+     * вызова изменения сети должны быть приостановлены.
+     */
+    void checkpoint(const CorporateNetwork& network, const std::string& snapshotPath);
+
+    /**
+     * @brief Возвращает номер последней записи, гарантированно сохранённой на диске.
+     * @return Порядковый номер записи с момента открытия журнала.
+     */
+    uint64_t getDurableSequence();
+
+    /**
+     * @brief Применяет записи журнала к сети.
+     * @param[in] path Путь к файлу журнала; отсутствующий файл означает пустой журнал.
+     * @param[in,out] network Сеть, к которой применяются изменения (журнал к ней не подписан).
+     * @return Итог воспроизведения.
+     * @throw ValidationException Если файл не является журналом NetSphere.
+     * @details Изменения применяются от имени администраторов затронутых доменов,
+     * так как права уже были проверены при исходной операции.
+     */
+    static JournalReplayResult replay(const std::string& path, CorporateNetwork& network);
+
+    /**
+     * @brief Восстанавливает сеть после перезапуска: снимок (если есть) плюс журнал.
+     * @param[in] snapshotPath Путь к последнему снимку.
+     * @param[in] journalPath Путь к журналу.
+     * @param[in] rootAdminId Администратор корневого домена, если снимка нет.
+     * @return Восстановленная сеть.
+     */
+    static CorporateNetwork recover(const std::string& snapshotPath, const std::string& journalPath,
+        const std::string& rootAdminId);
+
+    void onEntityAdded(const Domain& parent, const NetworkEntity& entity) override;
+    void onEntityRemoved(const Domain& parent, const NetworkEntity& entity) override;
+    void onStorageUsageChanged(const DataStorage& storage, double previousUsedMB) override;
+    void onTrustedUserAdded(const DataStorage& storage, Symbol user) override;
+    void onTrustedUserRemoved(const DataStorage& storage, Symbol user) override;
+    void onPowerOnTimeChanged(const Workstation& workstation, time_t previousTime) override;
+};
+
+/** @} */ // Конец группы journal_module
@@ -9,12 +9,45 @@
 #include "Workstation.h"
 #include "Printer.h"
 #include "NetworkExceptions.h"
+#include "HandleTable.h"
+#include "CommandBuffer.h"
+#include "NetworkCursor.h"
+#include "ChangeFeed.h"
+#include "PowerOnIngestor.h"
 #include <sstream>
 #include <cstdarg>
-#include <unordered_map>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+#include <vector>
 
-static std::string last_error;
-static std::unordered_map<void*, std::shared_ptr<CorporateNetwork>> networks;
+// Ошибка хранится отдельно для каждого потока, вызывающего API
+static thread_local std::string last_error;
+static HandleTable<CorporateNetwork> networks(1);
+static HandleTable<NetworkEntity> devices(2);
+static HandleTable<NetworkCursor> cursors(3);
+
+static std::shared_ptr<CorporateNetwork> require_network(NetSphereHandle network_handle) {
+    auto network = networks.get(network_handle);
+    if (!network) {
+        throw ValidationException("Недействительный или устаревший дескриптор сети");
+    }
+    return network;
+}
+
+template<typename T = NetworkEntity>
+static std::shared_ptr<T> require_device(NetSphereHandle device_handle) {
+    auto entity = devices.get(device_handle);
+    if (!entity) {
+        throw ValidationException("Недействительный или устаревший дескриптор устройства");
+    }
+    auto typed = entityCast<T>(entity);
+    if (!typed) {
+        throw DeviceOperationException("Сущность '" + entity->getId() + "' не поддерживает эту операцию");
+    }
+    return typed;
+}
 
 // Вспомогательная функция для обработки исключений
 template<typename Func>
@@ -34,58 +67,415 @@ auto handle_exception(Func func) -> decltype(func()) {
 }
 
 // Создание сети
-NETSPHERE_API void* create_network(const char* admin_id) {
-    return handle_exception([&]() -> void* {
-        auto network = std::make_shared<CorporateNetwork>(admin_id);
-        void* handle = static_cast<void*>(new std::shared_ptr<CorporateNetwork>(network));
-        networks[handle] = network;
-        return handle;
+NETSPHERE_API NetSphereHandle network_create(const char* admin_id) {
+    return handle_exception([&]() -> NetSphereHandle {
+        return networks.insert(std::make_shared<CorporateNetwork>(admin_id));
         });
 }
 
+NETSPHERE_API NetSphereHandle create_network(const char* admin_id) {
+    return network_create(admin_id);
+}
+
 // Удаление сети
-NETSPHERE_API void delete_network(void* network_handle) {
+NETSPHERE_API void network_destroy(NetSphereHandle network_handle) {
+    handle_exception([&]() {
+        if (!networks.erase(network_handle)) {
+            throw ValidationException("Недействительный или устаревший дескриптор сети");
+        }
+        });
+}
+
+NETSPHERE_API void delete_network(NetSphereHandle network_handle) {
+    network_destroy(network_handle);
+}
+
+// Добавление созданного устройства или домена в сеть
+NETSPHERE_API int network_add_device(NetSphereHandle network_handle, const char* domain_id, NetSphereHandle device_handle, const char* user) {
+    return handle_exception([&]() -> int {
+        auto network = require_network(network_handle);
+        network->addEntityToDomain(domain_id, require_device(device_handle), user);
+        return 1;
+        });
+}
+
+// Удаление сущности из сети по идентификатору
+NETSPHERE_API int network_remove_device(NetSphereHandle network_handle, const char* device_id, const char* user) {
+    return handle_exception([&]() -> int {
+        require_network(network_handle)->removeEntity(device_id, user);
+        return 1;
+        });
+}
+
+// Создание устройств
+NETSPHERE_API NetSphereHandle device_create_domain(const char* domain_id, const char* admin_id) {
+    return handle_exception([&]() -> NetSphereHandle {
+        return devices.insert(std::make_shared<Domain>(domain_id, admin_id));
+        });
+}
+
+NETSPHERE_API NetSphereHandle device_create_storage(const char* id, const char* mac, double total_size) {
+    return handle_exception([&]() -> NetSphereHandle {
+        return devices.insert(std::make_shared<DataStorage>(id, mac, total_size));
+        });
+}
+
+NETSPHERE_API NetSphereHandle device_create_workstation(const char* id, const char* mac, const char* user_id, long long power_on_time) {
+    return handle_exception([&]() -> NetSphereHandle {
+        return devices.insert(
+            std::make_shared<Workstation>(id, mac, user_id, static_cast<time_t>(power_on_time)));
+        });
+}
+
+NETSPHERE_API NetSphereHandle device_create_printer(const char* id, const char* mac) {
+    return handle_exception([&]() -> NetSphereHandle {
+        return devices.insert(std::make_shared<Printer>(id, mac));
+        });
+}
+
+// Освобождение дескриптора устройства (сущность остаётся в сети, если была добавлена)
+NETSPHERE_API void device_destroy(NetSphereHandle device_handle) {
     handle_exception([&]() {
-        auto it = networks.find(network_handle);
-        if (it != networks.end()) {
-            delete static_cast<std::shared_ptr<CorporateNetwork>*>(network_handle);
-            networks.erase(it);
+        if (!devices.erase(device_handle)) {
+            throw ValidationException("Недействительный или устаревший дескриптор устройства");
         }
         });
 }
 
+// Сведения о сущности по дескриптору устройства
+NETSPHERE_API int device_get_info(NetSphereHandle device_handle, DeviceInfo* info) {
+    return handle_exception([&]() -> int {
+        if (!info) {
+            throw ValidationException("Не передана структура DeviceInfo");
+        }
+        fillDeviceInfo(*require_device(device_handle), *info);
+        return 1;
+        });
+}
+
+// Сведения о сущности сети по идентификатору; сущность не копируется и счётчик ссылок не меняется
+NETSPHERE_API int network_get_device_info(NetSphereHandle network_handle, const char* device_id, DeviceInfo* info) {
+    return handle_exception([&]() -> int {
+        if (!info || !device_id) {
+            throw ValidationException("Не передан идентификатор или структура DeviceInfo");
+        }
+        auto network = require_network(network_handle);
+        const bool found = network->withEntity(device_id, [info](const NetworkEntity& entity) {
+            fillDeviceInfo(entity, *info);
+        });
+        if (!found) {
+            throw DomainOperationException("Сущность с идентификатором '" + std::string(device_id) + "' не найдена");
+        }
+        return 1;
+        });
+}
+
+// Пакетное получение сведений за один вызов
+NETSPHERE_API int network_get_device_info_bulk(NetSphereHandle network_handle, const char* const* ids, size_t count, DeviceInfo* infos) {
+    auto network = networks.get(network_handle);
+    if (!network || (count > 0 && (!ids || !infos))) {
+        last_error = network ? "Не переданы идентификаторы или массив DeviceInfo"
+            : "Недействительный или устаревший дескриптор сети";
+        return -1;
+    }
+    last_error.clear();
+    int found = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const bool visited = ids[i] && network->withEntity(ids[i], [&](const NetworkEntity& entity) {
+            fillDeviceInfo(entity, infos[i]);
+        });
+        if (visited) {
+            ++found;
+        }
+        else {
+            std::memset(&infos[i], 0, sizeof(DeviceInfo));
+        }
+    }
+    return found;
+}
+
+// Курсоры перечисления
+NETSPHERE_API NetSphereHandle cursor_open(NetSphereHandle network_handle, const char* domain_id, int order) {
+    return handle_exception([&]() -> NetSphereHandle {
+        if (order < CURSOR_CHILDREN || order > CURSOR_BREADTH_FIRST) {
+            throw ValidationException("Неизвестный порядок перечисления " + std::to_string(order));
+        }
+        auto cursor = std::make_shared<NetworkCursor>(require_network(network_handle),
+            domain_id ? domain_id : "", static_cast<CursorOrder>(order));
+        return cursors.insert(std::move(cursor));
+        });
+}
+
+NETSPHERE_API int cursor_next(NetSphereHandle cursor_handle, CursorRecord* records, size_t capacity) {
+    last_error.clear();
+    try {
+        auto cursor = cursors.get(cursor_handle);
+        if (!cursor) {
+            throw ValidationException("Недействительный или устаревший дескриптор курсора");
+        }
+        if (!records && capacity > 0) {
+            throw ValidationException("Не передан буфер записей");
+        }
+        return static_cast<int>(cursor->nextPage(std::span(records, capacity)));
+    }
+    catch (const ConcurrentModificationException& e) {
+        last_error = e.what();
+        return CURSOR_MODIFIED;
+    }
+    catch (const std::exception& e) {
+        last_error = e.what();
+        return CURSOR_ERROR;
+    }
+}
+
+NETSPHERE_API void cursor_close(NetSphereHandle cursor_handle) {
+    handle_exception([&]() {
+        if (!cursors.erase(cursor_handle)) {
+            throw ValidationException("Недействительный или устаревший дескриптор курсора");
+        }
+        });
+}
+
+// Лента изменений
+NETSPHERE_API int network_enable_change_feed(NetSphereHandle network_handle, size_t capacity) {
+    return handle_exception([&]() -> int {
+        require_network(network_handle)->enableChangeFeed(capacity ? capacity : ChangeFeed::DEFAULT_CAPACITY);
+        return 1;
+        });
+}
+
+NETSPHERE_API int network_fetch_changes(NetSphereHandle network_handle, uint64_t after_sequence, ChangeRecord* records,
+    size_t capacity, uint64_t* last_sequence) {
+    last_error.clear();
+    try {
+        auto network = require_network(network_handle);
+        const ChangeFeed* feed = network->getChangeFeed();
+        if (!feed) {
+            throw ValidationException("Лента изменений не включена");
+        }
+        if (!records && capacity > 0) {
+            throw ValidationException("Не передан буфер событий");
+        }
+        const size_t limit = std::min<size_t>(capacity, std::numeric_limits<int>::max());
+        size_t written = 0;
+        const ChangeFetchResult result = feed->visitSince(after_sequence, limit, [&](const ChangeEvent& event) {
+            fillChangeRecord(event, records[written++]);
+            });
+        if (last_sequence) {
+            *last_sequence = result.lastSequence;
+        }
+        return result.resyncRequired ? CHANGES_RESYNC : static_cast<int>(result.count);
+    }
+    catch (const std::exception& e) {
+        last_error = e.what();
+        return CHANGES_ERROR;
+    }
+}
+
+// Поиск рабочих станций по пользователям
+NETSPHERE_API int network_find_user_workstations(NetSphereHandle network_handle, const char* const* users, size_t user_count,
+    const char* domain_id, UserWorkstationRecord* records, size_t capacity) {
+    last_error.clear();
+    try {
+        auto network = require_network(network_handle);
+        if ((user_count > 0 && !users) || (capacity > 0 && !records)) {
+            throw ValidationException("Не переданы пользователи или буфер записей");
+        }
+        std::vector<std::string> userIds(user_count);
+        for (size_t i = 0; i < user_count; ++i) {
+            if (users[i]) {
+                userIds[i] = users[i];
+            }
+        }
+
+        const auto found = network->getWorkstationsForUsers(userIds, domain_id ? domain_id : "");
+        size_t total = 0;
+        for (size_t i = 0; i < found.size(); ++i) {
+            for (const auto& workstation : found[i]) {
+                if (total < capacity) {
+                    fillUserWorkstationRecord(*workstation, static_cast<uint32_t>(i), records[total]);
+                }
+                ++total;
+            }
+        }
+        if (total > static_cast<size_t>(std::numeric_limits<int>::max())) {
+            throw ValidationException("Слишком много найденных станций");
+        }
+        return static_cast<int>(total);
+    }
+    catch (const std::exception& e) {
+        last_error = e.what();
+        return -1;
+    }
+}
+
+// Поиск рабочих станций по времени включения
+NETSPHERE_API int network_find_workstations_by_power_on(NetSphereHandle network_handle, int64_t from_time, int64_t to_time,
+    const char* domain_id, PowerOnRecord* records, size_t capacity) {
+    last_error.clear();
+    try {
+        auto network = require_network(network_handle);
+        if (capacity > 0 && !records) {
+            throw ValidationException("Не передан буфер записей");
+        }
+
+        const auto found = network->getWorkstationsPoweredOnBetween(static_cast<time_t>(from_time),
+            static_cast<time_t>(to_time), domain_id ? domain_id : "");
+        if (found.size() > static_cast<size_t>(std::numeric_limits<int>::max())) {
+            throw ValidationException("Слишком много найденных станций");
+        }
+        const size_t filled = std::min(found.size(), capacity);
+        for (size_t i = 0; i < filled; ++i) {
+            fillPowerOnRecord(*found[i], records[i]);
+        }
+        return static_cast<int>(found.size());
+    }
+    catch (const std::exception& e) {
+        last_error = e.what();
+        return -1;
+    }
+}
+
+// Приём телеметрии включения
+NETSPHERE_API int network_ingest_power_on(NetSphereHandle network_handle, const char* const* ids, const int64_t* times,
+    size_t count, PowerOnIngestResult* result) {
+    last_error.clear();
+    try {
+        auto network = require_network(network_handle);
+        if (count > 0 && (!ids || !times)) {
+            throw ValidationException("Не переданы идентификаторы или время событий");
+        }
+        std::vector<PowerOnEvent> events(count);
+        for (size_t i = 0; i < count; ++i) {
+            events[i] = PowerOnEvent{ ids[i] ? std::string_view(ids[i]) : std::string_view(),
+                static_cast<time_t>(times[i]) };
+        }
+
+        // Пакет C API - одно окно: объединение внутри вызова и немедленное применение
+        PowerOnIngestor ingestor(*network, std::chrono::milliseconds(0));
+        const PowerOnSubmitResult submitted = ingestor.submit(events);
+        const PowerOnWindowStats window = submitted.closedWindow ? *submitted.closedWindow : ingestor.flush();
+        if (result) {
+            *result = PowerOnIngestResult{ submitted.batch.received, submitted.batch.unknown,
+                submitted.batch.coalesced, window.applied, window.stale };
+        }
+        return 1;
+    }
+    catch (const std::exception& e) {
+        last_error = e.what();
+        return 0;
+    }
+}
+
+// Двухфазные резервы места в нескольких хранилищах
+NETSPHERE_API uint64_t network_reserve_capacity(NetSphereHandle network_handle, const NetSphereHandle* storages, const double* sizes_mb,
+    size_t count, int64_t ttl_ms) {
+    return handle_exception([&]() -> uint64_t {
+        auto network = require_network(network_handle);
+        if (count > 0 && (!storages || !sizes_mb)) {
+            throw ValidationException("Не переданы хранилища или объёмы резерва");
+        }
+        if (ttl_ms < 0) {
+            throw ValidationException("Срок действия резерва не может быть отрицательным");
+        }
+        std::vector<CapacityRequest> requests(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (!(sizes_mb[i] > 0)) {
+                throw ValidationException("Размер резерва должен быть положительным");
+            }
+            auto storage = require_device<DataStorage>(storages[i]);
+            if (network->findEntity(storage->getId()) != storage) {
+                throw ValidationException("Хранилище '" + storage->getId() + "' не принадлежит сети");
+            }
+            requests[i] = CapacityRequest{ std::move(storage), DataStorage::toBytes(sizes_mb[i]) };
+        }
+        const auto ttl = ttl_ms > 0 ? std::chrono::milliseconds(ttl_ms) : CapacityReservations::DEFAULT_TTL;
+        return network->getCapacityReservations().reserve(requests, ttl);
+        });
+}
+
+NETSPHERE_API int network_commit_reservation(NetSphereHandle network_handle, uint64_t token) {
+    return handle_exception([&]() -> int {
+        require_network(network_handle)->getCapacityReservations().commit(token);
+        return 1;
+        });
+}
+
+NETSPHERE_API int network_release_reservation(NetSphereHandle network_handle, uint64_t token) {
+    return handle_exception([&]() -> int {
+        require_network(network_handle)->getCapacityReservations().release(token);
+        return 1;
+        });
+}
+
+// Операции с хранилищами
+NETSPHERE_API int storage_add_data(NetSphereHandle storage_handle, double size) {
+    return handle_exception([&]() -> int {
+        *require_device<DataStorage>(storage_handle) += size;
+        return 1;
+        });
+}
+
+NETSPHERE_API int storage_free_data(NetSphereHandle storage_handle, double size) {
+    return handle_exception([&]() -> int {
+        *require_device<DataStorage>(storage_handle) -= size;
+        return 1;
+        });
+}
+
+NETSPHERE_API int storage_add_trusted_user(NetSphereHandle storage_handle, const char* user) {
+    return handle_exception([&]() -> int {
+        require_device<DataStorage>(storage_handle)->addTrustedUser(user);
+        return 1;
+        });
+}
+
+// Пакетное выполнение команд за одно пересечение границы FFI
+NETSPHERE_API int network_execute_commands(NetSphereHandle network_handle, const unsigned char* buffer, size_t size,
+    int* statuses, size_t status_capacity) {
+    auto network = networks.get(network_handle);
+    if (!network) {
+        last_error = "Недействительный или устаревший дескриптор сети";
+        return -1;
+    }
+    return handle_exception([&]() -> int {
+        auto result = CommandBufferExecutor::execute(*network,
+            std::span(reinterpret_cast<const std::byte*>(buffer), size),
+            std::span(statuses, status_capacity));
+        last_error = std::move(result.lastError);
+        return static_cast<int>(result.processed);
+        });
+}
+
 // Информация о сети
-NETSPHERE_API const char* get_network_info(void* network_handle) {
+NETSPHERE_API const char* get_network_info(NetSphereHandle network_handle) {
     return handle_exception([&]() -> const char* {
-        auto it = networks.find(network_handle);
-        if (it == networks.end()) return nullptr;
+        auto network = require_network(network_handle);
+        auto root = network->getRootDomain();
 
         std::stringstream ss;
-        it->second->printNetworkInfo();
-        // В реальной реализации нужно перехватывать вывод
-        std::string result = "Network information"; // Заглушка
-        return _strdup(result.c_str());
+        ss << "Сущностей: " << network->getEntityCount()
+            << "; корневой домен: " << root->getId() << " (админ: " << root->getAdminId() << ")";
+        return _strdup(ss.str().c_str());
         });
 }
 
 // Добавление домена
-NETSPHERE_API int add_domain(void* network_handle, const char* domain_id, const char* admin_id, const char* user) {
+NETSPHERE_API int add_domain(NetSphereHandle network_handle, const char* domain_id, const char* admin_id, const char* user) {
     return handle_exception([&]() -> int {
-        auto it = networks.find(network_handle);
-        if (it == networks.end()) return 0;
+        auto network = require_network(network_handle);
 
         auto domain = std::make_shared<Domain>(domain_id, admin_id);
-        it->second->addEntityToDomain("", domain, user);
+        network->addEntityToDomain("", domain, user);
         return 1;
         });
 }
 
 // Добавление устройства
-NETSPHERE_API int add_device(void* network_handle, const char* domain_id, int device_type,
+NETSPHERE_API int add_device(NetSphereHandle network_handle, const char* domain_id, int device_type,
     const char* id, const char* mac, const char* user, ...) {
     return handle_exception([&]() -> int {
-        auto it = networks.find(network_handle);
-        if (it == networks.end()) return 0;
+        auto network = require_network(network_handle);
 
         std::shared_ptr<Device> device;
         va_list args;
@@ -113,48 +503,43 @@ NETSPHERE_API int add_device(void* network_handle, const char* domain_id, int de
         }
 
         va_end(args);
-        it->second->addEntityToDomain(domain_id, device, user);
+        network->addEntityToDomain(domain_id, device, user);
         return 1;
         });
 }
 
 // Удаление устройства
-NETSPHERE_API int remove_device(void* network_handle, const char* device_id, const char* user) {
+NETSPHERE_API int remove_device(NetSphereHandle network_handle, const char* device_id, const char* user) {
     return handle_exception([&]() -> int {
-        auto it = networks.find(network_handle);
-        if (it == networks.end()) return 0;
-
-        it->second->removeEntity(device_id, user);
+        require_network(network_handle)->removeEntity(device_id, user);
         return 1;
         });
 }
 
 // Информация об устройстве
-NETSPHERE_API const char* get_device_info(void* network_handle, const char* device_id) {
+NETSPHERE_API const char* get_device_info(NetSphereHandle network_handle, const char* device_id) {
     return handle_exception([&]() -> const char* {
-        auto it = networks.find(network_handle);
-        if (it == networks.end()) return nullptr;
-
-        auto entity = it->second->findEntity(device_id);
+        auto entity = require_network(network_handle)->findEntity(device_id);
         if (!entity) return nullptr;
 
+        DeviceInfo info;
+        fillDeviceInfo(*entity, info);
         std::stringstream ss;
-        // В реальной реализации нужно получить информацию об устройстве
-        std::string result = "Device: " + std::string(device_id);
-        return _strdup(result.c_str());
+        ss << entityKindName(entity->kind()) << " " << info.id;
+        if (info.mac[0]) {
+            ss << " (MAC: " << info.mac << ")";
+        }
+        return _strdup(ss.str().c_str());
         });
 }
 
 // Поиск сущности
-NETSPHERE_API const char* find_entity(void* network_handle, const char* entity_id) {
+NETSPHERE_API const char* find_entity(NetSphereHandle network_handle, const char* entity_id) {
     return handle_exception([&]() -> const char* {
-        auto it = networks.find(network_handle);
-        if (it == networks.end()) return nullptr;
-
-        auto entity = it->second->findEntity(entity_id);
+        auto entity = require_network(network_handle)->findEntity(entity_id);
         if (!entity) return nullptr;
 
-        std::string result = "Found: " + std::string(entity_id) + " (" + entity->getType() + ")";
+        std::string result = "Found: " + std::string(entity_id) + " (" + entityKindName(entity->kind()) + ")";
         return _strdup(result.c_str());
         });
 }
@@ -166,7 +551,11 @@ NETSPHERE_API void free_string(const char* str) {
     }
 }
 
-// Получение последней ошибки
+// Получение последней ошибки вызывающего потока
 NETSPHERE_API const char* get_last_error() {
     return last_error.c_str();
+}
+
+NETSPHERE_API void clear_last_error() {
+    last_error.clear();
 }
\ No newline at end of file
@@ -11,6 +11,7 @@
 #define NETSPHERE_API __declspec(dllimport)
 #endif
 
+#include "DeviceInfo.h"
 #include <string>
 
 extern "C" {
@@ -22,27 +23,133 @@ extern "C" {
         DEVICE_PRINTER = 2
     };
 
+    // Дескрипторы сети, устройств и курсоров - непрозрачные 64-битные значения
+    // (слот, тег таблицы, поколение) одинаковой раскладки на всех платформах; 0 - ошибка.
+    typedef uint64_t NetSphereHandle;
+
+    // Устаревший или чужой дескриптор не разыменовывается: функция возвращает
+    // ошибку, текст которой доступен через get_last_error в том же потоке.
+
     // Создание и управление сетью
-    NETSPHERE_API void* create_network(const char* admin_id);
-    NETSPHERE_API void delete_network(void* network);
-    NETSPHERE_API const char* get_network_info(void* network);
+    NETSPHERE_API NetSphereHandle network_create(const char* admin_id);
+    NETSPHERE_API void network_destroy(NetSphereHandle network);
+    NETSPHERE_API int network_add_device(NetSphereHandle network, const char* domain_id, NetSphereHandle device, const char* user);
+    NETSPHERE_API int network_remove_device(NetSphereHandle network, const char* device_id, const char* user);
+
+    // Создание устройств вне сети; дескриптор остаётся действительным после добавления в сеть
+    NETSPHERE_API NetSphereHandle device_create_domain(const char* domain_id, const char* admin_id);
+    NETSPHERE_API NetSphereHandle device_create_storage(const char* id, const char* mac, double total_size);
+    NETSPHERE_API NetSphereHandle device_create_workstation(const char* id, const char* mac, const char* user_id, long long power_on_time);
+    NETSPHERE_API NetSphereHandle device_create_printer(const char* id, const char* mac);
+    NETSPHERE_API void device_destroy(NetSphereHandle device);
+
+    // Сведения о сущности без выделения памяти: структура заполняется на стороне вызывающего
+    NETSPHERE_API int device_get_info(NetSphereHandle device, DeviceInfo* info);
+    NETSPHERE_API int network_get_device_info(NetSphereHandle network, const char* device_id, DeviceInfo* info);
+    // Заполняет infos[i] для каждого ids[i]; для ненайденных type = DEVICE_INFO_UNKNOWN и пустой id.
+    // Возвращает число найденных сущностей или -1, если дескриптор сети недействителен.
+    NETSPHERE_API int network_get_device_info_bulk(NetSphereHandle network, const char* const* ids, size_t count, DeviceInfo* infos);
+
+    // Постраничное перечисление детей домена или его поддерева
+    enum CursorOrderType {
+        CURSOR_CHILDREN = 0,
+        CURSOR_DEPTH_FIRST = 1,
+        CURSOR_BREADTH_FIRST = 2
+    };
+
+    // Коды возврата cursor_next помимо числа записей
+    enum CursorResult {
+        CURSOR_ERROR = -1,      // Недействительный дескриптор или аргументы
+        CURSOR_MODIFIED = -2    // Сеть изменилась после открытия курсора; нужно открыть новый
+    };
+
+    NETSPHERE_API NetSphereHandle cursor_open(NetSphereHandle network, const char* domain_id, int order);
+    // Заполняет до capacity записей; возвращает их число (0 - конец) или CursorResult
+    NETSPHERE_API int cursor_next(NetSphereHandle cursor, CursorRecord* records, size_t capacity);
+    NETSPHERE_API void cursor_close(NetSphereHandle cursor);
+
+    // Лента изменений: клиент хранит номер последнего применённого события
+    // и запрашивает только более новые. Включение повторно не пересоздаёт ленту.
+    NETSPHERE_API int network_enable_change_feed(NetSphereHandle network, size_t capacity);
+
+    // Коды возврата network_fetch_changes помимо числа событий
+    enum ChangeFeedResult {
+        CHANGES_ERROR = -1,     // Недействительный дескриптор, аргументы или лента не включена
+        CHANGES_RESYNC = -2     // События после after_sequence вытеснены; нужно перечитать сеть целиком
+    };
+
+    // Заполняет до capacity событий с номерами больше after_sequence; возвращает их число
+    // или ChangeFeedResult. В *last_sequence (если передан) пишется номер последнего события ленты:
+    // после CHANGES_RESYNC клиент перечитывает сеть и продолжает с этого номера.
+    NETSPHERE_API int network_fetch_changes(NetSphereHandle network, uint64_t after_sequence, ChangeRecord* records,
+        size_t capacity, uint64_t* last_sequence);
+
+    // Рабочие станции пользователей users[0..user_count) в поддереве domain_id (NULL или "" - вся сеть).
+    // Записи сгруппированы по пользователям в порядке users; заполняется не больше capacity.
+    // Возвращает общее число найденных станций (если оно больше capacity, вызов повторяется
+    // с большим буфером) или -1 при ошибке.
+    NETSPHERE_API int network_find_user_workstations(NetSphereHandle network, const char* const* users, size_t user_count,
+        const char* domain_id, UserWorkstationRecord* records, size_t capacity);
+
+    // Рабочие станции, последнее включение которых попадает в [from_time, to_time), в поддереве
+    // domain_id (NULL или "" - вся сеть), по возрастанию времени. Заполняется не больше capacity.
+    // Возвращает общее число найденных станций или -1 при ошибке.
+    NETSPHERE_API int network_find_workstations_by_power_on(NetSphereHandle network, int64_t from_time, int64_t to_time,
+        const char* domain_id, PowerOnRecord* records, size_t capacity);
+
+    // Пакет событий включения: ids[i] включилась в times[i]. Повторы одной станции объединяются,
+    // время, не новее текущего, отбрасывается. result (может быть NULL) получает статистику.
+    // Возвращает 1 при успехе, 0 при ошибке.
+    NETSPHERE_API int network_ingest_power_on(NetSphereHandle network, const char* const* ids, const int64_t* times,
+        size_t count, PowerOnIngestResult* result);
+
+    // Резервирует sizes_mb[i] МБ в хранилищах storages[i] (дескрипторы устройств) по принципу
+    // "всё или ничего" на ttl_ms миллисекунд (0 - срок по умолчанию). Не хватает места хотя бы
+    // в одном хранилище - не меняется ни одно. Хранилища должны принадлежать этой сети,
+    // чужие отклоняются. Возвращает идентификатор резерва или 0 при ошибке.
+    NETSPHERE_API uint64_t network_reserve_capacity(NetSphereHandle network, const NetSphereHandle* storages, const double* sizes_mb,
+        size_t count, int64_t ttl_ms);
+
+    // Подтверждает резерв: место остаётся занятым. 1 при успехе, 0 если резерв не найден или истёк.
+    NETSPHERE_API int network_commit_reservation(NetSphereHandle network, uint64_t token);
+
+    // Отменяет резерв и возвращает место. 1 при успехе, 0 если резерв не найден.
+    NETSPHERE_API int network_release_reservation(NetSphereHandle network, uint64_t token);
+
+    // Операции с хранилищами
+    NETSPHERE_API int storage_add_data(NetSphereHandle storage, double size);
+    NETSPHERE_API int storage_free_data(NetSphereHandle storage, double size);
+    NETSPHERE_API int storage_add_trusted_user(NetSphereHandle storage, const char* user);
+
+    // Пакетное выполнение команд (формат буфера - CommandBuffer.h).
+    // Пишет статус каждой команды (CommandStatus) в statuses, выполняет не больше
+    // status_capacity команд. Возвращает число обработанных команд или -1,
+    // если дескриптор сети недействителен.
+    NETSPHERE_API int network_execute_commands(NetSphereHandle network, const unsigned char* buffer, size_t size,
+        int* statuses, size_t status_capacity);
+
+    // Прежний интерфейс; использует те же дескрипторы сети
+    NETSPHERE_API NetSphereHandle create_network(const char* admin_id);
+    NETSPHERE_API void delete_network(NetSphereHandle network);
+    NETSPHERE_API const char* get_network_info(NetSphereHandle network);
 
     // Управление доменами
-    NETSPHERE_API int add_domain(void* network, const char* domain_id, const char* admin_id, const char* user);
-    NETSPHERE_API int remove_domain(void* network, const char* domain_id, const char* user);
-    NETSPHERE_API const char* get_domain_info(void* network, const char* domain_id);
+    NETSPHERE_API int add_domain(NetSphereHandle network, const char* domain_id, const char* admin_id, const char* user);
+    NETSPHERE_API int remove_domain(NetSphereHandle network, const char* domain_id, const char* user);
+    NETSPHERE_API const char* get_domain_info(NetSphereHandle network, const char* domain_id);
 
     // Управление устройствами
-    NETSPHERE_API int add_device(void* network, const char* domain_id, int device_type,
+    NETSPHERE_API int add_device(NetSphereHandle network, const char* domain_id, int device_type,
         const char* id, const char* mac, const char* user, ...);
-    NETSPHERE_API int remove_device(void* network, const char* device_id, const char* user);
-    NETSPHERE_API const char* get_device_info(void* network, const char* device_id);
+    NETSPHERE_API int remove_device(NetSphereHandle network, const char* device_id, const char* user);
+    NETSPHERE_API const char* get_device_info(NetSphereHandle network, const char* device_id);
 
     // Поиск
-    NETSPHERE_API const char* find_entity(void* network, const char* entity_id);
+    NETSPHERE_API const char* find_entity(NetSphereHandle network, const char* entity_id);
 
     // Утилиты
     NETSPHERE_API void free_string(const char* str);
-    NETSPHERE_API const char* get_last_error();
+    NETSPHERE_API const char* get_last_error();    // Последняя ошибка вызывающего потока
+    NETSPHERE_API void clear_last_error();
 
 }
\ No newline at end of file
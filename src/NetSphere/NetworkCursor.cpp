@@ -0,0 +1,82 @@
+﻿/**
+ * @file NetworkCursor.cpp
+ * @brief Реализация постраничного перечисления сущностей сети.
+ */
+
+#include "NetworkCursor.h"
+
+NetworkCursor::Frame NetworkCursor::makeFrame(std::shared_ptr<Domain> domain, uint32_t depth) {
+    const uint64_t version = domain->getStructureVersion();
+    const auto position = domain->getAllEntities().begin();
+    return Frame{ std::move(domain), position, version, depth };
+}
+
+NetworkCursor::NetworkCursor(std::shared_ptr<const CorporateNetwork> network, const std::string& domainId,
+    CursorOrder order)
+    : network(std::move(network)), order(order) {
+    this->network->readLocked([&] {
+        auto domain = this->network->findDomain(domainId);
+        if (!domain) {
+            throw DomainOperationException("Домен с идентификатором '" + domainId + "' не найден");
+        }
+        start = domain;
+        frames.push_back(makeFrame(std::move(domain), 1));
+    });
+}
+
+bool NetworkCursor::isReachable(const Domain& domain) const {
+    const Domain* current = &domain;
+    bool underStart = false;
+    while (const Domain* owner = current->getOwnerDomain()) {
+        underStart = underStart || current == start.get();
+        current = owner;
+    }
+    return (underStart || current == start.get()) && current == network->getRootDomain().get();
+}
+
+void NetworkCursor::invalidate() {
+    frames.clear();
+    throw ConcurrentModificationException("курсор больше недействителен, откройте новый");
+}
+
+size_t NetworkCursor::nextPage(std::span<CursorRecord> page) {
+    return network->readLocked([&]() -> size_t {
+        // Итераторы каждого домена в стеке (очереди) действительны, пока не изменилась его версия
+        for (const Frame& frame : frames) {
+            if (frame.domain->getStructureVersion() != frame.version) {
+                invalidate();
+            }
+        }
+
+        size_t filled = 0;
+        const Domain* verified = nullptr;
+        while (filled < page.size() && !frames.empty()) {
+            // В глубину обрабатывается последний добавленный домен, в ширину - первый
+            Frame& frame = order == CursorOrder::BreadthFirst ? frames.front() : frames.back();
+            // Домен мог остаться целым, но уйти из-под начального вместе с предком
+            if (frame.domain.get() != verified) {
+                if (!isReachable(*frame.domain)) {
+                    invalidate();
+                }
+                verified = frame.domain.get();
+            }
+            if (frame.position == frame.domain->getAllEntities().end()) {
+                if (order == CursorOrder::BreadthFirst) {
+                    frames.pop_front();
+                }
+                else {
+                    frames.pop_back();
+                }
+                continue;
+            }
+
+            const auto& entity = (frame.position++)->second;
+            const uint32_t depth = frame.depth;
+            fillCursorRecord(*entity, *frame.domain, depth, page[filled++]);
+            if (order != CursorOrder::Children && entity->kind() == EntityKind::Domain) {
+                frames.push_back(makeFrame(std::static_pointer_cast<Domain>(entity), depth + 1));
+            }
+        }
+        return filled;
+    });
+}
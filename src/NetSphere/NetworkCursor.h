@@ -0,0 +1,101 @@
+﻿/**
+ * @file NetworkCursor.h
+ * @brief Заголовочный файл класса NetworkCursor - постраничного перечисления сущностей сети.
+ */
+
+#pragma once
+
+#include "CorporateNetwork.h"
+#include "DeviceInfo.h"
+#include <deque>
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+
+ /**
+  * @addtogroup network_module
+  * @{
+  */
+
+  /**
+   * @brief Порядок перечисления курсора.
+   */
+enum class CursorOrder {
+    Children = 0,       ///< Только непосредственные дети домена
+    DepthFirst = 1,     ///< Всё поддерево в глубину (домен перед своими детьми)
+    BreadthFirst = 2    ///< Всё поддерево в ширину (по уровням)
+};
+
+/**
+ * @brief Курсор, перечисляющий детей домена или его поддерево страницами фиксированного размера.
+ *
+ * Позиция обхода хранится итераторами по детям доменов без копирования, и для
+ * каждого домена в стеке (очереди) обхода курсор запоминает его версию структуры
+ * (Domain::getStructureVersion). Каждая страница читается под блокировкой
+ * писателей; перед чтением версии доменов сравниваются с запомненными, а для
+ * домена, с которого продолжается обход, проверяется, что он по-прежнему лежит
+ * под начальным доменом, а тот - в сети. Если что-то из этого нарушено, курсор
+ * становится недействительным и бросает ConcurrentModificationException.
+ * Изменения остальной сети курсор не затрагивают.
+ */
+class NetworkCursor {
+private:
+    using ChildIterator = std::unordered_map<std::string_view, std::shared_ptr<NetworkEntity>>::const_iterator;
+
+    /**
+     * @brief Позиция обхода внутри одного домена.
+     */
+    struct Frame {
+        std::shared_ptr<Domain> domain;   ///< Перечисляемый домен
+        ChildIterator position;           ///< Следующий ребёнок
+        uint64_t version;                 ///< Версия структуры домена при создании позиции
+        uint32_t depth;                   ///< Глубина детей домена
+    };
+
+    std::shared_ptr<const CorporateNetwork> network;   ///< Перечисляемая сеть (удерживается курсором)
+    std::shared_ptr<const Domain> start;               ///< Начальный домен
+    CursorOrder order;                                 ///< Порядок перечисления
+    std::deque<Frame> frames;                          ///< Стек (в глубину) или очередь (в ширину) доменов
+
+    static Frame makeFrame(std::shared_ptr<Domain> domain, uint32_t depth);
+
+    /**
+     * @brief Проверяет, что домен лежит под начальным доменом, а тот - в сети.
+     * @details Вызывается под блокировкой писателей; стоит O(глубины).
+     */
+    bool isReachable(const Domain& domain) const;
+
+    /**
+     * @brief Делает курсор недействительным.
+     * @throw ConcurrentModificationException Всегда.
+     */
+    [[noreturn]] void invalidate();
+
+public:
+    /**
+     * @brief Открывает курсор.
+     * @param[in] network Сеть.
+     * @param[in] domainId Начальный домен (пусто - корневой).
+     * @param[in] order Порядок перечисления.
+     * @throw DomainOperationException Если домен не найден.
+     */
+    NetworkCursor(std::shared_ptr<const CorporateNetwork> network, const std::string& domainId, CursorOrder order);
+
+    /**
+     * @brief Заполняет следующую страницу записей.
+     * @param[out] page Буфер страницы.
+     * @return Число заполненных записей; 0 означает конец перечисления.
+     * @throw ConcurrentModificationException Если перечисляемые домены изменились или были
+     * перенесены после открытия курсора.
+     */
+    size_t nextPage(std::span<CursorRecord> page);
+
+    /**
+     * @brief Проверяет, завершено ли перечисление.
+     * @return true если записей больше нет.
+     */
+    bool isFinished() const { return frames.empty(); }
+};
+
+/** @} */ // Конец группы network_module
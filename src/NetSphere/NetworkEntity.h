@@ -5,6 +5,10 @@
 
 #pragma once
 
+#include "SymbolTable.h"
+#include "NetworkObserver.h"
+#include <atomic>
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <memory>
@@ -16,21 +20,86 @@
   */
 
   /**
-   * @brief Абстрактный базовый класс для всех сущностей корпоративной сети.
-   *
-   * Содержит общие свойства и методы, которые должны быть реализованы
-   * всеми производными классами (устройствами и доменами).
+   * @brief Вид конкретной сущности сети.
+   * @details Хранится в каждой сущности и позволяет выполнять проверку типа
+   * и приведение без RTTI и без выделения памяти.
    */
+enum class EntityKind : uint8_t {
+    Domain,         ///< Домен
+    DataStorage,    ///< Хранилище данных
+    Workstation,    ///< Рабочая станция
+    Printer         ///< Принтер
+};
+
+/**
+ * @brief Возвращает отображаемое имя вида сущности.
+ * @param[in] kind Вид сущности.
+ * @return Статическая строка с именем вида (совпадает с результатом getType()).
+ */
+constexpr const char* entityKindName(EntityKind kind) noexcept {
+    switch (kind) {
+    case EntityKind::Domain: return "Domain";
+    case EntityKind::DataStorage: return "DataStorage";
+    case EntityKind::Workstation: return "Workstation";
+    case EntityKind::Printer: return "Printer";
+    }
+    return "Unknown";
+}
+
+/**
+ * @brief Абстрактный базовый класс для всех сущностей корпоративной сети.
+ *
+ * Содержит общие свойства и методы, которые должны быть реализованы
+ * всеми производными классами (устройствами и доменами).
+ */
 class NetworkEntity {
+private:
+    std::atomic<NetworkObserver*> observer{ nullptr }; ///< Наблюдатели сети, к которой присоединена сущность (nullptr вне сети)
+    std::atomic<Domain*> ownerDomain{ nullptr };        ///< Домен, непосредственно содержащий сущность (nullptr вне домена)
+    std::atomic<uint64_t> reportedUsedBytes{ 0 };       ///< Занятый объём сущности, уже учтённый в сводке ownerDomain
+
+    friend class CorporateNetwork;
+    friend class Domain;
+
 protected:
-    std::string id;   ///< Уникальный строковый идентификатор сущности внутри домена
+    Symbol id;                  ///< Уникальный идентификатор сущности внутри домена (интернированная строка)
+    const EntityKind entityKind; ///< Вид сущности, задаваемый конструктором производного класса
+
+    /**
+     * @brief Уведомляет наблюдателя сети, к которой присоединена сущность.
+     * @param[in] notify Функция вида void(NetworkObserver&); не вызывается, если сущность не в сети.
+     * @details Наблюдатель читается и вызывается внутри EpochGuard: сеть, отсоединяющая
+     * сущность или уничтожаемая, дожидается завершения начатых уведомлений.
+     */
+    template <typename Notify>
+    void notifyObserver(Notify&& notify) const {
+        EpochGuard guard;
+        if (NetworkObserver* current = observer.load(std::memory_order_acquire)) {
+            notify(*current);
+        }
+    }
 
 public:
     /**
      * @brief Конструктор базового класса NetworkEntity.
      * @param[in] id Уникальный строковый идентификатор сущности.
+     * @param[in] kind Вид создаваемой сущности.
+     */
+    NetworkEntity(const std::string& id, EntityKind kind) : id(Symbol::intern(id)), entityKind(kind) {}
+
+    /**
+     * @brief Конструктор с уже интернированным идентификатором (без обращения к пулу строк).
+     * @param[in] id Символ идентификатора сущности.
+     * @param[in] kind Вид создаваемой сущности.
      */
-    NetworkEntity(const std::string& id) : id(id) {}
+    NetworkEntity(Symbol id, EntityKind kind) : id(id), entityKind(kind) {}
+
+    /**
+     * @brief Проверяет, относится ли вид сущности к данному классу.
+     * @param[in] kind Проверяемый вид.
+     * @return Всегда true: любая сущность является NetworkEntity.
+     */
+    static constexpr bool isKindOf(EntityKind) noexcept { return true; }
 
     /**
      * @brief Виртуальный деструктор для обеспечения корректного удаления производных классов.
@@ -41,7 +110,28 @@ public:
      * @brief Возвращает идентификатор сущности.
      * @return Константная ссылка на строковый идентификатор сущности.
      */
-    const std::string& getId() const { return id; }
+    const std::string& getId() const { return id.str(); }
+
+    /**
+     * @brief Возвращает идентификатор сущности в виде интернированного символа.
+     * @return Символ идентификатора.
+     */
+    const Symbol& getIdSymbol() const noexcept { return id; }
+
+    /**
+     * @brief Возвращает вид сущности.
+     * @return Вид сущности (без виртуального вызова и выделения памяти).
+     */
+    EntityKind kind() const noexcept { return entityKind; }
+
+    /**
+     * @brief Возвращает домен, непосредственно содержащий сущность.
+     * @return Указатель на домен или nullptr для корневого домена и сущностей вне доменов.
+     * @details Домен владеет своими детьми, поэтому указатель действителен, пока сущность в нём.
+     * Потоки, не удерживающие блокировку писателя сети, читают его внутри EpochGuard:
+     * отсоединение и уничтожение домена дожидаются таких читателей.
+     */
+    Domain* getOwnerDomain() const noexcept { return ownerDomain.load(std::memory_order_seq_cst); }
 
     /**
      * @brief Чисто виртуальная функция для вывода информации о сущности.
@@ -52,8 +142,50 @@ public:
     /**
      * @brief Чисто виртуальная функция для получения типа сущности.
      * @return Строка, идентифицирующая тип сущности.
+     * @details Предназначена для отображения; для проверки типа используйте kind().
      */
     virtual std::string getType() const = 0;
 };
 
+/**
+ * @brief Проверяет, является ли сущность экземпляром класса T.
+ * @param[in] entity Проверяемая сущность.
+ * @return true если вид сущности соответствует классу T.
+ */
+template<typename T>
+bool isEntityOf(const NetworkEntity& entity) noexcept {
+    return T::isKindOf(entity.kind());
+}
+
+/**
+ * @brief Проверенное статическое приведение указателя на сущность.
+ * @param[in] entity Указатель на сущность (может быть nullptr).
+ * @return Указатель на T или nullptr, если вид сущности не соответствует T.
+ * @details Не увеличивает счётчик ссылок и не использует RTTI.
+ */
+template<typename T>
+T* entityCast(NetworkEntity* entity) noexcept {
+    return (entity && T::isKindOf(entity->kind())) ? static_cast<T*>(entity) : nullptr;
+}
+
+/**
+ * @brief Проверенное статическое приведение константного указателя на сущность.
+ * @param[in] entity Указатель на сущность (может быть nullptr).
+ * @return Константный указатель на T или nullptr, если вид сущности не соответствует T.
+ */
+template<typename T>
+const T* entityCast(const NetworkEntity* entity) noexcept {
+    return (entity && T::isKindOf(entity->kind())) ? static_cast<const T*>(entity) : nullptr;
+}
+
+/**
+ * @brief Проверенное статическое приведение умного указателя на сущность.
+ * @param[in] entity Умный указатель на сущность (может быть пустым).
+ * @return Умный указатель на T или nullptr, если вид сущности не соответствует T.
+ */
+template<typename T, typename From>
+std::shared_ptr<T> entityCast(const std::shared_ptr<From>& entity) noexcept {
+    return (entity && T::isKindOf(entity->kind())) ? std::static_pointer_cast<T>(entity) : nullptr;
+}
+
 /** @} */ // Конец группы entity_module
\ No newline at end of file
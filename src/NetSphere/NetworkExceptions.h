@@ -63,4 +63,24 @@ public:
     }
 };
 
+/**
+ * @brief Исключение, когда сущность с указанным идентификатором не найдена или имеет другой тип.
+ */
+class EntityNotFoundException : public NetworkException {
+public:
+    explicit EntityNotFoundException(const std::string& message)
+        : NetworkException("Сущность не найдена: " + message) {
+    }
+};
+
+/**
+ * @brief Исключение при обнаружении изменения сети во время перечисления.
+ */
+class ConcurrentModificationException : public NetworkException {
+public:
+    explicit ConcurrentModificationException(const std::string& message)
+        : NetworkException("Сеть изменилась во время перечисления: " + message) {
+    }
+};
+
 /** @} */ // Конец группы exceptions_module
\ No newline at end of file
@@ -0,0 +1,186 @@
+﻿/**
+ * @file NetworkObserver.h
+ * @brief Заголовочный файл интерфейса NetworkObserver - наблюдателя за изменениями сети.
+ */
+
+#pragma once
+
+#include "EpochReclamation.h"
+#include "SymbolTable.h"
+#include <algorithm>
+#include <atomic>
+#include <ctime>
+#include <memory>
+#include <vector>
+
+class NetworkEntity;
+class Domain;
+class DataStorage;
+class Workstation;
+
+/**
+ * @addtogroup network_module
+ * @{
+ */
+
+ /**
+  * @brief Наблюдатель за изменениями корпоративной сети.
+  *
+  * Уведомления вызываются синхронно, после того как изменение успешно
+  * применено. Они приходят только для сущностей, присоединённых к сети.
+  * Реализации переопределяют только нужные им события.
+  * События устройств приходят из потоков, изменяющих устройства, внутри EpochGuard,
+  * поэтому обработчик не должен вызывать изменяющие структуру методы сети.
+  */
+class NetworkObserver {
+public:
+    virtual ~NetworkObserver() = default;
+
+    /**
+     * @brief Сущность (вместе со всем поддеревом) добавлена в домен.
+     * @param[in] parent Домен, в который добавлена сущность.
+     * @param[in] entity Добавленная сущность.
+     */
+    virtual void onEntityAdded([[maybe_unused]] const Domain& parent, [[maybe_unused]] const NetworkEntity& entity) {}
+
+    /**
+     * @brief Сущность (вместе со всем поддеревом) удалена из домена.
+     * @param[in] parent Домен, из которого удалена сущность.
+     * @param[in] entity Удалённая сущность.
+     */
+    virtual void onEntityRemoved([[maybe_unused]] const Domain& parent, [[maybe_unused]] const NetworkEntity& entity) {}
+
+    /**
+     * @brief Изменился занятый объём хранилища.
+     * @param[in] storage Хранилище после изменения.
+     * @param[in] previousUsedMB Занятый объём до изменения.
+     */
+    virtual void onStorageUsageChanged([[maybe_unused]] const DataStorage& storage, [[maybe_unused]] double previousUsedMB) {}
+
+    /**
+     * @brief Пользователь добавлен в список доверенных хранилища.
+     * @param[in] storage Хранилище.
+     * @param[in] user Добавленный пользователь.
+     */
+    virtual void onTrustedUserAdded([[maybe_unused]] const DataStorage& storage, [[maybe_unused]] Symbol user) {}
+
+    /**
+     * @brief Пользователь удалён из списка доверенных хранилища.
+     * @param[in] storage Хранилище.
+     * @param[in] user Удалённый пользователь.
+     */
+    virtual void onTrustedUserRemoved([[maybe_unused]] const DataStorage& storage, [[maybe_unused]] Symbol user) {}
+
+    /**
+     * @brief Изменилось время последнего включения рабочей станции.
+     * @param[in] workstation Рабочая станция после изменения.
+     * @param[in] previousTime Время включения до изменения.
+     */
+    virtual void onPowerOnTimeChanged([[maybe_unused]] const Workstation& workstation, [[maybe_unused]] time_t previousTime) {}
+};
+
+/**
+ * @brief Рассылает события сети всем подписанным наблюдателям.
+ *
+ * Каждая сущность сети хранит указатель на список своей сети, поэтому
+ * уведомление от устройства стоит одного косвенного вызова, а при пустом
+ * списке подписчиков — одной проверки.
+ *
+ * Список подписчиков публикуется копированием при записи: подписка и отписка
+ * собирают новый вектор и освобождают прежний через EpochManager, а рассылка
+ * читает опубликованный вектор в EpochGuard. Поэтому события устройств из любых
+ * потоков не блокируют подписку. Сами подписка и отписка вызываются под внешней
+ * блокировкой писателя.
+ */
+class NetworkObserverList final : public NetworkObserver {
+private:
+    using Observers = std::vector<NetworkObserver*>;
+
+    std::atomic<const Observers*> observers{ new Observers() };   ///< Подписанные наблюдатели (не владеет ими)
+
+    /**
+     * @brief Публикует новый список и откладывает освобождение прежнего.
+     * @param[in] next Новый список.
+     */
+    void publish(std::unique_ptr<Observers> next) {
+        const Observers* previous = observers.exchange(next.release(), std::memory_order_acq_rel);
+        EpochManager::instance().retireObject(previous);
+    }
+
+    /**
+     * @brief Вызывает функцию для каждого подписчика опубликованного списка.
+     * @param[in] notify Функция вида void(NetworkObserver&).
+     */
+    template <typename Notify>
+    void forEach(Notify&& notify) const {
+        EpochGuard guard;
+        for (auto* observer : *observers.load(std::memory_order_acquire)) {
+            notify(*observer);
+        }
+    }
+
+public:
+    NetworkObserverList() = default;
+    ~NetworkObserverList() override { delete observers.load(std::memory_order_relaxed); }
+
+    NetworkObserverList(const NetworkObserverList&) = delete;
+    NetworkObserverList& operator=(const NetworkObserverList&) = delete;
+
+    /**
+     * @brief Подписывает наблюдателя; повторная подписка игнорируется.
+     * @param[in] observer Наблюдатель, который должен пережить подписку.
+     */
+    void add(NetworkObserver* observer) {
+        const Observers& current = *observers.load(std::memory_order_acquire);
+        if (observer && std::find(current.begin(), current.end(), observer) == current.end()) {
+            auto next = std::make_unique<Observers>(current);
+            next->push_back(observer);
+            publish(std::move(next));
+        }
+    }
+
+    /**
+     * @brief Отписывает наблюдателя.
+     * @param[in] observer Ранее подписанный наблюдатель.
+     * @details Рассылки, начатые до вызова, ещё могут обратиться к наблюдателю;
+     * дождаться их можно через EpochManager::synchronize.
+     */
+    void remove(NetworkObserver* observer) {
+        const Observers& current = *observers.load(std::memory_order_acquire);
+        if (std::find(current.begin(), current.end(), observer) != current.end()) {
+            auto next = std::make_unique<Observers>(current);
+            next->erase(std::remove(next->begin(), next->end(), observer), next->end());
+            publish(std::move(next));
+        }
+    }
+
+    /**
+     * @brief Проверяет, есть ли подписчики.
+     * @return true если подписчиков нет.
+     */
+    bool empty() const noexcept {
+        EpochGuard guard;
+        return observers.load(std::memory_order_acquire)->empty();
+    }
+
+    void onEntityAdded(const Domain& parent, const NetworkEntity& entity) override {
+        forEach([&](NetworkObserver& observer) { observer.onEntityAdded(parent, entity); });
+    }
+    void onEntityRemoved(const Domain& parent, const NetworkEntity& entity) override {
+        forEach([&](NetworkObserver& observer) { observer.onEntityRemoved(parent, entity); });
+    }
+    void onStorageUsageChanged(const DataStorage& storage, double previousUsedMB) override {
+        forEach([&](NetworkObserver& observer) { observer.onStorageUsageChanged(storage, previousUsedMB); });
+    }
+    void onTrustedUserAdded(const DataStorage& storage, Symbol user) override {
+        forEach([&](NetworkObserver& observer) { observer.onTrustedUserAdded(storage, user); });
+    }
+    void onTrustedUserRemoved(const DataStorage& storage, Symbol user) override {
+        forEach([&](NetworkObserver& observer) { observer.onTrustedUserRemoved(storage, user); });
+    }
+    void onPowerOnTimeChanged(const Workstation& workstation, time_t previousTime) override {
+        forEach([&](NetworkObserver& observer) { observer.onPowerOnTimeChanged(workstation, previousTime); });
+    }
+};
+
+/** @} */ // Конец группы network_module
@@ -0,0 +1,465 @@
+﻿/**
+ * @file NetworkSnapshot.cpp
+ * @brief Реализация записи и чтения двоичного снимка корпоративной сети.
+ */
+
+#include "NetworkSnapshot.h"
+#include "DataStorage.h"
+#include "Workstation.h"
+#include "Printer.h"
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+struct NetworkSnapshot::Header {
+    char magic[8];                  ///< Сигнатура "NSPSNAP\0"
+    uint32_t version;               ///< Версия формата
+    uint32_t headerSize;            ///< Размер заголовка в байтах
+    uint32_t entityCount;           ///< Число записей сущностей
+    uint32_t stringCount;           ///< Число строк
+    uint32_t domainCount;           ///< Число записей доменов
+    uint32_t storageCount;          ///< Число записей хранилищ
+    uint32_t workstationCount;      ///< Число записей рабочих станций
+    uint32_t printerCount;          ///< Число записей принтеров
+    uint32_t trustedUserCount;      ///< Длина общего списка доверенных пользователей
+    uint32_t indexBucketCount;      ///< Число корзин хэш-индекса (степень двойки)
+    uint64_t stringTableOffset;     ///< Смещение таблицы строк
+    uint64_t stringDataOffset;      ///< Смещение блока символов
+    uint64_t stringDataSize;        ///< Размер блока символов
+    uint64_t entityTableOffset;     ///< Смещение записей сущностей
+    uint64_t domainTableOffset;     ///< Смещение записей доменов
+    uint64_t storageTableOffset;    ///< Смещение записей хранилищ
+    uint64_t workstationTableOffset;///< Смещение записей рабочих станций
+    uint64_t printerTableOffset;    ///< Смещение записей принтеров
+    uint64_t trustedUserOffset;     ///< Смещение списка доверенных пользователей
+    uint64_t indexOffset;           ///< Смещение хэш-индекса
+    uint64_t fileSize;              ///< Полный размер файла
+};
+
+struct NetworkSnapshot::StringRef {
+    uint32_t offset;                ///< Смещение в блоке символов
+    uint32_t length;                ///< Длина строки
+};
+
+struct NetworkSnapshot::EntityRecord {
+    uint32_t id;                    ///< Индекс строки идентификатора
+    uint32_t parent;                ///< Индекс родителя (NO_INDEX для корня)
+    uint32_t subtreeEnd;            ///< Индекс, следующий за последним потомком
+    uint32_t detail;                ///< Индекс записи в таблице своего вида
+    uint32_t kind;                  ///< Значение EntityKind
+};
+
+struct NetworkSnapshot::DomainRecord {
+    uint32_t admin;                 ///< Индекс строки администратора
+};
+
+struct NetworkSnapshot::StorageRecord {
+    uint64_t mac;                   ///< MAC-адрес
+    double totalSizeMB;             ///< Общий объём
+    double usedSizeMB;              ///< Занятый объём
+    uint32_t trustedFirst;          ///< Первый элемент в списке доверенных пользователей
+    uint32_t trustedCount;          ///< Число доверенных пользователей
+};
+
+struct NetworkSnapshot::WorkstationRecord {
+    uint64_t mac;                   ///< MAC-адрес
+    int64_t powerOnTime;            ///< Время последнего включения
+    uint32_t user;                  ///< Индекс строки пользователя
+    uint32_t reserved;              ///< Выравнивание
+};
+
+struct NetworkSnapshot::PrinterRecord {
+    uint64_t mac;                   ///< MAC-адрес
+};
+
+namespace {
+
+    constexpr char SNAPSHOT_MAGIC[8] = { 'N', 'S', 'P', 'S', 'N', 'A', 'P', '\0' };
+    constexpr uint32_t NO_INDEX = 0xFFFFFFFFu;
+
+    static_assert(std::endian::native == std::endian::little, "Формат снимка рассчитан на little-endian платформы");
+
+    /**
+     * @brief Хэш FNV-1a, не зависящий от реализации стандартной библиотеки.
+     */
+    uint64_t hashId(std::string_view id) noexcept {
+        uint64_t hash = 14695981039346656037ull;
+        for (unsigned char c : id) {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    constexpr uint64_t alignUp(uint64_t offset) noexcept {
+        return (offset + 7) & ~uint64_t(7);
+    }
+
+    template <typename T>
+    void writeTable(std::ofstream& out, const std::vector<T>& table, uint64_t& position) {
+        static const char padding[8] = {};
+        out.write(padding, static_cast<std::streamsize>(alignUp(position) - position));
+        position = alignUp(position);
+        out.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(table.size() * sizeof(T)));
+        position += table.size() * sizeof(T);
+    }
+
+}
+
+void NetworkSnapshot::write(const CorporateNetwork& network, const std::string& path) {
+    std::vector<StringRef> stringTable;
+    std::string stringBlock;
+    std::unordered_map<Symbol, uint32_t> stringIndex;
+    std::vector<EntityRecord> entityTable;
+    std::vector<DomainRecord> domainTable;
+    std::vector<StorageRecord> storageTable;
+    std::vector<WorkstationRecord> workstationTable;
+    std::vector<PrinterRecord> printerTable;
+    std::vector<uint32_t> trustedTable;
+
+    auto addString = [&](Symbol symbol) {
+        auto [it, inserted] = stringIndex.try_emplace(symbol, static_cast<uint32_t>(stringTable.size()));
+        if (inserted) {
+            const std::string& text = symbol.str();
+            if (stringBlock.size() + text.size() > UINT32_MAX) {
+                throw NetworkException("Снимок сети превышает допустимый размер блока строк");
+            }
+            stringTable.push_back({ static_cast<uint32_t>(stringBlock.size()), static_cast<uint32_t>(text.size()) });
+            stringBlock += text;
+        }
+        return it->second;
+    };
+
+    // Прямой обход: родитель всегда предшествует потомкам, а потомки занимают
+    // непрерывный диапазон [index + 1, subtreeEnd)
+    auto appendEntity = [&](auto& self, const NetworkEntity& entity, uint32_t parent) -> void {
+        const uint32_t index = static_cast<uint32_t>(entityTable.size());
+        EntityRecord record{ addString(entity.getIdSymbol()), parent, 0, 0, static_cast<uint32_t>(entity.kind()) };
+
+        switch (entity.kind()) {
+        case EntityKind::Domain: {
+            const auto& domain = static_cast<const Domain&>(entity);
+            record.detail = static_cast<uint32_t>(domainTable.size());
+            domainTable.push_back({ addString(domain.getAdminSymbol()) });
+            break;
+        }
+        case EntityKind::DataStorage: {
+            const auto& storage = static_cast<const DataStorage&>(entity);
+            record.detail = static_cast<uint32_t>(storageTable.size());
+            StorageRecord detail{ storage.getMac().toUInt64(), storage.getTotalSize(), storage.getUsedSize(),
+                static_cast<uint32_t>(trustedTable.size()), static_cast<uint32_t>(storage.getTrustedUserCount()) };
+            storage.forEachTrustedUser([&](Symbol user) { trustedTable.push_back(addString(user)); });
+            storageTable.push_back(detail);
+            break;
+        }
+        case EntityKind::Workstation: {
+            const auto& workstation = static_cast<const Workstation&>(entity);
+            record.detail = static_cast<uint32_t>(workstationTable.size());
+            workstationTable.push_back({ workstation.getMac().toUInt64(),
+                static_cast<int64_t>(workstation.getLastPowerOnTime()), addString(workstation.getUserSymbol()), 0 });
+            break;
+        }
+        case EntityKind::Printer: {
+            const auto& printer = static_cast<const Printer&>(entity);
+            record.detail = static_cast<uint32_t>(printerTable.size());
+            printerTable.push_back({ printer.getMac().toUInt64() });
+            break;
+        }
+        }
+        entityTable.push_back(record);
+
+        if (const Domain* domain = entityCast<Domain>(&entity)) {
+            for (const auto& [id, child] : domain->getAllEntities()) {
+                self(self, *child, index);
+            }
+        }
+        entityTable[index].subtreeEnd = static_cast<uint32_t>(entityTable.size());
+    };
+    appendEntity(appendEntity, *network.getRootDomain(), NO_INDEX);
+
+    // Хэш-индекс с коэффициентом заполнения не выше 1/2
+    const uint32_t bucketCount = std::bit_ceil(static_cast<uint32_t>(entityTable.size() * 2));
+    std::vector<uint32_t> indexTable(bucketCount, NO_INDEX);
+    for (uint32_t i = 0; i < entityTable.size(); ++i) {
+        const StringRef& ref = stringTable[entityTable[i].id];
+        size_t bucket = hashId(std::string_view(stringBlock).substr(ref.offset, ref.length)) & (bucketCount - 1);
+        while (indexTable[bucket] != NO_INDEX) {
+            bucket = (bucket + 1) & (bucketCount - 1);
+        }
+        indexTable[bucket] = i;
+    }
+
+    Header header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = FORMAT_VERSION;
+    header.headerSize = sizeof(Header);
+    header.entityCount = static_cast<uint32_t>(entityTable.size());
+    header.stringCount = static_cast<uint32_t>(stringTable.size());
+    header.domainCount = static_cast<uint32_t>(domainTable.size());
+    header.storageCount = static_cast<uint32_t>(storageTable.size());
+    header.workstationCount = static_cast<uint32_t>(workstationTable.size());
+    header.printerCount = static_cast<uint32_t>(printerTable.size());
+    header.trustedUserCount = static_cast<uint32_t>(trustedTable.size());
+    header.indexBucketCount = bucketCount;
+
+    uint64_t offset = sizeof(Header);
+    auto place = [&offset](uint64_t bytes) {
+        offset = alignUp(offset);
+        const uint64_t start = offset;
+        offset += bytes;
+        return start;
+    };
+    header.stringTableOffset = place(stringTable.size() * sizeof(StringRef));
+    header.stringDataOffset = place(stringBlock.size());
+    header.stringDataSize = stringBlock.size();
+    header.entityTableOffset = place(entityTable.size() * sizeof(EntityRecord));
+    header.domainTableOffset = place(domainTable.size() * sizeof(DomainRecord));
+    header.storageTableOffset = place(storageTable.size() * sizeof(StorageRecord));
+    header.workstationTableOffset = place(workstationTable.size() * sizeof(WorkstationRecord));
+    header.printerTableOffset = place(printerTable.size() * sizeof(PrinterRecord));
+    header.trustedUserOffset = place(trustedTable.size() * sizeof(uint32_t));
+    header.indexOffset = place(indexTable.size() * sizeof(uint32_t));
+    header.fileSize = offset;
+
+    const std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw NetworkException("Не удалось создать файл снимка: " + temporaryPath);
+        }
+        uint64_t position = sizeof(Header);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        writeTable(out, stringTable, position);
+        writeTable(out, std::vector<char>(stringBlock.begin(), stringBlock.end()), position);
+        writeTable(out, entityTable, position);
+        writeTable(out, domainTable, position);
+        writeTable(out, storageTable, position);
+        writeTable(out, workstationTable, position);
+        writeTable(out, printerTable, position);
+        writeTable(out, trustedTable, position);
+        writeTable(out, indexTable, position);
+        out.flush();
+        if (!out) {
+            throw NetworkException("Ошибка записи файла снимка: " + temporaryPath);
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error) {
+        std::filesystem::remove(temporaryPath, error);
+        throw NetworkException("Не удалось заменить файл снимка: " + path);
+    }
+}
+
+NetworkSnapshot::NetworkSnapshot(const std::string& path) : file(path) {
+    if (file.size() < sizeof(Header)) {
+        throw ValidationException("Файл снимка слишком мал: " + path);
+    }
+    header = reinterpret_cast<const Header*>(file.data());
+    validate();
+
+    const char* base = file.data();
+    strings = reinterpret_cast<const StringRef*>(base + header->stringTableOffset);
+    stringData = base + header->stringDataOffset;
+    entities = reinterpret_cast<const EntityRecord*>(base + header->entityTableOffset);
+    domains = reinterpret_cast<const DomainRecord*>(base + header->domainTableOffset);
+    storages = reinterpret_cast<const StorageRecord*>(base + header->storageTableOffset);
+    workstations = reinterpret_cast<const WorkstationRecord*>(base + header->workstationTableOffset);
+    printers = reinterpret_cast<const PrinterRecord*>(base + header->printerTableOffset);
+    trustedUsers = reinterpret_cast<const uint32_t*>(base + header->trustedUserOffset);
+    idIndex = reinterpret_cast<const uint32_t*>(base + header->indexOffset);
+}
+
+void NetworkSnapshot::validate() const {
+    if (std::memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        throw ValidationException("Файл не является снимком сети NetSphere");
+    }
+    if (header->version != FORMAT_VERSION || header->headerSize != sizeof(Header)) {
+        throw ValidationException("Неподдерживаемая версия снимка: " + std::to_string(header->version));
+    }
+    if (header->fileSize != file.size()) {
+        throw ValidationException("Размер файла снимка не совпадает с заголовком");
+    }
+
+    auto checkTable = [&](uint64_t offset, uint64_t count, uint64_t elementSize) {
+        if (offset % 8 != 0 || offset < sizeof(Header) || offset > file.size() ||
+            count > (file.size() - offset) / elementSize) {
+            throw ValidationException("Таблица снимка выходит за границы файла");
+        }
+    };
+    checkTable(header->stringTableOffset, header->stringCount, sizeof(StringRef));
+    checkTable(header->stringDataOffset, header->stringDataSize, 1);
+    checkTable(header->entityTableOffset, header->entityCount, sizeof(EntityRecord));
+    checkTable(header->domainTableOffset, header->domainCount, sizeof(DomainRecord));
+    checkTable(header->storageTableOffset, header->storageCount, sizeof(StorageRecord));
+    checkTable(header->workstationTableOffset, header->workstationCount, sizeof(WorkstationRecord));
+    checkTable(header->printerTableOffset, header->printerCount, sizeof(PrinterRecord));
+    checkTable(header->trustedUserOffset, header->trustedUserCount, sizeof(uint32_t));
+    checkTable(header->indexOffset, header->indexBucketCount, sizeof(uint32_t));
+    if (header->entityCount == 0 || !std::has_single_bit(header->indexBucketCount) ||
+        header->indexBucketCount <= header->entityCount) {
+        throw ValidationException("Повреждён заголовок снимка");
+    }
+
+    const char* base = file.data();
+    const auto* stringTable = reinterpret_cast<const StringRef*>(base + header->stringTableOffset);
+    for (uint32_t i = 0; i < header->stringCount; ++i) {
+        if (uint64_t(stringTable[i].offset) + stringTable[i].length > header->stringDataSize) {
+            throw ValidationException("Строка снимка выходит за границы блока строк");
+        }
+    }
+
+    // Проверка структуры дерева: родитель предшествует потомку, поддеревья вложены
+    const auto* records = reinterpret_cast<const EntityRecord*>(base + header->entityTableOffset);
+    const auto* storageTable = reinterpret_cast<const StorageRecord*>(base + header->storageTableOffset);
+    const auto* workstationTable = reinterpret_cast<const WorkstationRecord*>(base + header->workstationTableOffset);
+    const auto* domainTable = reinterpret_cast<const DomainRecord*>(base + header->domainTableOffset);
+    const auto* trustedTable = reinterpret_cast<const uint32_t*>(base + header->trustedUserOffset);
+    const uint32_t limits[] = { header->domainCount, header->storageCount, header->workstationCount, header->printerCount };
+    for (uint32_t i = 0; i < header->entityCount; ++i) {
+        const EntityRecord& record = records[i];
+        const bool rootOk = (i == 0) ? record.parent == NO_INDEX && record.subtreeEnd == header->entityCount
+            : record.parent < i && records[record.parent].kind == static_cast<uint32_t>(EntityKind::Domain) &&
+              record.subtreeEnd <= records[record.parent].subtreeEnd;
+        if (!rootOk || record.subtreeEnd <= i || record.id >= header->stringCount ||
+            record.kind > static_cast<uint32_t>(EntityKind::Printer) || record.detail >= limits[record.kind]) {
+            throw ValidationException("Повреждена запись сущности снимка №" + std::to_string(i));
+        }
+        if (record.kind == static_cast<uint32_t>(EntityKind::Domain) && domainTable[record.detail].admin >= header->stringCount) {
+            throw ValidationException("Повреждена запись домена снимка №" + std::to_string(i));
+        }
+        if (record.kind == static_cast<uint32_t>(EntityKind::Workstation) &&
+            workstationTable[record.detail].user >= header->stringCount) {
+            throw ValidationException("Повреждена запись рабочей станции снимка №" + std::to_string(i));
+        }
+    }
+    if (records[0].kind != static_cast<uint32_t>(EntityKind::Domain)) {
+        throw ValidationException("Корневая запись снимка должна быть доменом");
+    }
+    for (uint32_t i = 0; i < header->storageCount; ++i) {
+        const StorageRecord& record = storageTable[i];
+        if (uint64_t(record.trustedFirst) + record.trustedCount > header->trustedUserCount) {
+            throw ValidationException("Повреждён список доверенных пользователей снимка");
+        }
+    }
+    for (uint32_t i = 0; i < header->trustedUserCount; ++i) {
+        if (trustedTable[i] >= header->stringCount) {
+            throw ValidationException("Повреждён список доверенных пользователей снимка");
+        }
+    }
+}
+
+std::string_view NetworkSnapshot::stringAt(uint32_t index) const {
+    return std::string_view(stringData + strings[index].offset, strings[index].length);
+}
+
+size_t NetworkSnapshot::getEntityCount() const {
+    return header->entityCount;
+}
+
+std::optional<size_t> NetworkSnapshot::findIndex(std::string_view id) const {
+    const uint32_t mask = header->indexBucketCount - 1;
+    size_t bucket = hashId(id) & mask;
+    for (uint32_t probe = 0; probe < header->indexBucketCount && idIndex[bucket] != NO_INDEX; ++probe) {
+        const uint32_t index = idIndex[bucket];
+        bucket = (bucket + 1) & mask;
+        if (index < header->entityCount && stringAt(entities[index].id) == id) {
+            return index;
+        }
+    }
+    return std::nullopt;
+}
+
+std::string_view NetworkSnapshot::getId(size_t index) const {
+    return stringAt(entities[index].id);
+}
+
+EntityKind NetworkSnapshot::getKind(size_t index) const {
+    return static_cast<EntityKind>(entities[index].kind);
+}
+
+std::optional<size_t> NetworkSnapshot::getParentIndex(size_t index) const {
+    const uint32_t parent = entities[index].parent;
+    return parent == NO_INDEX ? std::nullopt : std::optional<size_t>(parent);
+}
+
+std::shared_ptr<NetworkEntity> NetworkSnapshot::buildEntity(size_t index) const {
+    const EntityRecord& record = entities[index];
+    const std::string id(stringAt(record.id));
+
+    switch (static_cast<EntityKind>(record.kind)) {
+    case EntityKind::Domain:
+        return std::make_shared<Domain>(id, std::string(stringAt(domains[record.detail].admin)));
+    case EntityKind::DataStorage: {
+        const StorageRecord& detail = storages[record.detail];
+        auto storage = std::make_shared<DataStorage>(id, MacAddress::fromUInt64(detail.mac), detail.totalSizeMB);
+        if (detail.usedSizeMB > 0) {
+            *storage = detail.usedSizeMB;
+        }
+        for (uint32_t i = 0; i < detail.trustedCount; ++i) {
+            storage->addTrustedUser(std::string(stringAt(trustedUsers[detail.trustedFirst + i])));
+        }
+        return storage;
+    }
+    case EntityKind::Workstation: {
+        const WorkstationRecord& detail = workstations[record.detail];
+        return std::make_shared<Workstation>(id, MacAddress::fromUInt64(detail.mac),
+            std::string(stringAt(detail.user)), static_cast<time_t>(detail.powerOnTime));
+    }
+    case EntityKind::Printer:
+        return std::make_shared<Printer>(id, MacAddress::fromUInt64(printers[record.detail].mac));
+    }
+    throw ValidationException("Неизвестный вид сущности в снимке");
+}
+
+std::shared_ptr<NetworkEntity> NetworkSnapshot::buildSubtree(size_t index) const {
+    if (index >= header->entityCount) {
+        throw ValidationException("Индекс сущности снимка вне таблицы: " + std::to_string(index));
+    }
+    const size_t end = entities[index].subtreeEnd;
+    std::vector<std::shared_ptr<NetworkEntity>> built;
+    built.reserve(end - index);
+    for (size_t i = index; i < end; ++i) {
+        built.push_back(buildEntity(i));
+    }
+
+    // Прямые потомки домена перечисляются переходом через границы их поддеревьев
+    std::vector<std::shared_ptr<NetworkEntity>> children;
+    for (size_t i = index; i < end; ++i) {
+        if (entities[i].kind != static_cast<uint32_t>(EntityKind::Domain) || entities[i].subtreeEnd == i + 1) {
+            continue;
+        }
+        children.clear();
+        for (size_t child = i + 1; child < entities[i].subtreeEnd; child = entities[child].subtreeEnd) {
+            // validate() гарантирует вложенность границ, но не то, что потомок в границах
+            // домена ссылается именно на него
+            if (entities[child].parent != i || entities[child].subtreeEnd > end) {
+                throw ValidationException("Повреждена запись сущности снимка №" + std::to_string(child));
+            }
+            children.push_back(built[child - index]);
+        }
+        auto domain = entityCast<Domain>(built[i - index]);
+        domain->addEntities(children, domain->getAdminId());
+    }
+    return built.front();
+}
+
+std::shared_ptr<NetworkEntity> NetworkSnapshot::materialize(std::string_view id) const {
+    auto index = findIndex(id);
+    return index ? buildSubtree(*index) : nullptr;
+}
+
+CorporateNetwork NetworkSnapshot::restore() const {
+    const std::string rootAdmin(stringAt(domains[entities[0].detail].admin));
+    CorporateNetwork network(rootAdmin);
+
+    std::vector<std::shared_ptr<NetworkEntity>> topLevel;
+    for (size_t child = 1; child < header->entityCount; child = entities[child].subtreeEnd) {
+        topLevel.push_back(buildSubtree(child));
+    }
+    network.addEntitiesToDomain("", topLevel, rootAdmin);
+    return network;
+}
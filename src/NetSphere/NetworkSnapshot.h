@@ -0,0 +1,154 @@
+﻿/**
+ * @file NetworkSnapshot.h
+ * @brief Заголовочный файл класса NetworkSnapshot - двоичного снимка корпоративной сети.
+ */
+
+#pragma once
+
+#include "CorporateNetwork.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+ /**
+  * @addtogroup snapshot_module
+  * @{
+  */
+
+  /**
+   * @brief Версионированный двоичный снимок всей корпоративной сети.
+   *
+   * Формат файла (все поля фиксированной ширины, выравнивание 8 байт):
+   * - заголовок с сигнатурой, версией и смещениями всех таблиц;
+   * - таблица строк (смещение и длина каждой строки) и общий блок символов;
+   * - массив записей сущностей в прямом порядке обхода: идентификатор,
+   *   индекс родителя, граница поддерева, вид и индекс записи вида;
+   * - отдельные массивы записей доменов, хранилищ, рабочих станций и принтеров
+   *   (MAC-адреса хранятся как 48-битные числа);
+   * - список доверенных пользователей хранилищ;
+   * - хэш-индекс идентификаторов с открытой адресацией (FNV-1a, линейное пробирование).
+   *
+   * Читатель отображает файл в память и проверяет только границы таблиц,
+   * поэтому открытие снимка не зависит от числа полей. Поиск по идентификатору
+   * и навигация по дереву выполняются прямо в отображении; объекты сущностей
+   * создаются по требованию (materialize) или целиком (restore).
+   */
+class NetworkSnapshot {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 1;   ///< Текущая версия формата файла
+
+private:
+    struct Header;
+    struct StringRef;
+    struct EntityRecord;
+    struct DomainRecord;
+    struct StorageRecord;
+    struct WorkstationRecord;
+    struct PrinterRecord;
+
+    MappedFile file;                                ///< Отображение файла снимка
+    const Header* header = nullptr;                 ///< Заголовок файла
+    const StringRef* strings = nullptr;             ///< Таблица строк
+    const char* stringData = nullptr;               ///< Блок символов строк
+    const EntityRecord* entities = nullptr;         ///< Записи сущностей в прямом порядке обхода
+    const DomainRecord* domains = nullptr;          ///< Записи доменов
+    const StorageRecord* storages = nullptr;        ///< Записи хранилищ данных
+    const WorkstationRecord* workstations = nullptr;///< Записи рабочих станций
+    const PrinterRecord* printers = nullptr;        ///< Записи принтеров
+    const uint32_t* trustedUsers = nullptr;         ///< Индексы строк доверенных пользователей
+    const uint32_t* idIndex = nullptr;              ///< Хэш-индекс идентификаторов
+
+    /**
+     * @brief Проверяет заголовок, границы таблиц и каждую запись снимка.
+     * @throw ValidationException Если файл повреждён или имеет неподдерживаемую версию.
+     * @details Проверка заголовка и границ таблиц - O(1), но затем однократно просматриваются
+     * все строки, записи сущностей, хранилищ и доверенных пользователей: открытие снимка
+     * линейно по его размеру. После неё индексы записей при чтении не проверяются.
+     */
+    void validate() const;
+
+    std::string_view stringAt(uint32_t index) const;
+
+    /**
+     * @brief Создаёт объект одной сущности без вложенных сущностей.
+     */
+    std::shared_ptr<NetworkEntity> buildEntity(size_t index) const;
+
+    /**
+     * @brief Создаёт сущность со всем её поддеревом.
+     * @throw ValidationException Если индекс вне таблицы или потомок ссылается не на свой домен.
+     */
+    std::shared_ptr<NetworkEntity> buildSubtree(size_t index) const;
+
+public:
+    /**
+     * @brief Открывает снимок: отображает файл в память и проверяет его структуру.
+     * @param[in] path Путь к файлу снимка.
+     * @throw NetworkException Если файл не удалось открыть.
+     * @throw ValidationException Если файл повреждён или имеет другую версию формата.
+     */
+    explicit NetworkSnapshot(const std::string& path);
+
+    /**
+     * @brief Записывает снимок сети в файл.
+     * @param[in] network Сохраняемая сеть.
+     * @param[in] path Путь к файлу снимка.
+     * @throw NetworkException Если файл не удалось записать.
+     * @details Данные сначала пишутся во временный файл, который затем атомарно
+     * заменяет целевой, поэтому читатели никогда не видят частично записанный снимок.
+     */
+    static void write(const CorporateNetwork& network, const std::string& path);
+
+    /**
+     * @brief Возвращает количество сущностей в снимке (включая корневой домен).
+     * @return Число сущностей.
+     */
+    size_t getEntityCount() const;
+
+    /**
+     * @brief Ищет сущность по идентификатору в хэш-индексе снимка.
+     * @param[in] id Идентификатор сущности.
+     * @return Индекс записи или std::nullopt, если сущности нет.
+     */
+    std::optional<size_t> findIndex(std::string_view id) const;
+
+    /**
+     * @brief Возвращает идентификатор сущности по индексу записи.
+     * @param[in] index Индекс записи (меньше getEntityCount()).
+     * @return Строка, указывающая прямо в отображение файла.
+     */
+    std::string_view getId(size_t index) const;
+
+    /**
+     * @brief Возвращает вид сущности по индексу записи.
+     * @param[in] index Индекс записи.
+     * @return Вид сущности.
+     */
+    EntityKind getKind(size_t index) const;
+
+    /**
+     * @brief Возвращает индекс родительского домена.
+     * @param[in] index Индекс записи.
+     * @return Индекс родителя или std::nullopt для корневого домена.
+     */
+    std::optional<size_t> getParentIndex(size_t index) const;
+
+    /**
+     * @brief Создаёт объект сущности вместе со всеми вложенными сущностями.
+     * @param[in] id Идентификатор сущности.
+     * @return Новая сущность, не принадлежащая никакой сети, или nullptr, если её нет в снимке.
+     */
+    std::shared_ptr<NetworkEntity> materialize(std::string_view id) const;
+
+    /**
+     * @brief Восстанавливает всю сеть из снимка.
+     * @return Новая сеть с тем же составом и иерархией.
+     * @details Сущности каждого домена добавляются пакетно, без разбора текстовых полей.
+     */
+    CorporateNetwork restore() const;
+};
+
+/** @} */ // Конец группы snapshot_module
@@ -0,0 +1,79 @@
+﻿/**
+ * @file PowerOnIngestor.cpp
+ * @brief Реализация пакетного приёма телеметрии включения рабочих станций.
+ */
+
+#include "PowerOnIngestor.h"
+#include "Workstation.h"
+
+PowerOnIngestor::PowerOnIngestor(CorporateNetwork& network, std::chrono::milliseconds window)
+    : network(network), window(window), windowStart(std::chrono::steady_clock::now()) {
+}
+
+PowerOnSubmitResult PowerOnIngestor::submit(std::span<const PowerOnEvent> batch) {
+    PowerOnSubmitResult result;
+    PowerOnBatchStats& stats = result.batch;
+    stats.received = batch.size();
+
+    ids.clear();
+    ids.reserve(batch.size());
+    for (const PowerOnEvent& event : batch) {
+        ids.push_back(event.workstationId);
+    }
+
+    if (pending.empty()) {
+        windowStart = std::chrono::steady_clock::now();
+    }
+    network.withEntities(ids, [&](size_t position, const std::shared_ptr<NetworkEntity>* entity) {
+        auto* workstation = entity ? entityCast<Workstation>(entity->get()) : nullptr;
+        if (!workstation) {
+            ++stats.unknown;
+            return;
+        }
+        const time_t powerOnTime = batch[position].powerOnTime;
+        auto [it, inserted] = pending.try_emplace(workstation);
+        if (inserted) {
+            // Умный указатель копируется один раз на станцию в окне, а не на событие
+            it->second = Pending{ std::static_pointer_cast<Workstation>(*entity), powerOnTime };
+        }
+        else {
+            ++stats.coalesced;
+            if (powerOnTime > it->second.powerOnTime) {
+                it->second.powerOnTime = powerOnTime;
+            }
+        }
+    });
+
+    result.closedWindow = flushIfDue();
+    return result;
+}
+
+std::optional<PowerOnWindowStats> PowerOnIngestor::flushIfDue() {
+    if (pending.empty() || std::chrono::steady_clock::now() < deadline()) {
+        return std::nullopt;
+    }
+    return applyPending();
+}
+
+PowerOnWindowStats PowerOnIngestor::flush() {
+    return applyPending();
+}
+
+std::chrono::steady_clock::time_point PowerOnIngestor::deadline() const noexcept {
+    return pending.empty() ? std::chrono::steady_clock::time_point::max() : windowStart + window;
+}
+
+PowerOnWindowStats PowerOnIngestor::applyPending() {
+    PowerOnWindowStats stats;
+    for (auto& [key, update] : pending) {
+        if (update.workstation->advancePowerOnTime(update.powerOnTime)) {
+            ++stats.applied;
+        }
+        else {
+            ++stats.stale;
+        }
+    }
+    pending.clear();
+    windowStart = std::chrono::steady_clock::now();
+    return stats;
+}
@@ -0,0 +1,145 @@
+﻿/**
+ * @file PowerOnIngestor.h
+ * @brief Заголовочный файл класса PowerOnIngestor - пакетного приёма телеметрии включения рабочих станций.
+ */
+
+#pragma once
+
+#include "CorporateNetwork.h"
+#include <chrono>
+#include <cstddef>
+#include <ctime>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class Workstation;
+
+/**
+ * @defgroup telemetry_module Модуль приёма телеметрии
+ * @brief Поточное применение событий агентов рабочих станций к сети
+ * @{
+ */
+
+ /**
+  * @brief Событие включения рабочей станции от агента.
+  */
+struct PowerOnEvent {
+    std::string_view workstationId;   ///< Идентификатор рабочей станции (должен жить до возврата submit)
+    time_t powerOnTime = 0;           ///< Время включения
+};
+
+/**
+ * @brief Статистика приёма одного пакета событий.
+ */
+struct PowerOnBatchStats {
+    size_t received = 0;    ///< Событий в пакете
+    size_t unknown = 0;     ///< Идентификатор не найден в сети или принадлежит не рабочей станции
+    size_t coalesced = 0;   ///< Событий, слитых с событием той же станции в текущем окне
+};
+
+/**
+ * @brief Статистика применения одного окна.
+ */
+struct PowerOnWindowStats {
+    size_t applied = 0;     ///< Станций, получивших новое время
+    size_t stale = 0;       ///< Станций, чьё время из окна не новее текущего (обновление отброшено)
+};
+
+/**
+ * @brief Итог submit(): статистика пакета и, отдельно, окна, если пакет его закрыл.
+ */
+struct PowerOnSubmitResult {
+    PowerOnBatchStats batch;                        ///< Статистика принятого пакета
+    std::optional<PowerOnWindowStats> closedWindow; ///< Статистика окна, закрытого этим вызовом
+};
+
+/**
+ * @brief Приёмник телеметрии включения рабочих станций с объединением событий в окне.
+ *
+ * submit() находит идентификаторы пакета в индексе сети за одну эпоху чтения,
+ * без блокировки писателей, и копит для каждой станции наибольшее время включения.
+ * Когда с начала окна проходит window, накопленное применяется через
+ * Workstation::advancePowerOnTime - по одному вызову на станцию, а не на событие.
+ * Это атомарный максимум, поэтому запоздавшие события агентов не откатывают
+ * время назад даже при одновременных обновлениях станции из других потоков.
+ *
+ * Приёмник не заводит таймеров: окно закрывается только вызовом submit(),
+ * flushIfDue() или flush(). Поток приёма, у которого может не быть новых
+ * пакетов, должен периодически вызывать flushIfDue() (не реже deadline()),
+ * иначе накопленное ждёт следующего пакета.
+ *
+ * Экземпляр не потокобезопасен: каждому потоку приёма нужен собственный.
+ * Деструктор не применяет накопленное - перед ним вызывается flush().
+ */
+class PowerOnIngestor {
+private:
+    /**
+     * @brief Накопленное обновление станции.
+     */
+    struct Pending {
+        std::shared_ptr<Workstation> workstation;   ///< Станция (удерживается до сброса окна)
+        time_t powerOnTime;                         ///< Наибольшее время включения в окне
+    };
+
+    CorporateNetwork& network;                              ///< Сеть, к которой применяются события
+    std::chrono::steady_clock::duration window;             ///< Длительность окна объединения
+    std::chrono::steady_clock::time_point windowStart;      ///< Начало текущего окна
+    std::unordered_map<const Workstation*, Pending> pending; ///< Обновления текущего окна
+    std::vector<std::string_view> ids;                      ///< Идентификаторы пакета (переиспользуемый буфер)
+
+    /**
+     * @brief Применяет накопленные обновления и открывает новое окно.
+     * @return Статистика применённого окна.
+     */
+    PowerOnWindowStats applyPending();
+
+public:
+    static constexpr std::chrono::milliseconds DEFAULT_WINDOW{ 100 };   ///< Окно объединения по умолчанию
+
+    /**
+     * @brief Создаёт приёмник для сети.
+     * @param[in] network Сеть; должна пережить приёмник.
+     * @param[in] window Длительность окна объединения; ноль - применять каждый пакет сразу.
+     */
+    explicit PowerOnIngestor(CorporateNetwork& network, std::chrono::milliseconds window = DEFAULT_WINDOW);
+
+    PowerOnIngestor(const PowerOnIngestor&) = delete;
+    PowerOnIngestor& operator=(const PowerOnIngestor&) = delete;
+
+    /**
+     * @brief Принимает пакет событий; по истечении окна применяет накопленное.
+     * @param[in] batch События пакета.
+     * @return Статистика пакета и, если пакет закрыл окно, статистика окна.
+     */
+    PowerOnSubmitResult submit(std::span<const PowerOnEvent> batch);
+
+    /**
+     * @brief Применяет накопленное, если окно истекло.
+     * @return Статистика окна или std::nullopt, если окно ещё открыто или пусто.
+     */
+    std::optional<PowerOnWindowStats> flushIfDue();
+
+    /**
+     * @brief Немедленно применяет накопленные обновления.
+     * @return Статистика окна.
+     */
+    PowerOnWindowStats flush();
+
+    /**
+     * @brief Возвращает момент, после которого текущее окно следует закрыть.
+     * @return Конец окна или time_point::max(), если ожидающих обновлений нет.
+     */
+    std::chrono::steady_clock::time_point deadline() const noexcept;
+
+    /**
+     * @brief Возвращает число станций, ожидающих применения.
+     * @return Число станций в текущем окне.
+     */
+    size_t pendingCount() const noexcept { return pending.size(); }
+};
+
+/** @} */ // Конец группы telemetry_module
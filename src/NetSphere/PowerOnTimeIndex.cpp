@@ -0,0 +1,47 @@
+﻿/**
+ * @file PowerOnTimeIndex.cpp
+ * @brief Реализация упорядоченного индекса рабочих станций по времени включения.
+ */
+
+#include "PowerOnTimeIndex.h"
+#include "Workstation.h"
+
+void PowerOnTimeIndex::add(Workstation& workstation) {
+    std::lock_guard lock(mutex);
+    const time_t powerOnTime = workstation.getLastPowerOnTime();
+    if (indexedTimes.try_emplace(&workstation, powerOnTime).second) {
+        byTime.emplace(powerOnTime, &workstation);
+    }
+}
+
+void PowerOnTimeIndex::remove(const Workstation& workstation) {
+    std::lock_guard lock(mutex);
+    auto it = indexedTimes.find(&workstation);
+    if (it == indexedTimes.end()) {
+        return;
+    }
+    byTime.erase(Key(it->second, const_cast<Workstation*>(&workstation)));
+    indexedTimes.erase(it);
+}
+
+size_t PowerOnTimeIndex::size() const {
+    std::lock_guard lock(mutex);
+    return byTime.size();
+}
+
+void PowerOnTimeIndex::onPowerOnTimeChanged(const Workstation& workstation, [[maybe_unused]] time_t previousTime) {
+    std::lock_guard lock(mutex);
+    auto it = indexedTimes.find(&workstation);
+    if (it == indexedTimes.end()) {
+        return;
+    }
+    // Время читается под мьютексом: последнее уведомление всегда видит последнее значение
+    const time_t powerOnTime = workstation.getLastPowerOnTime();
+    if (it->second == powerOnTime) {
+        return;
+    }
+    auto node = byTime.extract(Key(it->second, const_cast<Workstation*>(&workstation)));
+    node.value().first = powerOnTime;
+    byTime.insert(std::move(node));
+    it->second = powerOnTime;
+}
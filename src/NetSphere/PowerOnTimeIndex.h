@@ -0,0 +1,84 @@
+﻿/**
+ * @file PowerOnTimeIndex.h
+ * @brief Заголовочный файл класса PowerOnTimeIndex - упорядоченного индекса рабочих станций по времени включения.
+ */
+
+#pragma once
+
+#include "NetworkObserver.h"
+#include <ctime>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @addtogroup workstation_module
+ * @{
+ */
+
+ /**
+  * @brief Упорядоченный индекс присоединённых рабочих станций по времени последнего включения.
+  *
+  * Сеть добавляет станции при присоединении и убирает при отсоединении, а новое время
+  * включения индекс получает как NetworkObserver из Workstation::updatePowerOnTime.
+  * Запрос диапазона стоит O(log n + k). Ключ станции запоминается отдельно, поэтому
+  * переиндексация не зависит от previousTime события и переживает гонку обновлений.
+  *
+  * Индекс защищён собственным мьютексом: время включения меняется без блокировки
+  * писателей сети.
+  */
+class PowerOnTimeIndex : public NetworkObserver {
+private:
+    using Key = std::pair<time_t, Workstation*>;
+
+    mutable std::mutex mutex;                                  ///< Защищает byTime и indexedTimes
+    std::set<Key> byTime;                                      ///< Станции в порядке времени включения
+    std::unordered_map<const Workstation*, time_t> indexedTimes; ///< Время, под которым станция лежит в byTime
+
+public:
+    PowerOnTimeIndex() = default;
+    PowerOnTimeIndex(const PowerOnTimeIndex&) = delete;
+    PowerOnTimeIndex& operator=(const PowerOnTimeIndex&) = delete;
+
+    /**
+     * @brief Добавляет присоединённую станцию.
+     * @param[in] workstation Рабочая станция.
+     */
+    void add(Workstation& workstation);
+
+    /**
+     * @brief Убирает отсоединённую станцию.
+     * @param[in] workstation Рабочая станция.
+     */
+    void remove(const Workstation& workstation);
+
+    /**
+     * @brief Обходит станции, включавшиеся в полуинтервале [from, to), по возрастанию времени.
+     * @tparam Visitor Вызываемый объект вида void(Workstation&).
+     * @param[in] from Нижняя граница (включительно).
+     * @param[in] to Верхняя граница (не включительно).
+     * @param[in] visitor Вызывается под мьютексом индекса и не должен менять время включения.
+     */
+    template<typename Visitor>
+    void visitRange(time_t from, time_t to, Visitor&& visitor) const {
+        if (from >= to) {
+            return;
+        }
+        std::lock_guard lock(mutex);
+        const auto end = byTime.lower_bound(Key(to, nullptr));
+        for (auto it = byTime.lower_bound(Key(from, nullptr)); it != end; ++it) {
+            visitor(*it->second);
+        }
+    }
+
+    /**
+     * @brief Возвращает число станций в индексе.
+     * @return Число станций.
+     */
+    size_t size() const;
+
+    void onPowerOnTimeChanged(const Workstation& workstation, time_t previousTime) override;
+};
+
+/** @} */ // Конец группы workstation_module
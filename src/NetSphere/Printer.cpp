@@ -7,12 +7,20 @@
 #include <iostream>
 
 Printer::Printer(const std::string& id, const std::string& mac)
-    : Device(id, mac) {
+    : Device(id, mac, EntityKind::Printer) {
+}
+
+Printer::Printer(const std::string& id, MacAddress mac)
+    : Device(id, mac, EntityKind::Printer) {
+}
+
+Printer::Printer(Symbol id, MacAddress mac)
+    : Device(id, mac, EntityKind::Printer) {
 }
 
 void Printer::printInfo() const {
     std::cout << "Принтер: " << id << "\n";
-    std::cout << "MAC: " << macAddress << "\n";
+    std::cout << "MAC: " << getMacAddress() << "\n";
 }
 
 std::string Printer::getType() const {
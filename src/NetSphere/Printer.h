@@ -25,6 +25,27 @@ public:
      */
     Printer(const std::string& id, const std::string& mac);
 
+    /**
+     * @brief Конструктор принтера с уже разобранным MAC-адресом.
+     * @param[in] id Уникальный строковый идентификатор принтера.
+     * @param[in] mac MAC-адрес принтера.
+     */
+    Printer(const std::string& id, MacAddress mac);
+
+    /**
+     * @brief Конструктор принтера с уже интернированным идентификатором.
+     * @param[in] id Символ идентификатора принтера.
+     * @param[in] mac MAC-адрес принтера.
+     */
+    Printer(Symbol id, MacAddress mac);
+
+    /**
+     * @brief Проверяет, соответствует ли вид сущности принтеру.
+     * @param[in] kind Проверяемый вид.
+     * @return true для EntityKind::Printer.
+     */
+    static constexpr bool isKindOf(EntityKind kind) noexcept { return kind == EntityKind::Printer; }
+
     void printInfo() const override;
     std::string getType() const override;
 };
@@ -0,0 +1,59 @@
+﻿/**
+ * @file StorageAccessIndex.cpp
+ * @brief Реализация обратного индекса доступа пользователей к хранилищам.
+ */
+
+#include "StorageAccessIndex.h"
+#include "DataStorage.h"
+#include <algorithm>
+
+void StorageAccessIndex::addLocked(Symbol user, Symbol storage) {
+    storagesByUser[user].push_back(storage);
+}
+
+void StorageAccessIndex::removeLocked(Symbol user, Symbol storage) {
+    auto it = storagesByUser.find(user);
+    if (it == storagesByUser.end()) {
+        return;
+    }
+    auto& storages = it->second;
+    auto position = std::find(storages.begin(), storages.end(), storage);
+    if (position != storages.end()) {
+        *position = storages.back();
+        storages.pop_back();
+    }
+    if (storages.empty()) {
+        storagesByUser.erase(it);
+    }
+}
+
+void StorageAccessIndex::addStorage(const DataStorage& storage) {
+    std::lock_guard lock(mutex);
+    storage.forEachTrustedUser([&](Symbol user) { addLocked(user, storage.getIdSymbol()); });
+}
+
+void StorageAccessIndex::removeStorage(const DataStorage& storage) {
+    std::lock_guard lock(mutex);
+    storage.forEachTrustedUser([&](Symbol user) { removeLocked(user, storage.getIdSymbol()); });
+}
+
+std::vector<Symbol> StorageAccessIndex::storagesFor(Symbol user) const {
+    std::lock_guard lock(mutex);
+    auto it = storagesByUser.find(user);
+    return it == storagesByUser.end() ? std::vector<Symbol>{} : it->second;
+}
+
+size_t StorageAccessIndex::userCount() const {
+    std::lock_guard lock(mutex);
+    return storagesByUser.size();
+}
+
+void StorageAccessIndex::onTrustedUserAdded(const DataStorage& storage, Symbol user) {
+    std::lock_guard lock(mutex);
+    addLocked(user, storage.getIdSymbol());
+}
+
+void StorageAccessIndex::onTrustedUserRemoved(const DataStorage& storage, Symbol user) {
+    std::lock_guard lock(mutex);
+    removeLocked(user, storage.getIdSymbol());
+}
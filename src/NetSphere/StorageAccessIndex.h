@@ -0,0 +1,72 @@
+﻿/**
+ * @file StorageAccessIndex.h
+ * @brief Заголовочный файл класса StorageAccessIndex - обратного индекса доступа пользователей к хранилищам.
+ */
+
+#pragma once
+
+#include "NetworkObserver.h"
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @addtogroup storage_module
+ * @{
+ */
+
+ /**
+  * @brief Обратный индекс "пользователь -> хранилища, где он доверенный" по всей сети.
+  *
+  * Сеть добавляет в индекс хранилища при присоединении и убирает при отсоединении,
+  * а изменения списков доверенных пользователей индекс получает как NetworkObserver.
+  * Поэтому ответ на вопрос "к каким хранилищам есть доступ у пользователя" стоит
+  * O(числа таких хранилищ), без обхода сети. Хранилища представлены символами
+  * идентификаторов и в пределах одного пользователя не упорядочены.
+  *
+  * Индекс защищён собственным мьютексом: списки доверенных пользователей меняются
+  * без блокировки писателей сети.
+  */
+class StorageAccessIndex : public NetworkObserver {
+private:
+    mutable std::mutex mutex;                                        ///< Защищает storagesByUser
+    std::unordered_map<Symbol, std::vector<Symbol>> storagesByUser;  ///< Хранилища каждого пользователя
+
+    void addLocked(Symbol user, Symbol storage);
+    void removeLocked(Symbol user, Symbol storage);
+
+public:
+    StorageAccessIndex() = default;
+    StorageAccessIndex(const StorageAccessIndex&) = delete;
+    StorageAccessIndex& operator=(const StorageAccessIndex&) = delete;
+
+    /**
+     * @brief Учитывает всех доверенных пользователей присоединённого хранилища.
+     * @param[in] storage Хранилище.
+     */
+    void addStorage(const DataStorage& storage);
+
+    /**
+     * @brief Убирает из индекса всех доверенных пользователей отсоединённого хранилища.
+     * @param[in] storage Хранилище.
+     */
+    void removeStorage(const DataStorage& storage);
+
+    /**
+     * @brief Возвращает хранилища, в которых пользователь доверенный.
+     * @param[in] user Символ пользователя.
+     * @return Идентификаторы хранилищ.
+     */
+    std::vector<Symbol> storagesFor(Symbol user) const;
+
+    /**
+     * @brief Возвращает число пользователей, имеющих доступ хотя бы к одному хранилищу.
+     * @return Число пользователей в индексе.
+     */
+    size_t userCount() const;
+
+    void onTrustedUserAdded(const DataStorage& storage, Symbol user) override;
+    void onTrustedUserRemoved(const DataStorage& storage, Symbol user) override;
+};
+
+/** @} */ // Конец группы storage_module
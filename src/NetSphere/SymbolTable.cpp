@@ -0,0 +1,152 @@
+﻿/**
+ * @file SymbolTable.cpp
+ * @brief Реализация глобального пула интернированных строк.
+ */
+
+#include "SymbolTable.h"
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+SymbolTable::SymbolTable()
+    : chunks(new std::atomic<Entry*>[MAX_CHUNKS]) {
+    for (uint32_t i = 0; i < MAX_CHUNKS; ++i) {
+        chunks[i].store(nullptr, std::memory_order_relaxed);
+    }
+    // Символ с индексом 0 всегда соответствует пустой строке
+    chunks[0].store(new Entry[CHUNK_SIZE], std::memory_order_release);
+    indexByText.emplace(std::string_view(), 0);
+    count = 1;
+    live = 1;
+}
+
+SymbolTable::~SymbolTable() {
+    for (uint32_t i = 0; i < MAX_CHUNKS; ++i) {
+        delete[] chunks[i].load(std::memory_order_relaxed);
+    }
+}
+
+SymbolTable& SymbolTable::instance() {
+    // Пул намеренно не разрушается: строки должны пережить все статические объекты
+    static SymbolTable* table = new SymbolTable();
+    return *table;
+}
+
+DeviceIdStatus SymbolTable::classifyDeviceId(std::string_view text) noexcept {
+    if (text.empty()) {
+        return DeviceIdStatus::Empty;
+    }
+    if (text.length() > 50) {
+        return DeviceIdStatus::TooLong;
+    }
+    for (char c : text) {
+        const bool allowed = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+            (c >= '0' && c <= '9') || c == '_' || c == '-';
+        if (!allowed) {
+            return DeviceIdStatus::InvalidChars;
+        }
+    }
+    return DeviceIdStatus::Valid;
+}
+
+Symbol SymbolTable::intern(std::string_view text) {
+    {
+        std::shared_lock lock(mutex);
+        auto it = indexByText.find(text);
+        if (it != indexByText.end()) {
+            return acquire(it->second);
+        }
+    }
+
+    std::unique_lock lock(mutex);
+    return internLocked(text);
+}
+
+void SymbolTable::internAll(std::span<const std::string_view> texts, std::span<Symbol> symbols) {
+    // Прежние значения освобождаются до взятия блокировки: снятие последней ссылки само берёт её
+    std::fill(symbols.begin(), symbols.begin() + texts.size(), Symbol());
+    std::vector<size_t> missing;
+    {
+        std::shared_lock lock(mutex);
+        for (size_t i = 0; i < texts.size(); ++i) {
+            auto it = indexByText.find(texts[i]);
+            if (it != indexByText.end()) {
+                symbols[i] = acquire(it->second);
+            }
+            else {
+                missing.push_back(i);
+            }
+        }
+    }
+    if (missing.empty()) {
+        return;
+    }
+
+    std::unique_lock lock(mutex);
+    for (size_t i : missing) {
+        symbols[i] = internLocked(texts[i]);
+    }
+}
+
+Symbol SymbolTable::internLocked(std::string_view text) {
+    auto it = indexByText.find(text);
+    if (it != indexByText.end()) {
+        return acquire(it->second);
+    }
+
+    uint32_t index = freeHead;
+    if (index == 0) {
+        index = count;
+        const uint32_t chunkIndex = index >> CHUNK_BITS;
+        if (chunkIndex >= MAX_CHUNKS) {
+            throw std::length_error("Исчерпана ёмкость пула интернированных строк");
+        }
+        if (!chunks[chunkIndex].load(std::memory_order_relaxed)) {
+            chunks[chunkIndex].store(new Entry[CHUNK_SIZE], std::memory_order_release);
+        }
+    }
+
+    Entry& slot = entry(index);
+    slot.text.assign(text);
+    slot.idStatus = classifyDeviceId(text);
+    indexByText.emplace(slot.text, index);
+
+    // Индекс считается занятым, только когда строка уже в indexByText
+    if (index == freeHead) {
+        freeHead = slot.nextFree;
+        slot.nextFree = 0;
+    }
+    else {
+        ++count;
+    }
+    ++live;
+    return acquire(index);
+}
+
+void SymbolTable::releaseLast(uint32_t index) noexcept {
+    std::unique_lock lock(mutex);
+    Entry& slot = entry(index);
+    // Пока ждали блокировку, символ могли скопировать: тогда строка остаётся
+    if (slot.references.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+    indexByText.erase(slot.text);
+    std::string().swap(slot.text);
+    slot.nextFree = freeHead;
+    freeHead = index;
+    --live;
+}
+
+std::optional<Symbol> SymbolTable::lookup(std::string_view text) const {
+    std::shared_lock lock(mutex);
+    auto it = indexByText.find(text);
+    if (it == indexByText.end()) {
+        return std::nullopt;
+    }
+    return acquire(it->second);
+}
+
+size_t SymbolTable::size() const {
+    std::shared_lock lock(mutex);
+    return live;
+}
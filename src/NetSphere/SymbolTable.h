@@ -0,0 +1,307 @@
+﻿/**
+ * @file SymbolTable.h
+ * @brief Заголовочный файл глобального пула интернированных строк (символов).
+ */
+
+#pragma once
+
+#include <atomic>
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+ /**
+  * @defgroup symbol_module Модуль интернирования строк
+  * @brief Компактные дескрипторы для повторяющихся идентификаторов сущностей и пользователей
+  * @{
+  */
+
+  /**
+   * @brief Результат проверки строки как идентификатора устройства.
+   * @details Вычисляется один раз при интернировании строки.
+   */
+enum class DeviceIdStatus : uint8_t {
+    Valid,          ///< Идентификатор допустим
+    Empty,          ///< Пустая строка
+    TooLong,        ///< Длиннее 50 символов
+    InvalidChars    ///< Содержит символы помимо [a-zA-Z0-9_-]
+};
+
+/**
+ * @brief Компактный дескриптор интернированной строки.
+ *
+ * Две строки с одинаковым содержимым всегда получают один и тот же символ,
+ * поэтому сравнение символов сводится к сравнению целых чисел. Символ владеет
+ * ссылкой на строку пула: копирование атомарно увеличивает счётчик ссылок,
+ * а когда уничтожается последний символ строки, она удаляется из пула и её
+ * индекс используется повторно. Ссылки и std::string_view на текст символа
+ * остаются валидными, пока жив хотя бы один символ этой строки.
+ */
+class Symbol {
+private:
+    uint32_t index = 0;   ///< Индекс строки в пуле (0 - пустая строка)
+
+    /**
+     * @brief Принимает уже учтённую в счётчике ссылку на строку пула.
+     */
+    explicit Symbol(uint32_t idx) noexcept : index(idx) {}
+
+    void retain() const noexcept;
+    void release() noexcept;
+
+    friend class SymbolTable;
+
+public:
+    /**
+     * @brief Создаёт символ пустой строки.
+     */
+    Symbol() noexcept = default;
+
+    Symbol(const Symbol& other) noexcept : index(other.index) { retain(); }
+    Symbol(Symbol&& other) noexcept : index(other.index) { other.index = 0; }
+
+    Symbol& operator=(const Symbol& other) noexcept {
+        Symbol copy(other);
+        std::swap(index, copy.index);
+        return *this;
+    }
+
+    Symbol& operator=(Symbol&& other) noexcept {
+        std::swap(index, other.index);
+        return *this;
+    }
+
+    ~Symbol() { release(); }
+
+    /**
+     * @brief Интернирует строку, добавляя её в пул при первом обращении.
+     * @param[in] text Текст для интернирования.
+     * @return Символ, соответствующий тексту.
+     */
+    static Symbol intern(std::string_view text);
+
+    /**
+     * @brief Интернирует набор строк за одно взятие блокировки записи.
+     * @param[in] texts Тексты для интернирования.
+     * @param[out] symbols Символы в порядке texts (размер не меньше texts.size()).
+     */
+    static void internAll(std::span<const std::string_view> texts, std::span<Symbol> symbols);
+
+    /**
+     * @brief Ищет уже интернированную строку, не добавляя её в пул.
+     * @param[in] text Искомый текст.
+     * @return Символ или std::nullopt, если строка ещё не встречалась.
+     */
+    static std::optional<Symbol> lookup(std::string_view text);
+
+    /**
+     * @brief Возвращает текст символа.
+     * @return Константная ссылка на строку из пула.
+     */
+    const std::string& str() const noexcept;
+
+    /**
+     * @brief Возвращает текст символа в виде std::string_view.
+     * @return Представление строки из пула.
+     */
+    std::string_view view() const noexcept { return str(); }
+
+    /**
+     * @brief Возвращает закешированный результат проверки текста как идентификатора устройства.
+     * @return Статус проверки, вычисленный при интернировании.
+     */
+    DeviceIdStatus deviceIdStatus() const noexcept;
+
+    /**
+     * @brief Проверяет, является ли символ пустой строкой.
+     * @return true для пустой строки.
+     */
+    bool empty() const noexcept { return index == 0; }
+
+    /**
+     * @brief Возвращает числовое значение дескриптора.
+     * @return Индекс строки в пуле.
+     */
+    uint32_t value() const noexcept { return index; }
+
+    bool operator==(const Symbol& other) const noexcept { return index == other.index; }
+    auto operator<=>(const Symbol& other) const noexcept { return index <=> other.index; }
+
+    friend bool operator==(const Symbol& symbol, std::string_view text) noexcept {
+        return symbol.view() == text;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const Symbol& symbol) {
+        return os << symbol.str();
+    }
+};
+
+/**
+ * @brief Специализация std::hash для Symbol.
+ */
+template<>
+struct std::hash<Symbol> {
+    size_t operator()(const Symbol& symbol) const noexcept {
+        return std::hash<uint32_t>{}(symbol.value());
+    }
+};
+
+/**
+ * @brief Глобальный потокобезопасный пул интернированных строк.
+ *
+ * Строки хранятся в блоках фиксированного размера, которые никогда не перемещаются,
+ * поэтому получение текста по символу выполняется без блокировок. Добавление
+ * новых строк защищено мьютексом.
+ *
+ * У каждой строки есть счётчик ссылок. Пока ссылок больше одной, символ
+ * освобождается одним CAS; последняя ссылка снимается под блокировкой записи,
+ * чтобы intern() и lookup() не могли одновременно найти удаляемую строку.
+ * Освобождённые индексы образуют список и выдаются новым строкам.
+ */
+class SymbolTable {
+private:
+    struct Entry {
+        std::string text;                                   ///< Текст строки
+        DeviceIdStatus idStatus = DeviceIdStatus::Empty;    ///< Результат проверки как идентификатора устройства
+        std::atomic<uint32_t> references{ 0 };              ///< Число живых символов строки
+        uint32_t nextFree = 0;                              ///< Следующий свободный индекс (0 - конец списка)
+    };
+
+    static constexpr uint32_t CHUNK_BITS = 12;
+    static constexpr uint32_t CHUNK_SIZE = 1u << CHUNK_BITS;   ///< Число строк в одном блоке
+    static constexpr uint32_t MAX_CHUNKS = 1u << 14;           ///< Максимум 64M различных строк
+
+    std::unique_ptr<std::atomic<Entry*>[]> chunks;              ///< Блоки строк
+    std::unordered_map<std::string_view, uint32_t> indexByText; ///< Поиск символа по тексту
+    uint32_t count = 0;                                         ///< Число когда-либо выданных индексов
+    uint32_t live = 0;                                          ///< Число строк с живыми символами
+    uint32_t freeHead = 0;                                      ///< Первый освобождённый индекс (0 - нет)
+    mutable std::shared_mutex mutex;                            ///< Защищает indexByText, count и список свободных индексов
+
+    SymbolTable();
+
+    static DeviceIdStatus classifyDeviceId(std::string_view text) noexcept;
+
+    /**
+     * @brief Интернирует строку под уже взятой блокировкой записи.
+     */
+    Symbol internLocked(std::string_view text);
+
+    /**
+     * @brief Выдаёт новую ссылку на строку, найденную под блокировкой.
+     */
+    Symbol acquire(uint32_t index) const noexcept {
+        entry(index).references.fetch_add(1, std::memory_order_relaxed);
+        return Symbol(index);
+    }
+
+    /**
+     * @brief Снимает ссылку; последнюю - под блокировкой записи с удалением строки.
+     */
+    void release(uint32_t index) noexcept {
+        std::atomic<uint32_t>& references = entry(index).references;
+        uint32_t current = references.load(std::memory_order_relaxed);
+        while (current > 1) {
+            if (references.compare_exchange_weak(current, current - 1,
+                std::memory_order_release, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+        releaseLast(index);
+    }
+
+    void releaseLast(uint32_t index) noexcept;
+
+    Entry& entry(uint32_t index) const noexcept {
+        return chunks[index >> CHUNK_BITS].load(std::memory_order_acquire)[index & (CHUNK_SIZE - 1)];
+    }
+
+    friend class Symbol;
+
+public:
+    ~SymbolTable();
+
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    /**
+     * @brief Возвращает единственный экземпляр пула.
+     * @return Ссылка на глобальный пул строк.
+     */
+    static SymbolTable& instance();
+
+    /**
+     * @brief Интернирует строку.
+     * @param[in] text Текст для интернирования.
+     * @return Символ, соответствующий тексту.
+     * @throw std::length_error Если исчерпана ёмкость пула.
+     */
+    Symbol intern(std::string_view text);
+
+    /**
+     * @brief Интернирует набор строк.
+     * @param[in] texts Тексты для интернирования.
+     * @param[out] symbols Символы в порядке texts.
+     * @throw std::length_error Если исчерпана ёмкость пула.
+     * @details Уже известные строки находятся под блокировкой чтения; блокировка
+     * записи берётся не более одного раза на весь набор.
+     */
+    void internAll(std::span<const std::string_view> texts, std::span<Symbol> symbols);
+
+    /**
+     * @brief Ищет строку в пуле без добавления.
+     * @param[in] text Искомый текст.
+     * @return Символ или std::nullopt.
+     */
+    std::optional<Symbol> lookup(std::string_view text) const;
+
+    /**
+     * @brief Возвращает количество различных строк в пуле.
+     * @return Число строк, на которые есть живые символы (включая пустую).
+     */
+    size_t size() const;
+};
+
+inline Symbol Symbol::intern(std::string_view text) {
+    return SymbolTable::instance().intern(text);
+}
+
+inline void Symbol::internAll(std::span<const std::string_view> texts, std::span<Symbol> symbols) {
+    SymbolTable::instance().internAll(texts, symbols);
+}
+
+inline std::optional<Symbol> Symbol::lookup(std::string_view text) {
+    return SymbolTable::instance().lookup(text);
+}
+
+inline void Symbol::retain() const noexcept {
+    if (index != 0) {
+        SymbolTable::instance().entry(index).references.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+inline void Symbol::release() noexcept {
+    if (index != 0) {
+        SymbolTable::instance().release(index);
+        index = 0;
+    }
+}
+
+inline const std::string& Symbol::str() const noexcept {
+    return SymbolTable::instance().entry(index).text;
+}
+
+inline DeviceIdStatus Symbol::deviceIdStatus() const noexcept {
+    return SymbolTable::instance().entry(index).idStatus;
+}
+
+/** @} */ // Конец группы symbol_module
@@ -0,0 +1,100 @@
+﻿/**
+ * @file TrustedUserSet.cpp
+ * @brief Реализация множества доверенных пользователей хранилища.
+ */
+
+#include "TrustedUserSet.h"
+#include <algorithm>
+
+bool TrustedUserSet::contains(Symbol user) const noexcept {
+    if (useHash) {
+        return positions.find(user) != positions.end();
+    }
+    return std::binary_search(sorted.begin(), sorted.end(), user);
+}
+
+bool TrustedUserSet::insert(Symbol user) {
+    if (useHash) {
+        if (!positions.try_emplace(user, ordered.size()).second) {
+            return false;
+        }
+        ordered.push_back(user);
+        ++count;
+        return true;
+    }
+
+    auto position = std::lower_bound(sorted.begin(), sorted.end(), user);
+    if (position != sorted.end() && *position == user) {
+        return false;
+    }
+    ordered.push_back(user);
+    ++count;
+    if (count > HASH_THRESHOLD) {
+        positions.reserve(count * 2);
+        for (size_t i = 0; i < ordered.size(); ++i) {
+            positions.emplace(ordered[i], i);
+        }
+        sorted.clear();
+        sorted.shrink_to_fit();
+        useHash = true;
+    }
+    else {
+        sorted.insert(position, user);
+    }
+    return true;
+}
+
+bool TrustedUserSet::erase(Symbol user) {
+    if (!useHash) {
+        auto position = std::lower_bound(sorted.begin(), sorted.end(), user);
+        if (position == sorted.end() || *position != user) {
+            return false;
+        }
+        // Малое представление не содержит пустых позиций и ограничено HASH_THRESHOLD
+        sorted.erase(position);
+        ordered.erase(std::find(ordered.begin(), ordered.end(), user));
+        --count;
+        return true;
+    }
+
+    auto it = positions.find(user);
+    if (it == positions.end()) {
+        return false;
+    }
+    ordered[it->second] = Symbol();
+    positions.erase(it);
+    --count;
+
+    if (count <= HASH_THRESHOLD / 2) {
+        compact();
+        sorted.assign(ordered.begin(), ordered.end());
+        std::sort(sorted.begin(), sorted.end());
+        positions = {};
+        useHash = false;
+    }
+    else if (ordered.size() > 2 * count) {
+        compact();
+    }
+    return true;
+}
+
+void TrustedUserSet::compact() {
+    size_t next = 0;
+    for (Symbol user : ordered) {
+        if (user.empty()) {
+            continue;
+        }
+        if (useHash) {
+            positions[user] = next;
+        }
+        ordered[next++] = user;
+    }
+    ordered.resize(next);
+}
+
+std::vector<Symbol> TrustedUserSet::inInsertionOrder() const {
+    std::vector<Symbol> users;
+    users.reserve(count);
+    forEachInOrder([&](Symbol user) { users.push_back(user); });
+    return users;
+}
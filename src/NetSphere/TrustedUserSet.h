@@ -0,0 +1,100 @@
+﻿/**
+ * @file TrustedUserSet.h
+ * @brief Заголовочный файл класса TrustedUserSet - множества доверенных пользователей хранилища.
+ */
+
+#pragma once
+
+#include "SymbolTable.h"
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @addtogroup storage_module
+ * @{
+ */
+
+ /**
+  * @brief Множество доверенных пользователей, меняющее представление с ростом.
+  *
+  * Порядок добавления сохраняется (его видят getTrustedUsers, журнал и снимки).
+  * Для проверки принадлежности небольшое множество держит отсортированную копию
+  * символов и ищет двоичным поиском; после HASH_THRESHOLD элементов копия
+  * заменяется хэш-таблицей позиций в векторе порядка. Удаление из большого
+  * множества занимает O(1): позиция помечается пустым символом, а вектор
+  * уплотняется, когда пустых позиций становится больше живых (амортизированно O(1)).
+  * Обратно к отсортированной копии множество переходит, когда уменьшится вдвое,
+  * чтобы чередование вставок и удалений на границе не перестраивало представление
+  * каждый раз; работа малого представления ограничена HASH_THRESHOLD элементами.
+  */
+class TrustedUserSet {
+private:
+    std::vector<Symbol> ordered;                    ///< Порядок добавления; удалённые - пустые символы
+    std::vector<Symbol> sorted;                     ///< Отсортированная копия (пока множество мало)
+    std::unordered_map<Symbol, size_t> positions;   ///< Позиции в ordered (после роста)
+    size_t count = 0;                               ///< Число пользователей
+    bool useHash = false;                           ///< Текущее представление для поиска
+
+    /**
+     * @brief Удаляет пустые позиции из ordered и обновляет positions.
+     */
+    void compact();
+
+public:
+    static constexpr size_t HASH_THRESHOLD = 32; ///< Размер, после которого используется хэш-множество
+
+    /**
+     * @brief Проверяет, входит ли пользователь в множество.
+     * @param[in] user Символ пользователя.
+     * @return true если пользователь доверенный.
+     */
+    bool contains(Symbol user) const noexcept;
+
+    /**
+     * @brief Добавляет пользователя.
+     * @param[in] user Символ пользователя.
+     * @return false если пользователь уже был в множестве.
+     */
+    bool insert(Symbol user);
+
+    /**
+     * @brief Удаляет пользователя, сохраняя порядок остальных.
+     * @param[in] user Символ пользователя.
+     * @return false если пользователя не было в множестве.
+     * @details Амортизированно O(1) при любом размере множества.
+     */
+    bool erase(Symbol user);
+
+    /**
+     * @brief Возвращает число пользователей.
+     * @return Размер множества.
+     */
+    size_t size() const noexcept { return count; }
+
+    /**
+     * @brief Проверяет, используется ли хэш-множество.
+     * @return true для большого множества.
+     */
+    bool isHashed() const noexcept { return useHash; }
+
+    /**
+     * @brief Обходит пользователей в порядке добавления.
+     * @param[in] visitor Вызывается для каждого символа пользователя.
+     */
+    template <typename Visitor>
+    void forEachInOrder(Visitor&& visitor) const {
+        for (Symbol user : ordered) {
+            if (!user.empty()) {
+                visitor(user);
+            }
+        }
+    }
+
+    /**
+     * @brief Возвращает пользователей в порядке добавления.
+     * @return Копия списка символов без удалённых позиций.
+     */
+    std::vector<Symbol> inInsertionOrder() const;
+};
+
+/** @} */ // Конец группы storage_module
@@ -13,29 +13,60 @@
 
 Workstation::Workstation(const std::string& id, const std::string& mac,
     const std::string& user, time_t powerOnTime)
-    : Device(id, mac), userId(user), lastPowerOnTime(powerOnTime) {
+    : Device(id, mac, EntityKind::Workstation), lastPowerOnTime(powerOnTime) {
     validateUserId(user);
+    userId = Symbol::intern(user);
+}
+
+Workstation::Workstation(const std::string& id, MacAddress mac,
+    const std::string& user, time_t powerOnTime)
+    : Device(id, mac, EntityKind::Workstation), lastPowerOnTime(powerOnTime) {
+    validateUserId(user);
+    userId = Symbol::intern(user);
+}
+
+Workstation::Workstation(Symbol id, MacAddress mac, Symbol user, time_t powerOnTime)
+    : Device(id, mac, EntityKind::Workstation), userId(user), lastPowerOnTime(powerOnTime) {
+    validateUserId(user.str());
 }
 
 const std::string& Workstation::getUserId() const {
+    return userId.str();
+}
+
+const Symbol& Workstation::getUserSymbol() const noexcept {
     return userId;
 }
 
 time_t Workstation::getLastPowerOnTime() const {
-    return lastPowerOnTime;
+    return lastPowerOnTime.load(std::memory_order_acquire);
 }
 
 void Workstation::updatePowerOnTime(time_t newTime) {
-    lastPowerOnTime = newTime;
+    const time_t previousTime = lastPowerOnTime.exchange(newTime, std::memory_order_acq_rel);
+    notifyObserver([&](NetworkObserver& observer) { observer.onPowerOnTimeChanged(*this, previousTime); });
+}
+
+bool Workstation::advancePowerOnTime(time_t newTime) {
+    time_t previousTime = lastPowerOnTime.load(std::memory_order_acquire);
+    do {
+        if (newTime <= previousTime) {
+            return false;
+        }
+    } while (!lastPowerOnTime.compare_exchange_weak(previousTime, newTime,
+        std::memory_order_acq_rel, std::memory_order_acquire));
+    notifyObserver([&](NetworkObserver& observer) { observer.onPowerOnTimeChanged(*this, previousTime); });
+    return true;
 }
 
 void Workstation::printInfo() const {
     std::cout << "Рабочая станция: " << id << "\n";
-    std::cout << "MAC: " << macAddress << "\n";
+    std::cout << "MAC: " << getMacAddress() << "\n";
     std::cout << "Пользователь: " << userId << "\n";
 
     // Конвертируем время в читаемый формат
-    std::tm* timeinfo = std::localtime(&lastPowerOnTime);
+    const time_t powerOnTime = getLastPowerOnTime();
+    std::tm* timeinfo = std::localtime(&powerOnTime);
     std::cout << "Последнее включение: " << std::put_time(timeinfo, "%Y-%m-%d %H:%M:%S") << "\n";
 }
 
@@ -6,6 +6,7 @@
 #pragma once
 
 #include "Device.h"
+#include <atomic>
 #include <ctime>
 
  /**
@@ -19,8 +20,8 @@
    */
 class Workstation : public Device {
 private:
-    std::string userId;         ///< Идентификатор пользователя, закрепленного за станцией
-    time_t lastPowerOnTime;     ///< Время последнего включения (в секундах с эпохи Unix)
+    Symbol userId;              ///< Идентификатор пользователя, закрепленного за станцией (интернированная строка)
+    std::atomic<time_t> lastPowerOnTime;    ///< Время последнего включения (в секундах с эпохи Unix); меняется без блокировок сети
 
     /**
      * @brief Проверяет валидность идентификатора пользователя.
@@ -46,12 +47,48 @@ public:
     Workstation(const std::string& id, const std::string& mac,
         const std::string& user, time_t powerOnTime);
 
+    /**
+     * @brief Конструктор рабочей станции с уже разобранным MAC-адресом.
+     * @param[in] id Уникальный строковый идентификатор рабочей станции.
+     * @param[in] mac MAC-адрес рабочей станции.
+     * @param[in] user Идентификатор пользователя.
+     * @param[in] powerOnTime Время последнего включения (в секундах с эпохи Unix).
+     * @throw ValidationException Если идентификатор невалиден.
+     * @throw std::invalid_argument Если идентификатор пользователя пустой.
+     */
+    Workstation(const std::string& id, MacAddress mac,
+        const std::string& user, time_t powerOnTime);
+
+    /**
+     * @brief Конструктор рабочей станции с уже интернированными идентификаторами.
+     * @param[in] id Символ идентификатора рабочей станции.
+     * @param[in] mac MAC-адрес рабочей станции.
+     * @param[in] user Символ идентификатора пользователя.
+     * @param[in] powerOnTime Время последнего включения (в секундах с эпохи Unix).
+     * @throw ValidationException Если идентификатор невалиден.
+     * @throw std::invalid_argument Если идентификатор пользователя пустой.
+     */
+    Workstation(Symbol id, MacAddress mac, Symbol user, time_t powerOnTime);
+
+    /**
+     * @brief Проверяет, соответствует ли вид сущности рабочей станции.
+     * @param[in] kind Проверяемый вид.
+     * @return true для EntityKind::Workstation.
+     */
+    static constexpr bool isKindOf(EntityKind kind) noexcept { return kind == EntityKind::Workstation; }
+
     /**
      * @brief Возвращает идентификатор пользователя.
      * @return Константная ссылка на идентификатор пользователя.
      */
     const std::string& getUserId() const;
 
+    /**
+     * @brief Возвращает идентификатор пользователя в виде интернированного символа.
+     * @return Символ идентификатора пользователя.
+     */
+    const Symbol& getUserSymbol() const noexcept;
+
     /**
      * @brief Возвращает время последнего включения.
      * @return Время последнего включения в секундах с эпохи Unix.
@@ -61,9 +98,21 @@ public:
     /**
      * @brief Обновляет время последнего включения.
      * @param[in] newTime Новое время включения (в секундах с эпохи Unix).
+     * @details Время записывается атомарно до уведомления наблюдателя; индексы
+     * перечитывают его под своей блокировкой, поэтому последнее уведомление
+     * всегда приводит их к последнему значению.
      */
     void updatePowerOnTime(time_t newTime);
 
+    /**
+     * @brief Продвигает время последнего включения вперёд.
+     * @param[in] newTime Время включения (в секундах с эпохи Unix).
+     * @return true если время обновлено; false если текущее время не старше newTime.
+     * @details Атомарный максимум (цикл CAS): одновременные вызовы не откатывают
+     * время назад, а наблюдатель уведомляется только при фактическом изменении.
+     */
+    bool advancePowerOnTime(time_t newTime);
+
     void printInfo() const override;
     std::string getType() const override;
 };
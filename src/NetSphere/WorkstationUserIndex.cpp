@@ -0,0 +1,36 @@
+﻿/**
+ * @file WorkstationUserIndex.cpp
+ * @brief Реализация индекса рабочих станций по пользователям.
+ */
+
+#include "WorkstationUserIndex.h"
+#include "Workstation.h"
+#include <algorithm>
+
+void WorkstationUserIndex::add(Workstation& workstation) {
+    workstationsByUser[workstation.getUserSymbol()].push_back(&workstation);
+}
+
+void WorkstationUserIndex::remove(Workstation& workstation) noexcept {
+    auto it = workstationsByUser.find(workstation.getUserSymbol());
+    if (it == workstationsByUser.end()) {
+        return;
+    }
+    auto& workstations = it->second;
+    auto position = std::find(workstations.begin(), workstations.end(), &workstation);
+    if (position != workstations.end()) {
+        *position = workstations.back();
+        workstations.pop_back();
+    }
+    if (workstations.empty()) {
+        workstationsByUser.erase(it);
+    }
+}
+
+std::span<Workstation* const> WorkstationUserIndex::find(Symbol user) const noexcept {
+    auto it = workstationsByUser.find(user);
+    if (it == workstationsByUser.end()) {
+        return {};
+    }
+    return it->second;
+}
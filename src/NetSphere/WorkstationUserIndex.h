@@ -0,0 +1,59 @@
+﻿/**
+ * @file WorkstationUserIndex.h
+ * @brief Заголовочный файл класса WorkstationUserIndex - индекса рабочих станций по пользователям.
+ */
+
+#pragma once
+
+#include "SymbolTable.h"
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+class Workstation;
+
+/**
+ * @addtogroup workstation_module
+ * @{
+ */
+
+ /**
+  * @brief Индекс "пользователь -> закреплённые за ним рабочие станции" по всей сети.
+  *
+  * Пользователь станции задаётся при создании и не меняется, поэтому индекс
+  * обновляется только при присоединении и отсоединении станций и, как и остальная
+  * структура сети, защищён её блокировкой писателей. Указатели действительны,
+  * пока станции присоединены: сеть владеет ими через домены.
+  */
+class WorkstationUserIndex {
+private:
+    std::unordered_map<Symbol, std::vector<Workstation*>> workstationsByUser; ///< Станции каждого пользователя
+
+public:
+    /**
+     * @brief Добавляет присоединённую станцию.
+     * @param[in] workstation Рабочая станция.
+     */
+    void add(Workstation& workstation);
+
+    /**
+     * @brief Убирает отсоединённую станцию.
+     * @param[in] workstation Рабочая станция.
+     */
+    void remove(Workstation& workstation) noexcept;
+
+    /**
+     * @brief Возвращает станции пользователя.
+     * @param[in] user Символ пользователя.
+     * @return Станции в произвольном порядке; пустой диапазон для пользователя без станций.
+     */
+    std::span<Workstation* const> find(Symbol user) const noexcept;
+
+    /**
+     * @brief Возвращает число пользователей, за которыми закреплены станции.
+     * @return Число пользователей в индексе.
+     */
+    size_t userCount() const noexcept { return workstationsByUser.size(); }
+};
+
+/** @} */ // Конец группы workstation_module
@@ -0,0 +1,178 @@
+﻿/**
+ * @file CapacityReservationsTests.cpp
+ * @brief Тесты для класса CapacityReservations проекта NetSphere.
+ */
+
+#include <gtest/gtest.h>
+#include "CapacityReservations.h"
+#include "CorporateNetwork.h"
+#include "DataStorage.h"
+#include "NetworkExceptions.h"
+#include <chrono>
+#include <limits>
+#include <thread>
+#include <vector>
+
+ /**
+  * @defgroup capacity_reservations_tests Тесты резервов места
+  * @brief Тесты для проверки двухфазных резервов места в нескольких хранилищах
+  * @{
+  */
+
+namespace {
+
+    constexpr uint64_t MB = DataStorage::BYTES_PER_MB;
+
+    std::shared_ptr<DataStorage> makeStorage(const std::string& id, double totalMB) {
+        return std::make_shared<DataStorage>(id, MacAddress::fromUInt64(std::hash<std::string>()(id) & 0xFFFFFFFFFFFF), totalMB);
+    }
+
+}
+
+/**
+ * @brief Тест: подтверждённый резерв оставляет место занятым, отменённый - возвращает.
+ */
+TEST(CapacityReservationsTest, CommitKeepsAndReleaseReturnsSpace) {
+    CapacityReservations reservations;
+    auto primary = makeStorage("cr_primary", 100.0);
+    auto replica = makeStorage("cr_replica", 100.0);
+    const std::vector<CapacityRequest> requests{ { primary, 40 * MB }, { replica, 40 * MB } };
+
+    const ReservationToken committed = reservations.reserve(requests);
+    const ReservationToken released = reservations.reserve(requests);
+    EXPECT_NE(committed, released);
+    EXPECT_EQ(primary->getUsedBytes(), 80 * MB);
+    EXPECT_EQ(reservations.activeCount(), 2u);
+
+    reservations.commit(committed);
+    reservations.release(released);
+    EXPECT_EQ(primary->getUsedBytes(), 40 * MB);
+    EXPECT_EQ(replica->getUsedBytes(), 40 * MB);
+    EXPECT_EQ(reservations.activeCount(), 0u);
+    EXPECT_THROW(reservations.commit(committed), DeviceOperationException);
+    EXPECT_THROW(reservations.release(released), DeviceOperationException);
+}
+
+/**
+ * @brief Тест: нехватка места в одном хранилище не меняет ни одно хранилище.
+ */
+TEST(CapacityReservationsTest, ReservesAllOrNothing) {
+    CapacityReservations reservations;
+    auto roomy = makeStorage("cr_roomy", 100.0);
+    auto tight = makeStorage("cr_tight", 10.0);
+    const std::vector<CapacityRequest> requests{ { roomy, 20 * MB }, { tight, 20 * MB } };
+
+    EXPECT_THROW(reservations.reserve(requests), DeviceOperationException);
+    EXPECT_EQ(roomy->getUsedBytes(), 0u);
+    EXPECT_EQ(tight->getUsedBytes(), 0u);
+    EXPECT_EQ(reservations.activeCount(), 0u);
+
+    // Повторы одного хранилища складываются и проверяются вместе
+    const std::vector<CapacityRequest> duplicated{ { tight, 6 * MB }, { tight, 6 * MB } };
+    EXPECT_THROW(reservations.reserve(duplicated), DeviceOperationException);
+    EXPECT_EQ(tight->getUsedBytes(), 0u);
+
+    EXPECT_THROW(reservations.reserve({}), ValidationException);
+    const std::vector<CapacityRequest> empty{ { roomy, 0 } };
+    EXPECT_THROW(reservations.reserve(empty), ValidationException);
+}
+
+/**
+ * @brief Тест: переполнение суммы повторов отклоняется, огромный срок не переполняет дедлайн.
+ */
+TEST(CapacityReservationsTest, RejectsOverflowAndClampsTtl) {
+    CapacityReservations reservations;
+    auto storage = makeStorage("cr_overflow", 100.0);
+    const std::vector<CapacityRequest> overflowing{
+        { storage, std::numeric_limits<uint64_t>::max() }, { storage, MB } };
+    EXPECT_THROW(reservations.reserve(overflowing), ValidationException);
+    EXPECT_EQ(storage->getUsedBytes(), 0u);
+
+    const std::vector<CapacityRequest> request{ { storage, MB } };
+    const ReservationToken token = reservations.reserve(request, std::chrono::milliseconds::max());
+    EXPECT_EQ(reservations.collectExpired(), 0u);
+    reservations.commit(token);
+    EXPECT_EQ(storage->getUsedBytes(), MB);
+}
+
+/**
+ * @brief Тест: истёкший резерв нельзя подтвердить, а его место возвращается.
+ */
+TEST(CapacityReservationsTest, ExpiredReservationsReturnSpace) {
+    CapacityReservations reservations;
+    auto storage = makeStorage("cr_expiring", 100.0);
+    const std::vector<CapacityRequest> requests{ { storage, 30 * MB } };
+
+    const ReservationToken expiredOnCommit = reservations.reserve(requests, std::chrono::milliseconds(0));
+    EXPECT_THROW(reservations.commit(expiredOnCommit), DeviceOperationException);
+    EXPECT_EQ(storage->getUsedBytes(), 0u);
+
+    const ReservationToken live = reservations.reserve(requests, std::chrono::hours(1));
+    reservations.reserve(requests, std::chrono::milliseconds(0));
+    EXPECT_EQ(reservations.collectExpired(), 1u);
+    EXPECT_EQ(storage->getUsedBytes(), 30 * MB);
+    reservations.commit(live);
+    EXPECT_EQ(storage->getUsedBytes(), 30 * MB);
+}
+
+/**
+ * @brief Тест: одновременные резервы пересекающихся наборов хранилищ не блокируют друг друга.
+ */
+TEST(CapacityReservationsTest, ConcurrentOverlappingReservationsComplete) {
+    constexpr int THREAD_COUNT = 8;
+    constexpr int ITERATIONS = 2000;
+    CapacityReservations reservations;
+    std::vector<std::shared_ptr<DataStorage>> storages{
+        makeStorage("cr_shared_a", 10.0), makeStorage("cr_shared_b", 10.0), makeStorage("cr_shared_c", 10.0) };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREAD_COUNT; ++t) {
+        threads.emplace_back([&, t] {
+            // Потоки перечисляют хранилища в разном порядке
+            const std::vector<CapacityRequest> requests{
+                { storages[t % 3], 3 * MB }, { storages[(t + 1) % 3], 3 * MB }, { storages[(t + 2) % 3], 3 * MB } };
+            for (int i = 0; i < ITERATIONS; ++i) {
+                try {
+                    const ReservationToken token = reservations.reserve(requests);
+                    if (i % 2 == 0) {
+                        reservations.release(token);
+                    }
+                    else {
+                        reservations.commit(token);
+                        for (const auto& storage : storages) {
+                            storage->releaseBytes(3 * MB);
+                        }
+                    }
+                }
+                catch (const DeviceOperationException&) {
+                    // Места не хватило из-за чужого резерва - допустимый исход
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto& storage : storages) {
+        EXPECT_EQ(storage->getUsedBytes(), 0u);
+    }
+    EXPECT_EQ(reservations.activeCount(), 0u);
+}
+
+/**
+ * @brief Тест: резервы сети отражаются в сводках доменов и возвращаются при уничтожении сети.
+ */
+TEST(CapacityReservationsTest, NetworkReservationsUpdateSummaries) {
+    auto storage = makeStorage("cr_attached", 100.0);
+    {
+        CorporateNetwork network("admin");
+        network.addEntityToDomain("", storage, "admin");
+        const std::vector<CapacityRequest> requests{ { storage, 25 * MB } };
+        network.getCapacityReservations().reserve(requests);
+        EXPECT_DOUBLE_EQ(network.getDomainSummary("").usedStorageMB, 25.0);
+    }
+    EXPECT_EQ(storage->getUsedBytes(), 0u);
+}
+
+/** @} */ // Конец группы capacity_reservations_tests
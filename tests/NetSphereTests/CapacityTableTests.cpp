@@ -0,0 +1,221 @@
+﻿/**
+ * @file CapacityTableTests.cpp
+ * @brief Тесты для класса CapacityTable проекта NetSphere.
+ */
+
+#include <gtest/gtest.h>
+#include "CorporateNetwork.h"
+#include "DataStorage.h"
+#include "Printer.h"
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+ /**
+  * @defgroup capacity_table_tests Тесты таблицы ёмкости
+  * @brief Тесты для проверки синхронизации таблицы ёмкости с хранилищами и отчётов по ней
+  * @{
+  */
+
+namespace {
+
+    std::shared_ptr<DataStorage> makeStorage(const std::string& id, double total, double used) {
+        auto storage = std::make_shared<DataStorage>(id, MacAddress::fromUInt64(std::hash<std::string>{}(id) & 0xFFFFFF).toString(), total);
+        if (used > 0) {
+            *storage = used;
+        }
+        return storage;
+    }
+
+    const DomainCapacity* findDomain(const std::vector<DomainCapacity>& report, const std::string& id) {
+        auto it = std::find_if(report.begin(), report.end(),
+            [&](const DomainCapacity& entry) { return entry.domain.view() == id; });
+        return it == report.end() ? nullptr : &*it;
+    }
+
+}
+
+/**
+ * @brief Тест: таблица следует за присоединением, изменением объёма и удалением хранилищ.
+ */
+TEST(CapacityTableTest, TracksStoragesAndUsage) {
+    CorporateNetwork network("admin");
+    auto first = makeStorage("first", 100.0, 10.0);
+    auto second = makeStorage("second", 300.0, 0.0);
+    network.addEntityToDomain("", first, "admin");
+    network.addEntityToDomain("", second, "admin");
+    network.addEntityToDomain("", std::make_shared<Printer>("printer", "00:00:00:00:00:09"), "admin");
+
+    CapacityTotals totals = network.getCapacityTotals();
+    EXPECT_EQ(totals.storageCount, 2u);
+    EXPECT_DOUBLE_EQ(totals.totalMB, 400.0);
+    EXPECT_DOUBLE_EQ(totals.usedMB, 10.0);
+
+    *first += 5.0;
+    *second = 200.0;
+    *second -= 50.0;
+    totals = network.getCapacityTotals();
+    EXPECT_DOUBLE_EQ(totals.usedMB, 165.0);
+    EXPECT_DOUBLE_EQ(totals.freeMB(), 235.0);
+
+    network.removeEntity("first", "admin");
+    totals = network.getCapacityTotals();
+    EXPECT_EQ(totals.storageCount, 1u);
+    EXPECT_DOUBLE_EQ(totals.usedMB, 150.0);
+
+    // Отсоединённое хранилище больше не влияет на отчёты
+    *first += 1.0;
+    EXPECT_DOUBLE_EQ(network.getCapacityTotals().usedMB, 150.0);
+}
+
+/**
+ * @brief Тест: суммы по доменам учитывают вложенные домены и их перенос.
+ */
+TEST(CapacityTableTest, SumsPerOwningDomain) {
+    CorporateNetwork network("admin");
+    auto branch = std::make_shared<Domain>("branch", "branch_admin");
+    branch->addEntity(makeStorage("branch_storage", 50.0, 25.0), "branch_admin");
+    network.addEntityToDomain("", branch, "admin");
+    network.addEntityToDomain("", makeStorage("root_storage", 200.0, 20.0), "admin");
+    network.addEntityToDomain("branch", makeStorage("branch_storage_2", 150.0, 75.0), "branch_admin");
+
+    auto report = network.readCapacity([](const CapacityTable& table) { return table.sumByDomain(); });
+    ASSERT_EQ(report.size(), 2u);
+    const DomainCapacity* branchTotals = findDomain(report, "branch");
+    ASSERT_NE(branchTotals, nullptr);
+    EXPECT_EQ(branchTotals->totals.storageCount, 2u);
+    EXPECT_DOUBLE_EQ(branchTotals->totals.totalMB, 200.0);
+    EXPECT_DOUBLE_EQ(branchTotals->totals.usedMB, 100.0);
+    const DomainCapacity* rootTotals = findDomain(report, "root_domain");
+    ASSERT_NE(rootTotals, nullptr);
+    EXPECT_DOUBLE_EQ(rootTotals->totals.usedMB, 20.0);
+
+    DetachedSubtree subtree = network.detachSubtree("branch", "admin");
+    EXPECT_EQ(network.getCapacityTotals().storageCount, 1u);
+    network.addEntityToDomain("", std::make_shared<Domain>("archive", "archive_admin"), "admin");
+    network.attachSubtree("archive", std::move(subtree), "archive_admin");
+
+    report = network.readCapacity([](const CapacityTable& table) { return table.sumByDomain(); });
+    branchTotals = findDomain(report, "branch");
+    ASSERT_NE(branchTotals, nullptr);
+    EXPECT_EQ(branchTotals->totals.storageCount, 2u);
+    EXPECT_EQ(network.getCapacityTotals().storageCount, 3u);
+}
+
+/**
+ * @brief Тест: подсчёт по доле заполнения и гистограмма совпадают с поэлементным расчётом.
+ */
+TEST(CapacityTableTest, FillRatioReportsMatchScalarComputation) {
+    CorporateNetwork network("admin");
+    std::vector<std::shared_ptr<NetworkEntity>> batch;
+    std::vector<double> fills;
+    for (int i = 0; i < 101; ++i) {
+        const double total = 100.0 + i;
+        const double used = total * (i % 11) / 10.0;
+        fills.push_back(used / total);
+        batch.push_back(makeStorage("storage_" + std::to_string(i), total, used));
+    }
+    network.addEntitiesToDomain("", batch, "admin");
+
+    network.readCapacity([&](const CapacityTable& table) {
+        ASSERT_EQ(table.size(), 101u);
+        for (double ratio : { 0.0, 0.25, 0.5, 0.95 }) {
+            const size_t expected = std::count_if(fills.begin(), fills.end(), [&](double fill) { return fill > ratio; });
+            EXPECT_EQ(table.countAboveFillRatio(ratio), expected) << "ratio " << ratio;
+        }
+
+        const std::vector<size_t> histogram = table.fillHistogram(4);
+        ASSERT_EQ(histogram.size(), 4u);
+        std::vector<size_t> expected(4, 0);
+        for (double fill : fills) {
+            ++expected[std::min(static_cast<size_t>(fill * 4), size_t{ 3 })];
+        }
+        EXPECT_EQ(histogram, expected);
+        EXPECT_THROW(table.fillHistogram(0), ValidationException);
+    });
+}
+
+/**
+ * @brief Тест: освобождённые строки переиспользуются, а отчёты их не учитывают.
+ */
+TEST(CapacityTableTest, ReusesFreedRowsAcrossChunks) {
+    CorporateNetwork network("admin");
+    std::vector<std::shared_ptr<NetworkEntity>> batch;
+    for (int i = 0; i < 1500; ++i) {
+        batch.push_back(makeStorage("chunk_storage_" + std::to_string(i), 100.0, 50.0));
+    }
+    network.addEntitiesToDomain("", batch, "admin");
+    for (int i = 0; i < 1500; i += 3) {
+        network.removeEntity("chunk_storage_" + std::to_string(i), "admin");
+    }
+
+    network.readCapacity([](const CapacityTable& table) {
+        EXPECT_EQ(table.size(), 1000u);
+        EXPECT_EQ(table.countAboveFillRatio(0.25), 1000u);
+        EXPECT_EQ(table.fillHistogram(2), (std::vector<size_t>{ 0, 1000 }));
+    });
+    for (int i = 0; i < 500; ++i) {
+        network.addEntityToDomain("", makeStorage("refill_storage_" + std::to_string(i), 100.0, 0.0), "admin");
+    }
+    const CapacityTotals totals = network.getCapacityTotals();
+    EXPECT_EQ(totals.storageCount, 1500u);
+    EXPECT_DOUBLE_EQ(totals.totalMB, 150000.0);
+    EXPECT_DOUBLE_EQ(totals.usedMB, 50000.0);
+}
+
+/**
+ * @brief Тест: изменение объёма из других потоков, пока таблица растёт и строит отчёты.
+ */
+TEST(CapacityTableTest, UsageUpdatesDuringGrowthAndReports) {
+    CorporateNetwork network("admin");
+    std::vector<std::shared_ptr<DataStorage>> busy;
+    for (int i = 0; i < 4; ++i) {
+        busy.push_back(makeStorage("busy_storage_" + std::to_string(i), 1000.0, 0.0));
+        network.addEntityToDomain("", busy.back(), "admin");
+    }
+
+    std::atomic<bool> stop{ false };
+    std::vector<std::thread> writers;
+    for (const auto& storage : busy) {
+        writers.emplace_back([&stop, storage] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                *storage += 1.0;
+                *storage -= 1.0;
+            }
+            *storage += 2.0;
+        });
+    }
+    for (int i = 0; i < 2100; ++i) {
+        network.addEntityToDomain("", makeStorage("growth_storage_" + std::to_string(i), 10.0, 0.0), "admin");
+        if (i % 100 == 0) {
+            EXPECT_LE(network.getCapacityTotals().usedMB, 4.0);
+        }
+    }
+    stop.store(true, std::memory_order_relaxed);
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    const CapacityTotals totals = network.getCapacityTotals();
+    EXPECT_EQ(totals.storageCount, 2104u);
+    EXPECT_DOUBLE_EQ(totals.usedMB, 8.0);
+}
+
+/**
+ * @brief Тест: хранилище, пережившее сеть, отвязывается от её таблицы.
+ */
+TEST(CapacityTableTest, StorageOutlivesNetwork) {
+    auto storage = makeStorage("survivor", 100.0, 0.0);
+    {
+        CorporateNetwork network("admin");
+        network.addEntityToDomain("", storage, "admin");
+        *storage += 10.0;
+        EXPECT_DOUBLE_EQ(network.getCapacityTotals().usedMB, 10.0);
+    }
+    EXPECT_NO_THROW(*storage += 10.0);
+    EXPECT_DOUBLE_EQ(storage->getUsedSize(), 20.0);
+}
+
+/** @} */ // Конец группы capacity_table_tests
@@ -0,0 +1,140 @@
+﻿/**
+ * @file ChangeFeedTests.cpp
+ * @brief Тесты для класса ChangeFeed проекта NetSphere.
+ */
+
+#include <gtest/gtest.h>
+#include "ChangeFeed.h"
+#include "CorporateNetwork.h"
+#include "DataStorage.h"
+#include "Printer.h"
+#include "Workstation.h"
+#include <string>
+#include <vector>
+
+ /**
+  * @defgroup change_feed_tests Тесты ленты изменений
+  * @brief Тесты для проверки нумерации, выборки и вытеснения событий
+  * @{
+  */
+
+/**
+ * @brief Тест: каждое изменение сети попадает в ленту с очередным номером.
+ */
+TEST(ChangeFeedTest, RecordsNetworkChangesInOrder) {
+    CorporateNetwork network("admin");
+    ChangeFeed& feed = network.enableChangeFeed(16);
+
+    auto storage = std::make_shared<DataStorage>("storage", "00:00:00:00:00:01", 100.0);
+    auto workstation = std::make_shared<Workstation>("ws", "00:00:00:00:00:02", "user", 10);
+    network.addEntityToDomain("", storage, "admin");
+    network.addEntityToDomain("", workstation, "admin");
+    *storage += 25.0;
+    storage->addTrustedUser("alice");
+    workstation->updatePowerOnTime(20);
+    network.removeEntity("ws", "admin");
+
+    std::vector<ChangeEvent> events(16);
+    const ChangeFetchResult result = feed.fetchSince(0, events);
+    ASSERT_FALSE(result.resyncRequired);
+    ASSERT_EQ(result.count, 6u);
+    EXPECT_EQ(result.lastSequence, 6u);
+    for (size_t i = 0; i < result.count; ++i) {
+        EXPECT_EQ(events[i].sequence, i + 1);
+    }
+
+    EXPECT_EQ(events[0].type, ChangeType::EntityAdded);
+    EXPECT_EQ(events[0].entity.view(), "storage");
+    EXPECT_EQ(events[0].related.view(), "root_domain");
+    EXPECT_EQ(events[0].kind, EntityKind::DataStorage);
+    EXPECT_EQ(events[2].type, ChangeType::StorageUsageChanged);
+    EXPECT_DOUBLE_EQ(events[2].usedMB, 25.0);
+    EXPECT_EQ(events[3].type, ChangeType::EntityUpdated);
+    EXPECT_EQ(events[3].related.view(), "alice");
+    EXPECT_EQ(events[4].type, ChangeType::PowerOnChanged);
+    EXPECT_EQ(events[4].powerOnTime, 20);
+    EXPECT_EQ(events[5].type, ChangeType::EntityRemoved);
+    EXPECT_EQ(events[5].entity.view(), "ws");
+}
+
+/**
+ * @brief Тест: выборка возвращает только события новее переданного номера и ограничена буфером.
+ */
+TEST(ChangeFeedTest, FetchesOnlyNewerEventsInPages) {
+    CorporateNetwork network("admin");
+    ChangeFeed& feed = network.enableChangeFeed(64);
+    for (int i = 0; i < 10; ++i) {
+        network.addEntityToDomain("", std::make_shared<Printer>("printer_" + std::to_string(i),
+            MacAddress::fromUInt64(i + 1).toString()), "admin");
+    }
+
+    std::vector<ChangeEvent> page(4);
+    uint64_t applied = 0;
+    std::vector<std::string> seen;
+    while (true) {
+        const ChangeFetchResult result = feed.fetchSince(applied, page);
+        ASSERT_FALSE(result.resyncRequired);
+        if (result.count == 0) {
+            break;
+        }
+        for (size_t i = 0; i < result.count; ++i) {
+            seen.push_back(page[i].entity.str());
+        }
+        applied = page[result.count - 1].sequence;
+    }
+
+    ASSERT_EQ(seen.size(), 10u);
+    EXPECT_EQ(seen.front(), "printer_0");
+    EXPECT_EQ(seen.back(), "printer_9");
+    EXPECT_EQ(applied, feed.getLastSequence());
+}
+
+/**
+ * @brief Тест: отставший клиент получает требование пересинхронизации.
+ */
+TEST(ChangeFeedTest, RequiresResyncWhenClientFallsBehind) {
+    CorporateNetwork network("admin");
+    ChangeFeed& feed = network.enableChangeFeed(5);
+    EXPECT_EQ(feed.getCapacity(), 8u);
+
+    auto storage = std::make_shared<DataStorage>("storage", "00:00:00:00:00:01", 1000.0);
+    network.addEntityToDomain("", storage, "admin");
+    for (int i = 0; i < 11; ++i) {
+        *storage += 1.0;
+    }
+    ASSERT_EQ(feed.getLastSequence(), 12u);
+
+    std::vector<ChangeEvent> events(8);
+    ChangeFetchResult result = feed.fetchSince(0, events);
+    EXPECT_TRUE(result.resyncRequired);
+    EXPECT_EQ(result.count, 0u);
+    EXPECT_EQ(result.lastSequence, 12u);
+
+    // Самое старое событие в буфере - 5, клиент, применивший 4, ещё может догнать
+    result = feed.fetchSince(4, events);
+    ASSERT_FALSE(result.resyncRequired);
+    ASSERT_EQ(result.count, 8u);
+    EXPECT_EQ(events.front().sequence, 5u);
+    EXPECT_DOUBLE_EQ(events.back().usedMB, 11.0);
+
+    EXPECT_TRUE(feed.fetchSince(3, events).resyncRequired);
+    EXPECT_TRUE(feed.fetchSince(13, events).resyncRequired);
+    EXPECT_EQ(feed.fetchSince(12, events).count, 0u);
+}
+
+/**
+ * @brief Тест: лента создаётся один раз и не включена по умолчанию.
+ */
+TEST(ChangeFeedTest, EnabledOnDemandOnce) {
+    CorporateNetwork network("admin");
+    EXPECT_EQ(network.getChangeFeed(), nullptr);
+
+    ChangeFeed& feed = network.enableChangeFeed(32);
+    EXPECT_EQ(&network.enableChangeFeed(1024), &feed);
+    EXPECT_EQ(network.getChangeFeed(), &feed);
+    EXPECT_EQ(feed.getCapacity(), 32u);
+
+    EXPECT_THROW(ChangeFeed(0), ValidationException);
+}
+
+/** @} */ // Конец группы change_feed_tests
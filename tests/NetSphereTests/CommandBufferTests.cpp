@@ -0,0 +1,128 @@
+﻿/**
+ * @file CommandBufferTests.cpp
+ * @brief Тесты для пакетного буфера команд проекта NetSphere.
+ */
+
+#include <gtest/gtest.h>
+#include "CommandBuffer.h"
+#include "DataStorage.h"
+#include "Workstation.h"
+#include <vector>
+
+ /**
+  * @defgroup command_buffer_tests Тесты пакетного буфера команд
+  * @brief Тесты для проверки CommandBufferWriter и CommandBufferExecutor
+  * @{
+  */
+
+/**
+ * @brief Тест выполнения команд всех видов одним пакетом.
+ */
+TEST(CommandBufferTest, ExecutesAllCommandKinds) {
+    CorporateNetwork network("admin");
+    CommandBufferWriter writer;
+    writer.addDomain("", "admin", "batch_office", "office_admin")
+        .addStorage("batch_office", "office_admin", "batch_storage", "00:11:22:33:44:55", 1000)
+        .addWorkstation("batch_office", "office_admin", "batch_ws", "00:11:22:33:44:56", "carol", 100)
+        .addPrinter("", "admin", "batch_printer", "00:11:22:33:44:57")
+        .storageDelta("batch_storage", 300)
+        .storageDelta("batch_storage", -50)
+        .addTrustedUser("batch_storage", "alice")
+        .addTrustedUser("batch_storage", "bob")
+        .removeTrustedUser("batch_storage", "alice")
+        .powerOn("batch_ws", 1700000000)
+        .remove("batch_printer", "admin");
+
+    std::vector<CommandStatus> statuses(writer.size(), CommandStatus::Failed);
+    const auto result = CommandBufferExecutor::execute(network, writer.data(), statuses);
+
+    EXPECT_EQ(result.processed, writer.size());
+    EXPECT_EQ(result.failed, 0);
+    for (CommandStatus status : statuses) {
+        EXPECT_EQ(status, CommandStatus::Ok);
+    }
+
+    auto storage = entityCast<DataStorage>(network.findEntity("batch_storage"));
+    ASSERT_NE(storage, nullptr);
+    EXPECT_DOUBLE_EQ(storage->getUsedSize(), 250);
+    EXPECT_TRUE(storage->isUserTrusted("bob"));
+    EXPECT_FALSE(storage->isUserTrusted("alice"));
+    EXPECT_EQ(entityCast<Workstation>(network.findEntity("batch_ws"))->getLastPowerOnTime(), 1700000000);
+    EXPECT_EQ(network.findEntity("batch_printer"), nullptr);
+}
+
+/**
+ * @brief Тест: ошибка одной команды получает свой код и не прерывает пакет.
+ */
+TEST(CommandBufferTest, PerCommandStatusCodes) {
+    CorporateNetwork network("admin");
+    CommandBufferWriter writer;
+    writer.addPrinter("", "intruder", "denied_printer", "00:11:22:33:44:55")
+        .addPrinter("", "admin", "bad_mac_printer", "not-a-mac")
+        .storageDelta("missing_storage", 10)
+        .addPrinter("", "admin", "good_printer", "00:11:22:33:44:56")
+        .addPrinter("missing_domain", "admin", "orphan_printer", "00:11:22:33:44:57")
+        .addStorage("", "admin", "small_storage", "00:11:22:33:44:58", 10)
+        .storageDelta("small_storage", 100);
+
+    std::vector<CommandStatus> statuses(writer.size());
+    const auto result = CommandBufferExecutor::execute(network, writer.data(), statuses);
+
+    EXPECT_EQ(result.processed, writer.size());
+    EXPECT_EQ(result.failed, 5);
+    EXPECT_FALSE(result.lastError.empty());
+    EXPECT_EQ(statuses[0], CommandStatus::AccessDenied);
+    EXPECT_EQ(statuses[1], CommandStatus::Validation);
+    EXPECT_EQ(statuses[2], CommandStatus::NotFound);
+    EXPECT_EQ(statuses[3], CommandStatus::Ok);
+    EXPECT_EQ(statuses[4], CommandStatus::DomainOperation);
+    EXPECT_EQ(statuses[5], CommandStatus::Ok);
+    EXPECT_NE(statuses[6], CommandStatus::Ok);
+    EXPECT_NE(network.findEntity("good_printer"), nullptr);
+}
+
+/**
+ * @brief Тест: обрезанная команда получает статус Malformed и останавливает пакет.
+ */
+TEST(CommandBufferTest, TruncatedCommandStopsBatch) {
+    CorporateNetwork network("admin");
+    CommandBufferWriter writer;
+    writer.addPrinter("", "admin", "first_printer", "00:11:22:33:44:55")
+        .addPrinter("", "admin", "second_printer", "00:11:22:33:44:56");
+    auto bytes = writer.data();
+    auto truncated = bytes.first(bytes.size() - 3);
+
+    std::vector<CommandStatus> statuses(writer.size(), CommandStatus::Ok);
+    const auto result = CommandBufferExecutor::execute(network, truncated, statuses);
+
+    EXPECT_EQ(result.processed, 2);
+    EXPECT_EQ(statuses[0], CommandStatus::Ok);
+    EXPECT_EQ(statuses[1], CommandStatus::Malformed);
+    EXPECT_NE(network.findEntity("first_printer"), nullptr);
+    EXPECT_EQ(network.findEntity("second_printer"), nullptr);
+
+    // Неизвестный код команды
+    const std::byte unknown[] = { std::byte{ 0xEE } };
+    EXPECT_EQ(CommandBufferExecutor::execute(network, unknown, statuses).failed, 1);
+    EXPECT_EQ(statuses[0], CommandStatus::Malformed);
+}
+
+/**
+ * @brief Тест совместимости кодирования с построителем CommandBuffer из python/corporate_network.py.
+ */
+TEST(CommandBufferTest, EncodingMatchesPythonBuilder) {
+    CommandBufferWriter writer;
+    writer.addPrinter("", "admin", "p1", "00:11:22:33:44:55").storageDelta("s", -5.0);
+
+    const std::string expectedHex =
+        "030000050061646d696e02007031110030303a31313a32323a33333a34343a35350601007300000000000014c0";
+    std::string actualHex;
+    for (std::byte value : writer.data()) {
+        static const char digits[] = "0123456789abcdef";
+        actualHex += digits[std::to_integer<int>(value) >> 4];
+        actualHex += digits[std::to_integer<int>(value) & 0xF];
+    }
+    EXPECT_EQ(actualHex, expectedHex);
+}
+
+/** @} */ // Конец группы command_buffer_tests
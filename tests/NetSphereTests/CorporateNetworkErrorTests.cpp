@@ -73,6 +73,89 @@ TEST(CorporateNetworkErrorTest, AddDuplicateEntity) {
     );
 }
 
+// Тест добавления сущности с идентификатором, уже занятым в другом домене
+TEST(CorporateNetworkErrorTest, AddDuplicateEntityInAnotherDomain) {
+    CorporateNetwork network("admin");
+    auto subDomain = std::make_shared<Domain>("subdomain", "sub_admin");
+    network.addEntityToDomain("", subDomain, "admin");
+
+    auto storage = std::make_shared<DataStorage>("storage1", "00:1A:2B:3C:4D:66", 1000.0);
+    network.addEntityToDomain("", storage, "admin");
+
+    auto storage2 = std::make_shared<DataStorage>("storage1", "00:1A:2B:3C:4D:67", 2000.0);
+    EXPECT_THROW(
+        network.addEntityToDomain("subdomain", storage2, "sub_admin"),
+        DomainOperationException
+    );
+    EXPECT_EQ(subDomain->getEntityCount(), 0);
+    EXPECT_EQ(network.findEntity("storage1"), storage);
+}
+
+// Тест присоединения поддерева с конфликтующим идентификатором
+TEST(CorporateNetworkErrorTest, AttachSubtreeWithDuplicateId) {
+    CorporateNetwork network("admin");
+    auto team = std::make_shared<Domain>("team", "team_admin");
+    network.addEntityToDomain("", team, "admin");
+    auto storage = std::make_shared<DataStorage>("team_storage", "00:1A:2B:3C:4D:68", 1000.0);
+    network.addEntityToDomain("team", storage, "team_admin");
+
+    DetachedSubtree subtree = network.detachSubtree("team", "admin");
+    auto clash = std::make_shared<DataStorage>("team_storage", "00:1A:2B:3C:4D:69", 1000.0);
+    network.addEntityToDomain("", clash, "admin");
+
+    EXPECT_THROW(network.attachSubtree("", std::move(subtree), "admin"), DomainOperationException);
+    EXPECT_EQ(network.findEntity("team"), nullptr);
+    EXPECT_EQ(network.findEntity("team_storage"), clash);
+}
+
+// Тест отсоединения корневого домена
+TEST(CorporateNetworkErrorTest, DetachRootDomain) {
+    CorporateNetwork network("admin");
+
+    EXPECT_THROW(network.detachSubtree("root_domain", "admin"), DomainOperationException);
+    EXPECT_EQ(network.findEntity("root_domain"), network.getRootDomain());
+}
+
+// Тест атомарности пакетного добавления при конфликте вложенного идентификатора
+TEST(CorporateNetworkErrorTest, AddEntitiesToDomainIsAllOrNothing) {
+    CorporateNetwork network("admin");
+    auto existing = std::make_shared<DataStorage>("existing", "00:1A:2B:3C:4D:6A", 1000.0);
+    network.addEntityToDomain("", existing, "admin");
+
+    auto office = std::make_shared<Domain>("office", "office_admin");
+    office->addEntity(std::make_shared<DataStorage>("existing", "00:1A:2B:3C:4D:6B", 1000.0), "office_admin");
+    std::vector<std::shared_ptr<NetworkEntity>> batch{
+        std::make_shared<DataStorage>("fresh", "00:1A:2B:3C:4D:6C", 1000.0),
+        office
+    };
+
+    EXPECT_THROW(network.addEntitiesToDomain("", batch, "admin"), DomainOperationException);
+    EXPECT_EQ(network.findEntity("fresh"), nullptr);
+    EXPECT_EQ(network.findEntity("office"), nullptr);
+    EXPECT_EQ(network.getRootDomain()->getEntityCount(), 1);
+
+    batch.pop_back();
+    EXPECT_THROW(network.addEntitiesToDomain("", batch, "hacker"), AccessDeniedException);
+    EXPECT_EQ(network.findEntity("fresh"), nullptr);
+}
+
+// Тест: права проверяются до поиска дубликатов, чужие идентификаторы не раскрываются
+TEST(CorporateNetworkErrorTest, AddEntitiesToDomainChecksRightsBeforeDuplicates) {
+    CorporateNetwork network("admin");
+    network.addEntityToDomain("", std::make_shared<DataStorage>("hidden", "00:1A:2B:3C:4D:6D", 1000.0), "admin");
+
+    const std::vector<std::shared_ptr<NetworkEntity>> batch{
+        std::make_shared<DataStorage>("hidden", "00:1A:2B:3C:4D:6E", 1000.0)
+    };
+    try {
+        network.addEntitiesToDomain("", batch, "hacker");
+        FAIL() << "Ожидалось AccessDeniedException";
+    }
+    catch (const AccessDeniedException& e) {
+        EXPECT_EQ(std::string(e.what()).find("hidden"), std::string::npos);
+    }
+}
+
 // Тест вывода информации о несуществующем домене
 TEST(CorporateNetworkErrorTest, PrintNonExistentDomainInfo) {
     CorporateNetwork network("admin");
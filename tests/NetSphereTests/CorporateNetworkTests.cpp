@@ -5,10 +5,16 @@
 
 #include <gtest/gtest.h>
 #include "CorporateNetwork.h"
+#include "ChangeFeed.h"
 #include "DataStorage.h"
 #include "Workstation.h"
 #include "Printer.h"
 #include "Domain.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
  /**
   * @defgroup corporate_network_tests Тесты корпоративной сети
@@ -150,4 +156,255 @@ TEST(CorporateNetworkTest, ComplexDomainHierarchy) {
     EXPECT_NE(network.findEntity("backend"), nullptr);
 }
 
+// Тест индекса доменов-владельцев
+TEST(CorporateNetworkTest, GetParentDomain) {
+    CorporateNetwork network("admin");
+    auto subDomain = std::make_shared<Domain>("subdomain", "sub_admin");
+    auto nestedStorage = std::make_shared<DataStorage>("nested_storage", "00:1A:2B:3C:4D:69", 1000.0);
+    subDomain->addEntity(nestedStorage, "sub_admin");
+    network.addEntityToDomain("", subDomain, "admin");
+
+    auto workstation = std::make_shared<Workstation>("ws1", "00:1A:2B:3C:4D:6A", "user", time(nullptr));
+    network.addEntityToDomain("subdomain", workstation, "sub_admin");
+
+    EXPECT_EQ(network.getParentDomain("subdomain"), network.getRootDomain());
+    EXPECT_EQ(network.getParentDomain("ws1"), subDomain);
+    EXPECT_EQ(network.getParentDomain("nested_storage"), subDomain);
+    EXPECT_EQ(network.getParentDomain("root_domain"), nullptr);
+    EXPECT_EQ(network.getParentDomain("nonexistent"), nullptr);
+
+    network.removeEntity("ws1", "sub_admin");
+    EXPECT_EQ(network.getParentDomain("ws1"), nullptr);
+    EXPECT_EQ(subDomain->findEntity("ws1"), nullptr);
+}
+
+// Тест индекса доменов при присоединении и отсоединении вложенных поддоменов
+TEST(CorporateNetworkTest, FindDomainIndex) {
+    CorporateNetwork network("admin");
+    auto office = std::make_shared<Domain>("office", "office_admin");
+    auto floor = std::make_shared<Domain>("floor", "floor_admin");
+    auto room = std::make_shared<Domain>("room", "room_admin");
+    floor->addEntity(room, "floor_admin");
+    office->addEntity(floor, "office_admin");
+    network.addEntityToDomain("", office, "admin");
+
+    EXPECT_EQ(network.findDomain(""), network.getRootDomain());
+    EXPECT_EQ(network.findDomain("root_domain"), network.getRootDomain());
+    EXPECT_EQ(network.findDomain("office"), office);
+    EXPECT_EQ(network.findDomain("floor"), floor);
+    EXPECT_EQ(network.findDomain("room"), room);
+
+    auto printer = std::make_shared<Printer>("room_printer", "00:1A:2B:3C:4D:6B");
+    EXPECT_NO_THROW(network.addEntityToDomain("room", printer, "room_admin"));
+    EXPECT_EQ(room->findEntity("room_printer"), printer);
+
+    network.removeEntity("office", "admin");
+    EXPECT_EQ(network.findDomain("office"), nullptr);
+    EXPECT_EQ(network.findDomain("floor"), nullptr);
+    EXPECT_EQ(network.findDomain("room"), nullptr);
+}
+
+// Тест удаления домена вместе со всеми потомками
+TEST(CorporateNetworkTest, RemoveDomainReleasesDescendants) {
+    CorporateNetwork network("admin");
+    auto branch = std::make_shared<Domain>("branch", "branch_admin");
+    network.addEntityToDomain("", branch, "admin");
+    auto team = std::make_shared<Domain>("team", "team_admin");
+    network.addEntityToDomain("branch", team, "branch_admin");
+    auto storage = std::make_shared<DataStorage>("team_storage", "00:1A:2B:3C:4D:6C", 1000.0);
+    network.addEntityToDomain("team", storage, "team_admin");
+
+    std::weak_ptr<NetworkEntity> weakStorage = storage;
+    storage.reset();
+    team.reset();
+    branch.reset();
+
+    network.removeEntity("branch", "admin");
+    EXPECT_EQ(network.findEntity("branch"), nullptr);
+    EXPECT_EQ(network.findEntity("team"), nullptr);
+    EXPECT_EQ(network.findEntity("team_storage"), nullptr);
+    EXPECT_EQ(network.getParentDomain("team_storage"), nullptr);
+    EXPECT_EQ(network.findDomain("team"), nullptr);
+    EXPECT_TRUE(weakStorage.expired());
+}
+
+// Тест отсоединения поддерева и его присоединения в другом месте
+TEST(CorporateNetworkTest, DetachAndReattachSubtree) {
+    CorporateNetwork network("admin");
+    auto east = std::make_shared<Domain>("east", "east_admin");
+    auto west = std::make_shared<Domain>("west", "west_admin");
+    network.addEntityToDomain("", east, "admin");
+    network.addEntityToDomain("", west, "admin");
+
+    auto team = std::make_shared<Domain>("team", "team_admin");
+    network.addEntityToDomain("east", team, "east_admin");
+    auto workstation = std::make_shared<Workstation>("team_ws", "00:1A:2B:3C:4D:6D", "user", time(nullptr));
+    network.addEntityToDomain("team", workstation, "team_admin");
+
+    DetachedSubtree subtree = network.detachSubtree("team", "east_admin");
+    EXPECT_EQ(subtree.size(), 2);
+    EXPECT_EQ(subtree.getRoot(), team);
+    EXPECT_EQ(network.findEntity("team_ws"), nullptr);
+    EXPECT_EQ(east->getEntityCount(), 0);
+
+    network.attachSubtree("west", std::move(subtree), "west_admin");
+    EXPECT_TRUE(subtree.empty());
+    EXPECT_EQ(network.getParentDomain("team"), west);
+    EXPECT_EQ(network.getParentDomain("team_ws"), team);
+    EXPECT_EQ(network.findEntity("team_ws"), workstation);
+    EXPECT_EQ(network.findDomain("team"), team);
+}
+
+// Тест пакетного добавления сущностей, включая поддомен с вложенными сущностями
+TEST(CorporateNetworkTest, AddEntitiesToDomainBatch) {
+    CorporateNetwork network("admin");
+    auto office = std::make_shared<Domain>("office", "office_admin");
+    auto officePrinter = std::make_shared<Printer>("office_printer", "00:1A:2B:3C:4D:6E");
+    office->addEntity(officePrinter, "office_admin");
+
+    std::vector<std::shared_ptr<NetworkEntity>> batch{ office };
+    for (int i = 0; i < 100; ++i) {
+        batch.push_back(std::make_shared<Workstation>("bulk_ws_" + std::to_string(i),
+            MacAddress::fromUInt64(0x100 + i).toString(), "user", time(nullptr)));
+    }
+
+    network.addEntitiesToDomain("", batch, "admin");
+    EXPECT_EQ(network.getRootDomain()->getEntityCount(), 101);
+    EXPECT_EQ(network.findEntity("bulk_ws_42"), batch[43]);
+    EXPECT_EQ(network.getParentDomain("bulk_ws_42"), network.getRootDomain());
+    EXPECT_EQ(network.getParentDomain("office_printer"), office);
+    EXPECT_EQ(network.findDomain("office"), office);
+}
+
+// Тест сводок доменов при пакетном добавлении, переносе поддерева и изменении объёма
+TEST(CorporateNetworkTest, DomainSummariesFollowSubtreeMoves) {
+    CorporateNetwork network("admin");
+    network.addEntityToDomain("", std::make_shared<Domain>("north", "north_admin"), "admin");
+    network.addEntityToDomain("", std::make_shared<Domain>("south", "south_admin"), "admin");
+    network.addEntityToDomain("north", std::make_shared<Domain>("lab", "lab_admin"), "north_admin");
+
+    auto storage = std::make_shared<DataStorage>("lab_storage", "00:1A:2B:3C:5D:01", 1000.0);
+    std::vector<std::shared_ptr<NetworkEntity>> batch{
+        storage,
+        std::make_shared<Workstation>("lab_ws", "00:1A:2B:3C:5D:02", "user", 0),
+        std::make_shared<Printer>("lab_printer", "00:1A:2B:3C:5D:03")
+    };
+    network.addEntitiesToDomain("lab", batch, "lab_admin");
+    *storage += 250.0;
+
+    DomainSummary north = network.getDomainSummary("north");
+    EXPECT_EQ(north.entityCount(), 4);
+    EXPECT_DOUBLE_EQ(north.totalStorageMB, 1000.0);
+    EXPECT_DOUBLE_EQ(north.usedStorageMB, 250.0);
+    EXPECT_EQ(network.getDomainSummary("").entityCount(), network.getEntityCount() - 1);
+
+    DetachedSubtree lab = network.detachSubtree("lab", "north_admin");
+    EXPECT_EQ(network.getDomainSummary("north").entityCount(), 0);
+    network.attachSubtree("south", std::move(lab), "south_admin");
+
+    const DomainSummary south = network.getDomainSummary("south");
+    EXPECT_EQ(south.count(EntityKind::Domain), 1);
+    EXPECT_EQ(south.count(EntityKind::DataStorage), 1);
+    EXPECT_DOUBLE_EQ(south.usedStorageMB, 250.0);
+    EXPECT_DOUBLE_EQ(network.getDomainSummary("").usedStorageMB, 250.0);
+    EXPECT_THROW(network.getDomainSummary("missing"), DomainOperationException);
+}
+
+/**
+ * @brief Наблюдатель, считающий события устройств.
+ */
+class CountingObserver : public NetworkObserver {
+public:
+    explicit CountingObserver(std::atomic<size_t>& events) : events(events) {}
+
+    void onStorageUsageChanged(const DataStorage&, double) override { events.fetch_add(1, std::memory_order_relaxed); }
+    void onPowerOnTimeChanged(const Workstation&, time_t) override { events.fetch_add(1, std::memory_order_relaxed); }
+
+private:
+    std::atomic<size_t>& events;
+};
+
+// Тест подписки и отписки наблюдателей параллельно с событиями устройств;
+// отписанный наблюдатель сразу уничтожается (ошибку ловят санитайзеры)
+TEST(CorporateNetworkTest, ObserversChangeDuringDeviceEvents) {
+    CorporateNetwork network("admin");
+    auto storage = std::make_shared<DataStorage>("observed_storage", "00:1A:2B:3C:5E:01", 1000.0);
+    auto workstation = std::make_shared<Workstation>("observed_ws", "00:1A:2B:3C:5E:02", "user", 0);
+    network.addEntityToDomain("", storage, "admin");
+    network.addEntityToDomain("", workstation, "admin");
+
+    std::atomic<bool> stop{ false };
+    std::thread devices([&] {
+        for (time_t i = 1; !stop.load(std::memory_order_relaxed); ++i) {
+            *storage += 1.0;
+            *storage -= 1.0;
+            workstation->updatePowerOnTime(i);
+        }
+    });
+
+    std::atomic<size_t> events{ 0 };
+    for (int i = 0; i < 200; ++i) {
+        auto observer = std::make_unique<CountingObserver>(events);
+        network.addObserver(observer.get());
+        if (i == 100) {
+            network.enableChangeFeed(16);
+        }
+        std::this_thread::yield();
+        network.removeObserver(observer.get());
+    }
+    stop.store(true, std::memory_order_relaxed);
+    devices.join();
+
+    const size_t afterRemoval = events.load();
+    *storage += 1.0;
+    EXPECT_EQ(events.load(), afterRemoval);
+    EXPECT_GT(network.getChangeFeed()->getLastSequence(), 0u);
+    EXPECT_EQ(network.getWorkstationsPoweredOnBetween(workstation->getLastPowerOnTime(),
+        workstation->getLastPowerOnTime() + 1).size(), 1u);
+}
+
+// Тест учёта объёма хранилища, которое другие потоки меняют, пока сеть
+// присоединяет и отсоединяет его; таблица ёмкости и сводки сходятся к точному объёму
+TEST(CorporateNetworkTest, StorageAccountingDuringAttachAndDetach) {
+    CorporateNetwork network("admin");
+    network.addEntityToDomain("", std::make_shared<Domain>("accounting", "accounting_admin"), "admin");
+    auto storage = std::make_shared<DataStorage>("accounting_storage", "00:1A:2B:3C:5E:11", 1000.0);
+
+    std::atomic<bool> stop{ false };
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 2; ++t) {
+        writers.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                *storage += 0.25;
+                *storage -= 0.25;
+            }
+            *storage += 2.0;
+        });
+    }
+    for (int i = 0; i < 300; ++i) {
+        network.addEntityToDomain("accounting", storage, "accounting_admin");
+        // Хранилища с других строк занимают освобождённую строку таблицы
+        network.addEntityToDomain("", std::make_shared<DataStorage>("accounting_filler_" + std::to_string(i),
+            MacAddress::fromUInt64(0x5E0000 + i).toString(), 10.0), "admin");
+        network.removeEntity("accounting_storage", "accounting_admin");
+    }
+    network.addEntityToDomain("accounting", storage, "accounting_admin");
+    stop.store(true, std::memory_order_relaxed);
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    EXPECT_DOUBLE_EQ(storage->getUsedSize(), 4.0);
+    EXPECT_DOUBLE_EQ(network.getDomainSummary("accounting").usedStorageMB, 4.0);
+    EXPECT_DOUBLE_EQ(network.getDomainSummary("").usedStorageMB, 4.0);
+    const CapacityTotals totals = network.getCapacityTotals();
+    EXPECT_EQ(totals.storageCount, 301u);
+    EXPECT_DOUBLE_EQ(totals.usedMB, 4.0);
+
+    network.removeEntity("accounting_storage", "accounting_admin");
+    *storage -= 4.0;
+    EXPECT_DOUBLE_EQ(network.getCapacityTotals().usedMB, 0.0);
+    EXPECT_DOUBLE_EQ(network.getDomainSummary("").usedStorageMB, 0.0);
+}
+
 /** @} */ // Конец группы corporate_network_tests
\ No newline at end of file
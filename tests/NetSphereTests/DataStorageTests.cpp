@@ -5,6 +5,10 @@
 
 #include <gtest/gtest.h>
 #include "DataStorage.h"
+#include "NetworkExceptions.h"
+#include <atomic>
+#include <thread>
+#include <vector>
 
  /**
   * @defgroup storage_tests Тесты хранилища
@@ -114,4 +118,58 @@ TEST(DataStorageTest, PrintInfoNoCrash) {
     EXPECT_NO_THROW(storage.printInfo());
 }
 
+// Тест учёта в байтах: дробные мегабайты складываются без накопления ошибки
+TEST(DataStorageTest, ByteAccountingHasNoDrift) {
+    DataStorage storage("test08", "00:1A:2B:3C:4D:68", 1.0);
+
+    for (int i = 0; i < 10; ++i) {
+        storage.reserveBytes(DataStorage::BYTES_PER_MB / 10);
+    }
+    EXPECT_EQ(storage.getUsedBytes(), DataStorage::BYTES_PER_MB / 10 * 10);
+    for (int i = 0; i < 10; ++i) {
+        storage.releaseBytes(DataStorage::BYTES_PER_MB / 10);
+    }
+    EXPECT_EQ(storage.getUsedBytes(), 0u);
+    EXPECT_EQ(storage.getUsedSize(), 0.0);
+
+    storage += 0.25;
+    EXPECT_EQ(storage.getUsedBytes(), DataStorage::BYTES_PER_MB / 4);
+    EXPECT_THROW(storage.reserveBytes(0), DeviceOperationException);
+    EXPECT_THROW(storage.releaseBytes(DataStorage::BYTES_PER_MB), DeviceOperationException);
+}
+
+// Тест одновременного резервирования: хранилище заполняется ровно до общего объёма
+TEST(DataStorageTest, ConcurrentReservationsNeverOvercommit) {
+    constexpr int THREAD_COUNT = 8;
+    DataStorage storage("test09", "00:1A:2B:3C:4D:69", 100.0);
+
+    std::atomic<uint64_t> reserved{ 0 };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREAD_COUNT; ++t) {
+        threads.emplace_back([&] {
+            // Каждый поток занимает по 1 МБ, пока хранилище не откажет, затем освобождает половину
+            uint64_t own = 0;
+            try {
+                for (;;) {
+                    storage += 1.0;
+                    own += DataStorage::BYTES_PER_MB;
+                }
+            }
+            catch (const DeviceOperationException&) {
+            }
+            for (uint64_t i = 0; i < own / DataStorage::BYTES_PER_MB / 2; ++i) {
+                storage -= 1.0;
+                own -= DataStorage::BYTES_PER_MB;
+            }
+            reserved += own;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(storage.getUsedBytes(), reserved.load());
+    EXPECT_LE(storage.getUsedBytes(), storage.getTotalBytes());
+}
+
 /** @} */ // Конец группы storage_tests
\ No newline at end of file
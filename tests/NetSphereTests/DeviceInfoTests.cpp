@@ -0,0 +1,82 @@
+﻿/**
+ * @file DeviceInfoTests.cpp
+ * @brief Тесты заполнения сведений о сущности для C API.
+ */
+
+#include <gtest/gtest.h>
+#include "DeviceInfo.h"
+#include "CorporateNetwork.h"
+#include "DataStorage.h"
+#include "Workstation.h"
+#include "Printer.h"
+#include <cstddef>
+#include <cstring>
+
+ /**
+  * @defgroup device_info_tests Тесты сведений о сущности
+  * @brief Тесты для проверки fillDeviceInfo и раскладки DeviceInfo
+  * @{
+  */
+
+/**
+ * @brief Тест раскладки структуры, ожидаемой python/corporate_network.py.
+ */
+TEST(DeviceInfoTest, LayoutMatchesPythonStructure) {
+    EXPECT_EQ(offsetof(DeviceInfo, id), 0u);
+    EXPECT_EQ(offsetof(DeviceInfo, mac), 256u);
+    EXPECT_EQ(offsetof(DeviceInfo, type), 512u);
+    EXPECT_EQ(offsetof(DeviceInfo, data), 516u);
+    EXPECT_EQ(sizeof(DeviceInfo), 772u);
+}
+
+/**
+ * @brief Тест заполнения сведений о хранилище и рабочей станции.
+ */
+TEST(DeviceInfoTest, FillsTypeSpecificData) {
+    DataStorage storage("info_storage", "00:1a:2b:3c:4d:5e", 1000);
+    storage += 250;
+    storage.addTrustedUser("alice");
+    DeviceInfo info;
+    fillDeviceInfo(storage, info);
+
+    EXPECT_STREQ(info.id, "info_storage");
+    EXPECT_STREQ(info.mac, "00:1A:2B:3C:4D:5E");
+    EXPECT_EQ(info.type, DEVICE_INFO_DATA_STORAGE);
+    StorageInfoData storageData;
+    std::memcpy(&storageData, info.data, sizeof(storageData));
+    EXPECT_DOUBLE_EQ(storageData.total_mb, 1000);
+    EXPECT_DOUBLE_EQ(storageData.used_mb, 250);
+    EXPECT_EQ(storageData.trusted_user_count, 1u);
+
+    Workstation workstation("info_ws", "00:11:22:33:44:55", "carol", 1700000000);
+    fillDeviceInfo(workstation, info);
+    EXPECT_EQ(info.type, DEVICE_INFO_WORKSTATION);
+    WorkstationInfoData workstationData;
+    std::memcpy(&workstationData, info.data, sizeof(workstationData));
+    EXPECT_EQ(workstationData.power_on_time, 1700000000);
+    EXPECT_STREQ(workstationData.user_id, "carol");
+}
+
+/**
+ * @brief Тест сведений о домене и принтере, найденных через withEntity.
+ */
+TEST(DeviceInfoTest, FillsDomainAndPrinterThroughNetwork) {
+    CorporateNetwork network("admin");
+    network.addEntityToDomain("", std::make_shared<Domain>("info_office", "office_admin"), "admin");
+    network.addEntityToDomain("info_office", std::make_shared<Printer>("info_printer", "00:11:22:33:44:55"), "office_admin");
+
+    DeviceInfo info;
+    ASSERT_TRUE(network.withEntity("info_office", [&info](const NetworkEntity& entity) { fillDeviceInfo(entity, info); }));
+    EXPECT_EQ(info.type, DEVICE_INFO_DOMAIN);
+    EXPECT_STREQ(info.mac, "");
+    DomainInfoData domainData;
+    std::memcpy(&domainData, info.data, sizeof(domainData));
+    EXPECT_EQ(domainData.child_count, 1u);
+    EXPECT_STREQ(domainData.admin_id, "office_admin");
+
+    ASSERT_TRUE(network.withEntity("info_printer", [&info](const NetworkEntity& entity) { fillDeviceInfo(entity, info); }));
+    EXPECT_EQ(info.type, DEVICE_INFO_PRINTER);
+    EXPECT_STREQ(info.id, "info_printer");
+}
+
+/** @} */ // Конец группы device_info_tests
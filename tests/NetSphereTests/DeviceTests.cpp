@@ -7,6 +7,7 @@
 #include "DataStorage.h"
 #include "Workstation.h"
 #include "Printer.h"
+#include "Domain.h"
 #include "NetworkExceptions.h"
 
  /**
@@ -56,4 +57,42 @@ TEST(DeviceTest, InvalidCharactersInDeviceId) {
     );
 }
 
+// Тест вида сущности и его соответствия getType()
+TEST(DeviceTest, EntityKind) {
+    DataStorage storage("kind_storage", "00:1A:2B:3C:4D:5E", 1000.0);
+    Workstation workstation("kind_ws", "00:1A:2B:3C:4D:5F", "user", 0);
+    Printer printer("kind_printer", "00:1A:2B:3C:4D:60");
+    Domain domain("kind_domain", "admin");
+
+    EXPECT_EQ(storage.kind(), EntityKind::DataStorage);
+    EXPECT_EQ(workstation.kind(), EntityKind::Workstation);
+    EXPECT_EQ(printer.kind(), EntityKind::Printer);
+    EXPECT_EQ(domain.kind(), EntityKind::Domain);
+
+    for (const NetworkEntity* entity : { static_cast<const NetworkEntity*>(&storage),
+        static_cast<const NetworkEntity*>(&workstation), static_cast<const NetworkEntity*>(&printer),
+        static_cast<const NetworkEntity*>(&domain) }) {
+        EXPECT_EQ(entity->getType(), entityKindName(entity->kind()));
+    }
+}
+
+// Тест проверенного приведения сущностей
+TEST(DeviceTest, CheckedEntityCast) {
+    std::shared_ptr<NetworkEntity> storage = std::make_shared<DataStorage>("cast_storage", "00:1A:2B:3C:4D:61", 1000.0);
+    std::shared_ptr<NetworkEntity> domain = std::make_shared<Domain>("cast_domain", "admin");
+
+    EXPECT_NE(entityCast<DataStorage>(storage), nullptr);
+    EXPECT_NE(entityCast<Device>(storage), nullptr);
+    EXPECT_EQ(entityCast<Workstation>(storage), nullptr);
+    EXPECT_EQ(entityCast<Domain>(storage), nullptr);
+
+    EXPECT_EQ(entityCast<Domain>(domain.get()), domain.get());
+    EXPECT_EQ(entityCast<Device>(domain.get()), nullptr);
+    EXPECT_TRUE(isEntityOf<Domain>(*domain));
+    EXPECT_FALSE(isEntityOf<Printer>(*storage));
+
+    std::shared_ptr<NetworkEntity> empty;
+    EXPECT_EQ(entityCast<Domain>(empty), nullptr);
+}
+
 /** @} */ // Конец группы device_tests
\ No newline at end of file
@@ -106,4 +106,23 @@ TEST(DomainErrorTest, FindEntityWithEmptyId) {
     EXPECT_EQ(entity, nullptr);
 }
 
+// Тест атомарности пакетного добавления при дубликате внутри пакета
+TEST(DomainErrorTest, AddEntitiesBatchIsAllOrNothing) {
+    Domain domain("test_domain", "admin");
+    std::vector<std::shared_ptr<NetworkEntity>> batch{
+        std::make_shared<DataStorage>("storage_a", "00:1A:2B:3C:4D:62", 1000.0),
+        std::make_shared<DataStorage>("storage_a", "00:1A:2B:3C:4D:63", 1000.0)
+    };
+
+    EXPECT_THROW(domain.addEntities(batch, "admin"), DomainOperationException);
+    EXPECT_EQ(domain.getEntityCount(), 0);
+
+    std::vector<std::shared_ptr<NetworkEntity>> withNull{ batch[0], nullptr };
+    EXPECT_THROW(domain.addEntities(withNull, "admin"), ValidationException);
+    EXPECT_EQ(domain.getEntityCount(), 0);
+
+    EXPECT_THROW(domain.addEntities(std::span(batch).first(1), "hacker"), AccessDeniedException);
+    EXPECT_EQ(domain.getEntityCount(), 0);
+}
+
 /** @} */ // Конец группы domain_error_tests
\ No newline at end of file
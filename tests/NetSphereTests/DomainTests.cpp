@@ -8,6 +8,9 @@
 #include "DataStorage.h"
 #include "Workstation.h"
 #include "Printer.h"
+#include <atomic>
+#include <thread>
+#include <vector>
 
  /**
   * @defgroup domain_tests Тесты домена
@@ -92,6 +95,103 @@ TEST(DomainTest, GetAllEntities) {
     EXPECT_NE(allEntities.find("storage1"), allEntities.end());
 }
 
+// Тест пакетного добавления сущностей
+TEST(DomainTest, AddEntitiesBatch) {
+    Domain domain("test_domain", "admin");
+    std::vector<std::shared_ptr<NetworkEntity>> batch{
+        std::make_shared<DataStorage>("batch_storage", "00:1A:2B:3C:4D:64", 1000.0),
+        std::make_shared<Printer>("batch_printer", "00:1A:2B:3C:4D:65"),
+        std::make_shared<Domain>("batch_domain", "sub_admin")
+    };
+
+    domain.addEntities(batch, "admin");
+    EXPECT_EQ(domain.getEntityCount(), 3);
+    EXPECT_EQ(domain.findEntity("batch_printer"), batch[1]);
+}
+
+// Тест сводки по поддереву: вклад вложенных доменов, удаление и изменение объёма
+TEST(DomainTest, SubtreeSummaryRollsUpToAncestors) {
+    Domain root("root", "admin");
+    auto branch = std::make_shared<Domain>("branch", "branch_admin");
+    auto storage = std::make_shared<DataStorage>("summary_storage", "00:1A:2B:3C:4D:66", 500.0);
+    branch->addEntity(storage, "branch_admin");
+    branch->addEntity(std::make_shared<Workstation>("summary_ws", "00:1A:2B:3C:4D:67", "user", 0), "branch_admin");
+    root.addEntity(branch, "admin");
+    root.addEntity(std::make_shared<Printer>("summary_printer", "00:1A:2B:3C:4D:68"), "admin");
+
+    DomainSummary summary = root.getSubtreeSummary();
+    EXPECT_EQ(summary.count(EntityKind::Domain), 1);
+    EXPECT_EQ(summary.count(EntityKind::DataStorage), 1);
+    EXPECT_EQ(summary.count(EntityKind::Workstation), 1);
+    EXPECT_EQ(summary.count(EntityKind::Printer), 1);
+    EXPECT_EQ(summary.entityCount(), 4);
+    EXPECT_DOUBLE_EQ(summary.totalStorageMB, 500.0);
+    EXPECT_EQ(storage->getOwnerDomain(), branch.get());
+    EXPECT_EQ(branch->getOwnerDomain(), &root);
+
+    // Изменение объёма поднимается от хранилища ко всем предкам
+    *storage += 120.0;
+    EXPECT_DOUBLE_EQ(branch->getSubtreeSummary().usedStorageMB, 120.0);
+    EXPECT_DOUBLE_EQ(root.getSubtreeSummary().usedStorageMB, 120.0);
+
+    // Добавление в уже вложенный домен также учитывается предками
+    branch->addEntity(std::make_shared<Printer>("summary_printer_2", "00:1A:2B:3C:4D:69"), "branch_admin");
+    EXPECT_EQ(root.getSubtreeSummary().count(EntityKind::Printer), 2);
+
+    root.removeEntity("branch", "admin");
+    summary = root.getSubtreeSummary();
+    EXPECT_EQ(summary.entityCount(), 1);
+    EXPECT_DOUBLE_EQ(summary.totalStorageMB, 0.0);
+    EXPECT_DOUBLE_EQ(summary.usedStorageMB, 0.0);
+    EXPECT_EQ(branch->getOwnerDomain(), nullptr);
+
+    // Отсоединённое поддерево продолжает вести свою сводку
+    *storage -= 20.0;
+    EXPECT_DOUBLE_EQ(branch->getSubtreeSummary().usedStorageMB, 100.0);
+    EXPECT_DOUBLE_EQ(root.getSubtreeSummary().usedStorageMB, 0.0);
+}
+
+// Тест сводок при изменении объёма хранилищ из других потоков во время
+// отсоединения и повторного присоединения поддерева и уничтожения домена
+TEST(DomainTest, SubtreeUsageConvergesUnderConcurrentDetach) {
+    Domain root("usage_root", "admin");
+    auto branch = std::make_shared<Domain>("usage_branch", "branch_admin");
+    auto storage = std::make_shared<DataStorage>("usage_storage", "00:1A:2B:3C:4D:71", 1000.0);
+    branch->addEntity(storage, "branch_admin");
+    root.addEntity(branch, "admin");
+
+    std::atomic<bool> stop{ false };
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 2; ++t) {
+        writers.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                *storage += 0.5;
+                *storage -= 0.5;
+            }
+            *storage += 1.5;
+        });
+    }
+    for (int i = 0; i < 300; ++i) {
+        root.removeEntity("usage_branch", "admin");
+        root.addEntity(branch, "admin");
+        auto temporary = std::make_shared<Domain>("usage_temporary", "temporary_admin");
+        branch->removeEntity("usage_storage", "branch_admin");
+        temporary->addEntity(storage, "temporary_admin");
+        temporary.reset();
+        branch->addEntity(storage, "branch_admin");
+    }
+    stop.store(true, std::memory_order_relaxed);
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    EXPECT_DOUBLE_EQ(storage->getUsedSize(), 3.0);
+    EXPECT_DOUBLE_EQ(branch->getSubtreeSummary().usedStorageMB, 3.0);
+    EXPECT_DOUBLE_EQ(root.getSubtreeSummary().usedStorageMB, 3.0);
+    root.removeEntity("usage_branch", "admin");
+    EXPECT_DOUBLE_EQ(root.getSubtreeSummary().usedStorageMB, 0.0);
+}
+
 // Тест методов printInfo
 TEST(DomainTest, PrintInfoMethods) {
     Domain domain("test_domain", "admin");
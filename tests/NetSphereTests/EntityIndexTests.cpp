@@ -0,0 +1,214 @@
+﻿/**
+ * @file EntityIndexTests.cpp
+ * @brief Тесты для класса EntityIndex и чтения сети без блокировок.
+ */
+
+#include <gtest/gtest.h>
+#include "CorporateNetwork.h"
+#include "EntityIndex.h"
+#include "Printer.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+ /**
+  * @defgroup entity_index_tests Тесты индекса сущностей
+  * @brief Тесты для проверки EntityIndex, EpochManager и конкурентного поиска в CorporateNetwork
+  * @{
+  */
+
+namespace {
+
+    std::shared_ptr<Printer> makePrinter(const std::string& id, uint64_t mac) {
+        return std::make_shared<Printer>(id, MacAddress::fromUInt64(mac).toString());
+    }
+
+}
+
+/**
+ * @brief Тест добавления, замены и удаления записей с расширением таблицы.
+ */
+TEST(EntityIndexTest, AssignFindEraseAcrossGrowth) {
+    EntityIndex index;
+    auto owner = std::make_shared<Domain>("index_owner", "admin");
+    for (uint64_t i = 0; i < 1000; ++i) {
+        index.assign(makePrinter("index_printer_" + std::to_string(i), i), owner);
+    }
+    EXPECT_EQ(index.size(), 1000);
+
+    for (uint64_t i = 0; i < 1000; i += 2) {
+        EXPECT_TRUE(index.erase("index_printer_" + std::to_string(i)));
+    }
+    EXPECT_FALSE(index.erase("index_printer_0"));
+    EXPECT_EQ(index.size(), 500);
+
+    auto replacement = makePrinter("index_printer_1", 5000);
+    index.assign(replacement, nullptr);
+    EXPECT_EQ(index.size(), 500);
+
+    const EntityIndexEntry* entry = index.find("index_printer_1");
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->entity, replacement);
+    EXPECT_EQ(entry->parent, nullptr);
+    EXPECT_EQ(index.find("index_printer_2"), nullptr);
+    EXPECT_NE(index.find("index_printer_999"), nullptr);
+    EpochManager::instance().collect();
+}
+
+/**
+ * @brief Тест отложенного освобождения: удалённая запись живёт, пока её может видеть читатель.
+ */
+TEST(EntityIndexTest, RetiredEntryOutlivesActiveReader) {
+    EntityIndex index;
+    auto printer = makePrinter("retired_printer", 1);
+    std::weak_ptr<Printer> weakPrinter = printer;
+    index.assign(std::move(printer), nullptr);
+
+    {
+        EpochGuard guard;
+        const EntityIndexEntry* entry = index.find("retired_printer");
+        ASSERT_NE(entry, nullptr);
+
+        std::thread writer([&index] {
+            index.erase("retired_printer");
+            EpochManager::instance().collect();
+        });
+        writer.join();
+
+        // Запись уже удалена из индекса, но ещё не освобождена
+        EXPECT_EQ(index.find("retired_printer"), nullptr);
+        EXPECT_EQ(entry->id, "retired_printer");
+        EXPECT_FALSE(weakPrinter.expired());
+    }
+
+    EpochManager::instance().collect();
+    EXPECT_TRUE(weakPrinter.expired());
+}
+
+/**
+ * @brief Тест ожидания секций чтения: synchronize возвращается только после выхода читателя.
+ */
+TEST(EntityIndexTest, SynchronizeWaitsForEarlierReaders) {
+    std::atomic<bool> entered{ false };
+    std::atomic<bool> release{ false };
+    std::atomic<bool> readerDone{ false };
+    std::thread reader([&] {
+        EpochGuard guard;
+        entered.store(true);
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+        readerDone.store(true);
+    });
+    while (!entered.load()) {
+        std::this_thread::yield();
+    }
+
+    std::atomic<bool> synchronized{ false };
+    std::thread writer([&] {
+        EpochManager::instance().synchronize();
+        synchronized.store(true);
+        EXPECT_TRUE(readerDone.load());
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(synchronized.load());
+    release.store(true);
+    writer.join();
+    reader.join();
+    EXPECT_TRUE(synchronized.load());
+
+    // Собственная секция вызывающего потока не ожидается
+    EpochGuard guard;
+    EpochManager::instance().synchronize();
+}
+
+/**
+ * @brief Тест параллельных вставок разных идентификаторов с расширением шардов.
+ */
+TEST(EntityIndexTest, ConcurrentInsertsAcrossShards) {
+    EntityIndex index;
+    constexpr uint64_t PER_THREAD = 2000;
+    constexpr int THREADS = 4;
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < THREADS; ++t) {
+        writers.emplace_back([&index, t] {
+            for (uint64_t i = 0; i < PER_THREAD; ++i) {
+                const uint64_t key = t * PER_THREAD + i;
+                index.insert(makePrinter("sharded_" + std::to_string(key), key), nullptr);
+                EpochGuard guard;
+                if (!index.find("sharded_" + std::to_string(key))) {
+                    ADD_FAILURE() << "Вставленная запись не найдена";
+                }
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    EXPECT_EQ(index.size(), THREADS * PER_THREAD);
+    EXPECT_FALSE(index.insert(makePrinter("sharded_0", 0), nullptr));
+    size_t visited = 0;
+    index.forEach([&visited](const EntityIndexEntry&) { ++visited; });
+    EXPECT_EQ(visited, THREADS * PER_THREAD);
+}
+
+/**
+ * @brief Тест поиска из нескольких потоков во время добавления и удаления сущностей.
+ */
+TEST(EntityIndexTest, ConcurrentReadersDuringMutation) {
+    CorporateNetwork network("admin");
+    network.addEntityToDomain("", std::make_shared<Domain>("stable_domain", "stable_admin"), "admin");
+    constexpr uint64_t STABLE_COUNT = 64;
+    for (uint64_t i = 0; i < STABLE_COUNT; ++i) {
+        network.addEntityToDomain("stable_domain", makePrinter("stable_" + std::to_string(i), i), "stable_admin");
+    }
+
+    std::atomic<bool> done{ false };
+    std::atomic<size_t> failures{ 0 };
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&] {
+            while (!done.load(std::memory_order_acquire)) {
+                for (uint64_t i = 0; i < STABLE_COUNT; ++i) {
+                    const std::string id = "stable_" + std::to_string(i);
+                    auto entity = network.findEntity(id);
+                    auto parent = network.getParentDomain(id);
+                    if (!entity || entity->getId() != id || !parent || parent->getId() != "stable_domain") {
+                        failures.fetch_add(1);
+                    }
+                    const bool visited = network.withEntity(id, [&](const NetworkEntity& found) {
+                        if (found.getId() != id) {
+                            failures.fetch_add(1);
+                        }
+                    });
+                    if (!visited) {
+                        failures.fetch_add(1);
+                    }
+                }
+                // Временные сущности могут как присутствовать, так и отсутствовать
+                network.findEntity("churn_domain");
+            }
+        });
+    }
+
+    for (uint64_t round = 0; round < 200; ++round) {
+        network.addEntityToDomain("", std::make_shared<Domain>("churn_domain", "churn_admin"), "admin");
+        for (uint64_t i = 0; i < 20; ++i) {
+            network.addEntityToDomain("churn_domain", makePrinter("churn_" + std::to_string(i), 1000 + i), "churn_admin");
+        }
+        network.removeEntity("churn_domain", "admin");
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_EQ(network.findEntity("churn_0"), nullptr);
+    EXPECT_NE(network.findDomain("stable_domain"), nullptr);
+}
+
+/** @} */ // Конец группы entity_index_tests
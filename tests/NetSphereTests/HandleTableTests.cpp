@@ -0,0 +1,115 @@
+﻿/**
+ * @file HandleTableTests.cpp
+ * @brief Тесты для шаблона HandleTable проекта NetSphere.
+ */
+
+#include <gtest/gtest.h>
+#include "HandleTable.h"
+#include "CorporateNetwork.h"
+#include "Printer.h"
+#include <thread>
+#include <vector>
+
+ /**
+  * @defgroup handle_table_tests Тесты таблицы дескрипторов
+  * @brief Тесты для проверки выдачи, проверки и освобождения дескрипторов
+  * @{
+  */
+
+/**
+ * @brief Тест выдачи и разыменования дескриптора.
+ */
+TEST(HandleTableTest, InsertAndGet) {
+    HandleTable<NetworkEntity> table(2);
+    auto printer = std::make_shared<Printer>("handle_printer", "00:11:22:33:44:55");
+    const auto handle = table.insert(printer);
+
+    EXPECT_NE(handle, 0u);
+    EXPECT_EQ(table.get(handle), printer);
+    EXPECT_EQ(table.get(0), nullptr);
+    EXPECT_EQ(table.get(handle + 1), nullptr);
+}
+
+/**
+ * @brief Тест обнаружения устаревшего дескриптора после повторного использования слота.
+ */
+TEST(HandleTableTest, StaleHandleDetected) {
+    HandleTable<NetworkEntity> table(2);
+    auto first = std::make_shared<Printer>("stale_first", "00:11:22:33:44:55");
+    std::weak_ptr<Printer> weakFirst = first;
+    const auto staleHandle = table.insert(std::move(first));
+
+    EXPECT_TRUE(table.erase(staleHandle));
+    EpochManager::instance().collect();
+    EXPECT_TRUE(weakFirst.expired());
+    EXPECT_FALSE(table.erase(staleHandle));
+
+    // Слот используется повторно, но со следующим поколением
+    auto second = std::make_shared<Printer>("stale_second", "00:11:22:33:44:56");
+    const auto freshHandle = table.insert(second);
+    EXPECT_NE(freshHandle, staleHandle);
+    EXPECT_EQ(table.get(staleHandle), nullptr);
+    EXPECT_EQ(table.get(freshHandle), second);
+}
+
+/**
+ * @brief Тест: поколение слота не повторяется и после 2^16 переиспользований.
+ */
+TEST(HandleTableTest, GenerationSurvivesManyReuses) {
+    HandleTable<NetworkEntity> table(2);
+    auto printer = std::make_shared<Printer>("reused_printer", "00:11:22:33:44:55");
+    const auto firstHandle = table.insert(printer);
+    ASSERT_TRUE(table.erase(firstHandle));
+
+    constexpr int REUSES = (1 << 16) + 16;
+    for (int i = 0; i < REUSES; ++i) {
+        const auto handle = table.insert(printer);
+        EXPECT_NE(handle, firstHandle);
+        ASSERT_TRUE(table.erase(handle));
+    }
+    const auto lastHandle = table.insert(printer);
+    EXPECT_EQ(table.get(firstHandle), nullptr);
+    EXPECT_EQ(table.get(lastHandle), printer);
+}
+
+/**
+ * @brief Тест: дескриптор одной таблицы не принимается другой таблицей.
+ */
+TEST(HandleTableTest, ForeignHandleRejected) {
+    HandleTable<CorporateNetwork> networks(1);
+    HandleTable<NetworkEntity> devices(2);
+    const auto networkHandle = networks.insert(std::make_shared<CorporateNetwork>("admin"));
+    devices.insert(std::make_shared<Printer>("foreign_printer", "00:11:22:33:44:55"));
+
+    EXPECT_EQ(devices.get(networkHandle), nullptr);
+    EXPECT_FALSE(devices.erase(networkHandle));
+    EXPECT_NE(networks.get(networkHandle), nullptr);
+}
+
+/**
+ * @brief Тест параллельной проверки дескрипторов во время выдачи и освобождения других.
+ */
+TEST(HandleTableTest, ConcurrentGetDuringChurn) {
+    HandleTable<NetworkEntity> table(2);
+    auto stable = std::make_shared<Printer>("stable_handle", "00:11:22:33:44:55");
+    const auto stableHandle = table.insert(stable);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&table, &stable, stableHandle, t] {
+            for (int i = 0; i < 2000; ++i) {
+                const auto handle = table.insert(std::make_shared<Printer>(
+                    "churn_handle_" + std::to_string(t), MacAddress::fromUInt64(i).toString()));
+                EXPECT_EQ(table.get(stableHandle), stable);
+                EXPECT_TRUE(table.erase(handle));
+                EXPECT_EQ(table.get(handle), nullptr);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(table.get(stableHandle), stable);
+}
+
+/** @} */ // Конец группы handle_table_tests
@@ -0,0 +1,183 @@
+﻿/**
+ * @file InventoryLoaderTests.cpp
+ * @brief Тесты для класса InventoryLoader проекта NetSphere.
+ */
+
+#include <gtest/gtest.h>
+#include "InventoryLoader.h"
+#include "DataStorage.h"
+#include "Workstation.h"
+#include "Printer.h"
+#include <sstream>
+
+ /**
+  * @defgroup inventory_loader_tests Тесты загрузчика инвентаря
+  * @brief Тесты для проверки функциональности InventoryLoader
+  * @{
+  */
+
+  // Тест загрузки CSV со всеми типами сущностей
+TEST(InventoryLoaderTest, LoadCsv) {
+    CorporateNetwork network("admin");
+    std::istringstream input(
+        "type,id,parent,admin,mac,total_mb,used_mb,trusted_users,user,power_on\n"
+        "Domain,inv_office,,office_admin,,,,,,\n"
+        "DataStorage,inv_storage,inv_office,,00:11:22:33:44:55,1000,250,\"alice;bob\",,\n"
+        "Workstation,inv_ws,inv_office,,00:11:22:33:44:56,,,,carol,1700000000\n"
+        "Printer,inv_printer,,,00-11-22-33-44-57,,,,,\n");
+
+    InventoryLoader loader(network);
+    InventoryLoadReport report = loader.load(input);
+
+    EXPECT_EQ(report.linesRead, 4);
+    EXPECT_EQ(report.entitiesLoaded, 4);
+    EXPECT_EQ(report.errorCount, 0);
+
+    auto storage = entityCast<DataStorage>(network.findEntity("inv_storage"));
+    ASSERT_NE(storage, nullptr);
+    EXPECT_DOUBLE_EQ(storage->getTotalSize(), 1000);
+    EXPECT_DOUBLE_EQ(storage->getUsedSize(), 250);
+    EXPECT_TRUE(storage->isUserTrusted("alice"));
+    EXPECT_TRUE(storage->isUserTrusted("bob"));
+    EXPECT_EQ(network.getParentDomain("inv_storage")->getId(), "inv_office");
+
+    auto workstation = entityCast<Workstation>(network.findEntity("inv_ws"));
+    ASSERT_NE(workstation, nullptr);
+    EXPECT_EQ(workstation->getUserId(), "carol");
+    EXPECT_EQ(workstation->getLastPowerOnTime(), 1700000000);
+
+    EXPECT_EQ(network.getParentDomain("inv_printer"), network.getRootDomain());
+}
+
+// Тест загрузки JSON Lines
+TEST(InventoryLoaderTest, LoadJsonLines) {
+    CorporateNetwork network("admin");
+    std::istringstream input(
+        "{\"type\": \"Domain\", \"id\": \"json_office\", \"admin\": \"json_admin\"}\n"
+        "{\"type\": \"DataStorage\", \"id\": \"json_storage\", \"parent\": \"json_office\", "
+        "\"mac\": \"AA:BB:CC:DD:EE:01\", \"total_mb\": 512, \"trusted_users\": [\"dave\", \"erin\"]}\n"
+        "\n"
+        "{\"type\": \"Printer\", \"id\": \"json_printer\", \"parent\": null, \"mac\": \"AA:BB:CC:DD:EE:02\"}\n");
+
+    InventoryLoadOptions options;
+    options.format = InventoryFormat::JsonLines;
+    InventoryLoadReport report = InventoryLoader(network, options).load(input);
+
+    EXPECT_EQ(report.linesRead, 3);
+    EXPECT_EQ(report.entitiesLoaded, 3);
+    EXPECT_EQ(report.errorCount, 0);
+
+    auto storage = entityCast<DataStorage>(network.findEntity("json_storage"));
+    ASSERT_NE(storage, nullptr);
+    EXPECT_DOUBLE_EQ(storage->getTotalSize(), 512);
+    EXPECT_TRUE(storage->isUserTrusted("erin"));
+    EXPECT_EQ(network.getParentDomain("json_storage")->getId(), "json_office");
+    EXPECT_NE(network.findEntity("json_printer"), nullptr);
+}
+
+// Тест загрузки строк, в которых дети идут раньше родителей и в разных блоках
+TEST(InventoryLoaderTest, ChildrenBeforeParentsAcrossChunks) {
+    CorporateNetwork network("admin");
+    std::istringstream input(
+        "type,id,parent,admin,mac\n"
+        "Printer,order_printer,order_inner,,00:00:00:00:00:01\n"
+        "Domain,order_inner,order_outer,inner_admin,\n"
+        "Printer,order_printer2,order_outer,,00:00:00:00:00:02\n"
+        "Domain,order_outer,,outer_admin,\n");
+
+    InventoryLoadOptions options;
+    options.chunkLines = 1;
+    options.threadCount = 2;
+    InventoryLoadReport report = InventoryLoader(network, options).load(input);
+
+    EXPECT_EQ(report.entitiesLoaded, 4);
+    EXPECT_EQ(report.errorCount, 0);
+    EXPECT_EQ(network.getParentDomain("order_printer")->getId(), "order_inner");
+    EXPECT_EQ(network.getParentDomain("order_inner")->getId(), "order_outer");
+}
+
+// Тест ограничения ожидания родителя: строка, не дождавшаяся его, сообщается как ошибка
+TEST(InventoryLoaderTest, ReportsOrphansAfterPendingLimit) {
+    CorporateNetwork network("admin");
+    std::istringstream input(
+        "type,id,parent,admin,mac\n"
+        "Printer,wait_late,wait_late_domain,,00:00:00:00:00:21\n"
+        "Printer,wait_soon,wait_soon_domain,,00:00:00:00:00:22\n"
+        "Domain,wait_soon_domain,,soon_admin,\n"
+        "Printer,wait_filler,,,00:00:00:00:00:23\n"
+        "Domain,wait_late_domain,,late_admin,\n");
+
+    InventoryLoadOptions options;
+    options.chunkLines = 1;
+    options.threadCount = 2;
+    options.maxPendingChunks = 2;
+    InventoryLoadReport report = InventoryLoader(network, options).load(input);
+
+    EXPECT_EQ(report.entitiesLoaded, 4);
+    EXPECT_EQ(report.errorCount, 1);
+    ASSERT_EQ(report.errors.size(), 1);
+    EXPECT_EQ(report.errors[0].line, 2);
+    EXPECT_EQ(network.findEntity("wait_late"), nullptr);
+    EXPECT_EQ(network.getParentDomain("wait_soon")->getId(), "wait_soon_domain");
+    EXPECT_NE(network.findDomain("wait_late_domain"), nullptr);
+}
+
+// Тест построчных ошибок без прерывания загрузки
+TEST(InventoryLoaderTest, ReportsErrorsPerLine) {
+    CorporateNetwork network("admin");
+    std::istringstream input(
+        "type,id,parent,mac,total_mb\n"
+        "Printer,err_ok,,00:00:00:00:00:10\n"
+        "Printer,err_bad_mac,,not-a-mac\n"
+        "DataStorage,err_storage,,00:00:00:00:00:11,many\n"
+        "Printer,err_ok,,00:00:00:00:00:12\n"
+        "Router,err_router,,00:00:00:00:00:13\n"
+        "Printer,err_orphan,missing_domain,00:00:00:00:00:14\n"
+        "Printer,err_ok2,,00:00:00:00:00:15\n");
+
+    InventoryLoadReport report = InventoryLoader(network).load(input);
+
+    EXPECT_EQ(report.linesRead, 7);
+    EXPECT_EQ(report.entitiesLoaded, 2);
+    EXPECT_EQ(report.errorCount, 5);
+    ASSERT_EQ(report.errors.size(), 5);
+    EXPECT_EQ(report.errors[0].line, 3);
+    EXPECT_EQ(report.errors[1].line, 4);
+    EXPECT_EQ(report.errors[2].line, 5);
+    EXPECT_EQ(report.errors[3].line, 6);
+    EXPECT_EQ(report.errors[4].line, 7);
+    EXPECT_NE(network.findEntity("err_ok"), nullptr);
+    EXPECT_NE(network.findEntity("err_ok2"), nullptr);
+}
+
+// Тест ограничения числа сохраняемых сообщений об ошибках
+TEST(InventoryLoaderTest, LimitsReportedErrors) {
+    CorporateNetwork network("admin");
+    std::ostringstream rows;
+    rows << "type,id\n";
+    for (int i = 0; i < 10; ++i) {
+        rows << "Unknown,limit_" << i << "\n";
+    }
+    std::istringstream input(rows.str());
+
+    InventoryLoadOptions options;
+    options.maxReportedErrors = 3;
+    InventoryLoadReport report = InventoryLoader(network, options).load(input);
+
+    EXPECT_EQ(report.errorCount, 10);
+    EXPECT_EQ(report.errors.size(), 3);
+}
+
+// Тест ошибок формата, прерывающих загрузку
+TEST(InventoryLoaderTest, InvalidHeaderAndMissingFile) {
+    CorporateNetwork network("admin");
+    std::istringstream noType("id,parent\nprinter_1,\n");
+    EXPECT_THROW(InventoryLoader(network).load(noType), ValidationException);
+
+    std::istringstream empty("");
+    EXPECT_THROW(InventoryLoader(network).load(empty), ValidationException);
+
+    EXPECT_THROW(InventoryLoader(network).loadFile("no_such_inventory_file.csv"), NetworkException);
+}
+
+/** @} */ // Конец группы inventory_loader_tests
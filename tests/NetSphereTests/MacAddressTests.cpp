@@ -0,0 +1,64 @@
+﻿/**
+ * @file MacAddressTests.cpp
+ * @brief Тесты для класса MacAddress проекта NetSphere.
+ */
+
+#include <gtest/gtest.h>
+#include "MacAddress.h"
+#include "DataStorage.h"
+#include "NetworkExceptions.h"
+#include <unordered_set>
+
+ /**
+  * @defgroup mac_address_tests Тесты MAC-адресов
+  * @brief Тесты для проверки разбора, форматирования и сравнения MacAddress
+  * @{
+  */
+
+  // Тест разбора адреса с двоеточиями
+TEST(MacAddressTest, ParseColonSeparated) {
+    MacAddress mac = MacAddress::parse("00:1A:2B:3C:4D:5E");
+    EXPECT_EQ(mac.toUInt64(), 0x001A2B3C4D5Eull);
+    EXPECT_EQ(mac.toString(), "00:1A:2B:3C:4D:5E");
+}
+
+// Тест разбора адреса с дефисами и в нижнем регистре
+TEST(MacAddressTest, ParseDashSeparatedLowercase) {
+    MacAddress mac = MacAddress::parse("aa-bb-cc-dd-ee-ff");
+    EXPECT_EQ(mac.toUInt64(), 0xAABBCCDDEEFFull);
+    EXPECT_EQ(mac.toString(), "AA:BB:CC:DD:EE:FF");
+    EXPECT_EQ(mac, MacAddress::parse("AA:BB:CC:DD:EE:FF"));
+}
+
+// Тест отклонения невалидных строк
+TEST(MacAddressTest, RejectsInvalidText) {
+    MacAddress mac;
+    EXPECT_FALSE(MacAddress::tryParse("", mac));
+    EXPECT_FALSE(MacAddress::tryParse("invalid_mac", mac));
+    EXPECT_FALSE(MacAddress::tryParse("00:1A:2B:3C:4D", mac));
+    EXPECT_FALSE(MacAddress::tryParse("00:1A:2B:3C:4D:5E:6F", mac));
+    EXPECT_FALSE(MacAddress::tryParse("00:1A:2B:3C:4D:5G", mac));
+    EXPECT_FALSE(MacAddress::tryParse("00.1A.2B.3C.4D.5E", mac));
+    EXPECT_FALSE(MacAddress::tryParse("001A2B3C4D5E", mac));
+    EXPECT_THROW(MacAddress::parse("00:1A:2B"), ValidationException);
+}
+
+// Тест сравнения и хеширования
+TEST(MacAddressTest, OrderingAndHashing) {
+    MacAddress low = MacAddress::fromUInt64(0x000000000001ull);
+    MacAddress high = MacAddress::fromUInt64(0xFF0000000000ull);
+    EXPECT_LT(low, high);
+    EXPECT_NE(low, high);
+
+    std::unordered_set<MacAddress> macs{ low, high, MacAddress::parse("00-00-00-00-00-01") };
+    EXPECT_EQ(macs.size(), 2);
+}
+
+// Тест хранения упакованного адреса в устройстве
+TEST(MacAddressTest, DeviceStoresPackedValue) {
+    DataStorage storage("mac_storage", "0a-1b-2c-3d-4e-5f", 1000.0);
+    EXPECT_EQ(storage.getMac().toUInt64(), 0x0A1B2C3D4E5Full);
+    EXPECT_EQ(storage.getMacAddress(), "0A:1B:2C:3D:4E:5F");
+}
+
+/** @} */ // Конец группы mac_address_tests
@@ -0,0 +1,200 @@
+﻿/**
+ * @file MutationJournalTests.cpp
+ * @brief Тесты для класса MutationJournal проекта NetSphere.
+ */
+
+#include <gtest/gtest.h>
+#include "MutationJournal.h"
+#include "DataStorage.h"
+#include "Workstation.h"
+#include "Printer.h"
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+ /**
+  * @defgroup mutation_journal_tests Тесты журнала изменений
+  * @brief Тесты для проверки функциональности MutationJournal
+  * @{
+  */
+
+namespace {
+
+    std::string journalPath(const std::string& name) {
+        auto path = std::filesystem::temp_directory_path() / ("netsphere_" + name + ".journal");
+        std::filesystem::remove(path);
+        return path.string();
+    }
+
+    // Выполняет по одному изменению каждого журналируемого вида
+    void applySampleMutations(CorporateNetwork& network) {
+        network.addEntityToDomain("", std::make_shared<Domain>("wal_office", "office_admin"), "admin");
+        auto storage = std::make_shared<DataStorage>("wal_storage", "00:11:22:33:44:55", 1000);
+        storage->addTrustedUser("alice");
+        network.addEntityToDomain("wal_office", storage, "office_admin");
+        network.addEntityToDomain("wal_office",
+            std::make_shared<Workstation>("wal_ws", "00:11:22:33:44:56", "carol", 100), "office_admin");
+        network.addEntityToDomain("", std::make_shared<Printer>("wal_printer", "00:11:22:33:44:57"), "admin");
+
+        *storage += 300;
+        *storage -= 50;
+        storage->addTrustedUser("bob");
+        storage->removeTrustedUser("alice");
+        entityCast<Workstation>(network.findEntity("wal_ws"))->updatePowerOnTime(1700000000);
+        network.removeEntity("wal_printer", "admin");
+    }
+
+    void expectSampleState(const CorporateNetwork& network) {
+        auto storage = entityCast<DataStorage>(network.findEntity("wal_storage"));
+        ASSERT_NE(storage, nullptr);
+        EXPECT_EQ(network.getParentDomain("wal_storage")->getId(), "wal_office");
+        EXPECT_DOUBLE_EQ(storage->getUsedSize(), 250);
+        EXPECT_TRUE(storage->isUserTrusted("bob"));
+        EXPECT_FALSE(storage->isUserTrusted("alice"));
+        auto workstation = entityCast<Workstation>(network.findEntity("wal_ws"));
+        ASSERT_NE(workstation, nullptr);
+        EXPECT_EQ(workstation->getLastPowerOnTime(), 1700000000);
+        EXPECT_EQ(network.findEntity("wal_printer"), nullptr);
+    }
+
+}
+
+// Тест записи всех видов изменений и их воспроизведения
+TEST(MutationJournalTest, RecordAndReplay) {
+    const std::string path = journalPath("replay");
+    {
+        CorporateNetwork network("admin");
+        MutationJournal journal(path);
+        network.addObserver(&journal);
+        applySampleMutations(network);
+        EXPECT_EQ(journal.getDurableSequence(), 10);
+        network.removeObserver(&journal);
+    }
+
+    CorporateNetwork restored("admin");
+    JournalReplayResult result = MutationJournal::replay(path, restored);
+    EXPECT_EQ(result.recordsApplied, 10);
+    EXPECT_EQ(result.recordsFailed, 0);
+    EXPECT_FALSE(result.truncatedTail);
+    expectSampleState(restored);
+
+    std::filesystem::remove(path);
+}
+
+// Тест отбрасывания недописанного хвоста после сбоя
+TEST(MutationJournalTest, TornTailIsDiscarded) {
+    const std::string path = journalPath("torn");
+    {
+        CorporateNetwork network("admin");
+        MutationJournal journal(path);
+        network.addObserver(&journal);
+        network.addEntityToDomain("", std::make_shared<Printer>("torn_printer", "00:00:00:00:00:01"), "admin");
+        network.removeObserver(&journal);
+    }
+    const auto intactSize = std::filesystem::file_size(path);
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out.write("\x40\x00\x00\x00\x12\x34", 6); // Заголовок записи без тела
+    }
+
+    CorporateNetwork restored("admin");
+    JournalReplayResult result = MutationJournal::replay(path, restored);
+    EXPECT_EQ(result.recordsApplied, 1);
+    EXPECT_TRUE(result.truncatedTail);
+    EXPECT_NE(restored.findEntity("torn_printer"), nullptr);
+
+    MutationJournal reopened(path);
+    EXPECT_EQ(std::filesystem::file_size(path), intactSize);
+
+    std::filesystem::remove(path);
+}
+
+// Тест усечения журнала снимком и восстановления из снимка и журнала
+TEST(MutationJournalTest, CheckpointAndRecover) {
+    const std::string path = journalPath("checkpoint");
+    const std::string snapshot = (std::filesystem::temp_directory_path() / "netsphere_checkpoint.snap").string();
+    std::filesystem::remove(snapshot);
+    {
+        CorporateNetwork network("admin");
+        MutationJournal journal(path, { JournalDurability::Buffered });
+        network.addObserver(&journal);
+        network.addEntityToDomain("", std::make_shared<Domain>("cp_office", "office_admin"), "admin");
+        network.addEntityToDomain("cp_office",
+            std::make_shared<DataStorage>("cp_storage", "00:00:00:00:00:02", 500), "office_admin");
+
+        journal.checkpoint(network, snapshot);
+        EXPECT_EQ(std::filesystem::file_size(path), 16);
+
+        *entityCast<DataStorage>(network.findEntity("cp_storage")) += 125;
+        network.removeObserver(&journal);
+    }
+
+    CorporateNetwork recovered = MutationJournal::recover(snapshot, path, "admin");
+    auto storage = entityCast<DataStorage>(recovered.findEntity("cp_storage"));
+    ASSERT_NE(storage, nullptr);
+    EXPECT_DOUBLE_EQ(storage->getUsedSize(), 125);
+    EXPECT_EQ(recovered.getParentDomain("cp_storage")->getId(), "cp_office");
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(snapshot);
+}
+
+// Тест групповой фиксации при одновременных писателях
+TEST(MutationJournalTest, ConcurrentWritersShareCommits) {
+    constexpr int THREADS = 4;
+    constexpr int UPDATES = 50;
+    const std::string path = journalPath("group");
+    {
+        CorporateNetwork network("admin");
+        std::vector<std::shared_ptr<Workstation>> workstations;
+        for (int i = 0; i < THREADS; ++i) {
+            workstations.push_back(std::make_shared<Workstation>("group_ws_" + std::to_string(i),
+                MacAddress::fromUInt64(i), "user", 0));
+            network.addEntityToDomain("", workstations.back(), "admin");
+        }
+
+        MutationJournal journal(path);
+        network.addObserver(&journal);
+        std::vector<std::thread> writers;
+        for (int i = 0; i < THREADS; ++i) {
+            writers.emplace_back([&, i] {
+                for (int update = 1; update <= UPDATES; ++update) {
+                    workstations[i]->updatePowerOnTime(update);
+                }
+            });
+        }
+        for (auto& writer : writers) {
+            writer.join();
+        }
+        EXPECT_EQ(journal.getDurableSequence(), THREADS * UPDATES);
+        network.removeObserver(&journal);
+    }
+
+    CorporateNetwork restored("admin");
+    for (int i = 0; i < THREADS; ++i) {
+        restored.addEntityToDomain("", std::make_shared<Workstation>("group_ws_" + std::to_string(i),
+            MacAddress::fromUInt64(i), "user", 0), "admin");
+    }
+    JournalReplayResult result = MutationJournal::replay(path, restored);
+    EXPECT_EQ(result.recordsApplied, THREADS * UPDATES);
+    for (int i = 0; i < THREADS; ++i) {
+        EXPECT_EQ(entityCast<Workstation>(restored.findEntity("group_ws_" + std::to_string(i)))->getLastPowerOnTime(), UPDATES);
+    }
+
+    std::filesystem::remove(path);
+}
+
+// Тест отказа открывать файл, не являющийся журналом
+TEST(MutationJournalTest, RejectsForeignFile) {
+    const std::string path = journalPath("foreign");
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "this is not a journal";
+    }
+    EXPECT_THROW(MutationJournal journal(path), ValidationException);
+    CorporateNetwork network("admin");
+    EXPECT_THROW(MutationJournal::replay(path, network), ValidationException);
+    std::filesystem::remove(path);
+}
+
+/** @} */ // Конец группы mutation_journal_tests
@@ -0,0 +1,165 @@
+﻿/**
+ * @file NetworkCursorTests.cpp
+ * @brief Тесты для класса NetworkCursor проекта NetSphere.
+ */
+
+#include <gtest/gtest.h>
+#include "NetworkCursor.h"
+#include "Printer.h"
+#include <set>
+#include <string>
+#include <vector>
+
+ /**
+  * @defgroup network_cursor_tests Тесты курсора перечисления
+  * @brief Тесты для проверки постраничного обхода сети
+  * @{
+  */
+
+namespace {
+
+    // root -> hq -> (lab -> (lab_printer_0..2), hq_printer_0..4), root_printer
+    std::shared_ptr<CorporateNetwork> buildTree() {
+        auto network = std::make_shared<CorporateNetwork>("admin");
+        network->addEntityToDomain("", std::make_shared<Domain>("hq", "hq_admin"), "admin");
+        network->addEntityToDomain("hq", std::make_shared<Domain>("lab", "lab_admin"), "hq_admin");
+        network->addEntityToDomain("", std::make_shared<Printer>("root_printer", "00:00:00:00:00:01"), "admin");
+        for (int i = 0; i < 5; ++i) {
+            network->addEntityToDomain("hq", std::make_shared<Printer>("hq_printer_" + std::to_string(i),
+                MacAddress::fromUInt64(100 + i).toString()), "hq_admin");
+        }
+        for (int i = 0; i < 3; ++i) {
+            network->addEntityToDomain("lab", std::make_shared<Printer>("lab_printer_" + std::to_string(i),
+                MacAddress::fromUInt64(200 + i).toString()), "lab_admin");
+        }
+        return network;
+    }
+
+    std::vector<CursorRecord> drain(NetworkCursor& cursor, size_t pageSize) {
+        std::vector<CursorRecord> all;
+        std::vector<CursorRecord> page(pageSize);
+        while (size_t count = cursor.nextPage(page)) {
+            EXPECT_LE(count, pageSize);
+            all.insert(all.end(), page.begin(), page.begin() + count);
+        }
+        return all;
+    }
+
+    size_t positionOf(const std::vector<CursorRecord>& records, const std::string& id) {
+        for (size_t i = 0; i < records.size(); ++i) {
+            if (id == records[i].id) {
+                return i;
+            }
+        }
+        return records.size();
+    }
+
+}
+
+/**
+ * @brief Тест перечисления непосредственных детей домена страницами.
+ */
+TEST(NetworkCursorTest, ChildrenInPages) {
+    auto network = buildTree();
+    NetworkCursor cursor(network, "hq", CursorOrder::Children);
+    const auto records = drain(cursor, 2);
+
+    ASSERT_EQ(records.size(), 6);
+    std::set<std::string> ids;
+    for (const auto& record : records) {
+        ids.insert(record.id);
+        EXPECT_STREQ(record.parent_id, "hq");
+        EXPECT_EQ(record.depth, 1u);
+    }
+    EXPECT_TRUE(ids.count("lab"));
+    const auto& lab = records[positionOf(records, "lab")];
+    EXPECT_EQ(lab.type, DEVICE_INFO_DOMAIN);
+    EXPECT_EQ(lab.child_count, 3u);
+    EXPECT_EQ(cursor.nextPage(std::span<CursorRecord>()), 0);
+}
+
+/**
+ * @brief Тест обхода в глубину: домен идёт раньше своих детей, поддерево не разрывается.
+ */
+TEST(NetworkCursorTest, DepthFirstSubtree) {
+    auto network = buildTree();
+    NetworkCursor cursor(network, "", CursorOrder::DepthFirst);
+    const auto records = drain(cursor, 3);
+
+    ASSERT_EQ(records.size(), network->getEntityCount() - 1);
+    const size_t lab = positionOf(records, "lab");
+    ASSERT_LT(lab, records.size());
+    EXPECT_LT(positionOf(records, "hq"), lab);
+    for (int i = 0; i < 3; ++i) {
+        const size_t child = positionOf(records, "lab_printer_" + std::to_string(i));
+        EXPECT_GT(child, lab);
+        EXPECT_LE(child, lab + 3);
+        EXPECT_EQ(records[child].depth, 3u);
+    }
+}
+
+/**
+ * @brief Тест обхода в ширину: глубина записей не убывает.
+ */
+TEST(NetworkCursorTest, BreadthFirstByLevels) {
+    auto network = buildTree();
+    NetworkCursor cursor(network, "", CursorOrder::BreadthFirst);
+    const auto records = drain(cursor, 4);
+
+    ASSERT_EQ(records.size(), network->getEntityCount() - 1);
+    for (size_t i = 1; i < records.size(); ++i) {
+        EXPECT_LE(records[i - 1].depth, records[i].depth);
+    }
+}
+
+/**
+ * @brief Тест обнаружения изменения сети после открытия курсора.
+ */
+TEST(NetworkCursorTest, DetectsConcurrentModification) {
+    auto network = buildTree();
+    NetworkCursor cursor(network, "hq", CursorOrder::DepthFirst);
+    std::vector<CursorRecord> page(2);
+    EXPECT_EQ(cursor.nextPage(page), 2);
+
+    network->removeEntity("hq_printer_0", "hq_admin");
+    EXPECT_THROW(cursor.nextPage(page), ConcurrentModificationException);
+    EXPECT_TRUE(cursor.isFinished());
+
+    EXPECT_THROW(NetworkCursor(network, "missing", CursorOrder::Children), DomainOperationException);
+}
+
+/**
+ * @brief Тест: изменения вне перечисляемых доменов не делают курсор недействительным.
+ */
+TEST(NetworkCursorTest, IgnoresChangesOutsideEnumeratedDomains) {
+    auto network = buildTree();
+    NetworkCursor cursor(network, "lab", CursorOrder::Children);
+    std::vector<CursorRecord> page(1);
+    EXPECT_EQ(cursor.nextPage(page), 1);
+
+    network->addEntityToDomain("", std::make_shared<Printer>("outside_printer", "00:00:00:00:01:01"), "admin");
+    network->removeEntity("hq_printer_1", "hq_admin");
+    EXPECT_EQ(drain(cursor, 2).size(), 2);
+}
+
+/**
+ * @brief Тест: прямое изменение домена и перенос предка обнаруживаются.
+ */
+TEST(NetworkCursorTest, DetectsDirectDomainChangesAndDetachedAncestors) {
+    auto network = buildTree();
+    NetworkCursor children(network, "lab", CursorOrder::Children);
+    std::vector<CursorRecord> page(1);
+    EXPECT_EQ(children.nextPage(page), 1);
+    // Изменение в обход CorporateNetwork всё равно меняет версию домена
+    network->findDomain("lab")->addEntity(std::make_shared<Printer>("direct_printer", "00:00:00:00:01:02"), "lab_admin");
+    EXPECT_THROW(children.nextPage(page), ConcurrentModificationException);
+
+    // В ширину: после 9 записей домен hq пройден, а lab ждёт в очереди
+    NetworkCursor levels(network, "", CursorOrder::BreadthFirst);
+    std::vector<CursorRecord> levelPage(9);
+    EXPECT_EQ(levels.nextPage(levelPage), 9);
+    network->removeEntity("hq", "admin");
+    EXPECT_THROW(levels.nextPage(levelPage), ConcurrentModificationException);
+}
+
+/** @} */ // Конец группы network_cursor_tests
@@ -0,0 +1,159 @@
+﻿/**
+ * @file NetworkSnapshotTests.cpp
+ * @brief Тесты для класса NetworkSnapshot проекта NetSphere.
+ */
+
+#include <gtest/gtest.h>
+#include "NetworkSnapshot.h"
+#include "DataStorage.h"
+#include "Workstation.h"
+#include "Printer.h"
+#include <filesystem>
+#include <fstream>
+
+ /**
+  * @defgroup network_snapshot_tests Тесты снимков сети
+  * @brief Тесты для проверки функциональности NetworkSnapshot
+  * @{
+  */
+
+namespace {
+
+    std::string snapshotPath(const std::string& name) {
+        return (std::filesystem::temp_directory_path() / ("netsphere_" + name + ".snap")).string();
+    }
+
+    // Сеть: корень -> snap_office -> snap_lab, устройства на каждом уровне
+    void buildSampleNetwork(CorporateNetwork& network) {
+        network.addEntityToDomain("", std::make_shared<Domain>("snap_office", "office_admin"), "admin");
+        network.addEntityToDomain("snap_office", std::make_shared<Domain>("snap_lab", "lab_admin"), "office_admin");
+
+        auto storage = std::make_shared<DataStorage>("snap_storage", "00:11:22:33:44:55", 2000);
+        *storage += 750;
+        storage->addTrustedUser("alice");
+        storage->addTrustedUser("bob");
+        network.addEntityToDomain("snap_lab", storage, "lab_admin");
+        network.addEntityToDomain("snap_office",
+            std::make_shared<Workstation>("snap_ws", "00:11:22:33:44:56", "carol", 1700000000), "office_admin");
+        network.addEntityToDomain("", std::make_shared<Printer>("snap_printer", "00:11:22:33:44:57"), "admin");
+    }
+
+}
+
+// Тест записи и полного восстановления сети
+TEST(NetworkSnapshotTest, WriteAndRestore) {
+    CorporateNetwork network("admin");
+    buildSampleNetwork(network);
+    const std::string path = snapshotPath("restore");
+    NetworkSnapshot::write(network, path);
+
+    NetworkSnapshot snapshot(path);
+    EXPECT_EQ(snapshot.getEntityCount(), 6);
+
+    CorporateNetwork restored = snapshot.restore();
+    EXPECT_EQ(restored.getRootDomain()->getAdminId(), "admin");
+    EXPECT_EQ(restored.getParentDomain("snap_lab")->getId(), "snap_office");
+    EXPECT_EQ(restored.getParentDomain("snap_storage")->getId(), "snap_lab");
+    EXPECT_EQ(restored.getParentDomain("snap_printer"), restored.getRootDomain());
+    EXPECT_EQ(restored.findDomain("snap_lab")->getAdminId(), "lab_admin");
+
+    auto storage = entityCast<DataStorage>(restored.findEntity("snap_storage"));
+    ASSERT_NE(storage, nullptr);
+    EXPECT_DOUBLE_EQ(storage->getTotalSize(), 2000);
+    EXPECT_DOUBLE_EQ(storage->getUsedSize(), 750);
+    EXPECT_TRUE(storage->isUserTrusted("alice"));
+    EXPECT_TRUE(storage->isUserTrusted("bob"));
+    EXPECT_EQ(storage->getMacAddress(), "00:11:22:33:44:55");
+
+    auto workstation = entityCast<Workstation>(restored.findEntity("snap_ws"));
+    ASSERT_NE(workstation, nullptr);
+    EXPECT_EQ(workstation->getUserId(), "carol");
+    EXPECT_EQ(workstation->getLastPowerOnTime(), 1700000000);
+
+    std::filesystem::remove(path);
+}
+
+// Тест запросов к отображённому снимку без восстановления сети
+TEST(NetworkSnapshotTest, QueryAndMaterialize) {
+    CorporateNetwork network("admin");
+    buildSampleNetwork(network);
+    const std::string path = snapshotPath("query");
+    NetworkSnapshot::write(network, path);
+
+    NetworkSnapshot snapshot(path);
+    auto lab = snapshot.findIndex("snap_lab");
+    ASSERT_TRUE(lab.has_value());
+    EXPECT_EQ(snapshot.getId(*lab), "snap_lab");
+    EXPECT_EQ(snapshot.getKind(*lab), EntityKind::Domain);
+    ASSERT_TRUE(snapshot.getParentIndex(*lab).has_value());
+    EXPECT_EQ(snapshot.getId(*snapshot.getParentIndex(*lab)), "snap_office");
+    EXPECT_FALSE(snapshot.getParentIndex(0).has_value());
+    EXPECT_FALSE(snapshot.findIndex("missing").has_value());
+
+    auto office = entityCast<Domain>(snapshot.materialize("snap_office"));
+    ASSERT_NE(office, nullptr);
+    EXPECT_EQ(office->getEntityCount(), 2);
+    auto labDomain = entityCast<Domain>(office->findEntity("snap_lab"));
+    ASSERT_NE(labDomain, nullptr);
+    EXPECT_NE(labDomain->findEntity("snap_storage"), nullptr);
+    EXPECT_EQ(snapshot.materialize("missing"), nullptr);
+
+    std::filesystem::remove(path);
+}
+
+// Тест отказа открывать повреждённые и отсутствующие файлы
+TEST(NetworkSnapshotTest, RejectsInvalidFiles) {
+    EXPECT_THROW(NetworkSnapshot(snapshotPath("missing_file")), NetworkException);
+
+    const std::string path = snapshotPath("corrupt");
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "definitely not a NetSphere snapshot, but long enough to hold a header......"
+            "..................................................................................";
+    }
+    EXPECT_THROW(NetworkSnapshot snapshot(path), ValidationException);
+
+    CorporateNetwork network("admin");
+    buildSampleNetwork(network);
+    NetworkSnapshot::write(network, path);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+    EXPECT_THROW(NetworkSnapshot snapshot(path), ValidationException);
+
+    std::filesystem::remove(path);
+}
+
+// Тест: потомок внутри границ домена, ссылающийся на другой домен, отклоняется при сборке
+TEST(NetworkSnapshotTest, RejectsChildWithForeignParent) {
+    CorporateNetwork network("admin");
+    buildSampleNetwork(network);
+    const std::string path = snapshotPath("foreign_parent");
+    NetworkSnapshot::write(network, path);
+
+    // snap_storage переназначается на snap_office, оставаясь в границах snap_lab
+    size_t storageIndex = 0;
+    uint32_t officeIndex = 0;
+    {
+        NetworkSnapshot original(path);
+        storageIndex = *original.findIndex("snap_storage");
+        officeIndex = static_cast<uint32_t>(*original.findIndex("snap_office"));
+    }
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        constexpr std::streamoff ENTITY_TABLE_OFFSET_FIELD = 72;
+        constexpr std::streamoff ENTITY_RECORD_SIZE = 20;
+        uint64_t entityTableOffset = 0;
+        file.seekg(ENTITY_TABLE_OFFSET_FIELD);
+        file.read(reinterpret_cast<char*>(&entityTableOffset), sizeof(entityTableOffset));
+        file.seekp(static_cast<std::streamoff>(entityTableOffset + storageIndex * ENTITY_RECORD_SIZE + sizeof(uint32_t)));
+        file.write(reinterpret_cast<const char*>(&officeIndex), sizeof(officeIndex));
+    }
+
+    NetworkSnapshot snapshot(path);
+    ASSERT_EQ(snapshot.getParentIndex(storageIndex), officeIndex);
+    EXPECT_THROW(snapshot.materialize("snap_lab"), ValidationException);
+    EXPECT_THROW(snapshot.restore(), ValidationException);
+
+    std::filesystem::remove(path);
+}
+
+/** @} */ // Конец группы network_snapshot_tests
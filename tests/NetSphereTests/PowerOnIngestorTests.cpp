@@ -0,0 +1,143 @@
+﻿/**
+ * @file PowerOnIngestorTests.cpp
+ * @brief Тесты для класса PowerOnIngestor проекта NetSphere.
+ */
+
+#include <gtest/gtest.h>
+#include "CorporateNetwork.h"
+#include "PowerOnIngestor.h"
+#include "Printer.h"
+#include "Workstation.h"
+#include <chrono>
+#include <optional>
+#include <thread>
+#include <vector>
+
+ /**
+  * @defgroup power_on_ingestor_tests Тесты приёма телеметрии включения
+  * @brief Тесты для проверки объединения, разрешения и применения событий включения
+  * @{
+  */
+
+/**
+ * @brief Тест: пакет с нулевым окном применяется сразу, повторы одной станции объединяются.
+ */
+TEST(PowerOnIngestorTest, CoalescesAndAppliesBatch) {
+    CorporateNetwork network("admin");
+    auto first = std::make_shared<Workstation>("poe_ws1", "00:1A:2B:3C:9D:01", "poe_user", 100);
+    auto second = std::make_shared<Workstation>("poe_ws2", "00:1A:2B:3C:9D:02", "poe_user", 100);
+    network.addEntityToDomain("", first, "admin");
+    network.addEntityToDomain("", second, "admin");
+    network.addEntityToDomain("", std::make_shared<Printer>("poe_printer", "00:1A:2B:3C:9D:03"), "admin");
+
+    PowerOnIngestor ingestor(network, std::chrono::milliseconds(0));
+    const std::vector<PowerOnEvent> batch{
+        { "poe_ws1", 500 }, { "poe_ws1", 900 }, { "poe_ws1", 700 },
+        { "poe_ws2", 300 }, { "poe_missing", 400 }, { "poe_printer", 400 } };
+    const PowerOnSubmitResult result = ingestor.submit(batch);
+
+    EXPECT_EQ(result.batch.received, 6u);
+    EXPECT_EQ(result.batch.unknown, 2u);
+    EXPECT_EQ(result.batch.coalesced, 2u);
+    ASSERT_TRUE(result.closedWindow.has_value());
+    EXPECT_EQ(result.closedWindow->applied, 2u);
+    EXPECT_EQ(result.closedWindow->stale, 0u);
+    EXPECT_EQ(ingestor.pendingCount(), 0u);
+    EXPECT_EQ(first->getLastPowerOnTime(), 900);
+    EXPECT_EQ(second->getLastPowerOnTime(), 300);
+}
+
+/**
+ * @brief Тест: события копятся до конца окна и применяются при flush.
+ */
+TEST(PowerOnIngestorTest, HoldsUpdatesUntilWindowFlush) {
+    CorporateNetwork network("admin");
+    auto workstation = std::make_shared<Workstation>("poe_window_ws", "00:1A:2B:3C:9D:11", "poe_user", 100);
+    network.addEntityToDomain("", workstation, "admin");
+
+    PowerOnIngestor ingestor(network, std::chrono::hours(1));
+    const std::vector<PowerOnEvent> firstBatch{ { "poe_window_ws", 200 } };
+    const std::vector<PowerOnEvent> secondBatch{ { "poe_window_ws", 300 } };
+    EXPECT_FALSE(ingestor.submit(firstBatch).closedWindow.has_value());
+    const PowerOnSubmitResult second = ingestor.submit(secondBatch);
+    EXPECT_EQ(second.batch.coalesced, 1u);
+    EXPECT_FALSE(second.closedWindow.has_value());
+    EXPECT_FALSE(ingestor.flushIfDue().has_value());
+    EXPECT_EQ(ingestor.pendingCount(), 1u);
+    EXPECT_EQ(workstation->getLastPowerOnTime(), 100);
+
+    const PowerOnWindowStats stats = ingestor.flush();
+    EXPECT_EQ(stats.applied, 1u);
+    EXPECT_EQ(workstation->getLastPowerOnTime(), 300);
+    EXPECT_EQ(network.getWorkstationsPoweredOnBetween(300, 301).size(), 1u);
+}
+
+/**
+ * @brief Тест: запоздавшие события не откатывают время включения назад.
+ */
+TEST(PowerOnIngestorTest, DropsStaleUpdates) {
+    CorporateNetwork network("admin");
+    auto workstation = std::make_shared<Workstation>("poe_stale_ws", "00:1A:2B:3C:9D:21", "poe_user", 1000);
+    network.addEntityToDomain("", workstation, "admin");
+
+    PowerOnIngestor ingestor(network, std::chrono::milliseconds(0));
+    const std::vector<PowerOnEvent> batch{ { "poe_stale_ws", 500 } };
+    const PowerOnSubmitResult result = ingestor.submit(batch);
+    ASSERT_TRUE(result.closedWindow.has_value());
+    EXPECT_EQ(result.closedWindow->applied, 0u);
+    EXPECT_EQ(result.closedWindow->stale, 1u);
+    EXPECT_EQ(workstation->getLastPowerOnTime(), 1000);
+}
+
+/**
+ * @brief Тест: истёкшее окно закрывается flushIfDue без нового пакета.
+ */
+TEST(PowerOnIngestorTest, FlushIfDueClosesExpiredWindow) {
+    CorporateNetwork network("admin");
+    auto workstation = std::make_shared<Workstation>("poe_due_ws", "00:1A:2B:3C:9D:31", "poe_user", 100);
+    network.addEntityToDomain("", workstation, "admin");
+
+    PowerOnIngestor ingestor(network, std::chrono::milliseconds(20));
+    EXPECT_EQ(ingestor.deadline(), std::chrono::steady_clock::time_point::max());
+    const std::vector<PowerOnEvent> batch{ { "poe_due_ws", 400 } };
+    EXPECT_FALSE(ingestor.submit(batch).closedWindow.has_value());
+    EXPECT_NE(ingestor.deadline(), std::chrono::steady_clock::time_point::max());
+
+    std::this_thread::sleep_until(ingestor.deadline());
+    const std::optional<PowerOnWindowStats> window = ingestor.flushIfDue();
+    ASSERT_TRUE(window.has_value());
+    EXPECT_EQ(window->applied, 1u);
+    EXPECT_EQ(workstation->getLastPowerOnTime(), 400);
+    EXPECT_FALSE(ingestor.flushIfDue().has_value());
+}
+
+/**
+ * @brief Тест: приёмники в разных потоках не откатывают время станции назад.
+ */
+TEST(PowerOnIngestorTest, ConcurrentIngestorsNeverRegress) {
+    CorporateNetwork network("admin");
+    auto workstation = std::make_shared<Workstation>("poe_race_ws", "00:1A:2B:3C:9D:41", "poe_user", 0);
+    network.addEntityToDomain("", workstation, "admin");
+
+    static constexpr time_t EVENTS = 2000;
+    auto ingest = [&](time_t offset) {
+        PowerOnIngestor ingestor(network, std::chrono::milliseconds(0));
+        for (time_t i = 0; i < EVENTS; ++i) {
+            const std::vector<PowerOnEvent> batch{ { "poe_race_ws", i * 2 + offset } };
+            ingestor.submit(batch);
+        }
+    };
+    std::thread even(ingest, 0);
+    std::thread odd(ingest, 1);
+    time_t observed = 0;
+    while (observed < EVENTS * 2 - 1) {
+        const time_t current = workstation->getLastPowerOnTime();
+        ASSERT_GE(current, observed);
+        observed = current;
+    }
+    even.join();
+    odd.join();
+    EXPECT_EQ(workstation->getLastPowerOnTime(), EVENTS * 2 - 1);
+}
+
+/** @} */ // Конец группы power_on_ingestor_tests
@@ -0,0 +1,145 @@
+﻿/**
+ * @file PowerOnTimeIndexTests.cpp
+ * @brief Тесты для класса PowerOnTimeIndex проекта NetSphere.
+ */
+
+#include <gtest/gtest.h>
+#include "CorporateNetwork.h"
+#include "Workstation.h"
+#include "NetworkExceptions.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+ /**
+  * @defgroup power_on_time_index_tests Тесты индекса времени включения
+  * @brief Тесты для проверки диапазонных запросов по времени последнего включения станций
+  * @{
+  */
+
+namespace {
+
+    std::vector<std::string> workstationIds(const std::vector<std::shared_ptr<Workstation>>& workstations) {
+        std::vector<std::string> ids;
+        for (const auto& workstation : workstations) {
+            ids.push_back(workstation->getId());
+        }
+        return ids;
+    }
+
+}
+
+/**
+ * @brief Тест: диапазон полуоткрытый и упорядочен по времени включения.
+ */
+TEST(PowerOnTimeIndexTest, ReturnsRangesInTimeOrder) {
+    CorporateNetwork network("admin");
+    network.addEntityToDomain("", std::make_shared<Workstation>("poi_c", "00:1A:2B:3C:8D:01", "poi_user", 3000), "admin");
+    network.addEntityToDomain("", std::make_shared<Workstation>("poi_a", "00:1A:2B:3C:8D:02", "poi_user", 1000), "admin");
+    network.addEntityToDomain("", std::make_shared<Workstation>("poi_b", "00:1A:2B:3C:8D:03", "poi_user", 2000), "admin");
+
+    EXPECT_EQ(workstationIds(network.getWorkstationsPoweredOnBefore(3000)),
+        (std::vector<std::string>{ "poi_a", "poi_b" }));
+    EXPECT_EQ(workstationIds(network.getWorkstationsPoweredOnBetween(2000, 3001)),
+        (std::vector<std::string>{ "poi_b", "poi_c" }));
+    EXPECT_TRUE(network.getWorkstationsPoweredOnBetween(3000, 2000).empty());
+    EXPECT_TRUE(network.getWorkstationsPoweredOnBefore(1000).empty());
+}
+
+/**
+ * @brief Тест: новое время включения переносит станцию в индексе.
+ */
+TEST(PowerOnTimeIndexTest, FollowsPowerOnUpdates) {
+    CorporateNetwork network("admin");
+    auto stale = std::make_shared<Workstation>("poi_stale", "00:1A:2B:3C:8D:11", "poi_user", 1000);
+    network.addEntityToDomain("", stale, "admin");
+    network.addEntityToDomain("", std::make_shared<Workstation>("poi_fresh", "00:1A:2B:3C:8D:12", "poi_user", 5000), "admin");
+    EXPECT_EQ(workstationIds(network.getWorkstationsPoweredOnBefore(2000)), (std::vector<std::string>{ "poi_stale" }));
+
+    stale->updatePowerOnTime(9000);
+    EXPECT_TRUE(network.getWorkstationsPoweredOnBefore(2000).empty());
+    EXPECT_EQ(workstationIds(network.getWorkstationsPoweredOnBetween(0, 10000)),
+        (std::vector<std::string>{ "poi_fresh", "poi_stale" }));
+}
+
+/**
+ * @brief Тест: ограничение доменом учитывает вложенные поддомены.
+ */
+TEST(PowerOnTimeIndexTest, RestrictsResultsToDomainSubtree) {
+    CorporateNetwork network("admin");
+    auto branch = std::make_shared<Domain>("poi_branch", "branch_admin");
+    auto office = std::make_shared<Domain>("poi_office", "branch_admin");
+    office->addEntity(std::make_shared<Workstation>("poi_office_ws", "00:1A:2B:3C:8D:21", "poi_user", 1000), "branch_admin");
+    branch->addEntity(office, "branch_admin");
+    network.addEntityToDomain("", branch, "admin");
+    network.addEntityToDomain("", std::make_shared<Workstation>("poi_root_ws", "00:1A:2B:3C:8D:22", "poi_user", 1500), "admin");
+
+    EXPECT_EQ(workstationIds(network.getWorkstationsPoweredOnBefore(2000)),
+        (std::vector<std::string>{ "poi_office_ws", "poi_root_ws" }));
+    EXPECT_EQ(workstationIds(network.getWorkstationsPoweredOnBefore(2000, "poi_branch")),
+        (std::vector<std::string>{ "poi_office_ws" }));
+    EXPECT_THROW(network.getWorkstationsPoweredOnBefore(2000, "poi_missing_domain"), DomainOperationException);
+}
+
+/**
+ * @brief Тест: отсоединённые станции не попадают в индекс и не отслеживаются.
+ */
+TEST(PowerOnTimeIndexTest, IgnoresDetachedWorkstations) {
+    CorporateNetwork network("admin");
+    auto branch = std::make_shared<Domain>("poi_moving", "branch_admin");
+    auto workstation = std::make_shared<Workstation>("poi_moving_ws", "00:1A:2B:3C:8D:31", "poi_user", 1000);
+    branch->addEntity(workstation, "branch_admin");
+    network.addEntityToDomain("", branch, "admin");
+
+    DetachedSubtree subtree = network.detachSubtree("poi_moving", "admin");
+    EXPECT_TRUE(network.getWorkstationsPoweredOnBefore(2000).empty());
+
+    // Изменение отсоединённой станции учитывается при повторном присоединении
+    workstation->updatePowerOnTime(4000);
+    network.attachSubtree("", std::move(subtree), "admin");
+    EXPECT_TRUE(network.getWorkstationsPoweredOnBefore(2000).empty());
+    EXPECT_EQ(workstationIds(network.getWorkstationsPoweredOnBefore(5000)),
+        (std::vector<std::string>{ "poi_moving_ws" }));
+
+    network.removeEntity("poi_moving", "admin");
+    EXPECT_TRUE(network.getWorkstationsPoweredOnBefore(5000).empty());
+}
+
+/**
+ * @brief Тест: обновления времени из разных потоков во время запросов оставляют индекс согласованным.
+ */
+TEST(PowerOnTimeIndexTest, ConcurrentUpdatesAndQueries) {
+    CorporateNetwork network("admin");
+    std::vector<std::shared_ptr<Workstation>> workstations;
+    for (int i = 0; i < 4; ++i) {
+        auto workstation = std::make_shared<Workstation>("poi_concurrent_" + std::to_string(i),
+            MacAddress::fromUInt64(0x8E00 + i).toString(), "poi_user", 0);
+        network.addEntityToDomain("", workstation, "admin");
+        workstations.push_back(workstation);
+    }
+
+    static constexpr time_t UPDATES = 2000;
+    std::vector<std::thread> threads;
+    for (const auto& workstation : workstations) {
+        threads.emplace_back([workstation] {
+            for (time_t t = 1; t <= UPDATES; ++t) {
+                workstation->updatePowerOnTime(t);
+            }
+        });
+    }
+    threads.emplace_back([&network] {
+        for (int i = 0; i < 200; ++i) {
+            for (const auto& workstation : network.getWorkstationsPoweredOnBefore(UPDATES + 1)) {
+                EXPECT_LE(workstation->getLastPowerOnTime(), UPDATES);
+            }
+        }
+    });
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(network.getWorkstationsPoweredOnBetween(UPDATES, UPDATES + 1).size(), workstations.size());
+    EXPECT_TRUE(network.getWorkstationsPoweredOnBefore(UPDATES).empty());
+}
+
+/** @} */ // Конец группы power_on_time_index_tests
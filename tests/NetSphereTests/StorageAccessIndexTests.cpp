@@ -0,0 +1,82 @@
+﻿/**
+ * @file StorageAccessIndexTests.cpp
+ * @brief Тесты для класса StorageAccessIndex проекта NetSphere.
+ */
+
+#include <gtest/gtest.h>
+#include "CorporateNetwork.h"
+#include "DataStorage.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+ /**
+  * @defgroup storage_access_index_tests Тесты индекса доступа к хранилищам
+  * @brief Тесты для проверки обратного индекса "пользователь -> хранилища"
+  * @{
+  */
+
+namespace {
+
+    std::vector<std::string> storageIds(const std::vector<std::shared_ptr<DataStorage>>& storages) {
+        std::vector<std::string> ids;
+        for (const auto& storage : storages) {
+            ids.push_back(storage->getId());
+        }
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+
+}
+
+/**
+ * @brief Тест: индекс учитывает доверенных пользователей до и после присоединения хранилища.
+ */
+TEST(StorageAccessIndexTest, TracksTrustedUsersOfAttachedStorages) {
+    CorporateNetwork network("admin");
+    auto archive = std::make_shared<DataStorage>("sai_archive", "00:1A:2B:3C:6D:01", 100.0);
+    auto backup = std::make_shared<DataStorage>("sai_backup", "00:1A:2B:3C:6D:02", 100.0);
+    archive->addTrustedUser("sai_alice");
+    network.addEntityToDomain("", archive, "admin");
+    network.addEntityToDomain("", backup, "admin");
+    backup->addTrustedUser("sai_alice");
+    backup->addTrustedUser("sai_bob");
+
+    EXPECT_EQ(storageIds(network.getStoragesForUser("sai_alice")),
+        (std::vector<std::string>{ "sai_archive", "sai_backup" }));
+    EXPECT_EQ(storageIds(network.getStoragesForUser("sai_bob")), (std::vector<std::string>{ "sai_backup" }));
+    EXPECT_TRUE(network.getStoragesForUser("sai_nobody_at_all").empty());
+
+    backup->removeTrustedUser("sai_alice");
+    EXPECT_EQ(storageIds(network.getStoragesForUser("sai_alice")), (std::vector<std::string>{ "sai_archive" }));
+
+    network.removeEntity("sai_archive", "admin");
+    EXPECT_TRUE(network.getStoragesForUser("sai_alice").empty());
+
+    // Изменения отсоединённого хранилища в индекс не попадают
+    archive->addTrustedUser("sai_bob");
+    EXPECT_EQ(storageIds(network.getStoragesForUser("sai_bob")), (std::vector<std::string>{ "sai_backup" }));
+}
+
+/**
+ * @brief Тест: хранилища внутри перенесённого поддерева остаются в индексе.
+ */
+TEST(StorageAccessIndexTest, FollowsDetachedAndReattachedSubtrees) {
+    CorporateNetwork network("admin");
+    auto branch = std::make_shared<Domain>("sai_branch", "branch_admin");
+    auto storage = std::make_shared<DataStorage>("sai_branch_storage", "00:1A:2B:3C:6D:03", 100.0);
+    storage->addTrustedUser("sai_carol");
+    branch->addEntity(storage, "branch_admin");
+    network.addEntityToDomain("", branch, "admin");
+    EXPECT_EQ(network.getStoragesForUser("sai_carol").size(), 1u);
+
+    DetachedSubtree subtree = network.detachSubtree("sai_branch", "admin");
+    EXPECT_TRUE(network.getStoragesForUser("sai_carol").empty());
+
+    network.attachSubtree("", std::move(subtree), "admin");
+    const auto storages = network.getStoragesForUser("sai_carol");
+    ASSERT_EQ(storages.size(), 1u);
+    EXPECT_EQ(storages.front(), storage);
+}
+
+/** @} */ // Конец группы storage_access_index_tests
@@ -0,0 +1,137 @@
+﻿/**
+ * @file SymbolTableTests.cpp
+ * @brief Тесты для пула интернированных строк проекта NetSphere.
+ */
+
+#include <gtest/gtest.h>
+#include "SymbolTable.h"
+#include "DataStorage.h"
+#include "Workstation.h"
+#include "Domain.h"
+#include <string_view>
+#include <thread>
+#include <vector>
+
+ /**
+  * @defgroup symbol_table_tests Тесты пула строк
+  * @brief Тесты для проверки интернирования идентификаторов
+  * @{
+  */
+
+  // Тест: одинаковые строки получают один и тот же символ
+TEST(SymbolTableTest, InternReturnsSameSymbol) {
+    Symbol first = Symbol::intern("symbol_test_user");
+    Symbol second = Symbol::intern(std::string("symbol_test_") + "user");
+
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(first.str(), "symbol_test_user");
+    EXPECT_EQ(&first.str(), &second.str());
+    EXPECT_NE(first, Symbol::intern("symbol_test_other"));
+}
+
+// Тест поиска без добавления в пул
+TEST(SymbolTableTest, LookupDoesNotIntern) {
+    const size_t sizeBefore = SymbolTable::instance().size();
+    EXPECT_FALSE(Symbol::lookup("symbol_never_interned_xyz").has_value());
+    EXPECT_EQ(SymbolTable::instance().size(), sizeBefore);
+
+    Symbol added = Symbol::intern("symbol_lookup_target");
+    auto found = Symbol::lookup("symbol_lookup_target");
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(*found, added);
+}
+
+// Тест пустой строки
+TEST(SymbolTableTest, EmptySymbol) {
+    Symbol empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty, Symbol::intern(""));
+    EXPECT_EQ(empty.str(), "");
+}
+
+// Тест закешированной проверки идентификатора устройства
+TEST(SymbolTableTest, CachedDeviceIdStatus) {
+    EXPECT_EQ(Symbol::intern("valid_id-01").deviceIdStatus(), DeviceIdStatus::Valid);
+    EXPECT_EQ(Symbol::intern("").deviceIdStatus(), DeviceIdStatus::Empty);
+    EXPECT_EQ(Symbol::intern(std::string(51, 'a')).deviceIdStatus(), DeviceIdStatus::TooLong);
+    EXPECT_EQ(Symbol::intern("bad@id").deviceIdStatus(), DeviceIdStatus::InvalidChars);
+}
+
+// Тест пакетного интернирования известных, новых и повторяющихся строк
+TEST(SymbolTableTest, InternAllMatchesIntern) {
+    const Symbol known = Symbol::intern("sym_batch_known");
+    const std::vector<std::string_view> texts{ "sym_batch_new", "sym_batch_known", "", "sym_batch_new" };
+    std::vector<Symbol> symbols(texts.size());
+    Symbol::internAll(texts, symbols);
+
+    EXPECT_EQ(symbols[0], Symbol::intern("sym_batch_new"));
+    EXPECT_EQ(symbols[1], known);
+    EXPECT_TRUE(symbols[2].empty());
+    EXPECT_EQ(symbols[3], symbols[0]);
+}
+
+// Тест освобождения строки после уничтожения последнего символа
+TEST(SymbolTableTest, ReleasesStringWithLastSymbol) {
+    const size_t before = SymbolTable::instance().size();
+    {
+        Workstation ws("sym_released_ws", "00:1A:2B:3C:4D:74", "sym_released_user", 0);
+        Symbol copy = ws.getUserSymbol();
+        EXPECT_EQ(SymbolTable::instance().size(), before + 2);
+        EXPECT_TRUE(Symbol::lookup("sym_released_user").has_value());
+    }
+    EXPECT_FALSE(Symbol::lookup("sym_released_ws").has_value());
+    EXPECT_FALSE(Symbol::lookup("sym_released_user").has_value());
+    EXPECT_EQ(SymbolTable::instance().size(), before);
+
+    // Освобождённый индекс выдаётся новой строке, а её текст не смешивается с прежним
+    const Symbol reused = Symbol::intern("sym_reused_text");
+    EXPECT_EQ(reused.str(), "sym_reused_text");
+    EXPECT_EQ(reused.deviceIdStatus(), DeviceIdStatus::Valid);
+}
+
+// Тест одновременного копирования, освобождения и интернирования одной строки
+TEST(SymbolTableTest, ConcurrentInternAndRelease) {
+    static constexpr int ITERATIONS = 20000;
+    auto churn = [] {
+        for (int i = 0; i < ITERATIONS; ++i) {
+            Symbol first = Symbol::intern("sym_churn");
+            Symbol second = first;
+            EXPECT_EQ(second.str(), "sym_churn");
+            EXPECT_EQ(Symbol::intern("sym_churn"), first);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back(churn);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_FALSE(Symbol::lookup("sym_churn").has_value());
+}
+
+// Тест разделения символов между сущностями
+TEST(SymbolTableTest, EntitiesShareInternedIdentifiers) {
+    Workstation ws1("sym_ws1", "00:1A:2B:3C:4D:70", "shared_user", 0);
+    Workstation ws2("sym_ws2", "00:1A:2B:3C:4D:71", "shared_user", 0);
+    EXPECT_EQ(ws1.getUserSymbol(), ws2.getUserSymbol());
+    EXPECT_EQ(&ws1.getUserId(), &ws2.getUserId());
+
+    DataStorage storage("sym_storage", "00:1A:2B:3C:4D:72", 1000.0);
+    storage.addTrustedUser("shared_user");
+    EXPECT_EQ(storage.getTrustedUsers()[0], ws1.getUserSymbol());
+    EXPECT_TRUE(storage.isUserTrusted("shared_user"));
+    EXPECT_FALSE(storage.isUserTrusted("symbol_unknown_user_xyz"));
+}
+
+// Тест проверки прав администратора для неизвестного пользователя
+TEST(SymbolTableTest, AdminCheckWithUnknownUser) {
+    Domain domain("sym_domain", "sym_admin");
+    auto printer = std::make_shared<DataStorage>("sym_storage2", "00:1A:2B:3C:4D:73", 1000.0);
+
+    EXPECT_THROW(domain.addEntity(printer, "symbol_intruder_xyz"), AccessDeniedException);
+    EXPECT_FALSE(Symbol::lookup("symbol_intruder_xyz").has_value());
+    EXPECT_NO_THROW(domain.addEntity(printer, "sym_admin"));
+}
+
+/** @} */ // Конец группы symbol_table_tests
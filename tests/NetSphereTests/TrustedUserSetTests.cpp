@@ -0,0 +1,107 @@
+﻿/**
+ * @file TrustedUserSetTests.cpp
+ * @brief Тесты для класса TrustedUserSet проекта NetSphere.
+ */
+
+#include <gtest/gtest.h>
+#include "TrustedUserSet.h"
+#include <string>
+#include <vector>
+
+ /**
+  * @defgroup trusted_user_set_tests Тесты множества доверенных пользователей
+  * @brief Тесты для проверки смены представления и сохранения порядка
+  * @{
+  */
+
+/**
+ * @brief Тест: небольшое множество ищет по отсортированной копии и хранит порядок добавления.
+ */
+TEST(TrustedUserSetTest, SmallSetKeepsInsertionOrder) {
+    TrustedUserSet users;
+    const Symbol zed = Symbol::intern("tus_zed");
+    const Symbol amy = Symbol::intern("tus_amy");
+    const Symbol bob = Symbol::intern("tus_bob");
+
+    EXPECT_TRUE(users.insert(zed));
+    EXPECT_TRUE(users.insert(amy));
+    EXPECT_TRUE(users.insert(bob));
+    EXPECT_FALSE(users.insert(amy));
+    EXPECT_FALSE(users.isHashed());
+
+    EXPECT_TRUE(users.contains(bob));
+    EXPECT_FALSE(users.contains(Symbol::intern("tus_nobody")));
+    EXPECT_EQ(users.inInsertionOrder(), (std::vector<Symbol>{ zed, amy, bob }));
+
+    EXPECT_TRUE(users.erase(amy));
+    EXPECT_FALSE(users.erase(amy));
+    EXPECT_EQ(users.inInsertionOrder(), (std::vector<Symbol>{ zed, bob }));
+}
+
+/**
+ * @brief Тест: множество переходит на хэш при росте и возвращается после уменьшения.
+ */
+TEST(TrustedUserSetTest, SwitchesRepresentationWithSize) {
+    TrustedUserSet users;
+    std::vector<Symbol> expected;
+    for (size_t i = 0; i < TrustedUserSet::HASH_THRESHOLD * 4; ++i) {
+        const Symbol user = Symbol::intern("tus_user_" + std::to_string(i));
+        ASSERT_TRUE(users.insert(user));
+        expected.push_back(user);
+        EXPECT_EQ(users.isHashed(), users.size() > TrustedUserSet::HASH_THRESHOLD);
+    }
+    EXPECT_FALSE(users.insert(expected[7]));
+    EXPECT_TRUE(users.contains(expected.back()));
+    EXPECT_EQ(users.inInsertionOrder(), expected);
+
+    // Удаление с начала сохраняет порядок оставшихся
+    while (users.size() > TrustedUserSet::HASH_THRESHOLD / 2) {
+        ASSERT_TRUE(users.erase(expected.front()));
+        expected.erase(expected.begin());
+    }
+    EXPECT_FALSE(users.isHashed());
+    EXPECT_EQ(users.inInsertionOrder(), expected);
+    for (Symbol user : expected) {
+        EXPECT_TRUE(users.contains(user));
+    }
+    EXPECT_FALSE(users.contains(Symbol::intern("tus_user_0")));
+}
+
+/**
+ * @brief Тест: удаление из большого множества сохраняет порядок и переживает уплотнение.
+ */
+TEST(TrustedUserSetTest, LargeSetEraseKeepsOrderAcrossCompaction) {
+    TrustedUserSet users;
+    std::vector<Symbol> expected;
+    constexpr size_t COUNT = TrustedUserSet::HASH_THRESHOLD * 8;
+    for (size_t i = 0; i < COUNT; ++i) {
+        const Symbol user = Symbol::intern("tus_large_" + std::to_string(i));
+        ASSERT_TRUE(users.insert(user));
+        expected.push_back(user);
+    }
+
+    // Удаляются чётные позиции: пустых позиций становится больше живых, вектор уплотняется
+    for (size_t i = 0; i < COUNT; i += 2) {
+        ASSERT_TRUE(users.erase(Symbol::intern("tus_large_" + std::to_string(i))));
+    }
+    std::erase_if(expected, [](Symbol user) {
+        return std::stoul(std::string(user.view().substr(std::string_view("tus_large_").size()))) % 2 == 0;
+    });
+    EXPECT_TRUE(users.isHashed());
+    EXPECT_EQ(users.size(), expected.size());
+    EXPECT_EQ(users.inInsertionOrder(), expected);
+
+    // Позиции после уплотнения остаются верными для последующих удалений и вставок
+    ASSERT_TRUE(users.erase(expected[3]));
+    expected.erase(expected.begin() + 3);
+    const Symbol late = Symbol::intern("tus_large_late");
+    ASSERT_TRUE(users.insert(late));
+    expected.push_back(late);
+    EXPECT_FALSE(users.insert(expected[5]));
+    EXPECT_EQ(users.inInsertionOrder(), expected);
+    for (Symbol user : expected) {
+        EXPECT_TRUE(users.contains(user));
+    }
+}
+
+/** @} */ // Конец группы trusted_user_set_tests
@@ -0,0 +1,108 @@
+﻿/**
+ * @file WorkstationUserIndexTests.cpp
+ * @brief Тесты для класса WorkstationUserIndex проекта NetSphere.
+ */
+
+#include <gtest/gtest.h>
+#include "CorporateNetwork.h"
+#include "Workstation.h"
+#include "NetworkExceptions.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+ /**
+  * @defgroup workstation_user_index_tests Тесты индекса рабочих станций по пользователям
+  * @brief Тесты для проверки обратного индекса "пользователь -> рабочие станции"
+  * @{
+  */
+
+namespace {
+
+    std::vector<std::string> workstationIds(const std::vector<std::shared_ptr<Workstation>>& workstations) {
+        std::vector<std::string> ids;
+        for (const auto& workstation : workstations) {
+            ids.push_back(workstation->getId());
+        }
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+
+}
+
+/**
+ * @brief Тест: индекс отражает добавление и удаление станций пользователя.
+ */
+TEST(WorkstationUserIndexTest, TracksWorkstationsOfUser) {
+    CorporateNetwork network("admin");
+    network.addEntityToDomain("", std::make_shared<Workstation>("wui_ws1", "00:1A:2B:3C:7D:01", "wui_alice", 1000), "admin");
+    network.addEntityToDomain("", std::make_shared<Workstation>("wui_ws2", "00:1A:2B:3C:7D:02", "wui_alice", 2000), "admin");
+    network.addEntityToDomain("", std::make_shared<Workstation>("wui_ws3", "00:1A:2B:3C:7D:03", "wui_bob", 3000), "admin");
+
+    EXPECT_EQ(workstationIds(network.getWorkstationsForUser("wui_alice")),
+        (std::vector<std::string>{ "wui_ws1", "wui_ws2" }));
+    EXPECT_EQ(workstationIds(network.getWorkstationsForUser("wui_bob")), (std::vector<std::string>{ "wui_ws3" }));
+    EXPECT_TRUE(network.getWorkstationsForUser("wui_nobody_at_all").empty());
+
+    network.removeEntity("wui_ws1", "admin");
+    EXPECT_EQ(workstationIds(network.getWorkstationsForUser("wui_alice")), (std::vector<std::string>{ "wui_ws2" }));
+}
+
+/**
+ * @brief Тест: пакетный запрос возвращает станции в порядке пользователей.
+ */
+TEST(WorkstationUserIndexTest, AnswersBatchQueries) {
+    CorporateNetwork network("admin");
+    network.addEntityToDomain("", std::make_shared<Workstation>("wui_b1", "00:1A:2B:3C:7D:11", "wui_carol", 1000), "admin");
+    network.addEntityToDomain("", std::make_shared<Workstation>("wui_b2", "00:1A:2B:3C:7D:12", "wui_dave", 1000), "admin");
+
+    const std::vector<std::string> users{ "wui_dave", "wui_unknown_user", "wui_carol" };
+    const auto found = network.getWorkstationsForUsers(users);
+    ASSERT_EQ(found.size(), 3u);
+    EXPECT_EQ(workstationIds(found[0]), (std::vector<std::string>{ "wui_b2" }));
+    EXPECT_TRUE(found[1].empty());
+    EXPECT_EQ(workstationIds(found[2]), (std::vector<std::string>{ "wui_b1" }));
+}
+
+/**
+ * @brief Тест: ограничение доменом учитывает вложенные поддомены.
+ */
+TEST(WorkstationUserIndexTest, RestrictsResultsToDomainSubtree) {
+    CorporateNetwork network("admin");
+    auto branch = std::make_shared<Domain>("wui_branch", "branch_admin");
+    auto office = std::make_shared<Domain>("wui_office", "branch_admin");
+    office->addEntity(std::make_shared<Workstation>("wui_office_ws", "00:1A:2B:3C:7D:21", "wui_erin", 1000), "branch_admin");
+    branch->addEntity(office, "branch_admin");
+    network.addEntityToDomain("", branch, "admin");
+    network.addEntityToDomain("", std::make_shared<Workstation>("wui_root_ws", "00:1A:2B:3C:7D:22", "wui_erin", 1000), "admin");
+
+    EXPECT_EQ(workstationIds(network.getWorkstationsForUser("wui_erin")),
+        (std::vector<std::string>{ "wui_office_ws", "wui_root_ws" }));
+    EXPECT_EQ(workstationIds(network.getWorkstationsForUser("wui_erin", "wui_branch")),
+        (std::vector<std::string>{ "wui_office_ws" }));
+    EXPECT_EQ(workstationIds(network.getWorkstationsForUser("wui_erin", "root_domain")),
+        (std::vector<std::string>{ "wui_office_ws", "wui_root_ws" }));
+    EXPECT_THROW(network.getWorkstationsForUser("wui_erin", "wui_missing_domain"), DomainOperationException);
+}
+
+/**
+ * @brief Тест: станции перенесённого поддерева выпадают из индекса и возвращаются в него.
+ */
+TEST(WorkstationUserIndexTest, FollowsDetachedAndReattachedSubtrees) {
+    CorporateNetwork network("admin");
+    auto branch = std::make_shared<Domain>("wui_moving", "branch_admin");
+    auto workstation = std::make_shared<Workstation>("wui_moving_ws", "00:1A:2B:3C:7D:31", "wui_frank", 1000);
+    branch->addEntity(workstation, "branch_admin");
+    network.addEntityToDomain("", branch, "admin");
+    EXPECT_EQ(network.getWorkstationsForUser("wui_frank").size(), 1u);
+
+    DetachedSubtree subtree = network.detachSubtree("wui_moving", "admin");
+    EXPECT_TRUE(network.getWorkstationsForUser("wui_frank").empty());
+
+    network.attachSubtree("", std::move(subtree), "admin");
+    const auto workstations = network.getWorkstationsForUser("wui_frank");
+    ASSERT_EQ(workstations.size(), 1u);
+    EXPECT_EQ(workstations.front(), workstation);
+}
+
+/** @} */ // Конец группы workstation_user_index_tests